@@ -1,6 +1,7 @@
 
 CONFIG += debug_and_release	# warning: specifying EITHER release OR debug breaks the dll installation target on Windows !
 TEMPLATE = app
+QT += network
 TARGET = FreeSSM
 DESTDIR = ./
 DEPENDPATH += . src ui
@@ -23,6 +24,8 @@ HEADERS += src/FreeSSM.h \
            src/ATcommandControlledDiagInterface.h \
            src/SerialPassThroughDiagInterface.h \
            src/J2534DiagInterface.h \
+           src/CapturingDiagInterface.h \
+           src/ReplayDiagInterface.h \
            src/J2534.h \
            src/SSMP1communication.h \
            src/SSMP1communication_procedures.h \
@@ -32,6 +35,7 @@ HEADERS += src/FreeSSM.h \
            src/SSMprotocol.h \
            src/SSMprotocol1.h \
            src/SSMprotocol2.h \
+           src/CUsetupCache.h \
            src/AddMBsSWsDlg.h \
            src/ControlUnitDialog.h \
            src/CUinfo_Engine.h \
@@ -43,16 +47,33 @@ HEADERS += src/FreeSSM.h \
            src/CUcontent_DCs_stopCodes.h \
            src/CUcontent_MBsSWs.h \
            src/CUcontent_MBsSWs_tableView.h \
+           src/CUcontent_MBsSWs_tableModel.h \
            src/CUcontent_Adjustments.h \
            src/CUcontent_sysTests.h \
            src/DiagInterfaceStatusBar.h \
+           src/DiagInterfaceDetector.h \
+           src/VehicleScan.h \
+           src/DiagInterfaceMultiplexer.h \
+           src/MultiCUsession.h \
+           src/DiagSessionManager.h \
            src/SSM1definitionsInterface.h \
+           src/SSM1definitionsCache.h \
            src/SSM2definitionsInterface.h \
+           src/SSM2definitionTables.h \
            src/SSMprotocol2_ID.h \
            src/SSMprotocol2_def_en.h \
            src/SSMprotocol2_def_de.h \
            src/ClearMemoryDlg.h \
            src/libFSSM.h \
+           src/MBSWlogFile.h \
+           src/MBSWlogReplay.h \
+           src/MBSWtriggerLogger.h \
+           src/MBSWdecoder.h \
+           src/MBSWstatistics.h \
+           src/MBSWstatisticsDlg.h \
+           src/MBSWexpression.h \
+           src/MBSWtelemetryServer.h \
+           src/MBSWsharedMemoryExport.h \
            src/tinyxml/tinyxml.h \
            src/tinyxml/tinystr.h
 
@@ -71,6 +92,8 @@ SOURCES += src/main.cpp \
            src/ATcommandControlledDiagInterface.cpp \
            src/SerialPassThroughDiagInterface.cpp \
            src/J2534DiagInterface.cpp \
+           src/CapturingDiagInterface.cpp \
+           src/ReplayDiagInterface.cpp \
            src/SSMP1communication.cpp \
            src/SSMP1communication_procedures.cpp \
            src/SSMP1base.cpp \
@@ -79,6 +102,7 @@ SOURCES += src/main.cpp \
            src/SSMprotocol.cpp \
            src/SSMprotocol1.cpp \
            src/SSMprotocol2.cpp \
+           src/CUsetupCache.cpp \
            src/AddMBsSWsDlg.cpp \
            src/ControlUnitDialog.cpp \
            src/CUinfo_Engine.cpp \
@@ -90,16 +114,33 @@ SOURCES += src/main.cpp \
            src/CUcontent_DCs_stopCodes.cpp \
            src/CUcontent_MBsSWs.cpp \
            src/CUcontent_MBsSWs_tableView.cpp \
+           src/CUcontent_MBsSWs_tableModel.cpp \
            src/CUcontent_Adjustments.cpp \
            src/CUcontent_sysTests.cpp \
            src/DiagInterfaceStatusBar.cpp \
+           src/DiagInterfaceDetector.cpp \
+           src/VehicleScan.cpp \
+           src/DiagInterfaceMultiplexer.cpp \
+           src/MultiCUsession.cpp \
+           src/DiagSessionManager.cpp \
            src/SSM1definitionsInterface.cpp \
+           src/SSM1definitionsCache.cpp \
            src/SSM2definitionsInterface.cpp \
+           src/SSM2definitionTables.cpp \
            src/SSMprotocol2_ID.cpp \
            src/SSMprotocol2_def_en.cpp \
            src/SSMprotocol2_def_de.cpp \
            src/ClearMemoryDlg.cpp \
            src/libFSSM.cpp \
+           src/MBSWlogFile.cpp \
+           src/MBSWlogReplay.cpp \
+           src/MBSWtriggerLogger.cpp \
+           src/MBSWdecoder.cpp \
+           src/MBSWstatistics.cpp \
+           src/MBSWstatisticsDlg.cpp \
+           src/MBSWexpression.cpp \
+           src/MBSWtelemetryServer.cpp \
+           src/MBSWsharedMemoryExport.cpp \
            src/tinyxml/tinyxml.cpp \
            src/tinyxml/tinystr.cpp \
            src/tinyxml/tinyxmlerror.cpp \
@@ -120,6 +161,7 @@ FORMS +=   ui/FreeSSM.ui \
            ui/CUcontent_Adjustments.ui \
            ui/CUcontent_sysTests.ui \
            ui/AddMBsSWsDlg.ui \
+           ui/MBSWstatisticsDlg.ui \
            ui/ActuatorTestDlg.ui
 
 RESOURCES += resources/FreeSSM.qrc
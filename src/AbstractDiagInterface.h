@@ -48,7 +48,7 @@ public:
 	virtual bool connect(protocol_type protocol) = 0;
 	virtual bool isConnected() = 0;
 	virtual bool disconnect() = 0;
-	virtual bool read(std::vector<char> *buffer) = 0;
+	virtual bool read(std::vector<char> *buffer) = 0;	// NOTE: ISO-15765: max. one complete message (CAN-ID + data) per call
 	virtual bool write(std::vector<char> buffer) = 0;
 	virtual bool clearSendBuffer() = 0;
 	virtual bool clearReceiveBuffer() = 0;
@@ -581,6 +581,7 @@ void CUcontent_Adjustments::resetAllAdjustmentValues()
 	int uc = 0;
 	unsigned char k = 0;
 	bool calcerror = false;
+	std::vector<unsigned int> defaultValues;
 
 	if (!_SSMPdev) return;
 	// Show "Confirm"-dialog:
@@ -600,12 +601,11 @@ void CUcontent_Adjustments::resetAllAdjustmentValues()
 	waitmsgbox.show();
 	// Reset all adjustment values:
 	for (k=0; k<_supportedAdjustments.size(); k++)
+		defaultValues.push_back( _supportedAdjustments.at(k).rawDefault );
+	if (!_SSMPdev->setAllAdjustmentValues(defaultValues))
 	{
-		if (!_SSMPdev->setAdjustmentValue(k, _supportedAdjustments.at(k).rawDefault))
-		{
-			communicationError(tr("No or invalid answer from Control Unit."));
-			return;
-		}
+		communicationError(tr("No or invalid answer from Control Unit."));
+		return;
 	}
 	// Scale raw default values and display them:
 	QString scaledValueString = "";
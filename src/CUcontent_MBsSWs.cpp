@@ -26,18 +26,22 @@ CUcontent_MBsSWs::CUcontent_MBsSWs(MBSWsettings_dt settings, QWidget *parent) :
 	_SSMPdev = NULL;
 	_supportedMBs.clear();
 	_supportedSWs.clear();
+	_nrOfCUMBs = 0;
+	_derivedMBs.clear();
 	_MBSWmetaList.clear();
 	_timemode = settings.timeMode;
 	_lastrefreshduration_ms = 0;
 	_lastValues.clear();
-	_minmaxData.clear();
 	_tableRowPosIndexes.clear();
+	_replayActive = false;
+	_preReplayNrOfDerivedMBs = 0;
+	_MBSWdecoder = new MBSWdecoder();
 
 	// Setup GUI:
 	setupUi(this);
 	setupTimeModeUiElements();
 	setupUiFonts();
-	_valuesTableView = new CUcontent_MBsSWs_tableView(MBSWviews_tabWidget->widget(0), settings.minValuesEnabled, settings.maxValuesEnabled);
+	_valuesTableView = new CUcontent_MBsSWs_tableView(MBSWviews_tabWidget->widget(0), settings.minValuesEnabled, settings.maxValuesEnabled, settings.displayRate);
 	valuesTableView_gridLayout->addWidget(_valuesTableView);
 	//_curvesTableView = new ...
 	//curvesView_gridLayout->addWidget();
@@ -48,6 +52,12 @@ CUcontent_MBsSWs::CUcontent_MBsSWs(MBSWsettings_dt settings, QWidget *parent) :
 	startstopmbreading_pushButton->setEnabled( false );
 	mbswadd_pushButton->setEnabled( false );
 	mbswdelete_pushButton->setEnabled( false );
+	mbswrecord_pushButton->setEnabled( false );
+	mbswtrigger_pushButton->setEnabled( false );
+	mbswDTCs_pushButton->setEnabled( false );
+	mbswreplay_pushButton->setEnabled( false );
+	mbswstats_pushButton->setEnabled( false );
+	replayPosition_horizontalSlider->hide();
 	MBSWviews_tabWidget->setTabEnabled(1, false);
 	_valuesTableView->setEnabled(false);
 	// Set content of time refresh-time labels:
@@ -65,6 +75,12 @@ CUcontent_MBsSWs::CUcontent_MBsSWs(MBSWsettings_dt settings, QWidget *parent) :
 	connect( _valuesTableView , SIGNAL( resetMinMaxButton_pressed() ), this, SLOT( resetMinMaxTableValues() ) );
 	connect( _valuesTableView , SIGNAL( itemSelectionChanged() ), this, SLOT( setDeleteButtonEnabledState() ) );
 	connect( _timemode_pushButton , SIGNAL( released() ), this, SLOT( switchTimeMode() ) );
+	connect( mbswrecord_pushButton , SIGNAL( released() ), this, SLOT( recordMBsSWsButtonPressed() ) );
+	connect( mbswtrigger_pushButton , SIGNAL( released() ), this, SLOT( triggerMBsSWsButtonPressed() ) );
+	connect( mbswDTCs_pushButton , SIGNAL( released() ), this, SLOT( watchDTCsButtonPressed() ) );
+	connect( mbswreplay_pushButton , SIGNAL( released() ), this, SLOT( replayMBsSWsButtonPressed() ) );
+	connect( mbswstats_pushButton , SIGNAL( released() ), this, SLOT( showStatistics() ) );
+	connect( replayPosition_horizontalSlider , SIGNAL( sliderReleased() ), this, SLOT( seekReplayPosition() ) );
 	// NOTE: using released() instead of pressed() as workaround for a Qt-Bug occuring under MS Windows
 }
 
@@ -74,9 +90,12 @@ CUcontent_MBsSWs::~CUcontent_MBsSWs()
 	if (_SSMPdev)
 	{
 		_SSMPdev->stopMBSWreading();
-		disconnect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), this, SLOT( processMBSWRawValues(std::vector<unsigned int>, int) ) );
+		disconnect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), _MBSWdecoder, SLOT( addRawValues(std::vector<unsigned int>, int) ) );
 		disconnect( _SSMPdev , SIGNAL( stoppedMBSWreading() ), this, SLOT( callStop() ) );
 		disconnect( _SSMPdev , SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
+		disconnect( _SSMPdev, SIGNAL( MBSWreplayPosition(unsigned int) ), this, SLOT( updateReplayPosition(unsigned int) ) );
+		disconnect( _SSMPdev, SIGNAL( currentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ), this, SLOT( updateWatchedDTCs(QStringList, QStringList, bool, bool) ) );
+		disconnect( _SSMPdev, SIGNAL( capturedDTCsnapshot(QString) ), this, SLOT( saveDTCsnapshot(QString) ) );
 	}
 	disconnect( startstopmbreading_pushButton , SIGNAL( released() ), this, SLOT( startstopMBsSWsButtonPressed() ) ); 
 	disconnect( mbswadd_pushButton , SIGNAL( released() ), this, SLOT( addMBsSWs() ) );
@@ -86,9 +105,18 @@ CUcontent_MBsSWs::~CUcontent_MBsSWs()
 	disconnect( _valuesTableView , SIGNAL( resetMinMaxButton_pressed() ), this, SLOT( resetMinMaxTableValues() ) );
 	disconnect( _valuesTableView , SIGNAL( itemSelectionChanged() ), this, SLOT( setDeleteButtonEnabledState() ) );
 	disconnect( _timemode_pushButton , SIGNAL(released() ), this, SLOT( switchTimeMode() ) );
+	disconnect( mbswrecord_pushButton , SIGNAL( released() ), this, SLOT( recordMBsSWsButtonPressed() ) );
+	disconnect( mbswtrigger_pushButton , SIGNAL( released() ), this, SLOT( triggerMBsSWsButtonPressed() ) );
+	disconnect( mbswDTCs_pushButton , SIGNAL( released() ), this, SLOT( watchDTCsButtonPressed() ) );
+	disconnect( mbswreplay_pushButton , SIGNAL( released() ), this, SLOT( replayMBsSWsButtonPressed() ) );
+	disconnect( mbswstats_pushButton , SIGNAL( released() ), this, SLOT( showStatistics() ) );
+	disconnect( replayPosition_horizontalSlider , SIGNAL( sliderReleased() ), this, SLOT( seekReplayPosition() ) );
 	delete _MBSWrefreshTimeTitle_label;
 	delete _MBSWrefreshTimeValue_label;
 	delete _timemode_pushButton;
+	disconnect( _MBSWdecoder, SIGNAL( newValuesAvailable() ), this, SLOT( processMBSWvalues() ) );
+	_MBSWdecoder->stopDecoding();
+	delete _MBSWdecoder;
 	delete _valuesTableView;
 }
 
@@ -109,10 +137,15 @@ bool CUcontent_MBsSWs::setup(SSMprotocol *SSMPdev)
 		_supportedMBs.clear();
 		_supportedSWs.clear();
 	}
+	// Derived MBs (calculated from the supported MBs):
+	_nrOfCUMBs = _supportedMBs.size();
+	_derivedMBs.clear();
+	if (ok)
+		loadDerivedMBs();
 	_MBSWmetaList.clear();
 	_tableRowPosIndexes.clear();
 	_lastValues.clear();
-	_minmaxData.clear();
+	_replayActive = false;
 	// Reset refresh time:
 	_lastrefreshduration_ms = 0;
 	_MBSWrefreshTimeValue_label->setText("---      ");
@@ -134,6 +167,16 @@ bool CUcontent_MBsSWs::setup(SSMprotocol *SSMPdev)
 	setDeleteButtonEnabledState();
 	// Disable "Start"-button:
 	startstopmbreading_pushButton->setEnabled(false);
+	// Record/replay buttons:
+	mbswrecord_pushButton->setEnabled(false);
+	mbswtrigger_pushButton->setEnabled(false);
+	mbswreplay_pushButton->setEnabled( ok );
+	mbswstats_pushButton->setEnabled( ok );
+	// Combined DC reading (SSM2 only):
+	mbswDTCs_pushButton->setText(tr("DTCs"));
+	mbswDTCs_pushButton->setToolTip(tr("Watch trouble codes while reading"));
+	mbswDTCs_pushButton->setChecked( ok && _SSMPdev->combinedDCgroups() );
+	mbswDTCs_pushButton->setEnabled( ok && (_SSMPdev->protocolType() == SSMprotocol::SSM2) );
 	// Return result:
 	return ok;
 }
@@ -163,7 +206,6 @@ bool CUcontent_MBsSWs::setMBSWselection(std::vector<MBSWmetadata_dt> MBSWmetaLis
 	_MBSWmetaList = MBSWmetaList;
 	// Clear last values:
 	_lastValues.clear();
-	_minmaxData.clear();
 	// Setup table position indexes:	
 	for (k=0; k<MBSWmetaList.size(); k++)
 		_tableRowPosIndexes.push_back(k);
@@ -200,22 +242,20 @@ void CUcontent_MBsSWs::getMBSWselection(std::vector<MBSWmetadata_dt> *MBSWmetaLi
 void CUcontent_MBsSWs::displayMBsSWs()
 {
 	QStringList titles;
-	QStringList minvalues;
-	QStringList values;
-	QStringList maxvalues;
-	QStringList units;
+	std::vector<MBSWscaling_dt> scalings;
+	std::vector<MBSWscaling_dt> orderedScalings;
+	std::vector<MBSWvalue_dt> orderedValues;
 	unsigned int k=0;
 	unsigned int listPosIndex = 0;
-	// Prepare string-lists (fill with empty strings up to needed size):
+	// Prepare lists (fill with empty elements up to needed size):
 	for (int s=0; s<_tableRowPosIndexes.size(); s++)
-	{
 		titles << "";
-		minvalues << "";
-		values << "";
-		maxvalues << "";
-		units << "";
-	}
-	// Fill string-lists for output:
+	getMBSWscalings(&scalings);
+	orderedScalings.resize(scalings.size());
+	// NOTE: _lastValues can be empty !
+	if (_lastValues.size() == _MBSWmetaList.size())
+		orderedValues.resize(_lastValues.size());
+	// Fill lists for output:
 	for (k=0; k<_MBSWmetaList.size(); k++)
 	{
 		// Get MB/SW-index:
@@ -225,40 +265,184 @@ void CUcontent_MBsSWs::displayMBsSWs()
 			titles.replace( listPosIndex, _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex).title );
 		else	// SW
 			titles.replace( listPosIndex, _supportedSWs.at(_MBSWmetaList.at(k).nativeIndex).title );
-		// Value and unit strings:
-		// NOTE: _lastValues can be empty !
-		if (static_cast<unsigned int>(_lastValues.size()) > k)
+		// Scaling (value formatting and units):
+		orderedScalings.at(listPosIndex) = scalings.at(k);
+		// Last value and min/max values:
+		if (orderedValues.size())
+			orderedValues.at(listPosIndex) = _lastValues.at(k);
+	}
+	// Display MBs/SWs
+	_valuesTableView->setMBSWlistContent(titles, orderedScalings, orderedValues);
+}
+
+
+void CUcontent_MBsSWs::getMBSWscalings(std::vector<MBSWscaling_dt> *scalings)
+{
+	scalings->resize(_MBSWmetaList.size());
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if ((_MBSWmetaList.at(k).blockType == 0) && (_MBSWmetaList.at(k).nativeIndex >= _nrOfCUMBs))	// derived MB
+			scalings->at(k).setupDerived( _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex) );
+		else if (_MBSWmetaList.at(k).blockType == 0)	// MB
+			scalings->at(k).setup( _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex) );
+		else	// SW
+			scalings->at(k).setup( _supportedSWs.at(_MBSWmetaList.at(k).nativeIndex) );
+	}
+}
+
+
+void CUcontent_MBsSWs::loadDerivedMBs()
+{
+	QFile file(QDir::homePath() + "/" + DERIVED_MBS_FILENAME);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+	while (!file.atEnd())
+	{
+		// Line format: title;unit;precision;expression (e.g. "Boost;bar;2;{Manifold Relative Pressure}/1000")
+		QString line = QString::fromUtf8(file.readLine()).trimmed();
+		if (line.isEmpty() || line.startsWith('#') || (line.count(';') < 3))
+			continue;
+		addDerivedMB(line.section(';', 0, 0).trimmed(), line.section(';', 1, 1).trimmed(),
+			     line.section(';', 2, 2).trimmed().toInt(), line.section(';', 3).trimmed());
+	}
+	file.close();
+	/* NOTE: derived MBs referring to MBs which are not supported by the control unit are ignored */
+}
+
+
+int CUcontent_MBsSWs::addDerivedMB(QString title, QString unit, char precision, QString expression)
+{
+	MBSWderivedMB_dt derivedMB;
+	QStringList MBtitles;
+	// Check if the derived MB is already available:
+	for (unsigned int k=0; k<_derivedMBs.size(); k++)
+	{
+		if ((_derivedMBs.at(k).title == title) && (_derivedMBs.at(k).expression == expression))
+			return k;
+	}
+	// Compile expression (the variables refer to the MBs of the control unit):
+	for (unsigned int k=0; k<_nrOfCUMBs; k++)
+		MBtitles << _supportedMBs.at(k).title;
+	if (title.isEmpty() || !derivedMB.program.compile(expression, MBtitles))
+		return -1;
+	derivedMB.title = title;
+	derivedMB.unit = unit;
+	derivedMB.precision = precision;
+	derivedMB.expression = expression;
+	_derivedMBs.push_back(derivedMB);
+	// Make it selectable like the other MBs:
+	_supportedMBs.push_back(derivedMB);
+	return (_derivedMBs.size() - 1);
+}
+
+
+void CUcontent_MBsSWs::getMBSWreadingSetup(std::vector<MBSWmetadata_dt> *readMBSWmetaList, std::vector<MBSWscaling_dt> *scalings,
+					   std::vector<MBSWderivedChannel_dt> *derivedChannels, std::vector<unsigned int> *outputChannels)
+{
+	unsigned int k = 0;
+	unsigned int readIndex = 0;
+	unsigned int derivedIndex = 0;
+	readMBSWmetaList->clear();
+	scalings->clear();
+	derivedChannels->clear();
+	outputChannels->clear();
+	// Measured MBs/SWs:
+	for (k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if ((_MBSWmetaList.at(k).blockType == 0) && (_MBSWmetaList.at(k).nativeIndex >= _nrOfCUMBs))
+			continue;
+		readMBSWmetaList->push_back( _MBSWmetaList.at(k) );
+	}
+	// Derived MBs (MBs they refer to are read additionally, if they are not selected):
+	for (k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if ((_MBSWmetaList.at(k).blockType != 0) || (_MBSWmetaList.at(k).nativeIndex < _nrOfCUMBs))
+			continue;
+		const MBSWderivedMB_dt & derivedMB = _derivedMBs.at(_MBSWmetaList.at(k).nativeIndex - _nrOfCUMBs);
+		MBSWderivedChannel_dt channel;
+		channel.scaling.setupDerived(derivedMB);
+		channel.expression = derivedMB.program;
+		std::vector<unsigned int> variables = derivedMB.program.variables();
+		for (unsigned int v=0; v<variables.size(); v++)
 		{
-			if (_lastValues.at(k).scaledStr.isEmpty())
-				values.replace( listPosIndex, QString::number(_lastValues.at(k).rawValue) );
-			else
-				values.replace( listPosIndex, _lastValues.at(k).scaledStr );
-			units.replace( listPosIndex, _lastValues.at(k).unitStr );
+			unsigned int r = 0;
+			for (r=0; r<readMBSWmetaList->size(); r++)
+			{
+				if ((readMBSWmetaList->at(r).blockType == 0) && (readMBSWmetaList->at(r).nativeIndex == variables.at(v)))
+					break;
+			}
+			if (r == readMBSWmetaList->size())
+			{
+				MBSWmetadata_dt metadata;
+				metadata.blockType = 0;
+				metadata.nativeIndex = variables.at(v);
+				readMBSWmetaList->push_back( metadata );
+			}
+			channel.inputs.push_back(r);
 		}
+		derivedChannels->push_back(channel);
+	}
+	// Scalings of the read MBs/SWs:
+	scalings->resize(readMBSWmetaList->size());
+	for (k=0; k<readMBSWmetaList->size(); k++)
+	{
+		if (readMBSWmetaList->at(k).blockType == 0)	// MB
+			scalings->at(k).setup( _supportedMBs.at(readMBSWmetaList->at(k).nativeIndex) );
+		else	// SW
+			scalings->at(k).setup( _supportedSWs.at(readMBSWmetaList->at(k).nativeIndex) );
+	}
+	// Decoder channels in the order of the selected MBs/SWs:
+	for (k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if ((_MBSWmetaList.at(k).blockType == 0) && (_MBSWmetaList.at(k).nativeIndex >= _nrOfCUMBs))
+			outputChannels->push_back(readMBSWmetaList->size() + derivedIndex++);
 		else
+			outputChannels->push_back(readIndex++);
+	}
+}
+
+
+std::vector<MBSWlogChannel_dt> CUcontent_MBsSWs::derivedMBlogChannels()
+{
+	std::vector<MBSWlogChannel_dt> channels;
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if ((_MBSWmetaList.at(k).blockType != 0) || (_MBSWmetaList.at(k).nativeIndex < _nrOfCUMBs))
+			continue;
+		const MBSWderivedMB_dt & derivedMB = _derivedMBs.at(_MBSWmetaList.at(k).nativeIndex - _nrOfCUMBs);
+		MBSWlogChannel_dt channel;
+		channel.blockType = 0;
+		channel.precision = derivedMB.precision;
+		channel.addrLow = MEMORY_ADDRESS_NONE;	// not read from the control unit
+		channel.addrHigh = MEMORY_ADDRESS_NONE;
+		channel.title = derivedMB.title;
+		channel.unit = derivedMB.unit;
+		channel.scaleformula = derivedMB.expression;
+		channels.push_back(channel);
+	}
+	return channels;
+}
+
+
+std::vector<MBSWlogChannel_dt> CUcontent_MBsSWs::selectedMBSWlogChannels()
+{
+	// NOTE: only title, unit and type (order of the decoder output channels)
+	std::vector<MBSWlogChannel_dt> channels(_MBSWmetaList.size());
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+	{
+		channels.at(k).blockType = _MBSWmetaList.at(k).blockType;
+		if (_MBSWmetaList.at(k).blockType == 0)	// MB
 		{
-			if (_MBSWmetaList.at(k).blockType == 0)	// MB
-				units.replace( listPosIndex, _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex).unit );
+			channels.at(k).title = _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex).title;
+			channels.at(k).unit = _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex).unit;
 		}
-		// Last min/max value strings:
-		// NOTE: _minmaxData can be empty !
-		if (static_cast<unsigned int>(_minmaxData.size()) > k)
+		else	// SW
 		{
-			if (!_minmaxData.at(k).disabled)
-			{
-				if (_minmaxData.at(k).minScaledValueStr.isEmpty())
-					minvalues.replace( listPosIndex, QString::number(_minmaxData.at(k).minRawValue) );
-				else
-					minvalues.replace( listPosIndex, _minmaxData.at(k).minScaledValueStr );
-				if (_minmaxData.at(k).maxScaledValueStr.isEmpty())
-					maxvalues.replace( listPosIndex, QString::number(_minmaxData.at(k).maxRawValue) );
-				else
-					maxvalues.replace( listPosIndex, _minmaxData.at(k).maxScaledValueStr );
-			}
+			channels.at(k).title = _supportedSWs.at(_MBSWmetaList.at(k).nativeIndex).title;
+			channels.at(k).unit = _supportedSWs.at(_MBSWmetaList.at(k).nativeIndex).unit;
 		}
 	}
-	// Display MBs/SWs
-	_valuesTableView->setMBSWlistContent(titles, values, minvalues, maxvalues, units);
+	return channels;
 }
 
 
@@ -289,9 +473,15 @@ bool CUcontent_MBsSWs::startMBSWreading()
 {
 	SSMprotocol::state_dt state = SSMprotocol::state_needSetup;
 	std::vector<MBSWmetadata_dt> usedMBSWmetaList;
+	std::vector<MBSWmetadata_dt> readMBSWmetaList;
+	std::vector<MBSWscaling_dt> scalings;
+	std::vector<MBSWderivedChannel_dt> derivedChannels;
+	std::vector<unsigned int> outputChannels;
 	unsigned int k = 0;
 	bool consistent = true;
 	if (!_SSMPdev) return false;
+	// Get MBs/SWs to read (including MBs needed for derived MBs):
+	getMBSWreadingSetup(&readMBSWmetaList, &scalings, &derivedChannels, &outputChannels);
 	// Check premises:
 	state = _SSMPdev->state();
 	if (state == SSMprotocol::state_normal)
@@ -299,7 +489,7 @@ bool CUcontent_MBsSWs::startMBSWreading()
 		if (_MBSWmetaList.empty()) return false;
 		disconnect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
 		// Start MB/SW-reading:
-		if (!_SSMPdev->startMBSWreading(_MBSWmetaList))
+		if (!_SSMPdev->startMBSWreading(readMBSWmetaList))
 		{
 			connect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
 			return false;
@@ -310,17 +500,19 @@ bool CUcontent_MBsSWs::startMBSWreading()
 		// Verify consistency:
 		if (!_SSMPdev->getLastMBSWselection(&usedMBSWmetaList))
 			return false;
-		if (_MBSWmetaList.size() == usedMBSWmetaList.size())
+		if (readMBSWmetaList.size() == usedMBSWmetaList.size())
 		{
-			for (k=0; k<_MBSWmetaList.size(); k++)
+			for (k=0; k<readMBSWmetaList.size(); k++)
 			{
-				if ((_MBSWmetaList.at(k).blockType != usedMBSWmetaList.at(k).blockType) || (_MBSWmetaList.at(k).nativeIndex != usedMBSWmetaList.at(k).nativeIndex))
+				if ((readMBSWmetaList.at(k).blockType != usedMBSWmetaList.at(k).blockType) || (readMBSWmetaList.at(k).nativeIndex != usedMBSWmetaList.at(k).nativeIndex))
 				{
 					consistent = false;
 					break;
 				}
 			}
 		}
+		else
+			consistent = false;
 		if (!consistent)	// inconsistency detected !
 		{
 			// Stop MBSW-reading:
@@ -332,17 +524,45 @@ bool CUcontent_MBsSWs::startMBSWreading()
 		return false;
 	// Reset old data:
 	_lastValues.clear();
-	_minmaxData.clear();
 	// Clear values in MB/SW-table:
 	displayMBsSWs();
 	// Clear refresh-time-information:
 	_MBSWrefreshTimeValue_label->setText("---      ");
+	// Setup and start decoding of the raw values:
+	_MBSWdecoder->stopDecoding();
+	_MBSWdecoder->setup(scalings, derivedChannels, outputChannels);
+	// Export the latest values of the selected MBs/SWs to shared memory:
+	MBSWsharedMemoryExport *shmExport = MBSWsharedMemoryExport::instance();
+	if ((shmExport != NULL) && shmExport->setChannels(selectedMBSWlogChannels()))
+		_MBSWdecoder->setSharedMemoryExport(shmExport);
+	else
+		_MBSWdecoder->setSharedMemoryExport(NULL);
+	// Publish the decoded values of the selected MBs/SWs (including derived MBs) on the telemetry server:
+	MBSWtelemetryServer *telemetryServer = MBSWtelemetryServer::instance();
+	if (telemetryServer != NULL)
+		telemetryServer->setChannels(selectedMBSWlogChannels());
+	_MBSWdecoder->setTelemetryServer(telemetryServer);
+	_MBSWdecoder->startDecoding();
 	// Connect signals and slots:
-	connect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), this, SLOT( processMBSWRawValues(std::vector<unsigned int>, int) ) );
+	connect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), _MBSWdecoder, SLOT( addRawValues(std::vector<unsigned int>, int) ), Qt::DirectConnection );
+	connect( _MBSWdecoder, SIGNAL( newValuesAvailable() ), this, SLOT( processMBSWvalues() ) );
+	/* NOTE: addRawValues() only queues the raw values, scaling and min/max determination is done in the decoder thread */
 	connect( _SSMPdev , SIGNAL( stoppedMBSWreading() ), this, SLOT( callStop() ) );
 	// Disable add/delete buttons:
 	mbswdelete_pushButton->setEnabled(false);
 	mbswadd_pushButton->setEnabled(false);
+	// Record/replay buttons:
+	mbswrecord_pushButton->setChecked( _SSMPdev->isRecordingMBSWs() );
+	mbswrecord_pushButton->setEnabled(true);
+	mbswtrigger_pushButton->setChecked( _SSMPdev->isTriggerLoggingMBSWs() );
+	mbswtrigger_pushButton->setEnabled(true);
+	mbswreplay_pushButton->setEnabled(false);
+	mbswDTCs_pushButton->setEnabled(false);	// NOTE: changes take effect with the next start of MB/SW-reading only
+	if (_SSMPdev->combinedDCgroups() && !_SSMPdev->isReplayingMBSWs())
+	{
+		connect( _SSMPdev, SIGNAL( currentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ), this, SLOT( updateWatchedDTCs(QStringList, QStringList, bool, bool) ) );
+		connect( _SSMPdev, SIGNAL( capturedDTCsnapshot(QString) ), this, SLOT( saveDTCsnapshot(QString) ) );
+	}
 	// Set text+icon of start/stop-button:
 	startstopmbreading_pushButton->setText(tr(" Stop  "));
 	QIcon startstopmbreadingicon(QString::fromUtf8(":/icons/chrystal/32x32/player_stop.png"));
@@ -363,9 +583,33 @@ bool CUcontent_MBsSWs::stopMBSWreading()
 			connect( _SSMPdev , SIGNAL( stoppedMBSWreading() ), this, SLOT( callStop() ) ); // must be disconnected before stopMBSWreading is called
 			return false;
 		}
-		disconnect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), this, SLOT( processMBSWRawValues(std::vector<unsigned int>, int) ) );
+		disconnect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ), _MBSWdecoder, SLOT( addRawValues(std::vector<unsigned int>, int) ) );
+		disconnect( _SSMPdev, SIGNAL( MBSWreplayPosition(unsigned int) ), this, SLOT( updateReplayPosition(unsigned int) ) );
+		disconnect( _SSMPdev, SIGNAL( currentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ), this, SLOT( updateWatchedDTCs(QStringList, QStringList, bool, bool) ) );
+		disconnect( _SSMPdev, SIGNAL( capturedDTCsnapshot(QString) ), this, SLOT( saveDTCsnapshot(QString) ) );
 		connect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
 	}
+	// Stop decoding and display the last values:
+	if (_MBSWdecoder->isRunning())
+	{
+		_MBSWdecoder->stopDecoding();
+		_MBSWdecoder->setSharedMemoryExport(NULL);
+		_MBSWdecoder->setTelemetryServer(NULL);
+		processMBSWvalues();
+	}
+	disconnect( _MBSWdecoder, SIGNAL( newValuesAvailable() ), this, SLOT( processMBSWvalues() ) );
+	if (_replayActive)
+		restorePreReplaySelection();
+	// Record/replay elements:
+	mbswrecord_pushButton->setChecked(false);
+	mbswrecord_pushButton->setEnabled(false);
+	mbswtrigger_pushButton->setChecked(false);
+	mbswtrigger_pushButton->setEnabled(false);
+	mbswreplay_pushButton->setEnabled(_SSMPdev != NULL);
+	mbswDTCs_pushButton->setEnabled(_SSMPdev && (_SSMPdev->protocolType() == SSMprotocol::SSM2));
+	mbswDTCs_pushButton->setText(tr("DTCs"));
+	mbswDTCs_pushButton->setToolTip(tr("Watch trouble codes while reading"));
+	replayPosition_horizontalSlider->hide();
 	// Set text+icon of start/stop-button:
 	startstopmbreading_pushButton->setText(tr(" Start  "));
 	QIcon startstopmbreadingicon(QString::fromUtf8(":/icons/chrystal/32x32/player_play.png"));
@@ -380,298 +624,19 @@ bool CUcontent_MBsSWs::stopMBSWreading()
 }
 
 
-void CUcontent_MBsSWs::processMBSWRawValues(std::vector<unsigned int> rawValues, int refreshduration_ms)
+void CUcontent_MBsSWs::processMBSWvalues()
 {
-	QString defstr;
-	QString rvstr;
-	bool scalingSuccessful = false;
-	QString scaledValueStr;
-	unsigned int k = 0;
-	// Min/Max comparison:
-	bool invSWmeaning = false;
-	bool noLastMinMaxValue = false;
-	bool isCurrentValueNumeric = false;
-	bool isLastMinValueNumeric = false;
-	bool isLastMaxValueNumeric = false;
-	double currentScaledValueNumeric = 0;
-	double lastMinScaledValueNumeric = 0;
-	double lastMaxScaledValueNumeric = 0;
-	double currentMinCompValue = 0;
-	double currentMaxCompValue = 0;
-	double lastMinCompValue = 0;
-	double lastMaxCompValue = 0;
-	bool newMin = false;
-	bool newMax = false;
-	// List output
-	unsigned int tablePosIndex = 0;
-	QStringList minValueStrList;
-	QStringList valueStrList;
-	QStringList maxValueStrList;
-	QStringList unitStrList;
-
-	// Prepare string-lists for vlaues-table-output (fill with empty strings up to the needed size):
-	for (unsigned int s=0; s<rawValues.size(); s++)
-	{
-		minValueStrList << "";
-		valueStrList << "";
-		maxValueStrList << "";
-		unitStrList << "";
-	}
-	// Process raw values
-	for (k=0; k<_MBSWmetaList.size(); k++)	// MB/SW LOOP
-	{
-		// Get table-position-index for current MB/SW:
-		tablePosIndex = _tableRowPosIndexes.at(k);
-		// ******** SCALE MB/SW ********:
-		// Scale raw values:
-		if (_MBSWmetaList.at(k).blockType == 0) // if it is a MB
-		{
-			scalingSuccessful = libFSSM::raw2scaled( rawValues.at(k), _supportedMBs.at( _MBSWmetaList.at(k).nativeIndex ).scaleformula, _supportedMBs.at( _MBSWmetaList.at(k).nativeIndex ).precision, &scaledValueStr);
-			if (scalingSuccessful)
-				unitStrList.replace(tablePosIndex, _supportedMBs.at( _MBSWmetaList.at(k).nativeIndex ).unit);
-			else
-				unitStrList.replace(tablePosIndex, "[RAW]");
-		}
-		else	// it is a SW
-		{
-			/* NOTE: Some switches have an inverse meaning ! (e.g. 0="High", 1="Low")
-			 *       => the characters / and \ tell us which of them has to be interpreted as the lower/larger one
-			 *          during the min/max value determination (can't use < > in XML-files):
-			 *             a/b   => a smaller than b
-			 *             a\b   => a larger than b
-			 * THE MEANING DOES NOT AFFECT THE SCALING PROCESS !
-			 */ 
-			if (rawValues.at(k) == 0)
-			{
-				if (_supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.contains('/'))
-				{
-					scaledValueStr = _supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.section('/',0,0);
-					invSWmeaning = false;
-				}
-				else if (_supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.contains('\\'))
-				{
-					scaledValueStr = _supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.section('\\',0,0);
-					invSWmeaning = true;
-				}
-				else
-				{
-					scaledValueStr.clear();
-					invSWmeaning = false;
-				}
-				scalingSuccessful = !scaledValueStr.isEmpty();
-			}
-			else if (rawValues.at(k) == 1)
-			{
-				if (_supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.contains('/'))
-				{
-					scaledValueStr = _supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.section('/',1,1);
-					invSWmeaning = false;
-				}
-				else if (_supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.contains('\\'))
-				{
-					scaledValueStr = _supportedSWs.at( _MBSWmetaList.at(k).nativeIndex ).unit.section('\\',1,1);
-					invSWmeaning = true;
-				}
-				else
-				{
-					scaledValueStr.clear();
-					invSWmeaning = false;
-				}
-				scalingSuccessful = !scaledValueStr.isEmpty();
-			}
-			else
-			{
-				/* NOTE:
-				 * THIS MEANS THAT WE HAVE A SEVERE BUG IN SSMprotocol::assignMBSWRawData(...) !
-				 * => handling this theoretical case would be too complicated...
-				 *    => display the raw value (although it is definitely wrong)
-				 *       => in combination with the display unit [BIN], the user should notice
-                                 *          that something is going wrong...
-				 */
-				scalingSuccessful = false;
-				scaledValueStr = "";
-			}
-			// Add unit string to the output list:
-			if (!scalingSuccessful/*((rawValues.at(rvIndex)==0) || (rawValues.at(rvIndex) == 1)) && scaledValueStr.isEmpty()*/) // if we have a valid raw value but scaling failed
-				unitStrList.replace(tablePosIndex, "[BIN]"); // display a unit, to signal that the displayed value is unscaled 
-			else
-				unitStrList.replace(tablePosIndex, "");
-		}
-		// Add value string to the output list:
-		if (scalingSuccessful)
-			valueStrList.replace( tablePosIndex, scaledValueStr );
-		else
-			valueStrList.replace( tablePosIndex, QString::number( rawValues.at(k) ) );
-		// ******** CHECK FOR NEW MIN/MAX VALUE ********:
-		/* NOTE:   
-		 * - MB/SW scaled values can be NUMERIC VALUES or STRINGS or even BOTH MIXED (for different raw values)
-		 * - scaled numeric values DO NOT necessarily grow with increasing raw values
-		 * => STRATEGY:
-		 * - compare scaled values only if min/max AND current values both have numeric scaled values
-		 * - compare raw values in any other case (even if one of the scaled values is numeric !)
-		 */
-		// Check if we already have min+max values, try to convert last min/max values and current value to (scaled) numeric values:
-		isLastMinValueNumeric = false;
-		isLastMaxValueNumeric = false;
-		if (k >= static_cast<unsigned int>(_minmaxData.size()))	// if no last min/max values available
-			noLastMinMaxValue = true;
-		else
-		{
-			noLastMinMaxValue = false;
-			if (scalingSuccessful && !_minmaxData.at(k).disabled) // NOTE: otherwise values aren't used
-			{
-				lastMinScaledValueNumeric = _minmaxData.at(k).minScaledValueStr.toDouble(&isLastMinValueNumeric);
-				lastMaxScaledValueNumeric = _minmaxData.at(k).maxScaledValueStr.toDouble(&isLastMaxValueNumeric);
-			}
-		}
-		if (isLastMinValueNumeric || isLastMaxValueNumeric || noLastMinMaxValue)
-			currentScaledValueNumeric = valueStrList.at(tablePosIndex).toDouble(&isCurrentValueNumeric);
-		// Disable min/max values for this MB/SW, if scaling failed and if we already have scaled min/max values:
-		if (!noLastMinMaxValue && !_minmaxData.at(k).disabled)
-		{
-			if ( (!scalingSuccessful && (!_minmaxData.at(k).minScaledValueStr.isEmpty() || !_minmaxData.at(k).maxScaledValueStr.isEmpty())) ||
-			     (scalingSuccessful && (_minmaxData.at(k).minScaledValueStr.isEmpty() || _minmaxData.at(k).maxScaledValueStr.isEmpty())) )
-			{
-				_minmaxData[k].disabled = true;
-				_minmaxData[k].minScaledValueStr = "";	// important !
-				_minmaxData[k].maxScaledValueStr = "";	// important !
-				/* NOTE:
-				* - do not generally disable min/max values, if scaling failed. Pure raw value MBs/SWs
-				*   (without any scaling information) should be allowed
-				* - maybe we can improve the min/max determination for MBs/SWs which are partially unscalable
-				*   (does it make sense to switch betweend scaled and unscaled min/max values ???)
-				*/
-			}
-		}
-		// Update/get new min/max values:
-		if (noLastMinMaxValue || !_minmaxData.at(k).disabled) // if we don't have min/max-values yet or min/max values are not disabled
-		{
-			if (noLastMinMaxValue)
-			{
-				// Set min and max value to current value:
-				MinMaxMBSWvalue_dt newMinMaxDataset;
-				newMinMaxDataset.minRawValue = rawValues.at(k);
-				newMinMaxDataset.maxRawValue = rawValues.at(k);
-				if (scalingSuccessful)
-				{
-					newMinMaxDataset.minScaledValueStr = valueStrList.at(tablePosIndex);
-					newMinMaxDataset.maxScaledValueStr = valueStrList.at(tablePosIndex);
-				}
-				else
-				{
-					newMinMaxDataset.minScaledValueStr = "";
-					newMinMaxDataset.maxScaledValueStr = "";
-				}
-				_minmaxData.append( newMinMaxDataset );
-			}
-			else
-			{
-				// Determine values for min comparison:
-				if (scalingSuccessful && isCurrentValueNumeric && isLastMinValueNumeric)
-				{
-					// Use scaled values for min comparison:
-					currentMinCompValue = currentScaledValueNumeric;
-					lastMinCompValue = lastMinScaledValueNumeric;
-				}
-				else
-				{
-					// Use raw values for min comparison:
-					currentMinCompValue = rawValues.at(k);
-					lastMinCompValue = _minmaxData.at(k).minRawValue;
-				}
-				// Determine values for max comparison:
-				if (scalingSuccessful && isCurrentValueNumeric && isLastMaxValueNumeric)
-				{
-					// Use scaled values for max comparison:
-					currentMaxCompValue = currentScaledValueNumeric;
-					lastMaxCompValue = lastMaxScaledValueNumeric;
-				}
-				else
-				{
-					// Use raw values for max comparison:
-					currentMaxCompValue = rawValues.at(k);
-					lastMaxCompValue = _minmaxData.at(k).maxRawValue;
-				}
-				/* NOTE: only compare scaled values, if BOTH (min/max and current) are numeric ! */
-				// Compare current value with last min/max values:
-				if ( (_MBSWmetaList.at(k).blockType == 1) && scalingSuccessful && invSWmeaning)
-				{
-					// Inverse comparison:
-					newMin = (currentMinCompValue > lastMinCompValue);
-					newMax = (currentMaxCompValue < lastMaxCompValue);
-				}
-				else
-				{
-					// Normal comparison
-					newMin = (currentMinCompValue < lastMinCompValue);
-					newMax = (currentMaxCompValue > lastMaxCompValue);
-				}
-				// Check if we have a new min value:
-				if (newMin)
-				{
-					_minmaxData[k].minRawValue = rawValues.at(k);
-					if (scalingSuccessful)
-						_minmaxData[k].minScaledValueStr = valueStrList.at(tablePosIndex);
-					else
-						_minmaxData[k].minScaledValueStr = "";
-				}
-				// Check if we have a new max value:
-				if (newMax)
-				{
-					_minmaxData[k].maxRawValue = rawValues.at(k);
-					if (scalingSuccessful)
-						_minmaxData[k].maxScaledValueStr = valueStrList.at(tablePosIndex);
-					else
-						_minmaxData[k].maxScaledValueStr = "";
-				}
-				/* NOTE: always save "real" values for SWs with inverse meaning ! */
-			}
-		}
-		// Add min/max strings to the output list:
-		if (_minmaxData.at(k).disabled)
-		{
-			// Don not display any min/values, if disabled:
-			minValueStrList.replace( tablePosIndex, "" );
-			maxValueStrList.replace( tablePosIndex, "" );
-		}
-		else if (_minmaxData.at(k).minScaledValueStr.isEmpty() || _minmaxData.at(k).maxScaledValueStr.isEmpty()) // if min/max is not disabled an we have unscaled min/max values
-		{
-			/* NOTE: min/max scaled value strings should BOTH be empty in this case
-			         (otherwise min/max would have been disabled before !) */
-			// Display raw min/max values:
-			minValueStrList.replace( tablePosIndex, QString::number(_minmaxData.at(k).minRawValue) );
-			maxValueStrList.replace( tablePosIndex, QString::number(_minmaxData.at(k).maxRawValue) );
-		}
-		else
-		{
-			// Display scaled min/max values:
-			minValueStrList.replace( tablePosIndex, _minmaxData.at(k).minScaledValueStr );
-			maxValueStrList.replace( tablePosIndex, _minmaxData.at(k).maxScaledValueStr );
-		}
-		// ******** Save current value data ********:
-		if (k >= static_cast<unsigned int>(_lastValues.size()))
-		{
-			MBSWvalue_dt newValueDataset;
-			newValueDataset.rawValue = rawValues.at(k);
-			if (scalingSuccessful)
-				newValueDataset.scaledStr = valueStrList.at(tablePosIndex);
-			else
-				newValueDataset.scaledStr = "";
-			newValueDataset.unitStr = unitStrList.at(tablePosIndex);
-			_lastValues.append( newValueDataset );
-		}
-		else
-		{
-			_lastValues[k].rawValue = rawValues.at(k);
-			if (scalingSuccessful)
-				_lastValues[k].scaledStr = valueStrList.at(tablePosIndex);
-			else
-				_lastValues[k].scaledStr = "";
-			_lastValues[k].unitStr = unitStrList.at(tablePosIndex);
-		}
-	}
+	std::vector<MBSWvalue_dt> values;
+	int refreshduration_ms = 0;
+	// Get the latest values from the decoder:
+	if (!_MBSWdecoder->values(&values, &refreshduration_ms))
+		return;
+	if (values.size() != _MBSWmetaList.size())
+		return;	// values of a previous MB/SW selection
+	_lastValues = values;
 	// Display new values:
-	_valuesTableView->updateMBSWvalues(valueStrList, minValueStrList, maxValueStrList, unitStrList);
+	for (unsigned int k=0; k<_lastValues.size(); k++)
+		_valuesTableView->updateMBSWvalue(_tableRowPosIndexes.at(k), _lastValues.at(k));
 	// Output refresh duration:
 	updateTimeInfo(refreshduration_ms);
 }
@@ -710,7 +675,6 @@ void CUcontent_MBsSWs::addMBsSWs()
 	{
 		// Clear current values:
 		_lastValues.clear();
-		_minmaxData.clear();
 		// Add new table-position-indexes:
 		for (k=MBSWmetaList_len_old; k<_MBSWmetaList.size(); k++)
 			_tableRowPosIndexes.append(k);
@@ -762,11 +726,9 @@ void CUcontent_MBsSWs::deleteMBsSWs()
 		{
 			// DELETE MB/SW FROM SELECTION LIST (METALIST):
 			_MBSWmetaList.erase(_MBSWmetaList.begin() + k);
-			// DELETE LAST VALUE, MIN-/MAX-DATA AND PLOT DATA:
+			// DELETE LAST VALUE (INCL. MIN-/MAX-DATA) AND PLOT DATA:
 			if (_lastValues.size())
-				_lastValues.removeAt(k);
-			if (_minmaxData.size())
-				_minmaxData.removeAt(k);
+				_lastValues.erase(_lastValues.begin() + k);
 			// DELETE TABLE POSITION INDEX:
 			_tableRowPosIndexes.erase(_tableRowPosIndexes.begin() + k);
 		}
@@ -869,29 +831,14 @@ void CUcontent_MBsSWs::moveDownMBsSWsOnTheTable()
 
 void CUcontent_MBsSWs::resetMinMaxTableValues()
 {
-	QStringList lastValueStr;
-	QStringList lastUnitStr;
-	MinMaxMBSWvalue_dt newMinMaxDataset;
-	// Delete min/max values:
-	_minmaxData.clear();
-	// Setup new min/max values and output data:
-	for (int k=0; k<_lastValues.size(); k++)
-	{
-		// Set min/max values to current value:
-		newMinMaxDataset.minRawValue = _lastValues.at(k).rawValue;
-		newMinMaxDataset.maxRawValue = _lastValues.at(k).rawValue;
-		newMinMaxDataset.minScaledValueStr = _lastValues.at(k).scaledStr;
-		newMinMaxDataset.maxScaledValueStr = _lastValues.at(k).scaledStr;
-		_minmaxData.append( newMinMaxDataset );
-		// Get min/max value string and unit for output:
-		if (_lastValues.at(k).scaledStr.isEmpty())
-			lastValueStr.append( QString::number(_lastValues.at(k).rawValue) );
-		else
-			lastValueStr.append( _lastValues.at(k).scaledStr );
-		lastUnitStr.append( _lastValues.at(k).unitStr );
+	// Reset min/max values of the decoder (continues with the current values):
+	_MBSWdecoder->resetMinMax();
+	// Set min/max values to the last values and display them:
+	for (unsigned int k=0; k<_lastValues.size(); k++)
+	{
+		_lastValues.at(k).resetMinMax();
+		_valuesTableView->updateMBSWvalue(_tableRowPosIndexes.at(k), _lastValues.at(k));
 	}
-	// Display last values as current/min/max values:
-	_valuesTableView->updateMBSWvalues(lastValueStr, lastValueStr, lastValueStr, lastUnitStr);
 }
 
 
@@ -933,11 +880,299 @@ void CUcontent_MBsSWs::switchTimeMode()
 }
 
 
+void CUcontent_MBsSWs::recordMBsSWsButtonPressed()
+{
+	if (!_SSMPdev) return;
+	if (_SSMPdev->isRecordingMBSWs())
+	{
+		_SSMPdev->stopMBSWrecording();
+		mbswrecord_pushButton->setChecked(false);
+		return;
+	}
+	mbswrecord_pushButton->setChecked(false);
+	if (_SSMPdev->state() != SSMprotocol::state_MBSWreading) return;
+	QString filename = QFileDialog::getSaveFileName(this, tr("Record Measuring Blocks"), QDir::homePath(), tr("FreeSSM MB/SW logs (*.fmbsw)"));
+	if (filename.isEmpty()) return;
+	if (!filename.endsWith(".fmbsw"))
+		filename += ".fmbsw";
+	if (_SSMPdev->startMBSWrecording(filename, derivedMBlogChannels()))
+		mbswrecord_pushButton->setChecked(true);
+	else
+	{
+		QMessageBox msg( QMessageBox::Critical, tr("Error"), tr("Couldn't create the log file !"), QMessageBox::Ok, this);
+		QFont msgfont = msg.font();
+		msgfont.setPixelSize(12); // 9pts
+		msg.setFont( msgfont );
+		msg.show();
+		msg.exec();
+		msg.close();
+	}
+}
+
+
+void CUcontent_MBsSWs::triggerMBsSWsButtonPressed()
+{
+	bool ok = false;
+	if (!_SSMPdev) return;
+	if (_SSMPdev->isTriggerLoggingMBSWs())
+	{
+		_SSMPdev->stopMBSWtriggerLogging();
+		mbswtrigger_pushButton->setChecked(false);
+		return;
+	}
+	mbswtrigger_pushButton->setChecked(false);
+	if (_SSMPdev->state() != SSMprotocol::state_MBSWreading) return;
+	// Get trigger conditions:
+	QString conditions = QInputDialog::getText(this, tr("Triggered Recording"),
+						   tr("Trigger conditions, separated by ';'\n(e.g. \"Engine Speed > 6000; Knock Correction < 0; Idle Switch toggles\"):"),
+						   QLineEdit::Normal, _lastTriggerConditions, &ok);
+	if (!ok || conditions.trimmed().isEmpty()) return;
+	_lastTriggerConditions = conditions;
+	int preTrigger_s = QInputDialog::getInteger(this, tr("Triggered Recording"), tr("Seconds to keep before the trigger:"), 10, 0, 600, 1, &ok);
+	if (!ok) return;
+	int postTrigger_s = QInputDialog::getInteger(this, tr("Triggered Recording"), tr("Seconds to record after the trigger:"), 5, 0, 600, 1, &ok);
+	if (!ok) return;
+	// Check if the frames of the pre- and post-trigger window can be kept in memory (at the current frame rate):
+	unsigned int maxWindow_s = MBSWtriggerLogger::maxWindowDuration_ms(_lastrefreshduration_ms) / 1000;
+	if (static_cast<unsigned int>(preTrigger_s + postTrigger_s) > maxWindow_s)
+	{
+		QMessageBox msg( QMessageBox::Critical, tr("Error"), tr("The pre- and post-trigger time must not exceed %1 seconds in total at the current data rate.").arg(maxWindow_s), QMessageBox::Ok, this);
+		QFont msgfont = msg.font();
+		msgfont.setPixelSize(12); // 9pts
+		msg.setFont( msgfont );
+		msg.show();
+		msg.exec();
+		msg.close();
+		return;
+	}
+	QString dirname = QFileDialog::getExistingDirectory(this, tr("Directory for triggered logs"), QDir::homePath());
+	if (dirname.isEmpty()) return;
+	// Start triggered recording:
+	QStringList expressions = conditions.split(';', QString::SkipEmptyParts);
+	if (_SSMPdev->startMBSWtriggerLogging(QDir(dirname).filePath("trigger_"), expressions, 1000*preTrigger_s, 1000*postTrigger_s, _lastrefreshduration_ms))
+		mbswtrigger_pushButton->setChecked(true);
+	else
+	{
+		QMessageBox msg( QMessageBox::Critical, tr("Error"), tr("Invalid trigger condition !\nThe conditions must refer to the titles of the selected Measuring Blocks or Switches."), QMessageBox::Ok, this);
+		QFont msgfont = msg.font();
+		msgfont.setPixelSize(12); // 9pts
+		msg.setFont( msgfont );
+		msg.show();
+		msg.exec();
+		msg.close();
+	}
+}
+
+
+void CUcontent_MBsSWs::watchDTCsButtonPressed()
+{
+	int DCgroups = SSMprotocol::noDCs_DCgroup;
+	if (!_SSMPdev) return;
+	if (mbswDTCs_pushButton->isChecked())
+	{
+		// Watch current/temporary DTCs:
+		if (_SSMPdev->getSupportedDCgroups(&DCgroups))
+			DCgroups &= (SSMprotocol::currentDTCs_DCgroup | SSMprotocol::temporaryDTCs_DCgroup);
+		if ((DCgroups == SSMprotocol::noDCs_DCgroup) || !_SSMPdev->setCombinedDCreading(DCgroups))
+			mbswDTCs_pushButton->setChecked(false);
+	}
+	else
+		_SSMPdev->setCombinedDCreading(SSMprotocol::noDCs_DCgroup);
+	mbswDTCs_pushButton->setText(tr("DTCs"));
+	mbswDTCs_pushButton->setToolTip(tr("Watch trouble codes while reading"));
+}
+
+
+void CUcontent_MBsSWs::updateWatchedDTCs(QStringList currentDTCs, QStringList currentDTCsDescriptions, bool testMode, bool DCheckActive)
+{
+	(void)testMode; // to avoid compiler error
+	(void)DCheckActive; // to avoid compiler error
+	QString tooltip;
+	for (int k=0; k<currentDTCs.size(); k++)
+	{
+		if (k > 0)
+			tooltip += "\n";
+		tooltip += currentDTCs.at(k) + ": " + currentDTCsDescriptions.at(k);
+	}
+	if (currentDTCs.size())
+		mbswDTCs_pushButton->setText(tr("DTCs: %1").arg(currentDTCs.size()));
+	else
+	{
+		mbswDTCs_pushButton->setText(tr("DTCs"));
+		tooltip = tr("No trouble codes");
+	}
+	mbswDTCs_pushButton->setToolTip(tooltip);
+}
+
+
+void CUcontent_MBsSWs::saveDTCsnapshot(QString DTC)
+{
+	std::vector<DTCsnapshot_dt> snapshots;
+	if (!_SSMPdev) return;
+	_SSMPdev->getDTCsnapshots(&snapshots);
+	if (snapshots.empty() || snapshots.back().frames.empty()) return;
+	QMessageBox msg( QMessageBox::Question, tr("New trouble code"), tr("Trouble code %1 has been detected at %2.\nDo you want to save the Measuring Blocks recorded before ?").arg(DTC).arg(snapshots.back().firstSeen.toString("hh:mm:ss")), QMessageBox::Yes | QMessageBox::No, this);
+	QFont msgfont = msg.font();
+	msgfont.setPixelSize(12); // 9pts
+	msg.setFont( msgfont );
+	msg.show();
+	int ret = msg.exec();
+	msg.close();
+	if (ret != QMessageBox::Yes) return;
+	QString filename = QFileDialog::getSaveFileName(this, tr("Save Measuring Blocks"), QDir::homePath(), tr("FreeSSM MB/SW logs (*.fmbsw)"));
+	if (filename.isEmpty()) return;
+	if (!filename.endsWith(".fmbsw"))
+		filename += ".fmbsw";
+	// NOTE: the snapshot list may have changed while the dialogs were open
+	_SSMPdev->getDTCsnapshots(&snapshots);
+	for (unsigned int k=snapshots.size(); k>0; k--)
+	{
+		if (snapshots.at(k-1).DTC == DTC)
+		{
+			_SSMPdev->saveDTCsnapshot(k-1, filename);
+			break;
+		}
+	}
+}
+
+
+void CUcontent_MBsSWs::replayMBsSWsButtonPressed()
+{
+	if (!_SSMPdev || (_SSMPdev->state() != SSMprotocol::state_normal)) return;
+	// Select log file and replay speed:
+	QString filename = QFileDialog::getOpenFileName(this, tr("Replay Measuring Blocks"), QDir::homePath(), tr("FreeSSM MB/SW logs (*.fmbsw)"));
+	if (filename.isEmpty()) return;
+	QStringList speeds;
+	speeds << "1x" << "2x" << "5x" << "10x" << tr("max.");
+	bool ok = false;
+	QString speedStr = QInputDialog::getItem(this, tr("Replay Measuring Blocks"), tr("Replay speed:"), speeds, 0, false, &ok);
+	if (!ok) return;
+	double speed = 0;	// as fast as possible
+	if (speedStr != speeds.last())
+		speed = speedStr.left(speedStr.size()-1).toDouble();
+	// Start replay:
+	disconnect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
+	if (!_SSMPdev->startMBSWreplay(filename, speed))
+	{
+		if (_MBSWmetaList.size())
+			connect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
+		QMessageBox msg( QMessageBox::Critical, tr("Error"), tr("Couldn't replay the selected log file !\nThe file is damaged or has been recorded from a different Control Unit."), QMessageBox::Ok, this);
+		QFont msgfont = msg.font();
+		msgfont.setPixelSize(12); // 9pts
+		msg.setFont( msgfont );
+		msg.show();
+		msg.exec();
+		msg.close();
+		return;
+	}
+	// Display the recorded MBs/SWs (the user selection is restored when the replay ends):
+	_preReplayMBSWmetaList = _MBSWmetaList;
+	_preReplayTableRowPosIndexes = _tableRowPosIndexes;
+	_preReplayNrOfDerivedMBs = _derivedMBs.size();
+	_replayActive = true;
+	_SSMPdev->getLastMBSWselection(&_MBSWmetaList);
+	// Add the derived MBs stored in the log (calculated from the recorded MBs):
+	MBSWlogFileReader reader;
+	if (reader.open(filename))
+	{
+		std::vector<MBSWlogChannel_dt> channels = reader.channels();
+		for (unsigned int k=0; k<channels.size(); k++)
+		{
+			if ((channels.at(k).blockType != 0) || (channels.at(k).addrLow != MEMORY_ADDRESS_NONE))
+				continue;
+			int index = addDerivedMB(channels.at(k).title, channels.at(k).unit, channels.at(k).precision, channels.at(k).scaleformula);
+			if (index < 0)
+				continue;
+			MBSWmetadata_dt metadata;
+			metadata.blockType = 0;
+			metadata.nativeIndex = _nrOfCUMBs + index;
+			_MBSWmetaList.push_back(metadata);
+		}
+		reader.close();
+	}
+	_tableRowPosIndexes.clear();
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+		_tableRowPosIndexes.push_back(k);
+	startstopmbreading_pushButton->setEnabled(true);
+	if (!startMBSWreading())
+	{
+		_SSMPdev->stopMBSWreading();
+		restorePreReplaySelection();
+		return;
+	}
+	// Setup position slider:
+	replayPosition_horizontalSlider->setRange(0, _SSMPdev->MBSWreplayDuration() / 1000);
+	replayPosition_horizontalSlider->setValue(0);
+	replayPosition_horizontalSlider->show();
+	connect( _SSMPdev, SIGNAL( MBSWreplayPosition(unsigned int) ), this, SLOT( updateReplayPosition(unsigned int) ) );
+}
+
+
+void CUcontent_MBsSWs::restorePreReplaySelection()
+{
+	_replayActive = false;
+	// Remove the derived MBs which have been added for the replay:
+	_derivedMBs.erase(_derivedMBs.begin() + _preReplayNrOfDerivedMBs, _derivedMBs.end());
+	_supportedMBs.erase(_supportedMBs.begin() + _nrOfCUMBs + _preReplayNrOfDerivedMBs, _supportedMBs.end());
+	// Restore selection:
+	_MBSWmetaList = _preReplayMBSWmetaList;
+	_tableRowPosIndexes = _preReplayTableRowPosIndexes;
+	_preReplayMBSWmetaList.clear();
+	_preReplayTableRowPosIndexes.clear();
+	_lastValues.clear();
+	displayMBsSWs();
+	_MBSWrefreshTimeValue_label->setText("---      ");
+	startstopmbreading_pushButton->setEnabled(_MBSWmetaList.size() > 0);
+	disconnect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
+	if (_MBSWmetaList.size())
+		connect( _SSMPdev, SIGNAL( startedMBSWreading() ), this, SLOT( callStart() ) );
+}
+
+
+void CUcontent_MBsSWs::showStatistics()
+{
+	QStringList titles;
+	std::vector<MBSWscaling_dt> scalings;
+	MBSWdecoder *decoder = NULL;
+	// Titles and scalings of the selected MBs/SWs (order of the decoder):
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+	{
+		if (_MBSWmetaList.at(k).blockType == 0)	// MB
+			titles << _supportedMBs.at(_MBSWmetaList.at(k).nativeIndex).title;
+		else	// SW
+			titles << _supportedSWs.at(_MBSWmetaList.at(k).nativeIndex).title;
+	}
+	getMBSWscalings(&scalings);
+	// Statistics of the decoder are only valid if the selection hasn't changed since the last reading:
+	if (_lastValues.size() && (_lastValues.size() == _MBSWmetaList.size()))
+		decoder = _MBSWdecoder;
+	// Open statistics dialog:
+	MBSWstatisticsDlg *dlg = new MBSWstatisticsDlg(this, decoder, titles, scalings);
+	dlg->exec();
+	delete dlg;
+}
+
+
+void CUcontent_MBsSWs::updateReplayPosition(unsigned int time_ms)
+{
+	if (!replayPosition_horizontalSlider->isSliderDown())
+		replayPosition_horizontalSlider->setValue(time_ms / 1000);
+}
+
+
+void CUcontent_MBsSWs::seekReplayPosition()
+{
+	if (_SSMPdev)
+		_SSMPdev->seekMBSWreplay(1000 * replayPosition_horizontalSlider->value());
+}
+
+
 void CUcontent_MBsSWs::getSettings(MBSWsettings_dt *settings)
 {
 	settings->timeMode = _timemode;
 	settings->minValuesEnabled = _valuesTableView->minValuesEnabled();
 	settings->maxValuesEnabled = _valuesTableView->maxValuesEnabled();
+	settings->displayRate = _valuesTableView->displayRate();
 }
 
 
@@ -997,6 +1232,11 @@ void CUcontent_MBsSWs::setupUiFonts()
 	startstopmbreading_pushButton->setFont(contentfont);
 	mbswadd_pushButton->setFont(contentfont);
 	mbswdelete_pushButton->setFont(contentfont);
+	mbswrecord_pushButton->setFont(contentfont);
+	mbswtrigger_pushButton->setFont(contentfont);
+	mbswDTCs_pushButton->setFont(contentfont);
+	mbswreplay_pushButton->setFont(contentfont);
+	mbswstats_pushButton->setFont(contentfont);
 	_timemode_pushButton->setFont(contentfont);
 	// Refresh interval labels:
 	_MBSWrefreshTimeTitle_label->setFont(contentfont);
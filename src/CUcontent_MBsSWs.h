@@ -26,42 +26,26 @@
 #include <vector>
 #include "ui_CUcontent_MBsSWs.h"
 #include "CUcontent_MBsSWs_tableView.h"
+#include "MBSWdecoder.h"
 #include "AddMBsSWsDlg.h"
+#include "MBSWstatisticsDlg.h"
+#include "MBSWtelemetryServer.h"
+#include "MBSWsharedMemoryExport.h"
 #include "SSMprotocol.h"
 #include "libFSSM.h"
 
 
-class MBSWvalue_dt
-{
-public:
-	MBSWvalue_dt() { rawValue=0; };
-	unsigned int rawValue;
-	QString scaledStr;
-	QString unitStr;
-};
-
-
-
-class MinMaxMBSWvalue_dt
-{
-public:
-	MinMaxMBSWvalue_dt() { disabled=false; minRawValue=0; minRawValue=0; };
-	bool disabled;
-	double minRawValue;
-	double maxRawValue;
-	QString minScaledValueStr;
-	QString maxScaledValueStr;
-};
-
+#define		DERIVED_MBS_FILENAME	"FreeSSM.derivedMBs"	// in the home directory
 
 
 class MBSWsettings_dt
 {
 public:
-	MBSWsettings_dt() { timeMode=0; minValuesEnabled=1; maxValuesEnabled=1; };
+	MBSWsettings_dt() { timeMode=0; minValuesEnabled=1; maxValuesEnabled=1; displayRate=MBSW_TABLE_DEFAULT_DISPLAY_RATE; };
 	bool timeMode;
 	bool minValuesEnabled;
 	bool maxValuesEnabled;
+	unsigned int displayRate;	// [Hz], 0 = no rate limitation
 };
 
 
@@ -86,18 +70,33 @@ private:
 	QLabel *_MBSWrefreshTimeValue_label;
 	QPushButton *_timemode_pushButton;
 	CUcontent_MBsSWs_tableView *_valuesTableView;
+	MBSWdecoder *_MBSWdecoder;
 	std::vector<mb_dt> _supportedMBs;
 	std::vector<sw_dt> _supportedSWs;
+	unsigned int _nrOfCUMBs;	// derived MBs are appended to the supported MBs
+	std::vector<MBSWderivedMB_dt> _derivedMBs;
 	std::vector<MBSWmetadata_dt> _MBSWmetaList;
 	bool _timemode;
 	int _lastrefreshduration_ms;
-	QList<MBSWvalue_dt> _lastValues;
-	QList<MinMaxMBSWvalue_dt> _minmaxData;
+	std::vector<MBSWvalue_dt> _lastValues;
 	QList<unsigned int> _tableRowPosIndexes; /* index of the row at which the MB/SW is displayed in the values-table-widget */
+	QString _lastTriggerConditions;
+	bool _replayActive;
+	std::vector<MBSWmetadata_dt> _preReplayMBSWmetaList;	// user selection, restored when the replay ends
+	QList<unsigned int> _preReplayTableRowPosIndexes;
+	unsigned int _preReplayNrOfDerivedMBs;
 	
 	void setupTimeModeUiElements();
 	void setupUiFonts();
 	void displayMBsSWs();
+	void getMBSWscalings(std::vector<MBSWscaling_dt> *scalings);
+	void loadDerivedMBs();
+	int addDerivedMB(QString title, QString unit, char precision, QString expression);
+	void getMBSWreadingSetup(std::vector<MBSWmetadata_dt> *readMBSWmetaList, std::vector<MBSWscaling_dt> *scalings,
+				 std::vector<MBSWderivedChannel_dt> *derivedChannels, std::vector<unsigned int> *outputChannels);
+	std::vector<MBSWlogChannel_dt> derivedMBlogChannels();
+	std::vector<MBSWlogChannel_dt> selectedMBSWlogChannels();
+	void restorePreReplaySelection();
 	void updateTimeInfo(int refreshduration_ms);
 	void communicationError(QString addstr);
 	void resizeEvent(QResizeEvent *event);
@@ -106,7 +105,7 @@ private slots:
 	void startstopMBsSWsButtonPressed();
 	void callStart();
 	void callStop();
-	void processMBSWRawValues(std::vector<unsigned int> rawValues, int refreshduration_ms);
+	void processMBSWvalues();
 	void addMBsSWs();
 	void deleteMBsSWs();
 	void moveUpMBsSWsOnTheTable();
@@ -114,6 +113,15 @@ private slots:
 	void resetMinMaxTableValues();
 	void setDeleteButtonEnabledState();
 	void switchTimeMode();
+	void recordMBsSWsButtonPressed();
+	void triggerMBsSWsButtonPressed();
+	void watchDTCsButtonPressed();
+	void updateWatchedDTCs(QStringList currentDTCs, QStringList currentDTCsDescriptions, bool testMode, bool DCheckActive);
+	void saveDTCsnapshot(QString DTC);
+	void replayMBsSWsButtonPressed();
+	void showStatistics();
+	void updateReplayPosition(unsigned int time_ms);
+	void seekReplayPosition();
 
 signals:
 	void error();
@@ -0,0 +1,303 @@
+/*
+ * CUcontent_MBsSWs_tableModel.cpp - Item model for the MB/SW values table
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CUcontent_MBsSWs_tableModel.h"
+
+
+
+CUcontent_MBsSWs_tableModel::CUcontent_MBsSWs_tableModel(QObject *parent) : QAbstractTableModel(parent)
+{
+	_updatesPending = false;
+	_minRowCount = 0;
+	_displayRate = MBSW_TABLE_DEFAULT_DISPLAY_RATE;
+	_displayTimer.setSingleShot(true);
+	connect( &_displayTimer, SIGNAL( timeout() ), this, SLOT( applyPendingUpdates() ) );
+}
+
+
+void CUcontent_MBsSWs_tableModel::setContent(QStringList titles, std::vector<MBSWscaling_dt> scalings, std::vector<MBSWvalue_dt> values)
+{
+	unsigned int nrofMBsSWs = qMax(static_cast<unsigned int>(titles.size()), static_cast<unsigned int>(scalings.size()));
+	// Discard pending updates (refer to the old content):
+	_displayTimer.stop();
+	_updatesPending = false;
+	// Set new content:
+	beginResetModel();
+	_rows.assign(nrofMBsSWs, MBSWtableRow_dt());
+	for (unsigned int k=0; k<nrofMBsSWs; k++)
+	{
+		MBSWtableRow_dt & row = _rows.at(k);
+		if (static_cast<int>(k) < titles.size())
+			row.title = titles.at(k);
+		if (k < scalings.size())
+			row.scaling = scalings.at(k);
+		if (k < values.size())
+		{
+			row.value = values.at(k);
+			row.hasValue = true;
+		}
+	}
+	_pendingValues.assign(nrofMBsSWs, MBSWvalue_dt());
+	_rowPending.assign(nrofMBsSWs, false);
+	endResetModel();
+}
+
+
+void CUcontent_MBsSWs_tableModel::updateValue(unsigned int row, const MBSWvalue_dt & value)
+{
+	if (row >= _pendingValues.size()) return;
+	_pendingValues.at(row) = value;
+	_rowPending.at(row) = true;
+	_updatesPending = true;
+	// Apply updates immediately or schedule next display update:
+	if (_displayRate == 0)
+		applyPendingUpdates();
+	else if (!_displayTimer.isActive())
+		_displayTimer.start(1000 / _displayRate);
+	/* NOTE: the timer is not restarted with each update, otherwise permanent
+	 *       updates with a higher rate than the display rate would block the display */
+}
+
+
+void CUcontent_MBsSWs_tableModel::clear()
+{
+	_displayTimer.stop();
+	_updatesPending = false;
+	beginResetModel();
+	_rows.clear();
+	_pendingValues.clear();
+	_rowPending.clear();
+	endResetModel();
+}
+
+
+unsigned int CUcontent_MBsSWs_tableModel::nrOfMBsSWs() const
+{
+	return _rows.size();
+}
+
+
+void CUcontent_MBsSWs_tableModel::setMinRowCount(unsigned int rows)
+{
+	unsigned int oldRowCount = rowCount();
+	unsigned int newRowCount = qMax(rows, static_cast<unsigned int>(_rows.size()));
+	if (newRowCount > oldRowCount)
+	{
+		beginInsertRows(QModelIndex(), oldRowCount, newRowCount-1);
+		_minRowCount = rows;
+		endInsertRows();
+	}
+	else if (newRowCount < oldRowCount)
+	{
+		beginRemoveRows(QModelIndex(), newRowCount, oldRowCount-1);
+		_minRowCount = rows;
+		endRemoveRows();
+	}
+	else
+		_minRowCount = rows;
+	/* NOTE: the additional (empty) rows fill the visible area of the table */
+}
+
+
+void CUcontent_MBsSWs_tableModel::setDisplayRate(unsigned int rate_Hz)
+{
+	if (rate_Hz > 1000)
+		rate_Hz = 1000;
+	_displayRate = rate_Hz;
+	if (_updatesPending && ((_displayRate == 0) || !_displayTimer.isActive()))
+		applyPendingUpdates();
+}
+
+
+unsigned int CUcontent_MBsSWs_tableModel::displayRate() const
+{
+	return _displayRate;
+}
+
+
+bool CUcontent_MBsSWs_tableModel::numericValue(unsigned int row, double *value) const
+{
+	if ((row >= _rows.size()) || !_rows.at(row).hasValue || !_rows.at(row).value.scaled || !_rows.at(row).value.numeric)
+		return false;
+	*value = _rows.at(row).value.scaledValue;
+	return true;
+}
+
+
+int CUcontent_MBsSWs_tableModel::rowCount(const QModelIndex & parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return qMax(_minRowCount, static_cast<unsigned int>(_rows.size()));
+}
+
+
+int CUcontent_MBsSWs_tableModel::columnCount(const QModelIndex & parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return 5;
+}
+
+
+QVariant CUcontent_MBsSWs_tableModel::data(const QModelIndex & index, int role) const
+{
+	if (!index.isValid() || (index.row() >= static_cast<int>(_rows.size())))
+		return QVariant();
+	const MBSWtableRow_dt & row = _rows.at(index.row());
+	if (role == Qt::DisplayRole)
+	{
+		switch (index.column())
+		{
+			case col_title:
+				return row.title;
+			case col_min:
+				if (row.hasValue)
+					return minMaxValueStr(row, row.value.minRawValue);
+				break;
+			case col_value:
+				if (row.hasValue)
+					return row.scaling.valueStr(row.value.rawValue, row.value.scaled);
+				break;
+			case col_max:
+				if (row.hasValue)
+					return minMaxValueStr(row, row.value.maxRawValue);
+				break;
+			case col_unit:
+				if (row.hasValue)
+					return row.scaling.unitStr(row.value.scaled);
+				return row.scaling.defaultUnitStr();
+		}
+	}
+	else if (role == Qt::TextAlignmentRole)
+	{
+		if ((index.column() == col_min) || (index.column() == col_value) || (index.column() == col_max))
+			return static_cast<int>(Qt::AlignCenter);
+	}
+	else if ((role == Qt::ToolTipRole) && (index.column() == col_value))
+	{
+		if (row.hasValue && row.value.count)
+			return tr("Average: %1").arg(row.scaling.numberStr(row.value.average()));
+	}
+	else if ((role == Qt::UserRole) && (index.column() == col_value) && row.hasValue)
+	{
+		if (row.value.scaled && row.value.numeric)
+			return row.value.scaledValue;
+		return row.value.rawValue;
+	}
+	return QVariant();
+}
+
+
+QVariant CUcontent_MBsSWs_tableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole))
+		return QAbstractTableModel::headerData(section, orientation, role);
+	switch (section)
+	{
+		case col_title:
+			return tr("Title:");
+		case col_min:
+			return tr("Min. Value:");
+		case col_value:
+			return tr("Current Value:");
+		case col_max:
+			return tr("Max. Value:");
+		case col_unit:
+			return tr("Unit:");
+	}
+	return QVariant();
+}
+
+
+Qt::ItemFlags CUcontent_MBsSWs_tableModel::flags(const QModelIndex & index) const
+{
+	if (!index.isValid())
+		return 0;
+	return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+
+void CUcontent_MBsSWs_tableModel::applyPendingUpdates()
+{
+	int firstChangedCol = 0;
+	int lastChangedCol = 0;
+	if (!_updatesPending) return;
+	_updatesPending = false;
+	for (unsigned int k=0; k<_rows.size(); k++)
+	{
+		if (!_rowPending.at(k))
+			continue;
+		_rowPending.at(k) = false;
+		MBSWtableRow_dt & row = _rows.at(k);
+		const MBSWvalue_dt & newValue = _pendingValues.at(k);
+		// Get the range of columns with changed texts:
+		/* NOTE: the texts only depend on the raw values and the scaling/min/max states */
+		if (!row.hasValue)
+		{
+			firstChangedCol = col_min;
+			lastChangedCol = col_unit;
+		}
+		else
+		{
+			firstChangedCol = -1;
+			lastChangedCol = -1;
+			if ((row.value.minmaxDisabled != newValue.minmaxDisabled) || (row.value.minmaxScaled != newValue.minmaxScaled)
+			    || (row.value.minRawValue != newValue.minRawValue))
+			{
+				firstChangedCol = col_min;
+				lastChangedCol = col_min;
+			}
+			if ((row.value.rawValue != newValue.rawValue) || (row.value.scaled != newValue.scaled))
+			{
+				if (firstChangedCol < 0)
+					firstChangedCol = col_value;
+				lastChangedCol = col_value;
+			}
+			if ((row.value.minmaxDisabled != newValue.minmaxDisabled) || (row.value.minmaxScaled != newValue.minmaxScaled)
+			    || (row.value.maxRawValue != newValue.maxRawValue))
+			{
+				if (firstChangedCol < 0)
+					firstChangedCol = col_max;
+				lastChangedCol = col_max;
+			}
+			if (row.value.scaled != newValue.scaled)
+			{
+				if (firstChangedCol < 0)
+					firstChangedCol = col_unit;
+				lastChangedCol = col_unit;
+			}
+		}
+		row.value = newValue;
+		row.hasValue = true;
+		// Notify the view:
+		if (firstChangedCol >= 0)
+			emit dataChanged(index(k, firstChangedCol), index(k, lastChangedCol));
+	}
+}
+
+// PRIVATE
+
+QString CUcontent_MBsSWs_tableModel::minMaxValueStr(const MBSWtableRow_dt & row, unsigned int rawValue) const
+{
+	// Don't display any min/max values, if disabled:
+	if (row.value.minmaxDisabled)
+		return "";
+	return row.scaling.valueStr(rawValue, row.value.minmaxScaled);
+}
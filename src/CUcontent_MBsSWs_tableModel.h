@@ -0,0 +1,89 @@
+/*
+ * CUcontent_MBsSWs_tableModel.h - Item model for the MB/SW values table
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUCONTENT_MBSSWS_TABLEMODEL_H
+#define CUCONTENT_MBSSWS_TABLEMODEL_H
+
+
+
+#include <QtGui>
+#include <vector>
+#include "MBSWdecoder.h"
+
+
+#define		MBSW_TABLE_DEFAULT_DISPLAY_RATE		30	// [Hz]
+
+
+
+class MBSWtableRow_dt
+{
+public:
+	MBSWtableRow_dt() { hasValue=false; };
+	QString title;
+	MBSWscaling_dt scaling;
+	bool hasValue;
+	MBSWvalue_dt value;
+};
+
+
+
+/* NOTE: value updates are buffered and applied with the display rate.
+ *       Only cells whose text has changed are reported to the view.
+ *       Value strings are generated on request of the view (visible cells only). */
+
+class CUcontent_MBsSWs_tableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	enum column_dt {col_title=0, col_min=1, col_value=2, col_max=3, col_unit=4};
+
+	CUcontent_MBsSWs_tableModel(QObject *parent=0);
+	void setContent(QStringList titles, std::vector<MBSWscaling_dt> scalings, std::vector<MBSWvalue_dt> values);
+	void updateValue(unsigned int row, const MBSWvalue_dt & value);
+	void clear();
+	unsigned int nrOfMBsSWs() const;
+	void setMinRowCount(unsigned int rows);
+	void setDisplayRate(unsigned int rate_Hz);	// 0 = no rate limitation
+	unsigned int displayRate() const;
+	bool numericValue(unsigned int row, double *value) const;
+	int rowCount(const QModelIndex & parent = QModelIndex()) const;
+	int columnCount(const QModelIndex & parent = QModelIndex()) const;
+	QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	Qt::ItemFlags flags(const QModelIndex & index) const;
+
+public slots:
+	void applyPendingUpdates();
+
+private:
+	std::vector<MBSWtableRow_dt> _rows;
+	std::vector<MBSWvalue_dt> _pendingValues;
+	std::vector<bool> _rowPending;
+	bool _updatesPending;
+	unsigned int _minRowCount;
+	unsigned int _displayRate;
+	QTimer _displayTimer;
+
+	QString minMaxValueStr(const MBSWtableRow_dt & row, unsigned int rawValue) const;
+};
+
+
+
+#endif
@@ -21,7 +21,7 @@
 
 
 
-CUcontent_MBsSWs_tableView::CUcontent_MBsSWs_tableView(QWidget *parent, bool showMin, bool showMax) : QWidget(parent)
+CUcontent_MBsSWs_tableView::CUcontent_MBsSWs_tableView(QWidget *parent, bool showMin, bool showMax, unsigned int displayRate) : QWidget(parent)
 {
 	QHeaderView *headerview;
 	_nrofMBsSWs = 0;
@@ -30,43 +30,63 @@ CUcontent_MBsSWs_tableView::CUcontent_MBsSWs_tableView(QWidget *parent, bool sho
 	// Setup GUI:
 	setupUi(this);
 	setupUiFonts();
+	// Setup table model:
+	_tableModel = new CUcontent_MBsSWs_tableModel(this);
+	selectedMBsSWs_tableView->setModel(_tableModel);
 	// Disable all GUI-elements:
 	mbswmoveup_pushButton->setEnabled( false );
 	mbswmovedown_pushButton->setEnabled( false );
 	// Set table column resize behavior:
-	headerview = selectedMBsSWs_tableWidget->horizontalHeader();
+	headerview = selectedMBsSWs_tableView->horizontalHeader();
 	headerview->setResizeMode(0, QHeaderView::Stretch);
 	headerview->setResizeMode(1, QHeaderView::Fixed); // resize doesn't work correctly in this constellation (Qt-bug)
 	headerview->setResizeMode(2, QHeaderView::Fixed);
 	headerview->setResizeMode(3, QHeaderView::Fixed);
 	headerview->setResizeMode(4, QHeaderView::Fixed);
 	// Set table row resize behavior:
-	headerview = selectedMBsSWs_tableWidget->verticalHeader();
+	headerview = selectedMBsSWs_tableView->verticalHeader();
 	headerview->setResizeMode(QHeaderView::Fixed);
 	/* NOTE: Current method for calculating ther nr. of needed rows 
 	 * assumes all rows to have the same constsant height */
 	// Set column widths (columns 2-5):
-	selectedMBsSWs_tableWidget->setColumnWidth(1, 95);
-	selectedMBsSWs_tableWidget->setColumnWidth(2, 95);
-	selectedMBsSWs_tableWidget->setColumnWidth(3, 95);
-	selectedMBsSWs_tableWidget->setColumnWidth(4, 58);
+	selectedMBsSWs_tableView->setColumnWidth(1, 95);
+	selectedMBsSWs_tableView->setColumnWidth(2, 95);
+	selectedMBsSWs_tableView->setColumnWidth(3, 95);
+	selectedMBsSWs_tableView->setColumnWidth(4, 58);
 	// Install event-filter for MB/SW-table:
-	selectedMBsSWs_tableWidget->viewport()->installEventFilter(this);
+	selectedMBsSWs_tableView->viewport()->installEventFilter(this);
 	// (Un)check min/max toggle-buttons:
 	showMin_pushButton->setChecked(showMin);
 	showMax_pushButton->setChecked(showMax);
 	// Make min/max values columns (in)visible:
 	toggleMinColumnVisible(showMin);
 	toggleMaxColumnVisible(showMax);
+	// Display rate selection (context menu of the table):
+	const unsigned int displayRates[4] = {10, MBSW_TABLE_DEFAULT_DISPLAY_RATE, 60, 0};
+	_displayRateActions = new QActionGroup(this);
+	for (unsigned char k=0; k<4; k++)
+	{
+		QString text = tr("Display rate: unlimited");
+		if (displayRates[k])
+			text = tr("Display rate: %1 Hz").arg(displayRates[k]);
+		QAction *action = _displayRateActions->addAction(text);
+		action->setData(displayRates[k]);
+		action->setCheckable(true);
+		action->setChecked(displayRates[k] == displayRate);
+	}
+	selectedMBsSWs_tableView->addActions(_displayRateActions->actions());
+	selectedMBsSWs_tableView->setContextMenuPolicy(Qt::ActionsContextMenu);
+	setDisplayRate(displayRate);
 	// Connect signals and slots:
 	connect( mbswmoveup_pushButton , SIGNAL( released() ), this, SIGNAL( moveUpButton_pressed() ) );
 	connect( mbswmovedown_pushButton , SIGNAL( released() ), this, SIGNAL( moveDownButton_pressed() ) );
 	connect( resetMinMax_pushButton , SIGNAL( released() ), this, SIGNAL( resetMinMaxButton_pressed() ) );
 	connect( showMin_pushButton , SIGNAL( clicked(bool) ), this, SLOT( toggleMinColumnVisible(bool) ) );
 	connect( showMax_pushButton , SIGNAL( clicked(bool) ), this, SLOT( toggleMaxColumnVisible(bool) ) );
+	connect( _displayRateActions , SIGNAL( triggered(QAction*) ), this, SLOT( selectDisplayRate(QAction*) ) );
 	// NOTE: using released() instead of pressed() as workaround for a Qt-Bug occuring under MS Windows
-	connect( selectedMBsSWs_tableWidget , SIGNAL( itemSelectionChanged() ), this, SLOT( setMoveButtonsEnabledState() ) );
-	connect( selectedMBsSWs_tableWidget , SIGNAL( itemSelectionChanged() ), this, SIGNAL( itemSelectionChanged() ) );
+	connect( selectedMBsSWs_tableView->selectionModel() , SIGNAL( selectionChanged(const QItemSelection &, const QItemSelection &) ), this, SLOT( setMoveButtonsEnabledState() ) );
+	connect( selectedMBsSWs_tableView->selectionModel() , SIGNAL( selectionChanged(const QItemSelection &, const QItemSelection &) ), this, SIGNAL( itemSelectionChanged() ) );
 }
 
 
@@ -77,83 +97,46 @@ CUcontent_MBsSWs_tableView::~CUcontent_MBsSWs_tableView()
 	disconnect( resetMinMax_pushButton , SIGNAL( released() ), this, SIGNAL( resetMinMaxButton_pressed() ) );
 	disconnect( showMin_pushButton , SIGNAL( clicked(bool) ), this, SLOT( toggleMinColumnVisible(bool) ) );
 	disconnect( showMax_pushButton , SIGNAL( clicked(bool) ), this, SLOT( toggleMaxColumnVisible(bool) ) );
-	disconnect( selectedMBsSWs_tableWidget , SIGNAL( itemSelectionChanged() ), this, SLOT( setMoveButtonsEnabledState() ) );
-	disconnect( selectedMBsSWs_tableWidget , SIGNAL( itemSelectionChanged() ), this, SIGNAL( itemSelectionChanged() ) );
+	disconnect( _displayRateActions , SIGNAL( triggered(QAction*) ), this, SLOT( selectDisplayRate(QAction*) ) );
+	disconnect( selectedMBsSWs_tableView->selectionModel() , SIGNAL( selectionChanged(const QItemSelection &, const QItemSelection &) ), this, SLOT( setMoveButtonsEnabledState() ) );
+	disconnect( selectedMBsSWs_tableView->selectionModel() , SIGNAL( selectionChanged(const QItemSelection &, const QItemSelection &) ), this, SIGNAL( itemSelectionChanged() ) );
+	selectedMBsSWs_tableView->setModel(NULL);
+	delete _tableModel;
 }
 
 
-void CUcontent_MBsSWs_tableView::setMBSWlistContent(QStringList titles, QStringList values, QStringList minValues, QStringList maxValues, QStringList units)
+void CUcontent_MBsSWs_tableView::setMBSWlistContent(QStringList titles, std::vector<MBSWscaling_dt> scalings, std::vector<MBSWvalue_dt> values)
 {
-	int k=0;
 	int firstrowvisibleindex = 0;
-	QTableWidgetItem *tableelement;
-	// Delete table content:
-	selectedMBsSWs_tableWidget->clearContents();
+	// Set new table content:
+	_tableModel->setContent(titles, scalings, values);
 	// Save nr of MBs/Sws:
-	_nrofMBsSWs = qMax( qMax( qMax( qMax( values.size(), minValues.size() ), maxValues.size() ), titles.size() ), units.size() );
+	_nrofMBsSWs = _tableModel->nrOfMBsSWs();
 	// Set number of rows and vertical scroll bar policy:
+	_tableModel->setMinRowCount(_maxrowsvisible);
 	if (_nrofMBsSWs >= _maxrowsvisible)
 	{
-		selectedMBsSWs_tableWidget->setRowCount(_nrofMBsSWs);
-		selectedMBsSWs_tableWidget->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
+		selectedMBsSWs_tableView->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
 		// Check if get white space area at the bottom of the table:
-		firstrowvisibleindex = selectedMBsSWs_tableWidget->rowAt(0);
+		firstrowvisibleindex = selectedMBsSWs_tableView->rowAt(0);
 		if (firstrowvisibleindex+_maxrowsvisible > _nrofMBsSWs)
 		{
-			selectedMBsSWs_tableWidget->setVerticalScrollMode( QAbstractItemView::ScrollPerPixel );
-			selectedMBsSWs_tableWidget->scrollToBottom();
-			selectedMBsSWs_tableWidget->setVerticalScrollMode( QAbstractItemView::ScrollPerItem );
+			selectedMBsSWs_tableView->setVerticalScrollMode( QAbstractItemView::ScrollPerPixel );
+			selectedMBsSWs_tableView->scrollToBottom();
+			selectedMBsSWs_tableView->setVerticalScrollMode( QAbstractItemView::ScrollPerItem );
 		}
 	}
 	else
 	{
-		selectedMBsSWs_tableWidget->setRowCount(_maxrowsvisible);
-		selectedMBsSWs_tableWidget->setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
-		selectedMBsSWs_tableWidget->scrollToTop();
+		selectedMBsSWs_tableView->setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+		selectedMBsSWs_tableView->scrollToTop();
 	}
-	// *** Fill table ***:
-	for (k=0; k<titles.size(); k++)
-	{
-		// Title:
-		tableelement = new QTableWidgetItem( titles.at(k) );
-		selectedMBsSWs_tableWidget->setItem(k, 0, tableelement);
-	}
-	// current/min/max values, units:
-	updateMBSWvalues(values, minValues, maxValues, units);
 }
 
 
-void CUcontent_MBsSWs_tableView::updateMBSWvalues(QStringList valueStrList, QStringList minValueStrList, QStringList maxValueStrList, QStringList unitStrList)
+void CUcontent_MBsSWs_tableView::updateMBSWvalue(unsigned int rowindex, const MBSWvalue_dt & value)
 {
-	unsigned int k = 0;
-	QTableWidgetItem *tableelement;
-	// Update min values:
-	for (k=0; k<qMin(static_cast<unsigned int>(minValueStrList.size()), _nrofMBsSWs); k++)
-	{
-		tableelement = new QTableWidgetItem( minValueStrList.at(k) );
-		tableelement->setTextAlignment(Qt::AlignCenter);
-		selectedMBsSWs_tableWidget->setItem(k, 1, tableelement);
-	}
-	// Update values:
-	for (k=0; k<qMin(static_cast<unsigned int>(valueStrList.size()), _nrofMBsSWs); k++)
-	{
-		tableelement = new QTableWidgetItem( valueStrList.at(k) );
-		tableelement->setTextAlignment(Qt::AlignCenter);
-		selectedMBsSWs_tableWidget->setItem(k, 2, tableelement);
-	}
-	// Update max values:
-	for (k=0; k<qMin(static_cast<unsigned int>(maxValueStrList.size()), _nrofMBsSWs); k++)
-	{
-		tableelement = new QTableWidgetItem( maxValueStrList.at(k) );
-		tableelement->setTextAlignment(Qt::AlignCenter);
-		selectedMBsSWs_tableWidget->setItem(k, 3, tableelement);
-	}
-	// Update units:
-	for (k=0; k<qMin(static_cast<unsigned int>(unitStrList.size()), _nrofMBsSWs); k++)
-	{
-		tableelement = new QTableWidgetItem( unitStrList.at(k) );
-		selectedMBsSWs_tableWidget->setItem(k, 4, tableelement);
-	}
+	_tableModel->updateValue(rowindex, value);
 	/* NOTE: The units can change during MB/SW-reading !:
 	 *       If a MB/SW cannot be scaled (e.g. due to unexpected raw values, incomplete/invalid defintions),
 	 *       the raw value is displayed instead and the unit is switched to [RAW] (MBs) or [BIN] (SWs).
@@ -161,9 +144,25 @@ void CUcontent_MBsSWs_tableView::updateMBSWvalues(QStringList valueStrList, QStr
 }
 
 
+void CUcontent_MBsSWs_tableView::setDisplayRate(unsigned int rate_Hz)
+{
+	_tableModel->setDisplayRate(rate_Hz);
+	// Update display rate selection:
+	QList<QAction*> actions = _displayRateActions->actions();
+	for (int k=0; k<actions.size(); k++)
+		actions.at(k)->setChecked(actions.at(k)->data().toUInt() == rate_Hz);
+}
+
+
+unsigned int CUcontent_MBsSWs_tableView::displayRate()
+{
+	return _tableModel->displayRate();
+}
+
+
 void CUcontent_MBsSWs_tableView::clearMBSWlistContent()
 {
-	selectedMBsSWs_tableWidget->clear();
+	_tableModel->clear();
 	_nrofMBsSWs = 0;
 }
 
@@ -194,18 +193,24 @@ void CUcontent_MBsSWs_tableView::setMoveButtonsEnabledState()
 void CUcontent_MBsSWs_tableView::toggleMinColumnVisible(bool show)
 {
 	if (show)
-		selectedMBsSWs_tableWidget->showColumn(1);
+		selectedMBsSWs_tableView->showColumn(1);
 	else
-		selectedMBsSWs_tableWidget->hideColumn(1);
+		selectedMBsSWs_tableView->hideColumn(1);
 }
 
 
 void CUcontent_MBsSWs_tableView::toggleMaxColumnVisible(bool show)
 {
 	if (show)
-		selectedMBsSWs_tableWidget->showColumn(3);
+		selectedMBsSWs_tableView->showColumn(3);
 	else
-		selectedMBsSWs_tableWidget->hideColumn(3);
+		selectedMBsSWs_tableView->hideColumn(3);
+}
+
+
+void CUcontent_MBsSWs_tableView::selectDisplayRate(QAction *action)
+{
+	_tableModel->setDisplayRate(action->data().toUInt());
 }
 
 
@@ -228,21 +233,21 @@ void CUcontent_MBsSWs_tableView::getSelectedTableWidgetRows(QList<unsigned int>
 	int rows=0;
 	// GET INDEXES OF SELECTED ROWS:
 	selectedMBSWIndexes->clear();
-	QList<QTableWidgetSelectionRange> selectedRanges;
-	selectedRanges = selectedMBsSWs_tableWidget->selectedRanges();
+	QItemSelection selectedRanges;
+	selectedRanges = selectedMBsSWs_tableView->selectionModel()->selection();
 	for (k=0; k<selectedRanges.size(); k++)
 	{
-		rows = selectedRanges.at(k).bottomRow() - selectedRanges.at(k).topRow() + 1;
+		rows = selectedRanges.at(k).bottom() - selectedRanges.at(k).top() + 1;
 		for (m=0; m<rows; m++)
 		{
-			if (static_cast<unsigned int>(selectedRanges.at(k).topRow() + m) < _nrofMBsSWs)
-				selectedMBSWIndexes->push_back(selectedRanges.at(k).topRow() + m);
+			if (static_cast<unsigned int>(selectedRanges.at(k).top() + m) < _nrofMBsSWs)
+				selectedMBSWIndexes->push_back(selectedRanges.at(k).top() + m);
 		}
 	}
 	qSort(selectedMBSWIndexes->begin(), selectedMBSWIndexes->end());
 	/* NOTE: This function must return sorted indexes (from min to max) !
 	   At least for the QAbstractItemView::ContiguousSelction selection mode,
-	   QTableWidget::selectedRanges() seems to return always sorted indexes.
+	   QItemSelectionModel::selection() seems to return always sorted indexes.
 	   However, Qt-Documentation doesn't tell us anything about the order of
 	   the returned indexes, so we can NOT assume that they are and will
 	   ever be sorted in future Qt-versions !
@@ -252,16 +257,14 @@ void CUcontent_MBsSWs_tableView::getSelectedTableWidgetRows(QList<unsigned int>
 
 void CUcontent_MBsSWs_tableView::selectMBSWtableRows(unsigned int start, unsigned int end)
 {
-	QTableWidgetSelectionRange selrange(start, 0, end, 4);
-	selectedMBsSWs_tableWidget->setRangeSelected(selrange , true);
+	QItemSelection selrange(_tableModel->index(start, 0), _tableModel->index(end, 4));
+	selectedMBsSWs_tableView->selectionModel()->select(selrange, QItemSelectionModel::Select);
 }
 
 
 void CUcontent_MBsSWs_tableView::scrollMBSWtable(unsigned int rowindex)
 {
-	QTableWidgetItem *item = new QTableWidgetItem;
-	item = selectedMBsSWs_tableWidget->item(rowindex, 0);
-	selectedMBsSWs_tableWidget->scrollToItem(item, QAbstractItemView::EnsureVisible);
+	selectedMBsSWs_tableView->scrollTo(_tableModel->index(rowindex, 0), QAbstractItemView::EnsureVisible);
 }
 
 
@@ -271,27 +274,25 @@ void CUcontent_MBsSWs_tableView::resizeEvent(QResizeEvent *event)
 	int vspace = 0;
 	unsigned int minnrofrows = 0;
 	// Get available vertical space (for rows) and height per row:
-	if (selectedMBsSWs_tableWidget->rowCount() < 1)
-		selectedMBsSWs_tableWidget->setRowCount(1); // Temporary create a row to get the row hight
-	rowheight = selectedMBsSWs_tableWidget->rowHeight(0);
-	//vspace = selectedMBsSWs_tableWidget->viewport()->height(); // NOTE: Sometimes doesn't work as expected ! (Qt-Bug ?)
-	vspace = selectedMBsSWs_tableWidget->height() - selectedMBsSWs_tableWidget->horizontalHeader()->viewport()->height() - 4;
+	rowheight = selectedMBsSWs_tableView->verticalHeader()->defaultSectionSize();
+	//vspace = selectedMBsSWs_tableView->viewport()->height(); // NOTE: Sometimes doesn't work as expected ! (Qt-Bug ?)
+	vspace = selectedMBsSWs_tableView->height() - selectedMBsSWs_tableView->horizontalHeader()->viewport()->height() - 4;
 	// Temporary switch to "Scroll per Pixel"-mode to ensure auto-scroll (prevent white space between bottom of the last row and the lower table border)
-	selectedMBsSWs_tableWidget->setVerticalScrollMode( QAbstractItemView::ScrollPerPixel );
+	selectedMBsSWs_tableView->setVerticalScrollMode( QAbstractItemView::ScrollPerPixel );
 	// Calculate and set nr. of rows:
 	_maxrowsvisible = static_cast<unsigned int>(trunc((vspace-1)/rowheight) + 1);
 	if (_maxrowsvisible < _nrofMBsSWs)
 		minnrofrows = _nrofMBsSWs;
 	else
 		minnrofrows = _maxrowsvisible;
-	selectedMBsSWs_tableWidget->setRowCount(minnrofrows);
+	_tableModel->setMinRowCount(minnrofrows);
 	// Set vertical scroll bar policy:
 	if (minnrofrows > _nrofMBsSWs)
-		selectedMBsSWs_tableWidget->setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+		selectedMBsSWs_tableView->setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
 	else
-		selectedMBsSWs_tableWidget->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
+		selectedMBsSWs_tableView->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
 	// Switch back to "Scroll per item"-mode:
-	selectedMBsSWs_tableWidget->setVerticalScrollMode( QAbstractItemView::ScrollPerItem ); // auto-scroll is triggered; Maybe this is a Qt-Bug, we don't want that  here...
+	selectedMBsSWs_tableView->setVerticalScrollMode( QAbstractItemView::ScrollPerItem ); // auto-scroll is triggered; Maybe this is a Qt-Bug, we don't want that  here...
 	// Accept event:
 	event->accept();
 }
@@ -299,11 +300,11 @@ void CUcontent_MBsSWs_tableView::resizeEvent(QResizeEvent *event)
 
 bool CUcontent_MBsSWs_tableView::eventFilter(QObject *obj, QEvent *event)
 {
-	if (obj == selectedMBsSWs_tableWidget->viewport())
+	if (obj == selectedMBsSWs_tableView->viewport())
 	{
 		if (event->type() == QEvent::Wheel)
 		{
-			if (selectedMBsSWs_tableWidget->verticalScrollBarPolicy() ==  Qt::ScrollBarAlwaysOff)
+			if (selectedMBsSWs_tableView->verticalScrollBarPolicy() ==  Qt::ScrollBarAlwaysOff)
 			// ...or _maxrowsvisible > _nrofMBsSWs
 				return true;	// filter out
 			else
@@ -324,7 +325,7 @@ void CUcontent_MBsSWs_tableView::setupUiFonts()
 	contentfont.setBold(false);
 	this->setFont(contentfont);
 	// Table:
-	selectedMBsSWs_tableWidget->setFont(contentfont);
+	selectedMBsSWs_tableView->setFont(contentfont);
 	// Buttons:
 	mbswmoveup_pushButton->setFont(contentfont);
 	mbswmovedown_pushButton->setFont(contentfont);
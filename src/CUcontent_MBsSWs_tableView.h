@@ -24,7 +24,9 @@
 
 #include <QtGui>
 #include <QtGlobal>
+#include <vector>
 #include "ui_CUcontent_MBsSWs_tableView.h"
+#include "CUcontent_MBsSWs_tableModel.h"
 
 
 
@@ -33,10 +35,12 @@ class CUcontent_MBsSWs_tableView : public QWidget, private Ui::MBSWtable_Form
 	Q_OBJECT
 
 public:
-	CUcontent_MBsSWs_tableView(QWidget *parent, bool showMin=true, bool showMax=true);
+	CUcontent_MBsSWs_tableView(QWidget *parent, bool showMin=true, bool showMax=true, unsigned int displayRate=MBSW_TABLE_DEFAULT_DISPLAY_RATE);
 	~CUcontent_MBsSWs_tableView();
-	void setMBSWlistContent(QStringList titles, QStringList values, QStringList minValues, QStringList maxValues, QStringList units);
-	void updateMBSWvalues(QStringList valueStrList, QStringList minValueStrList, QStringList maxValueStrList, QStringList unitStrList);
+	void setMBSWlistContent(QStringList titles, std::vector<MBSWscaling_dt> scalings, std::vector<MBSWvalue_dt> values);
+	void updateMBSWvalue(unsigned int rowindex, const MBSWvalue_dt & value);
+	void setDisplayRate(unsigned int rate_Hz);
+	unsigned int displayRate();
 	void clearMBSWlistContent();
 	bool minValuesEnabled();
 	bool maxValuesEnabled();
@@ -45,8 +49,10 @@ public:
 	void scrollMBSWtable(unsigned int rowindex);
 
 private:
+	CUcontent_MBsSWs_tableModel *_tableModel;
 	unsigned int _nrofMBsSWs;
 	unsigned int _maxrowsvisible;
+	QActionGroup *_displayRateActions;
 
 	void setupUiFonts();
 	void resizeEvent(QResizeEvent *event);
@@ -56,6 +62,7 @@ private slots:
 	void setMoveButtonsEnabledState();
 	void toggleMinColumnVisible(bool show);
 	void toggleMaxColumnVisible(bool show);
+	void selectDisplayRate(QAction *action);
 
 signals:
 	void moveUpButton_pressed();
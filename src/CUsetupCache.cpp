@@ -0,0 +1,352 @@
+/*
+ * CUsetupCache.cpp - Persistent cache of control unit setups
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CUsetupCache.h"
+#include <QDataStream>
+#include <QFile>
+#include <QDir>
+
+
+QMutex CUsetupCache::_mutex;
+bool CUsetupCache::_loaded = false;
+std::vector<CUsetupCacheEntry_dt> CUsetupCache::_entries;
+QMap<QString, unsigned int> CUsetupCache::_CUaddresses;
+
+
+
+static QDataStream & operator<<(QDataStream & out, const dc_defs_dt & dc)
+{
+	out << static_cast<quint32>(dc.byteAddr_currentOrTempOrLatest) << static_cast<quint32>(dc.byteAddr_historicOrMemorized);
+	for (unsigned char k=0; k<8; k++)
+		out << dc.code[k] << dc.title[k];
+	return out;
+}
+
+
+static QDataStream & operator>>(QDataStream & in, dc_defs_dt & dc)
+{
+	quint32 addr_1 = 0, addr_2 = 0;
+	in >> addr_1 >> addr_2;
+	dc.byteAddr_currentOrTempOrLatest = addr_1;
+	dc.byteAddr_historicOrMemorized = addr_2;
+	for (unsigned char k=0; k<8; k++)
+		in >> dc.code[k] >> dc.title[k];
+	return in;
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const mb_intl_dt & mb)
+{
+	return out << mb.title << mb.unit << mb.scaleformula << static_cast<qint8>(mb.precision)
+		   << static_cast<quint32>(mb.addr_low) << static_cast<quint32>(mb.addr_high);
+}
+
+
+static QDataStream & operator>>(QDataStream & in, mb_intl_dt & mb)
+{
+	qint8 precision = 0;
+	quint32 addr_low = 0, addr_high = 0;
+	in >> mb.title >> mb.unit >> mb.scaleformula >> precision >> addr_low >> addr_high;
+	mb.precision = precision;
+	mb.addr_low = addr_low;
+	mb.addr_high = addr_high;
+	return in;
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const sw_intl_dt & sw)
+{
+	return out << sw.title << sw.unit << static_cast<quint32>(sw.byteAddr) << static_cast<quint8>(sw.bitAddr);
+}
+
+
+static QDataStream & operator>>(QDataStream & in, sw_intl_dt & sw)
+{
+	quint32 byteAddr = 0;
+	quint8 bitAddr = 0;
+	in >> sw.title >> sw.unit >> byteAddr >> bitAddr;
+	sw.byteAddr = byteAddr;
+	sw.bitAddr = bitAddr;
+	return in;
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const adjustment_intl_dt & adj)
+{
+	return out << adj.title << adj.unit << adj.formula << static_cast<quint32>(adj.rawMin) << static_cast<quint32>(adj.rawMax)
+		   << static_cast<quint32>(adj.rawDefault) << static_cast<qint8>(adj.precision)
+		   << static_cast<quint32>(adj.AddrLow) << static_cast<quint32>(adj.AddrHigh);
+}
+
+
+static QDataStream & operator>>(QDataStream & in, adjustment_intl_dt & adj)
+{
+	quint32 rawMin = 0, rawMax = 0, rawDefault = 0, addrLow = 0, addrHigh = 0;
+	qint8 precision = 0;
+	in >> adj.title >> adj.unit >> adj.formula >> rawMin >> rawMax >> rawDefault >> precision >> addrLow >> addrHigh;
+	adj.rawMin = rawMin;
+	adj.rawMax = rawMax;
+	adj.rawDefault = rawDefault;
+	adj.precision = precision;
+	adj.AddrLow = addrLow;
+	adj.AddrHigh = addrHigh;
+	return in;
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const actuator_dt & act)
+{
+	return out << act.title << static_cast<quint32>(act.byteadr) << static_cast<quint8>(act.bitadr);
+}
+
+
+static QDataStream & operator>>(QDataStream & in, actuator_dt & act)
+{
+	quint32 byteadr = 0;
+	quint8 bitadr = 0;
+	in >> act.title >> byteadr >> bitadr;
+	act.byteadr = byteadr;
+	act.bitadr = bitadr;
+	return in;
+}
+
+
+template <typename T> static void writeVector(QDataStream & out, const std::vector<T> & v)
+{
+	out << static_cast<quint32>(v.size());
+	for (unsigned int k=0; k<v.size(); k++)
+		out << v.at(k);
+}
+
+
+template <typename T> static void readVector(QDataStream & in, std::vector<T> *v)
+{
+	quint32 size = 0;
+	in >> size;
+	v->clear();
+	for (unsigned int k=0; (k<size) && (in.status() == QDataStream::Ok); k++)
+	{
+		T item;
+		in >> item;
+		v->push_back(item);
+	}
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const CUsetupCacheEntry_dt & e)
+{
+	out << static_cast<qint32>(e.protocol) << static_cast<qint32>(e.CU) << e.ID << e.language << e.defsKey;
+	out << e.sysDescription << e.has_OBD2 << e.has_Immo << e.has_TestMode << e.has_ActTest << e.has_MB_engineSpeed << e.has_SW_ignition;
+	writeVector(out, e.DTCdefs);
+	out << e.DTC_fmt_OBD2;
+	writeVector(out, e.MBs);
+	writeVector(out, e.SWs);
+	writeVector(out, e.adjustments);
+	writeVector(out, e.actuators);
+	out << e.has_CM << e.has_CM2 << e.has_VINsupport << e.has_integratedCC;
+	writeVector(out, e.CCCCdefs);
+	out << e.memCCs_supported << static_cast<quint32>(e.CMaddr) << static_cast<qint8>(e.CMvalue);
+	return out;
+}
+
+
+static QDataStream & operator>>(QDataStream & in, CUsetupCacheEntry_dt & e)
+{
+	qint32 protocol = 0, CU = 0;
+	quint32 CMaddr = 0;
+	qint8 CMvalue = 0;
+	in >> protocol >> CU >> e.ID >> e.language >> e.defsKey;
+	e.protocol = protocol;
+	e.CU = CU;
+	in >> e.sysDescription >> e.has_OBD2 >> e.has_Immo >> e.has_TestMode >> e.has_ActTest >> e.has_MB_engineSpeed >> e.has_SW_ignition;
+	readVector(in, &e.DTCdefs);
+	in >> e.DTC_fmt_OBD2;
+	readVector(in, &e.MBs);
+	readVector(in, &e.SWs);
+	readVector(in, &e.adjustments);
+	readVector(in, &e.actuators);
+	in >> e.has_CM >> e.has_CM2 >> e.has_VINsupport >> e.has_integratedCC;
+	readVector(in, &e.CCCCdefs);
+	in >> e.memCCs_supported >> CMaddr >> CMvalue;
+	e.CMaddr = CMaddr;
+	e.CMvalue = CMvalue;
+	return in;
+}
+
+
+
+CUsetupCacheEntry_dt::CUsetupCacheEntry_dt()
+{
+	protocol = 0;
+	CU = 0;
+	has_OBD2 = false;
+	has_Immo = false;
+	has_TestMode = false;
+	has_ActTest = false;
+	has_MB_engineSpeed = false;
+	has_SW_ignition = false;
+	DTC_fmt_OBD2 = false;
+	has_CM = false;
+	has_CM2 = false;
+	has_VINsupport = false;
+	has_integratedCC = false;
+	memCCs_supported = false;
+	CMaddr = MEMORY_ADDRESS_NONE;
+	CMvalue = 0;
+}
+
+
+bool CUsetupCacheEntry_dt::sameIdentity(const CUsetupCacheEntry_dt & entry) const
+{
+	return ((protocol == entry.protocol) && (CU == entry.CU) && (ID == entry.ID)
+		&& (language == entry.language) && (defsKey == entry.defsKey));
+}
+
+
+
+bool CUsetupCache::lookup(const CUsetupCacheEntry_dt & identity, CUsetupCacheEntry_dt *entry)
+{
+	QMutexLocker locker(&_mutex);
+	load();
+	for (unsigned int k=0; k<_entries.size(); k++)
+	{
+		if (_entries.at(k).sameIdentity(identity))
+		{
+			*entry = _entries.at(k);
+			// Move to front (most recently used):
+			if (k > 0)
+			{
+				_entries.erase(_entries.begin() + k);
+				_entries.insert(_entries.begin(), *entry);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void CUsetupCache::store(const CUsetupCacheEntry_dt & entry)
+{
+	QMutexLocker locker(&_mutex);
+	load();
+	for (unsigned int k=0; k<_entries.size(); k++)
+	{
+		if (_entries.at(k).sameIdentity(entry))
+		{
+			_entries.erase(_entries.begin() + k);
+			break;
+		}
+	}
+	_entries.insert(_entries.begin(), entry);
+	if (_entries.size() > CU_SETUP_CACHE_MAX_ENTRIES)
+		_entries.resize(CU_SETUP_CACHE_MAX_ENTRIES);
+	save();
+}
+
+
+bool CUsetupCache::lastCUaddress(QString key, unsigned int *address)
+{
+	QMutexLocker locker(&_mutex);
+	load();
+	if (!_CUaddresses.contains(key))
+		return false;
+	*address = _CUaddresses.value(key);
+	return true;
+}
+
+
+void CUsetupCache::setLastCUaddress(QString key, unsigned int address)
+{
+	QMutexLocker locker(&_mutex);
+	load();
+	if (_CUaddresses.contains(key) && (_CUaddresses.value(key) == address))
+		return;
+	_CUaddresses.insert(key, address);
+	save();
+}
+
+// PRIVATE
+
+QString CUsetupCache::filename()
+{
+	return QDir::homePath() + "/" + CU_SETUP_CACHE_DIRNAME + "/" + CU_SETUP_CACHE_FILENAME;
+}
+
+
+void CUsetupCache::load()
+{
+	QByteArray magic;
+	quint16 version = 0;
+	quint32 nrOfEntries = 0;
+	if (_loaded) return;
+	_loaded = true;
+	QFile file(filename());
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_5);
+	in >> magic >> version;
+	// NOTE: the used definitions are part of the identity of each entry (see defsKey)
+	if ((magic != "FSSMCUSC") || (version != CU_SETUP_CACHE_FORMAT_VERSION))
+		return;
+	in >> _CUaddresses >> nrOfEntries;
+	for (unsigned int k=0; (k<nrOfEntries) && (k<CU_SETUP_CACHE_MAX_ENTRIES); k++)
+	{
+		CUsetupCacheEntry_dt entry;
+		in >> entry;
+		if (in.status() != QDataStream::Ok)
+			break;
+		_entries.push_back(entry);
+	}
+	if (in.status() != QDataStream::Ok)
+	{
+		// Corrupted file: discard all data
+		_entries.clear();
+		_CUaddresses.clear();
+	}
+}
+
+
+bool CUsetupCache::save()
+{
+	QByteArray data;
+	QDataStream out(&data, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_4_5);
+	out << QByteArray("FSSMCUSC") << static_cast<quint16>(CU_SETUP_CACHE_FORMAT_VERSION);
+	out << _CUaddresses << static_cast<quint32>(_entries.size());
+	for (unsigned int k=0; k<_entries.size(); k++)
+		out << _entries.at(k);
+	// Write to a temporary file first, an incomplete file must never be used:
+	if (!QDir().mkpath(QDir::homePath() + "/" + CU_SETUP_CACHE_DIRNAME))
+		return false;
+	QFile file(filename() + ".tmp");
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	bool ok = (file.write(data) == data.size());
+	file.close();
+	if (ok)
+	{
+		QFile::remove(filename());
+		ok = QFile::rename(filename() + ".tmp", filename());
+	}
+	if (!ok)
+		QFile::remove(filename() + ".tmp");
+	return ok;
+}
@@ -0,0 +1,102 @@
+/*
+ * CUsetupCache.h - Persistent cache of control unit setups
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUSETUPCACHE_H
+#define CUSETUPCACHE_H
+
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <vector>
+#include "SSMprotocol.h"
+
+
+#define		CU_SETUP_CACHE_FORMAT_VERSION	2	// NOTE: increase if the setup resolution changes
+#define		CU_SETUP_CACHE_MAX_ENTRIES	32
+#define		CU_SETUP_CACHE_DIRNAME		"FreeSSM.cache"
+#define		CU_SETUP_CACHE_FILENAME		"CUsetups.bin"
+
+
+
+/* NOTE: the identity consists of all data which determines the setup of a control unit:
+ *       protocol, CU type, ID bytes (SYS-ID, ROM-ID, flagbytes, ...), language and a
+ *       key for the used definitions (e.g. definitions file size and modification time) */
+
+class CUsetupCacheEntry_dt
+{
+public:
+	CUsetupCacheEntry_dt();
+	bool sameIdentity(const CUsetupCacheEntry_dt & entry) const;
+	// Identity:
+	int protocol;
+	int CU;
+	QByteArray ID;
+	QString language;
+	QString defsKey;
+	// Control unit setup (common):
+	QString sysDescription;
+	bool has_OBD2;
+	bool has_Immo;
+	bool has_TestMode;
+	bool has_ActTest;
+	bool has_MB_engineSpeed;
+	bool has_SW_ignition;
+	std::vector<dc_defs_dt> DTCdefs;
+	bool DTC_fmt_OBD2;
+	std::vector<mb_intl_dt> MBs;
+	std::vector<sw_intl_dt> SWs;
+	std::vector<adjustment_intl_dt> adjustments;
+	std::vector<actuator_dt> actuators;
+	// Control unit setup (protocol specific):
+	bool has_CM;
+	bool has_CM2;
+	bool has_VINsupport;
+	bool has_integratedCC;
+	std::vector<dc_defs_dt> CCCCdefs;
+	bool memCCs_supported;
+	unsigned int CMaddr;
+	char CMvalue;
+};
+
+
+
+class CUsetupCache
+{
+
+public:
+	static bool lookup(const CUsetupCacheEntry_dt & identity, CUsetupCacheEntry_dt *entry);
+	static void store(const CUsetupCacheEntry_dt & entry);
+	static bool lastCUaddress(QString key, unsigned int *address);
+	static void setLastCUaddress(QString key, unsigned int address);
+
+private:
+	static QMutex _mutex;
+	static bool _loaded;
+	static std::vector<CUsetupCacheEntry_dt> _entries;	// most recently used first
+	static QMap<QString, unsigned int> _CUaddresses;
+
+	static QString filename();
+	static void load();
+	static bool save();
+};
+
+
+#endif
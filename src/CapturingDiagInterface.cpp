@@ -0,0 +1,204 @@
+/*
+ * CapturingDiagInterface.cpp - Diagnostic interface wrapper which captures all interface traffic
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CapturingDiagInterface.h"
+
+
+static void appendLE(std::vector<char> *buf, unsigned int value, unsigned char nrOfBytes)
+{
+	for (unsigned char k=0; k<nrOfBytes; k++)
+		buf->push_back( static_cast<char>((value >> (8*k)) & 0xFF) );
+}
+
+
+
+CapturingDiagInterface::CapturingDiagInterface(AbstractDiagInterface *diagInterface, std::string capturefilename)
+{
+	_diagInterface = diagInterface;
+	_capturefilename = capturefilename;
+	syncProperties();
+}
+
+
+CapturingDiagInterface::~CapturingDiagInterface()
+{
+	close();
+	delete _diagInterface;
+}
+
+
+AbstractDiagInterface::interface_type CapturingDiagInterface::interfaceType()
+{
+	return _diagInterface->interfaceType();
+}
+
+
+bool CapturingDiagInterface::open( std::string name )
+{
+	QMutexLocker locker(&_captureMutex);
+	if (_capturefile.is_open())
+		return false;
+	_capturefile.open(sessionFileName().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_capturefile.is_open())
+		return false;
+	_time.start();
+	bool ok = _diagInterface->open(name);
+	syncProperties();
+	// Write header:
+	std::vector<char> header;
+	std::string ifacename = AbstractDiagInterface::name();
+	header.insert(header.end(), "FSSMCAP", "FSSMCAP" + 7);
+	header.push_back(DIAGCAPTURE_FORMAT_VERSION);
+	header.push_back(interfaceType());
+	appendLE(&header, ifacename.size(), 2);
+	header.insert(header.end(), ifacename.begin(), ifacename.end());
+	_capturefile.write(&header.at(0), header.size());
+	locker.unlock();
+	capture(DiagCaptureRecord_dt::ev_open, ok, std::vector<char>(name.begin(), name.end()));
+	if (!ok)
+	{
+		locker.relock();
+		_capturefile.close();
+	}
+	return ok;
+}
+
+
+bool CapturingDiagInterface::isOpen()
+{
+	return _diagInterface->isOpen();
+}
+
+
+bool CapturingDiagInterface::close()
+{
+	// NOTE: always close the wrapped interface, even if the capture file couldn't be opened
+	bool ok = _diagInterface->close();
+	syncProperties();
+	capture(DiagCaptureRecord_dt::ev_close, ok);
+	QMutexLocker locker(&_captureMutex);
+	if (_capturefile.is_open())
+		_capturefile.close();
+	return ok;
+}
+
+
+bool CapturingDiagInterface::connect(AbstractDiagInterface::protocol_type protocol)
+{
+	bool ok = _diagInterface->connect(protocol);
+	syncProperties();
+	std::vector<char> data;
+	data.push_back(protocol);
+	appendLE(&data, protocolBaudRate(), 4);
+	capture(DiagCaptureRecord_dt::ev_connect, ok, data);
+	return ok;
+}
+
+
+bool CapturingDiagInterface::isConnected()
+{
+	return _diagInterface->isConnected();
+}
+
+
+bool CapturingDiagInterface::disconnect()
+{
+	bool ok = _diagInterface->disconnect();
+	syncProperties();
+	capture(DiagCaptureRecord_dt::ev_disconnect, ok);
+	return ok;
+}
+
+
+bool CapturingDiagInterface::read(std::vector<char> *buffer)
+{
+	bool ok = _diagInterface->read(buffer);
+	// NOTE: the interfaces are polled, do not capture empty reads
+	if (!ok || buffer->size())
+		capture(DiagCaptureRecord_dt::ev_read, ok, *buffer);
+	return ok;
+}
+
+
+bool CapturingDiagInterface::write(std::vector<char> buffer)
+{
+	bool ok = _diagInterface->write(buffer);
+	capture(DiagCaptureRecord_dt::ev_write, ok, buffer);
+	return ok;
+}
+
+
+bool CapturingDiagInterface::clearSendBuffer()
+{
+	bool ok = _diagInterface->clearSendBuffer();
+	capture(DiagCaptureRecord_dt::ev_clearSendBuffer, ok);
+	return ok;
+}
+
+
+bool CapturingDiagInterface::clearReceiveBuffer()
+{
+	bool ok = _diagInterface->clearReceiveBuffer();
+	capture(DiagCaptureRecord_dt::ev_clearReceiveBuffer, ok);
+	return ok;
+}
+
+// PRIVATE
+
+void CapturingDiagInterface::capture(DiagCaptureRecord_dt::event_dt event, bool result, const std::vector<char> & data)
+{
+	QMutexLocker locker(&_captureMutex);
+	if (!_capturefile.is_open())
+		return;
+	std::vector<char> record;
+	appendLE(&record, _time.elapsed(), 4);
+	record.push_back(event);
+	record.push_back(result);
+	appendLE(&record, data.size(), 4);
+	record.insert(record.end(), data.begin(), data.end());
+	_capturefile.write(&record.at(0), record.size());
+	// NOTE: flush immediately, the capture must survive crashes and hangs of the communication
+	_capturefile.flush();
+}
+
+
+void CapturingDiagInterface::syncProperties()
+{
+	setName(_diagInterface->name());
+	setVersion(_diagInterface->version());
+	setSupportedProtocols(_diagInterface->supportedProtocols());
+	setProtocolType(_diagInterface->protocolType());
+	setProtocolBaudrate(_diagInterface->protocolBaudRate());
+}
+
+
+std::string CapturingDiagInterface::sessionFileName()
+{
+	// NOTE: a new file for each session, the interface is opened again for each control unit dialog/scan
+	QFileInfo info( QString::fromStdString(_capturefilename) );
+	QString base = info.completeBaseName() + "_" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmsszzz");
+	QString suffix = info.suffix().size() ? ("." + info.suffix()) : QString();
+	QString filename = info.dir().filePath(base + suffix);
+	for (unsigned int n=1; QFile::exists(filename); n++)
+		filename = info.dir().filePath(base + "_" + QString::number(n) + suffix);
+#ifdef __FSSM_DEBUG__
+	std::cout << "CapturingDiagInterface::sessionFileName():   capturing to " << filename.toLocal8Bit().constData() << '\n';
+#endif
+	return filename.toLocal8Bit().constData();
+}
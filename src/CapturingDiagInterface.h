@@ -0,0 +1,102 @@
+/*
+ * CapturingDiagInterface.h - Diagnostic interface wrapper which captures all interface traffic
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAPTURINGDIAGINTERFACE_H
+#define CAPTURINGDIAGINTERFACE_H
+
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <QMutex>
+#include <QString>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include "AbstractDiagInterface.h"
+#ifdef __WIN32__
+    #include "windows\TimeM.h"
+#elif defined __linux__
+    #include "linux/TimeM.h"
+#else
+    #error "Operating system not supported !"
+#endif
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
+
+
+/* Capture file layout (all values little endian):
+ *   header:  "FSSMCAP", u8 version, u8 interface type, u16 name length, interface name
+ *   records: u32 time (ms since start of capture), u8 event, u8 result, u32 data length, data
+ *            connect: data = u8 protocol, u32 baud rate
+ *            read:    only non-empty or failed reads are captured
+ * Each session (open() ... close()) is captured to its own file: <name>_<date>-<time>[_<n>][.<suffix>]
+ */
+
+#define		DIAGCAPTURE_FORMAT_VERSION	1
+
+
+class DiagCaptureRecord_dt
+{
+public:
+	enum event_dt {ev_open, ev_close, ev_connect, ev_disconnect, ev_write, ev_read, ev_clearSendBuffer, ev_clearReceiveBuffer};
+	DiagCaptureRecord_dt() { time_ms=0; event=ev_open; result=false; };
+	unsigned int time_ms;
+	event_dt event;
+	bool result;
+	std::vector<char> data;
+};
+
+
+
+class CapturingDiagInterface : public AbstractDiagInterface
+{
+
+public:
+	CapturingDiagInterface(AbstractDiagInterface *diagInterface, std::string capturefilename);
+	~CapturingDiagInterface();
+	interface_type interfaceType();
+	bool open( std::string name );
+	bool isOpen();
+	bool close();
+	bool connect(AbstractDiagInterface::protocol_type protocol);
+	bool isConnected();
+	bool disconnect();
+	bool read(std::vector<char> *buffer);
+	bool write(std::vector<char> buffer);
+	bool clearSendBuffer();
+	bool clearReceiveBuffer();
+
+private:
+	AbstractDiagInterface *_diagInterface;
+	std::string _capturefilename;	// base name
+	std::ofstream _capturefile;
+	QMutex _captureMutex;	// NOTE: the interface is used by the GUI and the communication thread
+	TimeM _time;
+
+	void capture(DiagCaptureRecord_dt::event_dt event, bool result, const std::vector<char> & data = std::vector<char>());
+	void syncProperties();
+	std::string sessionFileName();
+
+};
+
+
+#endif
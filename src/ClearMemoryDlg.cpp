@@ -247,14 +247,11 @@ ClearMemoryDlg::CMresult_dt ClearMemoryDlg::restoreAdjustmentValues(std::vector<
 	// Restore all adjustment values:
 	FSSM_WaitMsgBox waitmsgbox(_parent, tr("Restoring Adjustment Values... Please wait !"));
 	waitmsgbox.show();
-	for (unsigned char m=0; m<oldAdjVal.size(); m++)
+	if (!_SSMPdev->setAllAdjustmentValues(oldAdjVal))
 	{
-		if (!_SSMPdev->setAdjustmentValue(m, oldAdjVal.at(m)))
-		{
-			waitmsgbox.close();
-			return CMresult_communicationError;
-			/* NOTE: we don't know if we really have a communication error... */
-		}
+		waitmsgbox.close();
+		return CMresult_communicationError;
+		/* NOTE: we don't know if we really have a communication error... */
 	}
 	// To be sure: read and verify value again
 	ok = _SSMPdev->getAllAdjustmentValues(&currentAdjVal);
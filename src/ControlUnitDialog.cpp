@@ -73,6 +73,8 @@ ControlUnitDialog::~ControlUnitDialog()
 	if (_SSMPdev)
 	{
 		disconnect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
+		disconnect( _SSMPdev, SIGNAL( commInterrupted() ), this, SLOT( communicationInterrupted() ) );
+		disconnect( _SSMPdev, SIGNAL( commResumed() ), this, SLOT( communicationResumed() ) );
 		delete _SSMPdev;
 	}
 	for (int k=0; k<_selButtons.size(); k++)
@@ -152,50 +154,41 @@ SSMprotocol::CUsetupResult_dt ControlUnitDialog::probeProtocol(SSMprotocol::CUty
 	/* NOTE:  probe SSM2-protocol first !
 	   If a serial pass through (K)KL-interface is used, the interface echo could be detected as a SSM1-ROM-ID,
 	   if receive buffer flushing doesn't work reliable with the used serial port driver !
+	   Exception: the SSM2-protocol of the last vehicle scan is probed first (SSM1 is always probed last)
 	*/
 	SSMprotocol::CUsetupResult_dt result = SSMprotocol::result_commError;
+	std::vector<AbstractDiagInterface::protocol_type> protocols;
 	if ((CUtype == SSMprotocol::CUtype_Engine) || (CUtype == SSMprotocol::CUtype_Transmission))
 	{
-		// Probe SSM2-protocol:
-		_SSMPdev = new SSMprotocol2(_diagInterface, _language);
-		if (_diagInterface->connect(AbstractDiagInterface::protocol_SSM2_ISO15765))
-		{
-			result = _SSMPdev->setupCUdata( CUtype );
-			if ((result != SSMprotocol::result_success) && (result != SSMprotocol::result_noOrInvalidDefsFile) && (result != SSMprotocol::result_noDefs))
-				_diagInterface->disconnect();
-		}
-		if (!_diagInterface->isConnected())
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO15765);
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO14230);
+	}
+	protocols.push_back(AbstractDiagInterface::protocol_SSM1);
+	VehicleTopologyCache::preferLastProtocol(CUtype, &protocols);
+	for (unsigned int k=0; (k<protocols.size()) && (_SSMPdev == NULL); k++)
+	{
+		if (!_diagInterface->connect(protocols.at(k)))
+			continue;
+		if (protocols.at(k) == AbstractDiagInterface::protocol_SSM1)
+			_SSMPdev = new SSMprotocol1(_diagInterface, _language);
+		else
+			_SSMPdev = new SSMprotocol2(_diagInterface, _language);
+		result = _SSMPdev->setupCUdata( CUtype );
+		if ((result == SSMprotocol::result_success) || (result == SSMprotocol::result_noOrInvalidDefsFile) || (result == SSMprotocol::result_noDefs))
 		{
-		  	if (_diagInterface->connect(AbstractDiagInterface::protocol_SSM2_ISO14230))
+			connect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
+			if (protocols.at(k) != AbstractDiagInterface::protocol_SSM1)
 			{
-				result = _SSMPdev->setupCUdata( CUtype );
-				if ((result != SSMprotocol::result_success) && (result != SSMprotocol::result_noOrInvalidDefsFile) && (result != SSMprotocol::result_noDefs))
-					_diagInterface->disconnect();
+				// Automatic resume after communication errors:
+				connect( _SSMPdev, SIGNAL( commInterrupted() ), this, SLOT( communicationInterrupted() ) );
+				connect( _SSMPdev, SIGNAL( commResumed() ), this, SLOT( communicationResumed() ) );
 			}
 		}
-		if (_diagInterface->isConnected())
-			connect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
 		else
 		{
 			delete _SSMPdev;
 			_SSMPdev = NULL;
-		}
-	}
-	if (_SSMPdev == NULL)
-	{
-		// Probe SSM1-protocol:
-		if (_diagInterface->connect(AbstractDiagInterface::protocol_SSM1))
-		{
-			_SSMPdev = new SSMprotocol1(_diagInterface, _language);
-			result = _SSMPdev->setupCUdata( CUtype );
-			if ((result == SSMprotocol::result_success) || (result == SSMprotocol::result_noOrInvalidDefsFile) || (result == SSMprotocol::result_noDefs))
-				connect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
-			else
-			{
-				delete _SSMPdev;
-				_SSMPdev = NULL;
-				_diagInterface->disconnect();
-			}
+			_diagInterface->disconnect();
 		}
 	}
 	// Update diagnostic interface status bar:
@@ -240,6 +233,19 @@ void ControlUnitDialog::communicationError(QString addstr)
 }
 
 
+void ControlUnitDialog::communicationInterrupted()
+{
+	// Indicate the resume attempt:
+	_ifstatusbar->setProtocolName( QString::fromStdString( _diagInterface->protocolDescription() ), Qt::red );
+}
+
+
+void ControlUnitDialog::communicationResumed()
+{
+	_ifstatusbar->setProtocolName( QString::fromStdString( _diagInterface->protocolDescription() ), Qt::darkGreen );
+}
+
+
 void ControlUnitDialog::closeEvent(QCloseEvent *event)
 {
 	if (_SSMPdev)
@@ -22,11 +22,14 @@
 
 
 #include <QtGui>
+#include <vector>
+#include <algorithm>
 #include "ui_ControlUnitDialog.h"
 #include "DiagInterfaceStatusBar.h"
 #include "AbstractDiagInterface.h"
 #include "SSMprotocol1.h"
 #include "SSMprotocol2.h"
+#include "VehicleScan.h"
 #include "FSSMdialogs.h"
 
 
@@ -61,6 +64,8 @@ private:
 
 protected slots:
 	void communicationError(QString addstr = "");
+	void communicationInterrupted();
+	void communicationResumed();
 
 };
 
@@ -0,0 +1,189 @@
+/*
+ * DiagInterfaceDetector.cpp - Automatic detection of diagnostic interfaces
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagInterfaceDetector.h"
+
+
+
+DiagInterfaceProbe::DiagInterfaceProbe(QString filename, bool J2534library)
+{
+	_filename = filename;
+	_J2534library = J2534library;
+	_found = false;
+	_result.type = AbstractDiagInterface::interface_serialPassThrough;
+	_result.identified = false;
+	_result.probeDuration_ms = 0;
+}
+
+
+bool DiagInterfaceProbe::result(detectedDiagInterface_dt *detectedInterface)
+{
+	if (isRunning() || !_found) return false;
+	*detectedInterface = _result;
+	return true;
+}
+
+// PRIVATE
+
+void DiagInterfaceProbe::run()
+{
+	QTime time;
+	time.start();
+	if (_J2534library)
+		_found = probe(new J2534DiagInterface);
+	else
+		_found = probe(new ATcommandControlledDiagInterface) || probe(new SerialPassThroughDiagInterface);
+	_result.probeDuration_ms = time.elapsed();
+#ifdef __FSSM_DEBUG__
+	std::cout << "DiagInterfaceProbe::run():   " << _filename.toStdString() << ": ";
+	if (_found)
+		std::cout << _result.name.toStdString() << " " << _result.version.toStdString();
+	else
+		std::cout << "no interface";
+	std::cout << " (" << std::dec << _result.probeDuration_ms << " ms)\n";
+#endif
+}
+
+
+bool DiagInterfaceProbe::probe(AbstractDiagInterface *diagInterface)
+{
+	bool ok = diagInterface->open(_filename.toStdString());
+	if (ok)
+	{
+		if (diagInterface->interfaceType() == AbstractDiagInterface::interface_serialPassThrough)
+			ok = echoTest(diagInterface);
+		if (ok)
+		{
+			_result.type = diagInterface->interfaceType();
+			_result.filename = _filename;
+			_result.name = QString::fromStdString(diagInterface->name());
+			_result.version = QString::fromStdString(diagInterface->version());
+			_result.protocols = diagInterface->supportedProtocols();
+			if (_result.type == AbstractDiagInterface::interface_serialPassThrough)
+			{
+				// An echo means ISO-14230 (SSM2), see SerialPassThroughDiagInterface
+				_result.protocols.clear();
+				_result.protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO14230);
+				_result.identified = false;
+			}
+			else if (_result.type == AbstractDiagInterface::interface_J2534)
+				_result.identified = !_result.version.isEmpty();	// version could be read from the device
+			else
+				_result.identified = true;
+		}
+		diagInterface->close();
+	}
+	delete diagInterface;
+	return ok;
+}
+
+
+bool DiagInterfaceProbe::echoTest(AbstractDiagInterface *diagInterface)
+{
+	/* NOTE: K-line interfaces echo all sent bytes, but only if they are powered.
+	 *       SSM1-interfaces have no echo, so they can not be detected this way.
+	 *       The test bytes are neither a valid SSM1 command nor a SSM2 header. */
+	const char testbytes[2] = {'\x55', '\x33'};
+	std::vector<char> testmsg(testbytes, testbytes + 2);
+	std::vector<char> echo;
+	std::vector<char> buffer;
+	QTime time;
+	if (!diagInterface->connect(AbstractDiagInterface::protocol_SSM2_ISO14230))
+		return false;
+	diagInterface->clearReceiveBuffer();
+	if (diagInterface->write(testmsg))
+	{
+		time.start();
+		while ((echo.size() < testmsg.size()) && (time.elapsed() < IFDETECTION_ECHO_TIMEOUT))
+		{
+			if (!diagInterface->read(&buffer))
+				break;
+			if (buffer.size())
+				echo.insert(echo.end(), buffer.begin(), buffer.end());
+			else
+				msleep(10);
+		}
+	}
+	diagInterface->disconnect();
+	return (echo == testmsg);
+}
+
+
+
+DiagInterfaceDetector::DiagInterfaceDetector()
+{
+	_nrOfRunningProbes = 0;
+}
+
+
+std::vector<detectedDiagInterface_dt> DiagInterfaceDetector::detectInterfaces()
+{
+	std::vector<DiagInterfaceProbe*> probes;
+	std::vector<detectedDiagInterface_dt> interfaces;
+	detectedDiagInterface_dt detectedInterface;
+	// Setup probes for all serial ports and J2534 libraries:
+	std::vector<std::string> portlist = serialCOM::GetAvailablePorts();
+	for (unsigned int k=0; k<portlist.size(); k++)
+		probes.push_back( new DiagInterfaceProbe(QString::fromStdString(portlist.at(k)), false) );
+	std::vector<J2534Library> J2534libs = J2534_API::getAvailableJ2534Libs();
+	for (unsigned int k=0; k<J2534libs.size(); k++)
+		probes.push_back( new DiagInterfaceProbe(QString::fromStdString(J2534libs.at(k).path), true) );
+	// Start all probes and wait until they have finished:
+	_nrOfRunningProbes = probes.size();
+	for (unsigned int k=0; k<probes.size(); k++)
+	{
+		connect( probes.at(k), SIGNAL( finished() ), this, SLOT( probeFinished() ) );
+		probes.at(k)->start();
+	}
+	if (_nrOfRunningProbes)
+		_el.exec();
+	// Collect results:
+	for (unsigned int k=0; k<probes.size(); k++)
+	{
+		probes.at(k)->wait();
+		disconnect( probes.at(k), SIGNAL( finished() ), this, SLOT( probeFinished() ) );
+		if (probes.at(k)->result(&detectedInterface))
+			interfaces.push_back(detectedInterface);
+		delete probes.at(k);
+	}
+	std::stable_sort(interfaces.begin(), interfaces.end(), rankedHigher);
+	return interfaces;
+}
+
+// PRIVATE
+
+bool DiagInterfaceDetector::rankedHigher(const detectedDiagInterface_dt & a, const detectedDiagInterface_dt & b)
+{
+	// Identified interfaces first, then nr. of supported protocols, then probe duration:
+	if (a.identified != b.identified)
+		return a.identified;
+	if (a.protocols.size() != b.protocols.size())
+		return (a.protocols.size() > b.protocols.size());
+	return (a.probeDuration_ms < b.probeDuration_ms);
+}
+
+
+void DiagInterfaceDetector::probeFinished()
+{
+	// NOTE: signals are queued (probes are running in their own threads)
+	if (_nrOfRunningProbes > 0)
+		_nrOfRunningProbes--;
+	if (!_nrOfRunningProbes)
+		_el.quit();
+}
@@ -0,0 +1,105 @@
+/*
+ * DiagInterfaceDetector.h - Automatic detection of diagnostic interfaces
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIAGINTERFACEDETECTOR_H
+#define DIAGINTERFACEDETECTOR_H
+
+
+#ifdef __WIN32__
+    #include "windows\serialCOM.h"
+    #include "windows\J2534_API.h"
+#elif defined __linux__
+    #include "linux/serialCOM.h"
+    #include "linux/J2534_API.h"
+#else
+    #error "Operating system not supported !"
+#endif
+#include <QtGui>
+#include <vector>
+#include <algorithm>
+#include "AbstractDiagInterface.h"
+#include "SerialPassThroughDiagInterface.h"
+#include "ATcommandControlledDiagInterface.h"
+#include "J2534DiagInterface.h"
+
+
+#define		IFDETECTION_ECHO_TIMEOUT	200	// [ms]
+
+
+
+class detectedDiagInterface_dt
+{
+public:
+	AbstractDiagInterface::interface_type type;
+	QString filename;	// device file or J2534 library path
+	QString name;
+	QString version;
+	std::vector<AbstractDiagInterface::protocol_type> protocols;
+	bool identified;	// interface has reported its name/version
+	unsigned int probeDuration_ms;
+};
+
+
+
+class DiagInterfaceProbe : public QThread
+{
+	Q_OBJECT
+
+public:
+	DiagInterfaceProbe(QString filename, bool J2534library);
+	bool result(detectedDiagInterface_dt *detectedInterface);
+
+private:
+	QString _filename;
+	bool _J2534library;
+	bool _found;
+	detectedDiagInterface_dt _result;
+
+	void run();
+	bool probe(AbstractDiagInterface *diagInterface);
+	bool echoTest(AbstractDiagInterface *diagInterface);
+
+};
+
+
+
+/* NOTE: all serial ports and J2534 libraries are probed concurrently (one thread per port/library).
+ *       Serial ports are probed for AT-command controlled interfaces first, because they echo, too. */
+
+class DiagInterfaceDetector : public QObject
+{
+	Q_OBJECT
+
+public:
+	DiagInterfaceDetector();
+	std::vector<detectedDiagInterface_dt> detectInterfaces();
+
+private:
+	QEventLoop _el;
+	unsigned int _nrOfRunningProbes;
+
+	static bool rankedHigher(const detectedDiagInterface_dt & a, const detectedDiagInterface_dt & b);
+
+private slots:
+	void probeFinished();
+
+};
+
+
+#endif
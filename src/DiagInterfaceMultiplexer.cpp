@@ -0,0 +1,268 @@
+/*
+ * DiagInterfaceMultiplexer.cpp - Shared use of one ISO-15765 interface by several control unit sessions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagInterfaceMultiplexer.h"
+
+
+
+MultiplexedDiagInterface::MultiplexedDiagInterface(DiagInterfaceMultiplexer *mux, unsigned int CUaddress)
+{
+	_mux = mux;
+	_CUaddress = CUaddress;
+	_connected = false;
+	setName(_mux->_diagInterface->name());
+	setVersion(_mux->_diagInterface->version());
+	setSupportedProtocols(std::vector<protocol_type>(1, protocol_SSM2_ISO15765));
+}
+
+
+AbstractDiagInterface::interface_type MultiplexedDiagInterface::interfaceType()
+{
+	return _mux->_diagInterface->interfaceType();
+}
+
+
+bool MultiplexedDiagInterface::open( std::string /* name */ )
+{
+	// NOTE: the shared interface is opened by its owner
+	return isOpen();
+}
+
+
+bool MultiplexedDiagInterface::isOpen()
+{
+	return _mux->_diagInterface->isOpen();
+}
+
+
+bool MultiplexedDiagInterface::close()
+{
+	disconnect();
+	return true;
+}
+
+
+bool MultiplexedDiagInterface::connect(AbstractDiagInterface::protocol_type protocol)
+{
+	if (protocol != protocol_SSM2_ISO15765)
+		return false;
+	if (!_mux->connect(protocol))
+		return false;
+	_connected = true;
+	setProtocolType(protocol);
+	setProtocolBaudrate(_mux->_diagInterface->protocolBaudRate());
+	return true;
+}
+
+
+bool MultiplexedDiagInterface::isConnected()
+{
+	return (_connected && _mux->_diagInterface->isConnected());
+}
+
+
+bool MultiplexedDiagInterface::disconnect()
+{
+	// NOTE: the shared interface stays connected for the other channels
+	QMutexLocker locker(&_mux->_mutex);
+	_mux->releaseBus(this);
+	_rxQueue.clear();
+	_connected = false;
+	setProtocolType(protocol_NONE);
+	setProtocolBaudrate(0);
+	return true;
+}
+
+
+bool MultiplexedDiagInterface::read(std::vector<char> *buffer)
+{
+	if (!_connected)
+		return false;
+	return _mux->read(this, buffer);
+}
+
+
+bool MultiplexedDiagInterface::write(std::vector<char> buffer)
+{
+	if (!_connected || (buffer.size() < 4))
+		return false;
+	unsigned int msgaddr = ((static_cast<unsigned char>(buffer.at(0)) << 24)
+			       + (static_cast<unsigned char>(buffer.at(1)) << 16)
+			       + (static_cast<unsigned char>(buffer.at(2)) << 8)
+			       +  static_cast<unsigned char>(buffer.at(3)));
+	if (msgaddr != _CUaddress)
+	{
+#ifdef __FSSM_DEBUG__
+		std::cout << "MultiplexedDiagInterface::write():   error: CAN-ID 0x" << std::hex << msgaddr
+		          << " does not belong to this channel (0x" << _CUaddress << ") !\n";
+#endif
+		return false;
+	}
+	return _mux->write(this, buffer);
+}
+
+
+bool MultiplexedDiagInterface::clearSendBuffer()
+{
+	// NOTE: the send buffer of the shared interface may contain requests of other channels
+	return _connected;
+}
+
+
+bool MultiplexedDiagInterface::clearReceiveBuffer()
+{
+	if (!_connected)
+		return false;
+	QMutexLocker locker(&_mux->_mutex);
+	_rxQueue.clear();
+	return true;
+}
+
+
+unsigned int MultiplexedDiagInterface::CUaddress()
+{
+	return _CUaddress;
+}
+
+
+
+DiagInterfaceMultiplexer::DiagInterfaceMultiplexer(AbstractDiagInterface *diagInterface)
+{
+	_diagInterface = diagInterface;
+	_busOwner = NULL;
+}
+
+
+DiagInterfaceMultiplexer::~DiagInterfaceMultiplexer()
+{
+	// NOTE: the shared interface is not deleted, it belongs to the caller
+	for (unsigned int k=0; k<_channels.size(); k++)
+		delete _channels.at(k);
+}
+
+
+AbstractDiagInterface * DiagInterfaceMultiplexer::channel(unsigned int CUaddress)
+{
+	QMutexLocker locker(&_mutex);
+	if ((CUaddress < 0x7E0) || (CUaddress > 0x7E7))	// ISO15765-4 11 bit CAN IDs for physical addressing
+		return NULL;
+	for (unsigned int k=0; k<_channels.size(); k++)
+	{
+		if (_channels.at(k)->_CUaddress == CUaddress)
+			return _channels.at(k);
+	}
+	_channels.push_back( new MultiplexedDiagInterface(this, CUaddress) );
+	return _channels.back();
+}
+
+
+AbstractDiagInterface * DiagInterfaceMultiplexer::diagInterface()
+{
+	return _diagInterface;
+}
+
+// PRIVATE
+
+bool DiagInterfaceMultiplexer::write(MultiplexedDiagInterface *channel, const std::vector<char> & buffer)
+{
+	QMutexLocker locker(&_mutex);
+	// Wait until the pending request of another channel has been answered:
+	while ((_busOwner != NULL) && (_busOwner != channel))
+	{
+		int remaining_ms = DIAGMUX_REQUEST_TIMEOUT - _requestTime.elapsed();
+		if (remaining_ms <= 0)
+		{
+#ifdef __FSSM_DEBUG__
+			std::cout << "DiagInterfaceMultiplexer::write():   request of channel 0x" << std::hex << _busOwner->_CUaddress
+			          << " timed out, releasing bus\n";
+#endif
+			_busOwner = NULL;
+			break;
+		}
+		_busReleased.wait(&_mutex, remaining_ms);
+	}
+	// Discard late replies to previous requests of this channel:
+	channel->_rxQueue.clear();
+	_busOwner = channel;
+	_requestTime.start();
+	if (!_diagInterface->write(buffer))
+	{
+		releaseBus(channel);
+		return false;
+	}
+	return true;
+}
+
+
+bool DiagInterfaceMultiplexer::read(MultiplexedDiagInterface *channel, std::vector<char> *buffer)
+{
+	QMutexLocker locker(&_mutex);
+	std::vector<char> rx_buffer;
+	buffer->clear();
+	if (!_diagInterface->read(&rx_buffer))
+		return false;
+	// Demultiplex by CAN-ID (NOTE: rx_buffer contains max. one message):
+	if (rx_buffer.size() >= 4)
+	{
+		unsigned int msgaddr = ((static_cast<unsigned char>(rx_buffer.at(0)) << 24)
+				       + (static_cast<unsigned char>(rx_buffer.at(1)) << 16)
+				       + (static_cast<unsigned char>(rx_buffer.at(2)) << 8)
+				       +  static_cast<unsigned char>(rx_buffer.at(3)));
+		MultiplexedDiagInterface *rx_channel = NULL;
+		for (unsigned int k=0; k<_channels.size(); k++)
+		{
+			if ((_channels.at(k)->_CUaddress + 8) == msgaddr)
+			{
+				rx_channel = _channels.at(k);
+				break;
+			}
+		}
+		if (rx_channel != NULL)
+		{
+			rx_channel->_rxQueue.insert(rx_channel->_rxQueue.end(), rx_buffer.begin(), rx_buffer.end());
+			releaseBus(rx_channel);
+		}
+#ifdef __FSSM_DEBUG__
+		else
+			std::cout << "DiagInterfaceMultiplexer::read():   discarding message with unknown CAN-ID 0x" << std::hex << msgaddr << '\n';
+#endif
+	}
+	buffer->swap(channel->_rxQueue);
+	return true;
+}
+
+
+bool DiagInterfaceMultiplexer::connect(AbstractDiagInterface::protocol_type protocol)
+{
+	QMutexLocker locker(&_mutex);
+	if (_diagInterface->isConnected())
+		return (_diagInterface->protocolType() == protocol);
+	return _diagInterface->connect(protocol);
+}
+
+
+void DiagInterfaceMultiplexer::releaseBus(MultiplexedDiagInterface *channel)
+{
+	// NOTE: _mutex must be locked by the caller
+	if (_busOwner == channel)
+	{
+		_busOwner = NULL;
+		_busReleased.wakeAll();
+	}
+}
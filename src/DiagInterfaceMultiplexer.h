@@ -0,0 +1,111 @@
+/*
+ * DiagInterfaceMultiplexer.h - Shared use of one ISO-15765 interface by several control unit sessions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIAGINTERFACEMULTIPLEXER_H
+#define DIAGINTERFACEMULTIPLEXER_H
+
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTime>
+#include <string>
+#include <vector>
+#include "AbstractDiagInterface.h"
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
+
+
+#define		DIAGMUX_REQUEST_TIMEOUT		2000	// [ms], SSM2_READ_TIMEOUT
+
+
+class DiagInterfaceMultiplexer;
+
+
+
+/* NOTE: a channel is the interface of one control unit session (SSMprotocol2).
+ *       It only sends to and receives from one CAN-ID (reply ID = request ID + 8).
+ *       Opening/closing and disconnecting a channel does not affect the shared interface. */
+
+class MultiplexedDiagInterface : public AbstractDiagInterface
+{
+
+public:
+	interface_type interfaceType();
+	bool open( std::string name );
+	bool isOpen();
+	bool close();
+	bool connect(AbstractDiagInterface::protocol_type protocol);
+	bool isConnected();
+	bool disconnect();
+	bool read(std::vector<char> *buffer);
+	bool write(std::vector<char> buffer);
+	bool clearSendBuffer();
+	bool clearReceiveBuffer();
+	unsigned int CUaddress();
+
+private:
+	DiagInterfaceMultiplexer *_mux;
+	unsigned int _CUaddress;
+	bool _connected;
+	std::vector<char> _rxQueue;	// complete messages received for this channel
+
+	MultiplexedDiagInterface(DiagInterfaceMultiplexer *mux, unsigned int CUaddress);
+
+	friend class DiagInterfaceMultiplexer;
+
+};
+
+
+
+/* NOTE: requests of all channels are interleaved on message level: a channel can send its request
+ *       when the reply to the previous request (of any channel) has been received or timed out.
+ *       This way, there is never more than one reply message in flight, which is required by the
+ *       interfaces (AT-command controlled interfaces switch the CAN-IDs with each request).
+ *       Received messages are demultiplexed by their CAN-ID. This requires that the interface returns
+ *       max. one message per read() (see AbstractDiagInterface::read()).                             */
+
+class DiagInterfaceMultiplexer
+{
+
+public:
+	DiagInterfaceMultiplexer(AbstractDiagInterface *diagInterface);
+	~DiagInterfaceMultiplexer();
+	AbstractDiagInterface * channel(unsigned int CUaddress);
+	AbstractDiagInterface * diagInterface();
+
+private:
+	AbstractDiagInterface *_diagInterface;
+	std::vector<MultiplexedDiagInterface*> _channels;
+	QMutex _mutex;
+	QWaitCondition _busReleased;
+	MultiplexedDiagInterface *_busOwner;	// channel with pending request
+	QTime _requestTime;
+
+	bool write(MultiplexedDiagInterface *channel, const std::vector<char> & buffer);
+	bool read(MultiplexedDiagInterface *channel, std::vector<char> *buffer);
+	bool connect(AbstractDiagInterface::protocol_type protocol);
+	void releaseBus(MultiplexedDiagInterface *channel);
+
+	friend class MultiplexedDiagInterface;
+
+};
+
+
+#endif
@@ -0,0 +1,490 @@
+/*
+ * DiagSessionManager.cpp - Several diagnostic sessions (interfaces/vehicles) in one process
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagSessionManager.h"
+
+
+
+diagSessionConfig_dt::diagSessionConfig_dt()
+{
+	interfaceType = AbstractDiagInterface::interface_serialPassThrough;
+	CU = SSMprotocol::CUtype_Engine;
+	language = "en";
+}
+
+
+
+diagSessionHealth_dt::diagSessionHealth_dt()
+{
+	status = status_stopped;
+	samples = 0;
+	sampleRate = 0;
+	lastSampleAge_ms = -1;
+	interruptions = 0;
+	recording = false;
+}
+
+
+
+DiagSession::DiagSession(const diagSessionConfig_dt & config)
+{
+	_config = config;
+	_diagInterface = NULL;
+	_SSMPdev = NULL;
+	_rateSamples = 0;
+}
+
+
+DiagSession::~DiagSession()
+{
+	releaseResources();
+}
+
+
+diagSessionConfig_dt DiagSession::config()
+{
+	return _config;
+}
+
+
+diagSessionHealth_dt DiagSession::health()
+{
+	if ((_health.status == diagSessionHealth_dt::status_running) || (_health.status == diagSessionHealth_dt::status_interrupted))
+	{
+		int elapsed_ms = _rateTime.restart();
+		if (elapsed_ms > 0)
+			_health.sampleRate = 1000.0 * _rateSamples / elapsed_ms;
+		_rateSamples = 0;
+	}
+	else
+		_health.sampleRate = 0;
+	if (_health.samples)
+		_health.lastSampleAge_ms = _lastSampleTime.elapsed();
+	if (_SSMPdev != NULL)
+		_health.recording = _SSMPdev->isRecordingMBSWs();
+	return _health;
+}
+
+
+bool DiagSession::start()
+{
+	std::vector<MBSWmetadata_dt> mbswmetaList;
+	if (_SSMPdev != NULL)
+		return true;
+	_health = diagSessionHealth_dt();
+	_health.status = diagSessionHealth_dt::status_starting;
+	// Open interface:
+	if (_config.interfaceType == AbstractDiagInterface::interface_serialPassThrough)
+		_diagInterface = new SerialPassThroughDiagInterface;
+	else if (_config.interfaceType == AbstractDiagInterface::interface_J2534)
+		_diagInterface = new J2534DiagInterface;
+	else if (_config.interfaceType == AbstractDiagInterface::interface_ATcommandControlled)
+		_diagInterface = new ATcommandControlledDiagInterface;
+	else
+	{
+		fail(tr("Unsupported interface type"));
+		return false;
+	}
+	if (!_diagInterface->open(_config.interfaceFilename.toStdString()))
+	{
+		fail(tr("Couldn't open the diagnostic interface"));
+		return false;
+	}
+	// Setup control unit:
+	if (!probeProtocols())
+	{
+		fail(tr("No or invalid answer from Control Unit"));
+		return false;
+	}
+	_health.protocol = QString::fromStdString( _diagInterface->protocolDescription() );
+	connect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
+	connect( _SSMPdev, SIGNAL( commInterrupted() ), this, SLOT( communicationInterrupted() ) );
+	connect( _SSMPdev, SIGNAL( commResumed() ), this, SLOT( communicationResumed() ) );
+	connect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ),
+		 this, SLOT( processMBSWrawValues(std::vector<unsigned int>, int) ) );
+	// Start MB/SW reading and recording:
+	if (!selectMBSWs(&mbswmetaList))
+	{
+		fail(tr("Invalid MB/SW selection"));
+		return false;
+	}
+	if (!_SSMPdev->startMBSWreading(mbswmetaList))
+	{
+		fail(tr("Couldn't start MB/SW reading"));
+		return false;
+	}
+	if (_config.logFilename.size() && !_SSMPdev->startMBSWrecording(_config.logFilename))
+	{
+		fail(tr("Couldn't open the log file"));
+		return false;
+	}
+	_rateSamples = 0;
+	_rateTime.start();
+	_health.status = diagSessionHealth_dt::status_running;
+	return true;
+}
+
+
+void DiagSession::stop()
+{
+	releaseResources();
+	if (_health.status != diagSessionHealth_dt::status_failed)
+		_health.status = diagSessionHealth_dt::status_stopped;
+}
+
+// PRIVATE
+
+bool DiagSession::probeProtocols()
+{
+	// NOTE: same order as in ControlUnitDialog::probeProtocol()
+	std::vector<AbstractDiagInterface::protocol_type> protocols;
+	if ((_config.CU == SSMprotocol::CUtype_Engine) || (_config.CU == SSMprotocol::CUtype_Transmission))
+	{
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO15765);
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO14230);
+	}
+	protocols.push_back(AbstractDiagInterface::protocol_SSM1);
+	VehicleTopologyCache::preferLastProtocol(_config.CU, &protocols);
+	for (unsigned int k=0; (k<protocols.size()) && (_SSMPdev == NULL); k++)
+	{
+		if (!_diagInterface->connect(protocols.at(k)))
+			continue;
+		if (protocols.at(k) == AbstractDiagInterface::protocol_SSM1)
+			_SSMPdev = new SSMprotocol1(_diagInterface, _config.language);
+		else
+			_SSMPdev = new SSMprotocol2(_diagInterface, _config.language);
+		if (_SSMPdev->setupCUdata(_config.CU) != SSMprotocol::result_success)
+		{
+			delete _SSMPdev;
+			_SSMPdev = NULL;
+			_diagInterface->disconnect();
+		}
+	}
+	return (_SSMPdev != NULL);
+}
+
+
+bool DiagSession::selectMBSWs(std::vector<MBSWmetadata_dt> *mbswmetaList)
+{
+	std::vector<mb_dt> supportedMBs;
+	std::vector<sw_dt> supportedSWs;
+	MBSWmetadata_dt mbswmetadata;
+	mbswmetaList->clear();
+	if (!_SSMPdev->getSupportedMBs(&supportedMBs) || !_SSMPdev->getSupportedSWs(&supportedSWs))
+		return false;
+	// No selection: all measuring blocks
+	if (_config.MBSWtitles.isEmpty())
+	{
+		mbswmetadata.blockType = 0;
+		for (unsigned int k=0; k<supportedMBs.size(); k++)
+		{
+			mbswmetadata.nativeIndex = k;
+			mbswmetaList->push_back(mbswmetadata);
+		}
+		return mbswmetaList->size();
+	}
+	// Select by title (measuring blocks first):
+	for (int t=0; t<_config.MBSWtitles.size(); t++)
+	{
+		QString title = _config.MBSWtitles.at(t).trimmed();
+		bool found = false;
+		for (unsigned int k=0; (k<supportedMBs.size()) && !found; k++)
+		{
+			if (!supportedMBs.at(k).title.compare(title, Qt::CaseInsensitive))
+			{
+				mbswmetadata.blockType = 0;
+				mbswmetadata.nativeIndex = k;
+				found = true;
+			}
+		}
+		for (unsigned int k=0; (k<supportedSWs.size()) && !found; k++)
+		{
+			if (!supportedSWs.at(k).title.compare(title, Qt::CaseInsensitive))
+			{
+				mbswmetadata.blockType = 1;
+				mbswmetadata.nativeIndex = k;
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			std::cout << "DiagSession: " << _config.name.toLocal8Bit().constData() << ": unknown MB/SW \""
+			          << title.toLocal8Bit().constData() << "\"\n";
+			return false;
+		}
+		mbswmetaList->push_back(mbswmetadata);
+	}
+	return true;
+}
+
+
+void DiagSession::fail(QString error)
+{
+	_health.status = diagSessionHealth_dt::status_failed;
+	_health.error = error;
+	releaseResources();
+}
+
+
+void DiagSession::processMBSWrawValues(std::vector<unsigned int> /* rawValues */, int /* duration_ms */)
+{
+	_health.samples++;
+	_rateSamples++;
+	_lastSampleTime.start();
+}
+
+
+void DiagSession::communicationInterrupted()
+{
+	_health.status = diagSessionHealth_dt::status_interrupted;
+	_health.interruptions++;
+}
+
+
+void DiagSession::communicationResumed()
+{
+	_health.status = diagSessionHealth_dt::status_running;
+}
+
+
+void DiagSession::communicationError()
+{
+	_health.status = diagSessionHealth_dt::status_failed;
+	_health.error = tr("Communication Error");
+	// NOTE: the protocol object must not be deleted while it is emitting signals
+	QTimer::singleShot(0, this, SLOT( releaseResources() ));
+}
+
+
+void DiagSession::releaseResources()
+{
+	if (_SSMPdev != NULL)
+	{
+		disconnect( _SSMPdev, SIGNAL( commError() ), this, SLOT( communicationError() ) );
+		disconnect( _SSMPdev, SIGNAL( commInterrupted() ), this, SLOT( communicationInterrupted() ) );
+		disconnect( _SSMPdev, SIGNAL( commResumed() ), this, SLOT( communicationResumed() ) );
+		disconnect( _SSMPdev, SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ),
+			    this, SLOT( processMBSWrawValues(std::vector<unsigned int>, int) ) );
+		if (_SSMPdev->isRecordingMBSWs())
+			_SSMPdev->stopMBSWrecording();
+		_SSMPdev->stopAllPermanentOperations();
+		delete _SSMPdev;
+		_SSMPdev = NULL;
+	}
+	if (_diagInterface != NULL)
+	{
+		if (_diagInterface->isConnected())
+			_diagInterface->disconnect();
+		if (_diagInterface->isOpen())
+			_diagInterface->close();
+		delete _diagInterface;
+		_diagInterface = NULL;
+	}
+	_health.recording = false;
+}
+
+
+
+volatile sig_atomic_t DiagSessionManager::_stopRequested = 0;
+
+
+DiagSessionManager::DiagSessionManager()
+{
+}
+
+
+DiagSessionManager::~DiagSessionManager()
+{
+	stopAll();
+	for (unsigned int k=0; k<_sessions.size(); k++)
+		delete _sessions.at(k);
+}
+
+
+bool DiagSessionManager::loadConfiguration(QString filename, std::vector<diagSessionConfig_dt> *configs)
+{
+	/* NOTE: one group per session:
+	 *   [name]
+	 *   interfaceType=serial|ATcommand|J2534
+	 *   interface=<device file or J2534 library path>
+	 *   controlUnit=engine|transmission|cruisecontrol|aircon|4ws|abs|airsuspension|powersteering
+	 *   MBSWs=<title>, <title>, ...   (optional, default: all measuring blocks)
+	 *   log=<MB/SW log file>         (optional)
+	 *   language=en|de               (optional)                                                  */
+	QSettings settings(filename, QSettings::IniFormat);
+	if (settings.status() != QSettings::NoError)
+		return false;
+	configs->clear();
+	QStringList groups = settings.childGroups();
+	for (int k=0; k<groups.size(); k++)
+	{
+		diagSessionConfig_dt config;
+		settings.beginGroup(groups.at(k));
+		config.name = groups.at(k);
+		QString type = settings.value("interfaceType", "serial").toString();
+		if (!type.compare("J2534", Qt::CaseInsensitive))
+			config.interfaceType = AbstractDiagInterface::interface_J2534;
+		else if (!type.compare("ATcommand", Qt::CaseInsensitive))
+			config.interfaceType = AbstractDiagInterface::interface_ATcommandControlled;
+		else
+			config.interfaceType = AbstractDiagInterface::interface_serialPassThrough;
+		config.interfaceFilename = settings.value("interface").toString();
+		bool ok = CUtypeFromName(settings.value("controlUnit", "engine").toString(), &config.CU);
+		config.MBSWtitles = settings.value("MBSWs").toStringList();
+		config.logFilename = settings.value("log").toString();
+		config.language = settings.value("language", "en").toString();
+		settings.endGroup();
+		if (!ok || config.interfaceFilename.isEmpty())
+		{
+			std::cout << "DiagSessionManager::loadConfiguration():   error: invalid configuration of session "
+			          << config.name.toLocal8Bit().constData() << '\n';
+			return false;
+		}
+		configs->push_back(config);
+	}
+	return configs->size();
+}
+
+
+bool DiagSessionManager::addSession(const diagSessionConfig_dt & config)
+{
+	if (_sessions.size() >= DIAGSESSION_MAX_SESSIONS)
+		return false;
+	_sessions.push_back( new DiagSession(config) );
+	return true;
+}
+
+
+unsigned int DiagSessionManager::numberOfSessions()
+{
+	return _sessions.size();
+}
+
+
+DiagSession * DiagSessionManager::session(unsigned int index)
+{
+	if (index >= _sessions.size())
+		return NULL;
+	return _sessions.at(index);
+}
+
+
+unsigned int DiagSessionManager::startAll()
+{
+	// NOTE: the sessions are set up one after another, the setup of a control unit is blocking
+	unsigned int started = 0;
+	for (unsigned int k=0; (k<_sessions.size()) && !_stopRequested; k++)
+	{
+		if (_sessions.at(k)->start())
+			started++;
+	}
+	return started;
+}
+
+
+void DiagSessionManager::stopAll()
+{
+	for (unsigned int k=0; k<_sessions.size(); k++)
+		_sessions.at(k)->stop();
+}
+
+
+QString DiagSessionManager::healthReport()
+{
+	const char *statusnames[] = {"stopped", "starting", "running", "interrupted", "FAILED"};
+	QString report;
+	for (unsigned int k=0; k<_sessions.size(); k++)
+	{
+		diagSessionHealth_dt health = _sessions.at(k)->health();
+		report += _sessions.at(k)->config().name.leftJustified(12) + " " + QString(statusnames[health.status]).leftJustified(12);
+		if (health.status == diagSessionHealth_dt::status_failed)
+		{
+			report += health.error + '\n';
+			continue;
+		}
+		report += health.protocol.leftJustified(24) + " samples: " + QString::number(health.samples)
+			+ "  rate: " + QString::number(health.sampleRate, 'f', 1) + "/s";
+		if (health.lastSampleAge_ms >= 0)
+			report += "  last: " + QString::number(health.lastSampleAge_ms) + " ms";
+		report += "  interruptions: " + QString::number(health.interruptions);
+		if (health.recording)
+			report += "  recording";
+		report += '\n';
+	}
+	return report;
+}
+
+
+int DiagSessionManager::exec(unsigned int reportInterval_ms)
+{
+	QTimer reportTimer;
+	QTimer stopTimer;
+	if (!startAll() || _stopRequested)
+	{
+		printHealthReport();
+		stopAll();
+		return -1;
+	}
+	printHealthReport();
+	connect( &reportTimer, SIGNAL( timeout() ), this, SLOT( printHealthReport() ) );
+	connect( &stopTimer, SIGNAL( timeout() ), this, SLOT( checkStopRequest() ) );
+	reportTimer.start(reportInterval_ms);
+	stopTimer.start(DIAGSESSION_STOPCHECK_INTERVAL_MS);
+	_el.exec();
+	stopAll();
+	printHealthReport();
+	return 0;
+}
+
+
+void DiagSessionManager::requestStop()
+{
+	// NOTE: async-signal-safe, can be called from signal handlers
+	_stopRequested = 1;
+}
+
+// PRIVATE
+
+bool DiagSessionManager::CUtypeFromName(QString name, SSMprotocol::CUtype_dt *CU)
+{
+	const char *CUnames[] = {"engine", "transmission", "cruisecontrol", "aircon", "4ws", "abs", "airsuspension", "powersteering"};
+	for (unsigned int k=0; k<(sizeof(CUnames)/sizeof(CUnames[0])); k++)
+	{
+		if (!name.compare(CUnames[k], Qt::CaseInsensitive))
+		{
+			*CU = static_cast<SSMprotocol::CUtype_dt>(k);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void DiagSessionManager::printHealthReport()
+{
+	std::cout << QTime::currentTime().toString("hh:mm:ss").toLocal8Bit().constData() << '\n'
+	          << healthReport().toLocal8Bit().constData() << std::flush;
+}
+
+
+void DiagSessionManager::checkStopRequest()
+{
+	if (_stopRequested)
+		_el.quit();
+}
@@ -0,0 +1,161 @@
+/*
+ * DiagSessionManager.h - Several diagnostic sessions (interfaces/vehicles) in one process
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIAGSESSIONMANAGER_H
+#define DIAGSESSIONMANAGER_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSettings>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTime>
+#include <vector>
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include "AbstractDiagInterface.h"
+#include "SerialPassThroughDiagInterface.h"
+#include "J2534DiagInterface.h"
+#include "ATcommandControlledDiagInterface.h"
+#include "SSMprotocol.h"
+#include "SSMprotocol1.h"
+#include "SSMprotocol2.h"
+#include "VehicleScan.h"
+
+
+#define		DIAGSESSION_MAX_SESSIONS		8
+#define		DIAGSESSION_REPORT_INTERVAL_MS		5000
+#define		DIAGSESSION_STOPCHECK_INTERVAL_MS	200
+
+
+
+class diagSessionConfig_dt
+{
+public:
+	diagSessionConfig_dt();
+
+	QString name;
+	AbstractDiagInterface::interface_type interfaceType;
+	QString interfaceFilename;	// device file or J2534 library path
+	SSMprotocol::CUtype_dt CU;
+	QStringList MBSWtitles;		// empty: all measuring blocks
+	QString logFilename;		// empty: no recording
+	QString language;
+};
+
+
+
+class diagSessionHealth_dt
+{
+public:
+	enum status_dt {status_stopped, status_starting, status_running, status_interrupted, status_failed};
+
+	diagSessionHealth_dt();
+
+	status_dt status;
+	QString protocol;
+	unsigned int samples;
+	double sampleRate;		// [1/s], since the last health query
+	int lastSampleAge_ms;		// -1: no samples received yet
+	unsigned int interruptions;	// automatically resumed communication interruptions
+	bool recording;
+	QString error;
+};
+
+
+
+/* NOTE: each session has its own interface, communication worker (SSMP1/SSMP2communication),
+ *       control unit definitions and MB/SW recording.
+ *       The communication workers poll their interfaces, a common I/O reactor is not possible
+ *       (J2534 libraries do not provide file descriptors). The workers sleep between polls,
+ *       so the CPU load of idle sessions is negligible.                                       */
+
+class DiagSession : public QObject
+{
+	Q_OBJECT
+
+public:
+	DiagSession(const diagSessionConfig_dt & config);
+	~DiagSession();
+	diagSessionConfig_dt config();
+	diagSessionHealth_dt health();
+
+public slots:
+	bool start();
+	void stop();
+
+private:
+	diagSessionConfig_dt _config;
+	AbstractDiagInterface *_diagInterface;
+	SSMprotocol *_SSMPdev;
+	diagSessionHealth_dt _health;
+	QTime _lastSampleTime;
+	QTime _rateTime;
+	unsigned int _rateSamples;
+
+	bool probeProtocols();
+	bool selectMBSWs(std::vector<MBSWmetadata_dt> *mbswmetaList);
+	void fail(QString error);
+
+private slots:
+	void processMBSWrawValues(std::vector<unsigned int> rawValues, int duration_ms);
+	void communicationInterrupted();
+	void communicationResumed();
+	void communicationError();
+	void releaseResources();
+
+};
+
+
+
+class DiagSessionManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	DiagSessionManager();
+	~DiagSessionManager();
+	static bool loadConfiguration(QString filename, std::vector<diagSessionConfig_dt> *configs);
+	bool addSession(const diagSessionConfig_dt & config);
+	unsigned int numberOfSessions();
+	DiagSession * session(unsigned int index);
+	unsigned int startAll();
+	void stopAll();
+	QString healthReport();
+	int exec(unsigned int reportInterval_ms = DIAGSESSION_REPORT_INTERVAL_MS);
+	static void requestStop();
+
+private:
+	std::vector<DiagSession*> _sessions;
+	QEventLoop _el;
+	static volatile sig_atomic_t _stopRequested;
+
+	static bool CUtypeFromName(QString name, SSMprotocol::CUtype_dt *CU);
+
+private slots:
+	void printHealthReport();
+	void checkStopRequest();
+
+};
+
+
+#endif
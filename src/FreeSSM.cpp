@@ -29,7 +29,50 @@ FreeSSM::FreeSSM(QApplication *app)
 	_iface_filename = "";
 	_language = "en";	// default language
 	_dumping = false;
+	_replay_originalTiming = true;
+	_telemetryServer = NULL;
+	_sharedMemoryExport = NULL;
+	bool telemetry = false;
+	bool sharedMemory = false;
 	QString appsPath( QCoreApplication::applicationDirPath() );
+	// EVALUATE COMMAND LINE ARGUMENTS:
+	// --capture <file>: capture the interface traffic (one file per session, see CapturingDiagInterface); --replay <file> [--fast]: replay captured traffic
+	// --telemetry: publish the live MB/SW values on a local socket and localhost TCP port
+	// --shm: export the latest MB/SW values to shared memory
+	QStringList args = app->arguments();
+	for (int k=1; k<args.size(); k++)
+	{
+		if ((args.at(k) == "--capture") && (k+1 < args.size()))
+			_capture_filename = args.at(++k);
+		else if ((args.at(k) == "--replay") && (k+1 < args.size()))
+			_replay_filename = args.at(++k);
+		else if (args.at(k) == "--fast")
+			_replay_originalTiming = false;
+		else if (args.at(k) == "--telemetry")
+			telemetry = true;
+		else if (args.at(k) == "--shm")
+			sharedMemory = true;
+	}
+	if (telemetry)
+	{
+		_telemetryServer = new MBSWtelemetryServer(this);
+		if (!_telemetryServer->listen())
+		{
+			delete _telemetryServer;
+			_telemetryServer = NULL;
+			displayErrorMsg(tr("Couldn't start the telemetry server !\nMaybe TCP port %1 is already in use...").arg(TELEMETRY_TCP_PORT));
+		}
+	}
+	if (sharedMemory)
+	{
+		_sharedMemoryExport = new MBSWsharedMemoryExport;
+		if (!_sharedMemoryExport->create())
+		{
+			delete _sharedMemoryExport;
+			_sharedMemoryExport = NULL;
+			displayErrorMsg(tr("Couldn't create the shared memory segment for the MB/SW values !"));
+		}
+	}
 	// SETUP GUI:
 	setupUi(this);
 	setWindowFlags( windowFlags() & ~Qt::WindowMaximizeButtonHint );	// only necessary for MS Windows
@@ -206,6 +249,10 @@ FreeSSM::FreeSSM(QApplication *app)
 	_dump_action = new QAction(this);
 	_dump_action->setShortcut( QKeySequence("Ctrl+Alt+Return") );
 	this->addAction(_dump_action);
+	// CREATE ACTION FOR SCANNING ALL CONTROL UNITS OF THE VEHICLE:
+	_scan_action = new QAction(this);
+	_scan_action->setShortcut( QKeySequence("Ctrl+Alt+S") );
+	this->addAction(_scan_action);
 	// CONNECT SIGNALS/SLOTS:
 	connect( engine_pushButton, SIGNAL( released() ), this, SLOT( engine() ) );
 	connect( transmission_pushButton, SIGNAL( released() ), this, SLOT( transmission() ) );
@@ -218,12 +265,14 @@ FreeSSM::FreeSSM(QApplication *app)
 	connect( exit_pushButton, SIGNAL( released() ), this, SLOT( close() ) );
 	// NOTE: using released() instead of pressed() as workaround for a Qt-Bug occuring under MS Windows
 	connect( _dump_action, SIGNAL(triggered()), this, SLOT(dumpCUdata()) );
+	connect( _scan_action, SIGNAL(triggered()), this, SLOT(scanVehicle()) );
 }
 
 
 FreeSSM::~FreeSSM()
 {
 	disconnect( _dump_action, SIGNAL( triggered() ), this, SLOT( dumpCUdata() ) );
+	disconnect( _scan_action, SIGNAL( triggered() ), this, SLOT( scanVehicle() ) );
 	disconnect( engine_pushButton, SIGNAL( released() ), this, SLOT( engine() ) ); 
 	disconnect( transmission_pushButton, SIGNAL( released() ), this, SLOT( transmission() ) ); 
 	disconnect( absvdc_pushButton, SIGNAL( released() ), this, SLOT( abs() ) );
@@ -234,6 +283,7 @@ FreeSSM::~FreeSSM()
 	disconnect( about_pushButton, SIGNAL( released() ), this, SLOT( about() ) ); 
 	disconnect( exit_pushButton, SIGNAL( released() ), this, SLOT( close() ) );
 	delete _dump_action;
+	delete _scan_action;
 	delete _progtitle_label;
 	if (_translator != NULL)
 	{
@@ -245,6 +295,8 @@ FreeSSM::~FreeSSM()
 		QApplication::removeTranslator(_qt_translator);
 		delete _qt_translator;
 	}
+	if (_sharedMemoryExport != NULL)
+		delete _sharedMemoryExport;
 }
 
 
@@ -352,6 +404,16 @@ void FreeSSM::about()
 
 AbstractDiagInterface * FreeSSM::initInterface()
 {
+	// Replay of captured interface traffic:
+	if (_replay_filename.size())
+	{
+		AbstractDiagInterface *replayInterface = new ReplayDiagInterface(_replay_originalTiming);
+		if (replayInterface->open(_replay_filename.toStdString()))
+			return replayInterface;
+		displayErrorMsg(tr("Couldn't open the capture file for replay !"));
+		delete replayInterface;
+		return NULL;
+	}
 	// Check if an interface is selected:
 	if (_iface_filename == "")
 	{
@@ -377,6 +439,8 @@ AbstractDiagInterface * FreeSSM::initInterface()
 		displayErrorMsg(tr("Internal error:\nThe selected interface type cannot be initialized !\n=> Please report this as a bug."));
 		return NULL;
 	}
+	if (_capture_filename.size())
+		diagInterface = new CapturingDiagInterface(diagInterface, _capture_filename.toStdString());
 	if (diagInterface->open(_iface_filename.toStdString()))
 		return diagInterface;
 	// Return error:
@@ -658,6 +722,56 @@ end:
 }
 
 
+void FreeSSM::scanVehicle()
+{
+	vehicleTopology_dt topology;
+	QString resultText;
+	bool ok = false;
+	if (_dumping) return;
+	AbstractDiagInterface *diagInterface = initInterface();
+	if (!diagInterface)
+		return;
+	_dumping = true;	// NOTE: blocks all other functions
+	// Scan all control units:
+	FSSM_WaitMsgBox *waitmsgbox = new FSSM_WaitMsgBox(this, tr("Scanning control units... Please wait !     "));
+	waitmsgbox->show();
+	VehicleScanner scanner(diagInterface, _language);
+	ok = scanner.scan(&topology);
+	waitmsgbox->close();
+	delete waitmsgbox;
+	delete diagInterface;	// will be closed in destructor
+	_dumping = false;
+	if (!ok)
+	{
+		displayErrorMsg(tr("No control unit found !\nPlease make sure that the interface is connected properly and ignition is switched ON."));
+		return;
+	}
+	// Display result:
+	const QString CUtitles[8] = {tr("Engine"), tr("Transmission"), tr("Cruise Control"), tr("Air Conditioning"),
+				     tr("4 Wheel Steering"), tr("ABS/VDC"), tr("Air Suspension"), tr("Power Steering")};
+	if (topology.VIN.size())
+		resultText = tr("VIN:") + " " + topology.VIN + "\n";
+	for (unsigned int k=0; k<topology.CUs.size(); k++)
+	{
+		const vehicleCU_dt & cu = topology.CUs.at(k);
+		resultText += "\n" + CUtitles[cu.CUtype] + ": " + cu.description;
+		resultText += "\n   " + tr("SYS-ID:") + " " + cu.SYS_ID;
+		if (cu.ROM_ID.size())
+			resultText += ", " + tr("ROM-ID:") + " " + cu.ROM_ID;
+		resultText += "\n   " + tr("DTCs (current/temporary, historic/memorized):") + " ";
+		resultText += ((cu.nrOfCurrentOrTempDTCs < 0) ? "?" : QString::number(cu.nrOfCurrentOrTempDTCs)) + ", ";
+		resultText += ((cu.nrOfHistoricOrMemDTCs < 0) ? "?" : QString::number(cu.nrOfHistoricOrMemDTCs));
+	}
+	QMessageBox msg( QMessageBox::Information, tr("Vehicle scan"), resultText, QMessageBox::Ok, this);
+	QFont msgfont = msg.font();
+	msgfont.setPixelSize(12); // 9pts
+	msg.setFont( msgfont );
+	msg.show();
+	msg.exec();
+	msg.close();
+}
+
+
 void FreeSSM::displayErrorMsg(QString errmsg)
 {
 	QMessageBox msg( QMessageBox::Critical, tr("Error"), errmsg, QMessageBox::Ok, this);
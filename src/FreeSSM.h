@@ -28,6 +28,8 @@
 #include "SerialPassThroughDiagInterface.h"
 #include "J2534DiagInterface.h"
 #include "ATcommandControlledDiagInterface.h"
+#include "CapturingDiagInterface.h"
+#include "ReplayDiagInterface.h"
 #include "SSMP1communication.h"
 #include "SSMP2communication.h"
 #include "libFSSM.h"
@@ -38,6 +40,9 @@
 #include "AirConDialog.h"
 #include "Preferences.h"
 #include "About.h"
+#include "VehicleScan.h"
+#include "MBSWtelemetryServer.h"
+#include "MBSWsharedMemoryExport.h"
 #include "ui_FreeSSM.h"
 
 
@@ -49,12 +54,18 @@ class FreeSSM : public QMainWindow, private Ui::FreeSSM_MainWindow
 private:
 	AbstractDiagInterface::interface_type _iface_type;
 	QString _iface_filename;
+	QString _capture_filename;
+	QString _replay_filename;
+	bool _replay_originalTiming;
 	QString _language;
 	QTranslator *_qt_translator;
 	QTranslator *_translator;
 	QLabel *_progtitle_label;
 	QAction *_dump_action;
+	QAction *_scan_action;
 	bool _dumping;
+	MBSWtelemetryServer *_telemetryServer;
+	MBSWsharedMemoryExport *_sharedMemoryExport;
 
 	void setupUiFonts();
 	AbstractDiagInterface * initInterface();
@@ -77,6 +88,7 @@ private slots:
 	void about();
 	void retranslate(QString newlanguage, QTranslator *newtranslator);
 	void dumpCUdata();
+	void scanVehicle();
 
 };
 
@@ -587,6 +587,10 @@ bool J2534DiagInterface::read(std::vector<char> *buffer)
 #endif
 					for (unsigned int k=0; k<rx_msg.DataSize; k++)
 						buffer->push_back(rx_msg.Data[k]);
+					/* NOTE: ISO-15765: return one message per call. The messages can not be separated
+					 *       after concatenation (no length information), see DiagInterfaceMultiplexer */
+					if ((protocolType() == protocol_SSM2_ISO15765) && !(rx_msg.RxStatus & TX_MSG_TYPE))
+						break;
 				}
 			}
 		} while ((STATUS_NOERROR == ret) && rxNumMsgs);
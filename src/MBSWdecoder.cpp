@@ -0,0 +1,810 @@
+/*
+ * MBSWdecoder.cpp - Scaling and min/max determination of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWdecoder.h"
+#include "MBSWsharedMemoryExport.h"
+#include "MBSWtelemetryServer.h"
+
+
+
+MBSWscaling_dt::MBSWscaling_dt()
+{
+	_isSW = false;
+	_derived = false;
+	_inverseOrder = false;
+	_precision = 0;
+	_signedBits = 0;
+}
+
+
+void MBSWscaling_dt::setup(const mb_dt & mb)
+{
+	QString defstr;
+	unsigned int nrofDAs = 0;
+	_isSW = false;
+	_derived = false;
+	_inverseOrder = false;
+	_precision = mb.precision;
+	_unit = mb.unit;
+	_signedBits = 0;
+	_operators.clear();
+	_operands.clear();
+	_textRawValues.clear();
+	_texts.clear();
+	if (mb.scaleformula.contains('='))
+	{
+		// Direct association:
+		nrofDAs = 1 + (mb.scaleformula.count(','));
+		for (unsigned int m=0; m<nrofDAs; m++)
+		{
+			defstr = mb.scaleformula.section(',',m,m);
+			_textRawValues.push_back( defstr.section('=', 0, 0).toUInt() );
+			_texts.push_back( defstr.section('=', 1, 1) );
+		}
+	}
+	else
+		libFSSM::compileScaleformula(mb.scaleformula, &_signedBits, &_operators, &_operands);
+	setupTexts();
+}
+
+
+void MBSWscaling_dt::setup(const sw_dt & sw)
+{
+	QChar separator;
+	_isSW = true;
+	_derived = false;
+	_inverseOrder = false;
+	_precision = 0;
+	_unit = sw.unit;
+	_signedBits = 0;
+	_operators.clear();
+	_operands.clear();
+	_textRawValues.clear();
+	_texts.clear();
+	/* NOTE: Some switches have an inverse meaning ! (e.g. 0="High", 1="Low")
+	 *       => the characters / and \ tell us which of them has to be interpreted as the lower/larger one
+	 *          during the min/max value determination (can't use < > in XML-files):
+	 *             a/b   => a smaller than b
+	 *             a\b   => a larger than b
+	 * THE MEANING DOES NOT AFFECT THE SCALING PROCESS !
+	 */
+	if (sw.unit.contains('/'))
+		separator = '/';
+	else if (sw.unit.contains('\\'))
+	{
+		separator = '\\';
+		_inverseOrder = true;
+	}
+	else
+	{
+		setupTexts();
+		return;
+	}
+	_textRawValues.push_back(0);
+	_texts.push_back( sw.unit.section(separator,0,0) );
+	_textRawValues.push_back(1);
+	_texts.push_back( sw.unit.section(separator,1,1) );
+	setupTexts();
+}
+
+
+void MBSWscaling_dt::setupDerived(const mb_dt & mb)
+{
+	_isSW = false;
+	_derived = true;
+	_inverseOrder = false;
+	_precision = mb.precision;
+	if (_precision < 0)
+		_precision = 0;
+	_unit = mb.unit;
+	_signedBits = 32;
+	_operators.assign(1, '/');
+	_operands.assign(1, pow(10, _precision));
+	_textRawValues.clear();
+	_texts.clear();
+	setupTexts();
+}
+
+
+bool MBSWscaling_dt::derivedRawValue(double value, unsigned int *rawValue) const
+{
+	double fixedPointValue = 0;
+	if (!_derived)
+		return false;
+	fixedPointValue = floor(value * pow(10, _precision) + 0.5);
+	if ((fixedPointValue > 2147483647.0) || (fixedPointValue < -2147483647.0))
+		return false;
+	*rawValue = static_cast<unsigned int>(static_cast<int>(fixedPointValue));
+	return true;
+}
+
+
+bool MBSWscaling_dt::scale(unsigned int rawValue, double *scaledValue, bool *numeric, int *textIndex) const
+{
+	double value = rawValue;
+	if (_derived && (rawValue == MBSW_DERIVED_INVALID_RAW))
+		return false;
+	// Direct association / switch states:
+	if (_textRawValues.size())
+	{
+		for (unsigned int k=0; k<_textRawValues.size(); k++)
+		{
+			if (_textRawValues.at(k) == rawValue)
+			{
+				if (_isSW && _texts.at(k).isEmpty())
+					return false;
+				*scaledValue = _textValues.at(k);
+				*numeric = _textNumeric.at(k);
+				*textIndex = k;
+				return true;
+			}
+		}
+		return false;
+	}
+	// Calculation:
+	if (_operators.empty())
+		return false;
+	if (_signedBits && (rawValue > pow(2,_signedBits-1) - 1))	// if MSB is set
+		value = rawValue - pow(2, _signedBits);
+	for (unsigned int k=0; k<_operators.size(); k++)
+	{
+		switch (_operators.at(k))
+		{
+			case '+':
+				value += _operands.at(k);
+				break;
+			case '-':
+				value -= _operands.at(k);
+				break;
+			case '*':
+				value *= _operands.at(k);
+				break;
+			case '/':
+				value /= _operands.at(k);
+				break;
+		}
+	}
+	*scaledValue = value;
+	*numeric = true;
+	*textIndex = -1;
+	return true;
+}
+
+
+QString MBSWscaling_dt::valueStr(unsigned int rawValue, bool scaled) const
+{
+	double scaledValue = 0;
+	bool numeric = false;
+	int textIndex = -1;
+	if (!scaled || !scale(rawValue, &scaledValue, &numeric, &textIndex))
+	{
+		if (_derived)
+			return "---";	// the raw value of derived MBs has no meaning
+		return QString::number(rawValue);
+	}
+	if (textIndex >= 0)
+		return _texts.at(textIndex);
+	return numberStr(scaledValue);
+}
+
+
+QString MBSWscaling_dt::numberStr(double scaledValue) const
+{
+	return QString::number(scaledValue, 'f', _precision);
+}
+
+
+QString MBSWscaling_dt::unitStr(bool scaled) const
+{
+	/* NOTE: If a MB/SW cannot be scaled (e.g. due to unexpected raw values, incomplete/invalid defintions),
+	 *       the raw value is displayed instead and the unit is switched to [RAW] (MBs) or [BIN] (SWs). */
+	if (_isSW)
+		return scaled ? "" : "[BIN]";
+	else if (_derived)
+		return _unit;
+	else
+		return scaled ? _unit : "[RAW]";
+}
+
+
+QString MBSWscaling_dt::defaultUnitStr() const
+{
+	if (_isSW)
+		return "";
+	return _unit;
+}
+
+
+bool MBSWscaling_dt::isSW() const
+{
+	return _isSW;
+}
+
+
+bool MBSWscaling_dt::inverseOrder() const
+{
+	return _inverseOrder;
+}
+
+
+void MBSWscaling_dt::setupTexts()
+{
+	bool ok = false;
+	_textNumeric.clear();
+	_textValues.clear();
+	for (int k=0; k<_texts.size(); k++)
+	{
+		_textValues.push_back( _texts.at(k).toDouble(&ok) );
+		_textNumeric.push_back( ok );
+	}
+}
+
+
+
+MBSWvalue_dt::MBSWvalue_dt()
+{
+	rawValue = 0;
+	scaled = false;
+	numeric = false;
+	scaledValue = 0;
+	textIndex = -1;
+	minmaxDisabled = false;
+	minmaxScaled = false;
+	minRawValue = 0;
+	maxRawValue = 0;
+	minNumeric = false;
+	maxNumeric = false;
+	minScaledValue = 0;
+	maxScaledValue = 0;
+	count = 0;
+	sum = 0;
+}
+
+
+void MBSWvalue_dt::resetMinMax()
+{
+	minmaxDisabled = false;
+	minmaxScaled = scaled;
+	minRawValue = rawValue;
+	maxRawValue = rawValue;
+	minNumeric = numeric;
+	maxNumeric = numeric;
+	minScaledValue = scaledValue;
+	maxScaledValue = scaledValue;
+	count = 0;
+	sum = 0;
+	if (scaled && numeric)
+	{
+		count = 1;
+		sum = scaledValue;
+	}
+}
+
+
+double MBSWvalue_dt::average() const
+{
+	if (!count)
+		return 0;
+	return sum / count;
+}
+
+
+
+MBSWdecoder::MBSWdecoder()
+{
+	_nrOfInputs = 0;
+	_haveValues = false;
+	_time_ms = 0;
+	_droppedRawValues = 0;
+	_resetMinMaxRequested = false;
+	_rollingWindow_ms = MBSW_DEFAULT_ROLLING_WINDOW_MS;
+	_rollingWindowChanged = false;
+	_abort = false;
+	_sharedMemoryExport = NULL;
+	_telemetryServer = NULL;
+	_snapshotHaveValues = false;
+	_lastDuration_ms = 0;
+	_notificationPending = false;
+}
+
+
+MBSWdecoder::~MBSWdecoder()
+{
+	stopDecoding();
+}
+
+
+bool MBSWdecoder::setup(std::vector<MBSWscaling_dt> scalings, std::vector<MBSWderivedChannel_dt> derivedChannels, std::vector<unsigned int> outputChannels)
+{
+	unsigned int nrOfVariables = 1;
+	if (isRunning()) return false;
+	// Validate derived channels and output channels:
+	for (unsigned int d=0; d<derivedChannels.size(); d++)
+	{
+		if (!derivedChannels.at(d).expression.isValid() || (derivedChannels.at(d).inputs.size() != derivedChannels.at(d).expression.variables().size()))
+			return false;
+		for (unsigned int v=0; v<derivedChannels.at(d).inputs.size(); v++)
+		{
+			if (derivedChannels.at(d).inputs.at(v) >= scalings.size())
+				return false;
+		}
+		nrOfVariables = qMax(nrOfVariables, static_cast<unsigned int>(derivedChannels.at(d).inputs.size()));
+	}
+	if (outputChannels.empty())
+	{
+		for (unsigned int k=0; k<(scalings.size() + derivedChannels.size()); k++)
+			outputChannels.push_back(k);
+	}
+	for (unsigned int k=0; k<outputChannels.size(); k++)
+	{
+		if (outputChannels.at(k) >= (scalings.size() + derivedChannels.size()))
+			return false;
+	}
+	_queueMutex.lock();
+	_mutex.lock();
+	_nrOfInputs = scalings.size();
+	_scalings = scalings;
+	for (unsigned int d=0; d<derivedChannels.size(); d++)
+		_scalings.push_back(derivedChannels.at(d).scaling);
+	_derivedChannels = derivedChannels;
+	_derivedHasValue.assign(derivedChannels.size(), false);
+	_variableValues.assign(nrOfVariables, 0);
+	_outputChannels = outputChannels;
+	_values.assign(_scalings.size(), MBSWvalue_dt());
+	_haveValues = false;
+	_statistics.assign(_scalings.size(), MBSWstatistics());
+	_rollingStatistics.assign(_scalings.size(), MBSWrollingStatistics());
+	setupRollingStatistics(_rollingWindow_ms);
+	_rollingWindowChanged = false;
+	_time_ms = 0;
+	_queue.clear();
+	_queueDurations.clear();
+	_droppedRawValues = 0;
+	_resetMinMaxRequested = false;
+	_snapshotValues = _values;
+	_snapshotHaveValues = false;
+	_lastDuration_ms = 0;
+	_snapshotStatistics.clear();
+	_snapshotRollingStatistics.clear();
+	_notificationPending = false;
+	_mutex.unlock();
+	_queueMutex.unlock();
+	return true;
+}
+
+
+bool MBSWdecoder::startDecoding()
+{
+	if (isRunning()) return false;
+	_abort = false;
+	start();
+	return true;
+}
+
+
+bool MBSWdecoder::stopDecoding()
+{
+	if (!isRunning())
+		return true;
+	_queueMutex.lock();
+	_abort = true;
+	_dataAvailable.wakeAll();
+	_queueMutex.unlock();
+	// NOTE: the remaining (limited) queue is decoded before the thread finishes
+	return wait();
+}
+
+
+void MBSWdecoder::resetMinMax()
+{
+	// Display the reset immediately:
+	_mutex.lock();
+	if (_snapshotHaveValues)
+		resetValuesMinMax(&_snapshotValues);
+	_mutex.unlock();
+	// Reset the values of the decoder thread:
+	_queueMutex.lock();
+	if (isRunning())
+		_resetMinMaxRequested = true;
+	else if (_haveValues)
+		resetValuesMinMax(&_values);
+	_queueMutex.unlock();
+}
+
+
+bool MBSWdecoder::values(std::vector<MBSWvalue_dt> *values, int *duration_ms)
+{
+	_mutex.lock();
+	_notificationPending = false;
+	if (!_snapshotHaveValues)
+	{
+		_mutex.unlock();
+		return false;
+	}
+	values->resize(_outputChannels.size());
+	for (unsigned int k=0; k<_outputChannels.size(); k++)
+		values->at(k) = _snapshotValues.at(_outputChannels.at(k));
+	*duration_ms = _lastDuration_ms;
+	_mutex.unlock();
+	return true;
+}
+
+
+void MBSWdecoder::setRollingWindow(unsigned int window_ms)
+{
+	_queueMutex.lock();
+	_rollingWindow_ms = window_ms;
+	if (isRunning())
+		_rollingWindowChanged = true;
+	else
+		setupRollingStatistics(_rollingWindow_ms);
+	_queueMutex.unlock();
+}
+
+
+unsigned int MBSWdecoder::rollingWindow()
+{
+	QMutexLocker locker(&_queueMutex);
+	return _rollingWindow_ms;
+}
+
+
+bool MBSWdecoder::statistics(std::vector<MBSWstatistics> *session, std::vector<MBSWstatistics> *rolling)
+{
+	_mutex.lock();
+	if (!_snapshotHaveValues || _snapshotStatistics.empty())
+	{
+		_mutex.unlock();
+		return false;
+	}
+	if (session)
+	{
+		session->clear();
+		for (unsigned int k=0; k<_outputChannels.size(); k++)
+			session->push_back( _snapshotStatistics.at(_outputChannels.at(k)) );
+	}
+	if (rolling)
+	{
+		rolling->clear();
+		for (unsigned int k=0; k<_outputChannels.size(); k++)
+			rolling->push_back( _snapshotRollingStatistics.at(_outputChannels.at(k)) );
+	}
+	_mutex.unlock();
+	return true;
+}
+
+
+void MBSWdecoder::setSharedMemoryExport(MBSWsharedMemoryExport *shmExport)
+{
+	_queueMutex.lock();
+	_sharedMemoryExport = shmExport;
+	_queueMutex.unlock();
+}
+
+
+void MBSWdecoder::setTelemetryServer(MBSWtelemetryServer *telemetryServer)
+{
+	_queueMutex.lock();
+	_telemetryServer = telemetryServer;
+	_queueMutex.unlock();
+}
+
+
+bool MBSWdecoder::logFileStatistics(QString filename, std::vector<MBSWlogChannel_dt> *channels, std::vector<MBSWstatistics> *statistics)
+{
+	MBSWlogFileReader reader;
+	MBSWlogChannelIterator iterator;
+	MBSWscaling_dt scaling;
+	unsigned int time_ms = 0;
+	unsigned int rawValue = 0;
+	double scaledValue = 0;
+	bool numeric = false;
+	int textIndex = -1;
+	if (!reader.open(filename))
+		return false;
+	*channels = reader.channels();
+	statistics->assign(channels->size(), MBSWstatistics());
+	for (unsigned int k=0; k<channels->size(); k++)
+	{
+		const MBSWlogChannel_dt & channel = channels->at(k);
+		// Setup scaling:
+		if (channel.blockType == 0)	// MB
+		{
+			mb_dt mb;
+			mb.title = channel.title;
+			mb.unit = channel.unit;
+			mb.scaleformula = channel.scaleformula;
+			mb.precision = channel.precision;
+			scaling.setup(mb);
+		}
+		else
+		{
+			sw_dt sw;
+			sw.title = channel.title;
+			sw.unit = channel.unit;
+			scaling.setup(sw);
+		}
+		// Evaluate all values of the channel:
+		if (!reader.channelIterator(k, 0, reader.duration_ms(), &iterator))
+			continue;
+		while (iterator.next(&time_ms, &rawValue))
+		{
+			if (scaling.scale(rawValue, &scaledValue, &numeric, &textIndex) && numeric)
+				statistics->at(k).add(scaledValue);
+		}
+	}
+	reader.close();
+	return true;
+}
+
+
+void MBSWdecoder::addRawValues(std::vector<unsigned int> rawValues, int duration_ms)
+{
+	_queueMutex.lock();
+	if (rawValues.size() != _nrOfInputs)
+	{
+		_queueMutex.unlock();
+		return;
+	}
+	if (_queue.size() < MBSWDECODER_MAX_QUEUE_SIZE)
+	{
+		_queue.push_back(rawValues);
+		_queueDurations.push_back(duration_ms);
+	}
+	else
+	{
+		// NOTE: the decoder thread doesn't keep up, don't let the queue grow without limit
+		_droppedRawValues++;
+		if (_queueDurations.size())
+			_queueDurations.back() += duration_ms;	// keep the time base
+#ifdef __FSSM_DEBUG__
+		std::cout << "MBSWdecoder::addRawValues():   queue full, dropped " << _droppedRawValues << " raw value set(s)\n";
+#endif
+	}
+	_dataAvailable.wakeOne();
+	_queueMutex.unlock();
+}
+
+// PRIVATE:
+
+void MBSWdecoder::run()
+{
+	std::vector< std::vector<unsigned int> > queue;
+	std::vector<int> queueDurations;
+	MBSWsharedMemoryExport *sharedMemoryExport = NULL;
+	MBSWtelemetryServer *telemetryServer = NULL;
+	bool abort = false;
+	bool resetMinMaxRequested = false;
+	bool rollingWindowChanged = false;
+	unsigned int rollingWindow_ms = 0;
+	bool notify = false;
+	QElapsedTimer statisticsTimer;
+	while (!abort)
+	{
+		// Take over the queued raw values (the communication continues while decoding):
+		_queueMutex.lock();
+		while (!_abort && _queue.empty())
+			_dataAvailable.wait(&_queueMutex);
+		abort = _abort;
+		queue.swap(_queue);
+		queueDurations.swap(_queueDurations);
+		sharedMemoryExport = _sharedMemoryExport;
+		telemetryServer = _telemetryServer;
+		resetMinMaxRequested = _resetMinMaxRequested;
+		_resetMinMaxRequested = false;
+		rollingWindowChanged = _rollingWindowChanged;
+		_rollingWindowChanged = false;
+		rollingWindow_ms = _rollingWindow_ms;
+		_queueMutex.unlock();
+		if (resetMinMaxRequested && _haveValues)
+			resetValuesMinMax(&_values);
+		if (rollingWindowChanged)
+			setupRollingStatistics(rollingWindow_ms);
+		if (queue.empty())
+		{
+			// Final statistics:
+			if (abort && _haveValues)
+			{
+				_mutex.lock();
+				updateStatisticsSnapshot();
+				_mutex.unlock();
+			}
+			continue;
+		}
+		// Decode all queued raw values:
+		for (unsigned int q=0; q<queue.size(); q++)
+		{
+			_time_ms += queueDurations.at(q);
+			for (unsigned int k=0; k<_nrOfInputs; k++)
+			{
+				decode(_scalings.at(k), queue.at(q).at(k), &_values.at(k), !_haveValues);
+				addToStatistics(k);
+			}
+			// Derived channels:
+			for (unsigned int d=0; d<_derivedChannels.size(); d++)
+			{
+				const MBSWderivedChannel_dt & derived = _derivedChannels.at(d);
+				double result = 0;
+				unsigned int rawValue = MBSW_DERIVED_INVALID_RAW;
+				for (unsigned int v=0; v<derived.inputs.size(); v++)
+				{
+					const MBSWvalue_dt & input = _values.at(derived.inputs.at(v));
+					if (input.scaled && input.numeric)
+						_variableValues.at(v) = input.scaledValue;
+					else
+						_variableValues.at(v) = std::numeric_limits<double>::quiet_NaN();
+				}
+				if (!derived.expression.evaluate(&_variableValues.at(0), &result) || !derived.scaling.derivedRawValue(result, &rawValue))
+					continue;	// keep last value (e.g. division by zero)
+				decode(derived.scaling, rawValue, &_values.at(_nrOfInputs + d), !_derivedHasValue.at(d));
+				_derivedHasValue.at(d) = true;
+				addToStatistics(_nrOfInputs + d);
+			}
+			_haveValues = true;
+			// Export the values of each frame:
+			if (sharedMemoryExport != NULL)
+				sharedMemoryExport->publish(_time_ms, _values, _outputChannels);
+			if (telemetryServer != NULL)
+				telemetryServer->publish(_time_ms, _values, _outputChannels);
+		}
+		// Update the snapshot for the GUI:
+		_mutex.lock();
+		_snapshotValues = _values;
+		_snapshotHaveValues = true;
+		_lastDuration_ms = queueDurations.back();
+		if (abort || !statisticsTimer.isValid() || (statisticsTimer.elapsed() >= MBSWDECODER_STATISTICS_INTERVAL_MS))
+		{
+			updateStatisticsSnapshot();
+			statisticsTimer.start();
+		}
+		// Notify receiver (only once until the values have been fetched):
+		notify = !_notificationPending;
+		_notificationPending = true;
+		_mutex.unlock();
+		if (notify)
+			emit newValuesAvailable();
+		queue.clear();
+		queueDurations.clear();
+	}
+}
+
+
+void MBSWdecoder::addToStatistics(unsigned int channel)
+{
+	const MBSWvalue_dt & value = _values.at(channel);
+	if (value.scaled && value.numeric)
+	{
+		_statistics.at(channel).add(value.scaledValue);
+		_rollingStatistics.at(channel).add(_time_ms, value.scaledValue);
+	}
+}
+
+
+void MBSWdecoder::updateStatisticsSnapshot()
+{
+	// NOTE: _mutex must be locked by the caller
+	_snapshotStatistics = _statistics;
+	_snapshotRollingStatistics.resize(_rollingStatistics.size());
+	for (unsigned int k=0; k<_rollingStatistics.size(); k++)
+		_snapshotRollingStatistics.at(k) = _rollingStatistics.at(k).statistics();
+}
+
+
+void MBSWdecoder::resetValuesMinMax(std::vector<MBSWvalue_dt> *values)
+{
+	for (unsigned int k=0; k<values->size(); k++)
+		values->at(k).resetMinMax();
+}
+
+
+void MBSWdecoder::setupRollingStatistics(unsigned int window_ms)
+{
+	for (unsigned int k=0; k<_rollingStatistics.size(); k++)
+		_rollingStatistics.at(k).setup(window_ms);
+}
+
+
+void MBSWdecoder::decode(const MBSWscaling_dt & scaling, unsigned int rawValue, MBSWvalue_dt *value, bool first)
+{
+	bool inverse = false;
+	double currentCompValue = 0;
+	double lastCompValue = 0;
+	// Unchanged raw value: scaled value and min/max values can't change
+	if (!first && (rawValue == value->rawValue))
+	{
+		if (value->scaled && value->numeric)
+		{
+			value->count++;
+			value->sum += value->scaledValue;
+		}
+		return;
+	}
+	// Scale raw value:
+	value->rawValue = rawValue;
+	value->scaled = scaling.scale(rawValue, &value->scaledValue, &value->numeric, &value->textIndex);
+	if (!value->scaled)
+	{
+		value->numeric = false;
+		value->scaledValue = 0;
+		value->textIndex = -1;
+	}
+	// Set min and max value to current value, if this is the first value:
+	if (first)
+	{
+		value->resetMinMax();
+		return;
+	}
+	// Average:
+	if (value->scaled && value->numeric)
+	{
+		value->count++;
+		value->sum += value->scaledValue;
+	}
+	/* NOTE:
+	 * - MB/SW scaled values can be NUMERIC VALUES or STRINGS or even BOTH MIXED (for different raw values)
+	 * - scaled numeric values DO NOT necessarily grow with increasing raw values
+	 * => STRATEGY:
+	 * - compare scaled values only if min/max AND current values both have numeric scaled values
+	 * - compare raw values in any other case (even if one of the scaled values is numeric !)
+	 */
+	if (value->minmaxDisabled)
+		return;
+	// Disable min/max values, if the MB/SW has scaled and unscaled values:
+	if (value->scaled != value->minmaxScaled)
+	{
+		value->minmaxDisabled = true;
+		return;
+	}
+	inverse = (scaling.isSW() && value->scaled && scaling.inverseOrder());
+	// Check for new min value:
+	if (value->scaled && value->numeric && value->minNumeric)
+	{
+		currentCompValue = value->scaledValue;
+		lastCompValue = value->minScaledValue;
+	}
+	else
+	{
+		currentCompValue = rawValue;
+		lastCompValue = value->minRawValue;
+	}
+	if (inverse ? (currentCompValue > lastCompValue) : (currentCompValue < lastCompValue))
+	{
+		value->minRawValue = rawValue;
+		value->minNumeric = value->numeric;
+		value->minScaledValue = value->scaledValue;
+	}
+	// Check for new max value:
+	if (value->scaled && value->numeric && value->maxNumeric)
+	{
+		currentCompValue = value->scaledValue;
+		lastCompValue = value->maxScaledValue;
+	}
+	else
+	{
+		currentCompValue = rawValue;
+		lastCompValue = value->maxRawValue;
+	}
+	if (inverse ? (currentCompValue < lastCompValue) : (currentCompValue > lastCompValue))
+	{
+		value->maxRawValue = rawValue;
+		value->maxNumeric = value->numeric;
+		value->maxScaledValue = value->scaledValue;
+	}
+	/* NOTE: always save "real" values for SWs with inverse meaning ! */
+}
@@ -0,0 +1,201 @@
+/*
+ * MBSWdecoder.h - Scaling and min/max determination of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWDECODER_H
+#define MBSWDECODER_H
+
+
+#include <QtGui>
+#include <vector>
+#include <limits>
+#include "SSMprotocol.h"
+#include "libFSSM.h"
+#include "MBSWstatistics.h"
+#include "MBSWlogFile.h"
+#include "MBSWexpression.h"
+
+
+#define		MBSW_DERIVED_INVALID_RAW	0x80000000
+#define		MBSWDECODER_MAX_QUEUE_SIZE	1024	// max. nr. of queued raw value sets, further sets are dropped
+#define		MBSWDECODER_STATISTICS_INTERVAL_MS	250	// min. interval between the statistics snapshots
+
+
+class MBSWsharedMemoryExport;
+class MBSWtelemetryServer;
+
+
+
+/* NOTE: scaling definitions of a MB/SW compiled for fast evaluation.
+ *       Scaling results are identical to libFSSM::raw2scaled().      */
+
+class MBSWscaling_dt
+{
+public:
+	MBSWscaling_dt();
+	void setup(const mb_dt & mb);
+	void setup(const sw_dt & sw);
+	void setupDerived(const mb_dt & mb);
+	bool derivedRawValue(double value, unsigned int *rawValue) const;
+	bool scale(unsigned int rawValue, double *scaledValue, bool *numeric, int *textIndex) const;
+	QString valueStr(unsigned int rawValue, bool scaled) const;
+	QString numberStr(double scaledValue) const;
+	QString unitStr(bool scaled) const;
+	QString defaultUnitStr() const;
+	bool isSW() const;
+	bool inverseOrder() const;
+
+private:
+	bool _isSW;
+	bool _derived;		// fixed point value of a derived MB (signed 32 bit)
+	bool _inverseOrder;	// SWs: a\b => a larger than b
+	char _precision;
+	QString _unit;
+	int _signedBits;	// 0 = unsigned
+	std::vector<char> _operators;	// empty if not scalable by calculation
+	std::vector<double> _operands;
+	std::vector<unsigned int> _textRawValues;	// direct association, SWs: 0 and 1
+	QStringList _texts;
+	std::vector<bool> _textNumeric;
+	std::vector<double> _textValues;
+
+	void setupTexts();
+};
+
+
+
+class MBSWvalue_dt
+{
+public:
+	MBSWvalue_dt();
+	unsigned int rawValue;
+	bool scaled;		// scaling successful
+	bool numeric;		// scaled value is numeric
+	double scaledValue;
+	int textIndex;		// -1 if scaled by calculation
+	bool minmaxDisabled;	// MB/SW has scaled and unscaled values
+	bool minmaxScaled;
+	unsigned int minRawValue;
+	unsigned int maxRawValue;
+	bool minNumeric;
+	bool maxNumeric;
+	double minScaledValue;
+	double maxScaledValue;
+	unsigned int count;	// nr. of numeric scaled values (average)
+	double sum;
+	void resetMinMax();
+	double average() const;
+};
+
+
+
+/* NOTE: derived MBs are calculated from the (scaled) values of measured MBs,
+ *       the value is passed as fixed point raw value to keep min/max and statistics unchanged */
+
+class MBSWderivedMB_dt : public mb_dt
+{
+public:
+	QString expression;
+	MBSWexpression program;		// variables: index of the MB
+};
+
+
+class MBSWderivedChannel_dt
+{
+public:
+	MBSWscaling_dt scaling;
+	MBSWexpression expression;
+	std::vector<unsigned int> inputs;	// input channel of each variable of the expression
+};
+
+
+
+/* NOTE: the decoder thread works on its own data, only the queue and the snapshot of the
+ *       values/statistics for the GUI are shared (each protected by a short lock).      */
+
+class MBSWdecoder : public QThread
+{
+	Q_OBJECT
+
+public:
+	MBSWdecoder();
+	~MBSWdecoder();
+	bool setup(std::vector<MBSWscaling_dt> scalings, std::vector<MBSWderivedChannel_dt> derivedChannels = std::vector<MBSWderivedChannel_dt>(),
+		   std::vector<unsigned int> outputChannels = std::vector<unsigned int>());
+	bool startDecoding();
+	bool stopDecoding();
+	void resetMinMax();
+	bool values(std::vector<MBSWvalue_dt> *values, int *duration_ms);
+	void setRollingWindow(unsigned int window_ms);
+	unsigned int rollingWindow();
+	bool statistics(std::vector<MBSWstatistics> *session, std::vector<MBSWstatistics> *rolling);
+	void setSharedMemoryExport(MBSWsharedMemoryExport *shmExport);
+	void setTelemetryServer(MBSWtelemetryServer *telemetryServer);
+	static bool logFileStatistics(QString filename, std::vector<MBSWlogChannel_dt> *channels, std::vector<MBSWstatistics> *statistics);
+
+public slots:
+	void addRawValues(std::vector<unsigned int> rawValues, int duration_ms);
+
+private:
+	// Decoder thread data:
+	std::vector<MBSWscaling_dt> _scalings;	// input channels, followed by the derived channels
+	unsigned int _nrOfInputs;
+	std::vector<MBSWderivedChannel_dt> _derivedChannels;
+	std::vector<bool> _derivedHasValue;
+	std::vector<double> _variableValues;
+	std::vector<unsigned int> _outputChannels;
+	std::vector<MBSWvalue_dt> _values;
+	bool _haveValues;
+	std::vector<MBSWstatistics> _statistics;
+	std::vector<MBSWrollingStatistics> _rollingStatistics;
+	unsigned int _time_ms;
+	// Queue and requests (protected by _queueMutex):
+	std::vector< std::vector<unsigned int> > _queue;
+	std::vector<int> _queueDurations;
+	unsigned int _droppedRawValues;
+	bool _resetMinMaxRequested;
+	unsigned int _rollingWindow_ms;
+	bool _rollingWindowChanged;
+	bool _abort;
+	MBSWsharedMemoryExport *_sharedMemoryExport;
+	MBSWtelemetryServer *_telemetryServer;
+	QMutex _queueMutex;
+	QWaitCondition _dataAvailable;
+	// Snapshot for the GUI (protected by _mutex):
+	std::vector<MBSWvalue_dt> _snapshotValues;
+	bool _snapshotHaveValues;
+	int _lastDuration_ms;
+	std::vector<MBSWstatistics> _snapshotStatistics;
+	std::vector<MBSWstatistics> _snapshotRollingStatistics;
+	bool _notificationPending;
+	QMutex _mutex;
+
+	void run();
+	void addToStatistics(unsigned int channel);
+	void updateStatisticsSnapshot();
+	void resetValuesMinMax(std::vector<MBSWvalue_dt> *values);
+	void setupRollingStatistics(unsigned int window_ms);
+	static void decode(const MBSWscaling_dt & scaling, unsigned int rawValue, MBSWvalue_dt *value, bool first);
+
+signals:
+	void newValuesAvailable();
+
+};
+
+
+#endif
@@ -0,0 +1,343 @@
+/*
+ * MBSWexpression.cpp - Compiled expressions for derived measuring blocks
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWexpression.h"
+
+
+
+MBSWexpression::MBSWexpression()
+{
+	_pos = 0;
+}
+
+
+bool MBSWexpression::compile(QString expression, QStringList names)
+{
+	bool ok = false;
+	_expression = expression;
+	_program.clear();
+	_variables.clear();
+	_str = expression;
+	_pos = 0;
+	_names = names;
+	ok = parseSum();
+	skipSpaces();
+	if (ok && (_pos < _str.size()))
+		ok = false;	// unexpected characters
+	if (ok)
+		ok = validateStack();
+	if (!ok)
+	{
+		_program.clear();
+		_variables.clear();
+	}
+	_str.clear();
+	_names.clear();
+	return ok;
+}
+
+
+bool MBSWexpression::isValid() const
+{
+	return _program.size();
+}
+
+
+QString MBSWexpression::expression() const
+{
+	return _expression;
+}
+
+
+std::vector<unsigned int> MBSWexpression::variables() const
+{
+	return _variables;
+}
+
+
+bool MBSWexpression::evaluate(const double *values, double *result) const
+{
+	double stack[MBSW_EXPRESSION_MAX_STACK];
+	int top = -1;
+	if (_program.empty())
+		return false;
+	for (unsigned int k=0; k<_program.size(); k++)
+	{
+		const instruction_dt & instr = _program[k];
+		switch (instr.opcode)
+		{
+			case op_const:
+				stack[++top] = instr.constant;
+				break;
+			case op_var:
+				stack[++top] = values[instr.index];
+				break;
+			case op_add:
+				top--;
+				stack[top] += stack[top+1];
+				break;
+			case op_sub:
+				top--;
+				stack[top] -= stack[top+1];
+				break;
+			case op_mul:
+				top--;
+				stack[top] *= stack[top+1];
+				break;
+			case op_div:
+				top--;
+				if (stack[top+1] == 0)
+					return false;
+				stack[top] /= stack[top+1];
+				break;
+			case op_pow:
+				top--;
+				stack[top] = pow(stack[top], stack[top+1]);
+				break;
+			case op_neg:
+				stack[top] = -stack[top];
+				break;
+			case op_abs:
+				stack[top] = fabs(stack[top]);
+				break;
+			case op_sqrt:
+				if (stack[top] < 0)
+					return false;
+				stack[top] = sqrt(stack[top]);
+				break;
+			case op_min:
+				top--;
+				if (stack[top+1] < stack[top])
+					stack[top] = stack[top+1];
+				break;
+			case op_max:
+				top--;
+				if (stack[top+1] > stack[top])
+					stack[top] = stack[top+1];
+				break;
+		}
+	}
+	*result = stack[0];
+	// Invalid variable values (NaN) propagate to the result:
+	return (fabs(*result) < HUGE_VAL);	// false for NaN and infinite values
+}
+
+// PRIVATE:
+
+bool MBSWexpression::parseSum()
+{
+	if (!parseProduct())
+		return false;
+	skipSpaces();
+	while ((_pos < _str.size()) && ((_str.at(_pos) == '+') || (_str.at(_pos) == '-')))
+	{
+		opcode_dt op = (_str.at(_pos) == '+') ? op_add : op_sub;
+		_pos++;
+		if (!parseProduct())
+			return false;
+		_program.push_back( instruction_dt(op) );
+		skipSpaces();
+	}
+	return true;
+}
+
+
+bool MBSWexpression::parseProduct()
+{
+	if (!parseUnary())
+		return false;
+	skipSpaces();
+	while ((_pos < _str.size()) && ((_str.at(_pos) == '*') || (_str.at(_pos) == '/')))
+	{
+		opcode_dt op = (_str.at(_pos) == '*') ? op_mul : op_div;
+		_pos++;
+		if (!parseUnary())
+			return false;
+		_program.push_back( instruction_dt(op) );
+		skipSpaces();
+	}
+	return true;
+}
+
+
+bool MBSWexpression::parseUnary()
+{
+	skipSpaces();
+	if ((_pos < _str.size()) && (_str.at(_pos) == '-'))
+	{
+		_pos++;
+		if (!parseUnary())
+			return false;
+		_program.push_back( instruction_dt(op_neg) );
+		return true;
+	}
+	return parsePower();
+}
+
+
+bool MBSWexpression::parsePower()
+{
+	if (!parsePrimary())
+		return false;
+	skipSpaces();
+	if ((_pos < _str.size()) && (_str.at(_pos) == '^'))
+	{
+		_pos++;
+		if (!parseUnary())	// right associative
+			return false;
+		_program.push_back( instruction_dt(op_pow) );
+	}
+	return true;
+}
+
+
+bool MBSWexpression::parsePrimary()
+{
+	skipSpaces();
+	if (_pos >= _str.size())
+		return false;
+	QChar c = _str.at(_pos);
+	if (c == '(')
+	{
+		// Sub-expression:
+		_pos++;
+		if (!parseSum())
+			return false;
+		skipSpaces();
+		if ((_pos >= _str.size()) || (_str.at(_pos) != ')'))
+			return false;
+		_pos++;
+		return true;
+	}
+	else if (c == '{')
+	{
+		// Variable (MB title):
+		int end = _str.indexOf('}', _pos+1);
+		if (end < 0)
+			return false;
+		int nameIndex = _names.indexOf( _str.mid(_pos+1, end-_pos-1).trimmed() );
+		if (nameIndex < 0)
+			return false;
+		_pos = end + 1;
+		unsigned int var = 0;
+		for (var=0; var<_variables.size(); var++)
+		{
+			if (_variables.at(var) == static_cast<unsigned int>(nameIndex))
+				break;
+		}
+		if (var == _variables.size())
+			_variables.push_back(nameIndex);
+		_program.push_back( instruction_dt(op_var, 0, var) );
+		return true;
+	}
+	else if (c.isDigit() || (c == '.'))
+	{
+		// Number:
+		int start = _pos;
+		while ((_pos < _str.size()) && (_str.at(_pos).isDigit() || (_str.at(_pos) == '.')))
+			_pos++;
+		bool ok = false;
+		double value = _str.mid(start, _pos-start).toDouble(&ok);
+		if (!ok)
+			return false;
+		_program.push_back( instruction_dt(op_const, value) );
+		return true;
+	}
+	else if (c.isLetter())
+	{
+		// Function:
+		int start = _pos;
+		while ((_pos < _str.size()) && _str.at(_pos).isLetter())
+			_pos++;
+		QString name = _str.mid(start, _pos-start).toLower();
+		unsigned int nrOfArgs = 1;
+		opcode_dt op = op_abs;
+		if (name == "abs")
+			op = op_abs;
+		else if (name == "sqrt")
+			op = op_sqrt;
+		else if (name == "min")
+		{
+			op = op_min;
+			nrOfArgs = 2;
+		}
+		else if (name == "max")
+		{
+			op = op_max;
+			nrOfArgs = 2;
+		}
+		else
+			return false;
+		skipSpaces();
+		if ((_pos >= _str.size()) || (_str.at(_pos) != '('))
+			return false;
+		_pos++;
+		for (unsigned int a=0; a<nrOfArgs; a++)
+		{
+			if (a > 0)
+			{
+				skipSpaces();
+				if ((_pos >= _str.size()) || (_str.at(_pos) != ','))
+					return false;
+				_pos++;
+			}
+			if (!parseSum())
+				return false;
+		}
+		skipSpaces();
+		if ((_pos >= _str.size()) || (_str.at(_pos) != ')'))
+			return false;
+		_pos++;
+		_program.push_back( instruction_dt(op) );
+		return true;
+	}
+	return false;
+}
+
+
+void MBSWexpression::skipSpaces()
+{
+	while ((_pos < _str.size()) && _str.at(_pos).isSpace())
+		_pos++;
+}
+
+
+bool MBSWexpression::validateStack() const
+{
+	int depth = 0;
+	for (unsigned int k=0; k<_program.size(); k++)
+	{
+		switch (_program.at(k).opcode)
+		{
+			case op_const:
+			case op_var:
+				depth++;
+				break;
+			case op_neg:
+			case op_abs:
+			case op_sqrt:
+				break;
+			default:	// binary operators
+				depth--;
+		}
+		if ((depth < 1) || (depth > MBSW_EXPRESSION_MAX_STACK))
+			return false;
+	}
+	return (depth == 1);
+}
@@ -0,0 +1,83 @@
+/*
+ * MBSWexpression.h - Compiled expressions for derived measuring blocks
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWEXPRESSION_H
+#define MBSWEXPRESSION_H
+
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <math.h>
+
+
+#define		MBSW_EXPRESSION_MAX_STACK	32
+
+
+
+/* Syntax:
+ *   numbers, {MB title}, + - * / ^, unary -, parentheses,
+ *   functions: abs(x), sqrt(x), min(x,y), max(x,y)
+ *   Example: "{Manifold Relative Pressure} / 1000"
+ * NOTE: the expression is compiled once into a stack program (reverse polish notation),
+ *       evaluation doesn't allocate any memory.
+ */
+
+class MBSWexpression
+{
+
+public:
+	MBSWexpression();
+	bool compile(QString expression, QStringList names);
+	bool isValid() const;
+	QString expression() const;
+	std::vector<unsigned int> variables() const;	// index of the name for each variable of the program
+	bool evaluate(const double *values, double *result) const;	// values of the variables
+
+private:
+	enum opcode_dt {op_const, op_var, op_add, op_sub, op_mul, op_div, op_pow, op_neg, op_abs, op_sqrt, op_min, op_max};
+
+	class instruction_dt
+	{
+	public:
+		instruction_dt(opcode_dt op = op_const, double c = 0, unsigned int i = 0) { opcode=op; constant=c; index=i; };
+		opcode_dt opcode;
+		double constant;
+		unsigned int index;
+	};
+
+	QString _expression;
+	std::vector<instruction_dt> _program;
+	std::vector<unsigned int> _variables;
+	// Parser:
+	QString _str;
+	int _pos;
+	QStringList _names;
+
+	bool parseSum();
+	bool parseProduct();
+	bool parseUnary();
+	bool parsePower();
+	bool parsePrimary();
+	void skipSpaces();
+	bool validateStack() const;
+};
+
+
+#endif
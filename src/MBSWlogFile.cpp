@@ -0,0 +1,753 @@
+/*
+ * MBSWlogFile.cpp - Recording and random access of measuring block/switch logs
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWlogFile.h"
+#include <QDateTime>
+#include <limits.h>
+#include <string.h>
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
+
+
+#define		MBSWLOG_BLOCK_HEADER_SIZE	20
+#define		MBSWLOG_INDEX_ENTRY_SIZE	16
+#define		MBSWLOG_TRAILER_SIZE		16
+
+
+static void appendU8(QByteArray *buf, unsigned char value)
+{
+	buf->append(static_cast<char>(value));
+}
+
+
+static void appendU16(QByteArray *buf, quint16 value)
+{
+	uchar tmp[2];
+	qToLittleEndian<quint16>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 2);
+}
+
+
+static void appendU32(QByteArray *buf, quint32 value)
+{
+	uchar tmp[4];
+	qToLittleEndian<quint32>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 4);
+}
+
+
+static void appendU64(QByteArray *buf, quint64 value)
+{
+	uchar tmp[8];
+	qToLittleEndian<quint64>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 8);
+}
+
+
+static void appendString(QByteArray *buf, QString str)
+{
+	QByteArray utf8 = str.toUtf8();
+	appendU16(buf, utf8.size());
+	buf->append(utf8);
+}
+
+
+
+MBSWrawValueDecoder::MBSWrawValueDecoder()
+{
+}
+
+
+void MBSWrawValueDecoder::setup(const std::vector<unsigned int> & queryAddresses, const std::vector<MBSWlogChannel_dt> & channels)
+{
+	// Precalculate the positions of the channel bytes in the raw data:
+	_lowSlots.assign(channels.size(), -1);
+	_highSlots.assign(channels.size(), -1);
+	_bitMasks.assign(channels.size(), 0);
+	for (unsigned int k=0; k<channels.size(); k++)
+	{
+		std::vector<unsigned int>::const_iterator it;
+		if (channels.at(k).blockType && ((channels.at(k).addrHigh < 1) || (channels.at(k).addrHigh > 8)))
+			continue;	// invalid bit address
+		it = std::find(queryAddresses.begin(), queryAddresses.end(), channels.at(k).addrLow);
+		if (it == queryAddresses.end())
+			continue;
+		_lowSlots.at(k) = it - queryAddresses.begin();
+		if (channels.at(k).blockType)
+			_bitMasks.at(k) = 1 << (channels.at(k).addrHigh - 1);
+		else if (channels.at(k).addrHigh != UINT_MAX)
+		{
+			it = std::find(queryAddresses.begin(), queryAddresses.end(), channels.at(k).addrHigh);
+			if (it != queryAddresses.end())
+				_highSlots.at(k) = it - queryAddresses.begin();
+		}
+	}
+}
+
+
+unsigned int MBSWrawValueDecoder::nrOfChannels() const
+{
+	return _lowSlots.size();
+}
+
+
+bool MBSWrawValueDecoder::isValid(unsigned int channelIndex) const
+{
+	return ((channelIndex < _lowSlots.size()) && (_lowSlots.at(channelIndex) >= 0));
+}
+
+
+unsigned int MBSWrawValueDecoder::rawValue(unsigned int channelIndex, const char *rawdata) const
+{
+	int lowSlot = _lowSlots.at(channelIndex);
+	if (lowSlot < 0)
+		return 0;
+	if (_bitMasks.at(channelIndex))
+		return (rawdata[lowSlot] & _bitMasks.at(channelIndex)) ? 1 : 0;
+	unsigned int value = static_cast<unsigned char>(rawdata[lowSlot]);
+	if (_highSlots.at(channelIndex) >= 0)
+		value += 256 * static_cast<unsigned char>(rawdata[_highSlots.at(channelIndex)]);
+	return value;
+}
+
+
+void MBSWrawValueDecoder::rawValues(const char *rawdata, std::vector<unsigned int> *rawValues) const
+{
+	rawValues->resize(_lowSlots.size());
+	for (unsigned int k=0; k<_lowSlots.size(); k++)
+		rawValues->at(k) = rawValue(k, rawdata);
+}
+
+
+
+MBSWframeRingBuffer::MBSWframeRingBuffer()
+{
+	_start = 0;
+	_count = 0;
+}
+
+
+void MBSWframeRingBuffer::setup(unsigned int capacity, unsigned int frameSize)
+{
+	_frames.resize(capacity);
+	for (unsigned int k=0; k<_frames.size(); k++)
+		_frames.at(k).type = MBSWlogFrame_dt::record_data;
+	setFrameSize(frameSize);
+}
+
+
+void MBSWframeRingBuffer::setFrameSize(unsigned int frameSize)
+{
+	// NOTE: the memory of the frames is reused, it is only reallocated if the frame size exceeds all previous sizes
+	for (unsigned int k=0; k<_frames.size(); k++)
+		_frames.at(k).rawdata.resize(frameSize);
+	clear();
+}
+
+
+void MBSWframeRingBuffer::clear()
+{
+	_start = 0;
+	_count = 0;
+}
+
+
+unsigned int MBSWframeRingBuffer::size() const
+{
+	return _count;
+}
+
+
+unsigned int MBSWframeRingBuffer::capacity() const
+{
+	return _frames.size();
+}
+
+
+void MBSWframeRingBuffer::add(unsigned int time_ms, const std::vector<char> & rawdata)
+{
+	unsigned int index = 0;
+	if (_frames.empty()) return;
+	if (_count < _frames.size())
+	{
+		index = (_start + _count) % _frames.size();
+		_count++;
+	}
+	else
+	{
+		// Overwrite oldest frame:
+		index = _start;
+		_start = (_start + 1) % _frames.size();
+	}
+	MBSWlogFrame_dt & frame = _frames.at(index);
+	frame.time_ms = time_ms;
+	if (rawdata.size() == frame.rawdata.size())
+		std::copy(rawdata.begin(), rawdata.end(), frame.rawdata.begin());
+	else
+		frame.rawdata = rawdata;
+}
+
+
+void MBSWframeRingBuffer::copyFrames(unsigned int from_ms, std::vector<MBSWlogFrame_dt> *frames, bool relativeTime) const
+{
+	unsigned int first = 0;
+	frames->clear();
+	// Skip frames older than the requested time:
+	while ((first < _count) && (at(first).time_ms < from_ms))
+		first++;
+	if (first >= _count)
+		return;
+	frames->resize(_count - first);
+	unsigned int startTime_ms = at(first).time_ms;
+	for (unsigned int k=first; k<_count; k++)
+	{
+		frames->at(k - first) = at(k);
+		if (relativeTime)
+			frames->at(k - first).time_ms -= startTime_ms;
+	}
+}
+
+// PRIVATE
+
+const MBSWlogFrame_dt & MBSWframeRingBuffer::at(unsigned int index) const
+{
+	return _frames.at((_start + index) % _frames.size());
+}
+
+
+
+MBSWlogFileWriter::MBSWlogFileWriter()
+{
+	_nrOfQueryAddresses = 0;
+	_blockRecords = 0;
+	_blockFirstTime = 0;
+	_blockLastTime = 0;
+}
+
+
+MBSWlogFileWriter::~MBSWlogFileWriter()
+{
+	close();
+}
+
+
+bool MBSWlogFileWriter::open(QString filename, std::vector<unsigned int> queryAddresses, std::vector<MBSWlogChannel_dt> channels)
+{
+	if (_file.isOpen())
+		return false;
+	if (queryAddresses.empty() || channels.empty())
+		return false;
+	_file.setFileName(filename);
+	if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	// Write header:
+	QByteArray header("FSSMMBSW", 8);
+	appendU16(&header, MBSWLOG_FORMAT_VERSION);
+	appendU16(&header, 0);
+	appendU64(&header, QDateTime::currentDateTime().toTime_t() * static_cast<quint64>(1000));
+	appendU32(&header, queryAddresses.size());
+	for (unsigned int k=0; k<queryAddresses.size(); k++)
+		appendU32(&header, queryAddresses.at(k));
+	appendU32(&header, channels.size());
+	for (unsigned int k=0; k<channels.size(); k++)
+	{
+		appendU8(&header, channels.at(k).blockType);
+		appendU8(&header, channels.at(k).precision);
+		appendU32(&header, channels.at(k).addrLow);
+		appendU32(&header, channels.at(k).addrHigh);
+		appendString(&header, channels.at(k).title);
+		appendString(&header, channels.at(k).unit);
+		appendString(&header, channels.at(k).scaleformula);
+	}
+	if (_file.write(header) != header.size())
+	{
+		_file.close();
+		return false;
+	}
+	_nrOfQueryAddresses = queryAddresses.size();
+	_block.clear();
+	_blockRecords = 0;
+	_index.clear();
+	return true;
+}
+
+
+bool MBSWlogFileWriter::isOpen()
+{
+	return _file.isOpen();
+}
+
+
+bool MBSWlogFileWriter::addFrame(unsigned int time_ms, const std::vector<char> & rawdata)
+{
+	if (rawdata.size() != _nrOfQueryAddresses)
+		return false;
+	return addRecord(MBSWlogFrame_dt::record_data, time_ms, &rawdata.at(0), rawdata.size());
+}
+
+
+bool MBSWlogFileWriter::addGapMarker(unsigned int time_ms)
+{
+	return addRecord(MBSWlogFrame_dt::record_gap, time_ms, NULL, 0);
+}
+
+
+bool MBSWlogFileWriter::close()
+{
+	if (!_file.isOpen())
+		return true;
+	bool ok = flushBlock();
+	// Write index footer:
+	QByteArray footer;
+	quint64 indexOffset = _file.pos();
+	for (unsigned int k=0; k<_index.size(); k++)
+	{
+		appendU32(&footer, _index.at(k).firstTime_ms);
+		appendU32(&footer, _index.at(k).lastTime_ms);
+		appendU64(&footer, _index.at(k).offset);
+	}
+	appendU64(&footer, indexOffset);
+	appendU32(&footer, _index.size());
+	footer.append("FIDX", 4);
+	if (_file.write(footer) != footer.size())
+		ok = false;
+	_file.close();
+	_index.clear();
+	return ok;
+}
+
+
+bool MBSWlogFileWriter::addRecord(MBSWlogFrame_dt::recordType_dt type, unsigned int time_ms, const char *data, unsigned int datalen)
+{
+	if (!_file.isOpen())
+		return false;
+	if (_blockRecords == 0)
+		_blockFirstTime = time_ms;
+	_blockLastTime = time_ms;
+	appendU8(&_block, type);
+	appendU32(&_block, time_ms);
+	if (datalen)
+		_block.append(data, datalen);
+	_blockRecords++;
+	if (_blockRecords >= MBSWLOG_RECORDS_PER_BLOCK)
+		return flushBlock();
+	return true;
+}
+
+
+bool MBSWlogFileWriter::flushBlock()
+{
+	if (_blockRecords == 0)
+		return true;
+	MBSWlogIndexEntry_dt entry;
+	entry.firstTime_ms = _blockFirstTime;
+	entry.lastTime_ms = _blockLastTime;
+	entry.offset = _file.pos();
+	entry.nrOfRecords = _blockRecords;
+	QByteArray blockheader("BLCK", 4);
+	appendU32(&blockheader, _block.size());
+	appendU32(&blockheader, _blockRecords);
+	appendU32(&blockheader, _blockFirstTime);
+	appendU32(&blockheader, _blockLastTime);
+	bool ok = (_file.write(blockheader) == blockheader.size());
+	ok &= (_file.write(_block) == _block.size());
+	// NOTE: flush each block, so that only the last block is lost if the recording is aborted
+	ok &= _file.flush();
+	_index.push_back(entry);
+	_block.clear();
+	_blockRecords = 0;
+	return ok;
+}
+
+
+
+MBSWlogChannelIterator::MBSWlogChannelIterator()
+{
+	_reader = NULL;
+	_lowSlot = -1;
+	_highSlot = -1;
+	_bitMask = 0;
+	_from_ms = 0;
+	_to_ms = 0;
+	_blockIndex = 0;
+	_recordsLeft = 0;
+	_pos = NULL;
+}
+
+
+bool MBSWlogChannelIterator::next(unsigned int *time_ms, unsigned int *rawValue)
+{
+	if (!_reader || (_lowSlot < 0))
+		return false;
+	while (true)
+	{
+		if (_recordsLeft == 0)
+		{
+			// Switch to next block:
+			if (_pos)
+				_blockIndex++;
+			if (_blockIndex >= _reader->_index.size())
+				return false;
+			const MBSWlogIndexEntry_dt & entry = _reader->_index.at(_blockIndex);
+			if (entry.firstTime_ms > _to_ms)
+				return false;
+			_pos = _reader->_data + entry.offset + MBSWLOG_BLOCK_HEADER_SIZE;
+			_recordsLeft = entry.nrOfRecords;
+			continue;
+		}
+		uchar type = _pos[0];
+		unsigned int t = qFromLittleEndian<quint32>(_pos + 1);
+		const uchar *rawdata = _pos + 5;
+		_pos += _reader->recordSize(type);
+		_recordsLeft--;
+		if (t > _to_ms)
+		{
+			_blockIndex = _reader->_index.size();
+			_recordsLeft = 0;
+			return false;
+		}
+		if ((type != MBSWlogFrame_dt::record_data) || (t < _from_ms))
+			continue;
+		*time_ms = t;
+		if (_bitMask)
+			*rawValue = (rawdata[_lowSlot] & _bitMask) ? 1 : 0;
+		else
+		{
+			*rawValue = rawdata[_lowSlot];
+			if (_highSlot >= 0)
+				*rawValue += 256 * rawdata[_highSlot];
+		}
+		return true;
+	}
+}
+
+
+
+MBSWlogFileReader::MBSWlogFileReader()
+{
+	_data = NULL;
+	_size = 0;
+	_startTime = 0;
+}
+
+
+MBSWlogFileReader::~MBSWlogFileReader()
+{
+	close();
+}
+
+
+bool MBSWlogFileReader::open(QString filename)
+{
+	quint64 dataOffset = 0;
+	if (_file.isOpen())
+		return false;
+	_file.setFileName(filename);
+	if (!_file.open(QIODevice::ReadOnly))
+		return false;
+	_size = _file.size();
+	_data = _file.map(0, _size);
+	if (!_data)
+	{
+		_file.close();
+		return false;
+	}
+	if (!parseHeader(&dataOffset))
+	{
+		close();
+		return false;
+	}
+	if (!readIndexFooter())
+	{
+#ifdef __FSSM_DEBUG__
+		std::cout << "MBSWlogFileReader::open():   no valid index found, scanning file...\n";
+#endif
+		if (!rebuildIndex(dataOffset))
+		{
+			close();
+			return false;
+		}
+	}
+	_decoder.setup(_queryAddresses, _channels);
+	return true;
+}
+
+
+bool MBSWlogFileReader::isOpen()
+{
+	return (_data != NULL);
+}
+
+
+void MBSWlogFileReader::close()
+{
+	if (_data)
+		_file.unmap(const_cast<uchar*>(_data));
+	_data = NULL;
+	_size = 0;
+	_file.close();
+	_queryAddresses.clear();
+	_channels.clear();
+	_decoder.setup(_queryAddresses, _channels);
+	_index.clear();
+}
+
+
+std::vector<unsigned int> MBSWlogFileReader::queryAddresses() const
+{
+	return _queryAddresses;
+}
+
+
+std::vector<MBSWlogChannel_dt> MBSWlogFileReader::channels() const
+{
+	return _channels;
+}
+
+
+quint64 MBSWlogFileReader::startTime() const
+{
+	return _startTime;
+}
+
+
+unsigned int MBSWlogFileReader::duration_ms() const
+{
+	if (_index.empty())
+		return 0;
+	return _index.back().lastTime_ms;
+}
+
+
+bool MBSWlogFileReader::readFrames(unsigned int from_ms, unsigned int to_ms, std::vector<MBSWlogFrame_dt> *frames) const
+{
+	frames->clear();
+	if (!_data || (from_ms > to_ms))
+		return false;
+	for (unsigned int b=firstBlockForTime(from_ms); b<_index.size(); b++)
+	{
+		if (_index.at(b).firstTime_ms > to_ms)
+			break;
+		const uchar *pos = _data + _index.at(b).offset + MBSWLOG_BLOCK_HEADER_SIZE;
+		for (unsigned int r=0; r<_index.at(b).nrOfRecords; r++)
+		{
+			MBSWlogFrame_dt frame;
+			frame.type = static_cast<MBSWlogFrame_dt::recordType_dt>(pos[0]);
+			frame.time_ms = qFromLittleEndian<quint32>(pos + 1);
+			unsigned int recsize = recordSize(pos[0]);
+			if (frame.time_ms > to_ms)
+				return true;
+			if (frame.time_ms >= from_ms)
+			{
+				if (frame.type == MBSWlogFrame_dt::record_data)
+					frame.rawdata.assign(pos + 5, pos + recsize);
+				frames->push_back(frame);
+			}
+			pos += recsize;
+		}
+	}
+	return true;
+}
+
+
+bool MBSWlogFileReader::channelIterator(unsigned int channelIndex, unsigned int from_ms, unsigned int to_ms, MBSWlogChannelIterator *iterator) const
+{
+	if (!_data || (channelIndex >= _channels.size()))
+		return false;
+	if (!_decoder.isValid(channelIndex))
+		return false;
+	iterator->_reader = this;
+	iterator->_lowSlot = _decoder._lowSlots.at(channelIndex);
+	iterator->_highSlot = _decoder._highSlots.at(channelIndex);
+	iterator->_bitMask = _decoder._bitMasks.at(channelIndex);
+	iterator->_from_ms = from_ms;
+	iterator->_to_ms = to_ms;
+	iterator->_blockIndex = firstBlockForTime(from_ms);
+	iterator->_recordsLeft = 0;
+	iterator->_pos = NULL;
+	return true;
+}
+
+
+bool MBSWlogFileReader::assignRawValues(const std::vector<char> & rawdata, std::vector<unsigned int> *rawValues) const
+{
+	if (rawdata.size() != _queryAddresses.size())
+		return false;
+	_decoder.rawValues(&rawdata.at(0), rawValues);
+	return true;
+}
+
+
+bool MBSWlogFileReader::parseHeader(quint64 *dataOffset)
+{
+	const uchar *pos = _data;
+	const uchar *end = _data + _size;
+	if ((_size < 24) || (memcmp(pos, "FSSMMBSW", 8) != 0))
+		return false;
+	if (qFromLittleEndian<quint16>(pos + 8) != MBSWLOG_FORMAT_VERSION)
+		return false;
+	_startTime = qFromLittleEndian<quint64>(pos + 12);
+	unsigned int nrOfAddr = qFromLittleEndian<quint32>(pos + 20);
+	pos += 24;
+	if (static_cast<quint64>(end - pos) < 4*static_cast<quint64>(nrOfAddr) + 4)
+		return false;
+	for (unsigned int k=0; k<nrOfAddr; k++)
+	{
+		_queryAddresses.push_back( qFromLittleEndian<quint32>(pos) );
+		pos += 4;
+	}
+	unsigned int nrOfChannels = qFromLittleEndian<quint32>(pos);
+	pos += 4;
+	for (unsigned int k=0; k<nrOfChannels; k++)
+	{
+		MBSWlogChannel_dt channel;
+		if (end - pos < 10)
+			return false;
+		channel.blockType = pos[0];
+		channel.precision = pos[1];
+		channel.addrLow = qFromLittleEndian<quint32>(pos + 2);
+		channel.addrHigh = qFromLittleEndian<quint32>(pos + 6);
+		pos += 10;
+		QString *strings[3] = {&channel.title, &channel.unit, &channel.scaleformula};
+		for (unsigned int s=0; s<3; s++)
+		{
+			if (end - pos < 2)
+				return false;
+			unsigned int len = qFromLittleEndian<quint16>(pos);
+			pos += 2;
+			if (static_cast<unsigned int>(end - pos) < len)
+				return false;
+			*strings[s] = QString::fromUtf8(reinterpret_cast<const char*>(pos), len);
+			pos += len;
+		}
+		_channels.push_back(channel);
+	}
+	*dataOffset = pos - _data;
+	return true;
+}
+
+
+bool MBSWlogFileReader::readIndexFooter()
+{
+	if (_size < MBSWLOG_TRAILER_SIZE)
+		return false;
+	const uchar *trailer = _data + _size - MBSWLOG_TRAILER_SIZE;
+	if (memcmp(trailer + 12, "FIDX", 4) != 0)
+		return false;
+	quint64 indexOffset = qFromLittleEndian<quint64>(trailer);
+	unsigned int nrOfBlocks = qFromLittleEndian<quint32>(trailer + 8);
+	if ((indexOffset > static_cast<quint64>(_size))
+	    || (indexOffset + static_cast<quint64>(nrOfBlocks) * MBSWLOG_INDEX_ENTRY_SIZE != static_cast<quint64>(_size - MBSWLOG_TRAILER_SIZE)))
+		return false;
+	const uchar *pos = _data + indexOffset;
+	_index.resize(nrOfBlocks);
+	for (unsigned int k=0; k<nrOfBlocks; k++)
+	{
+		_index.at(k).offset = qFromLittleEndian<quint64>(pos + 8);
+		pos += MBSWLOG_INDEX_ENTRY_SIZE;
+	}
+	// Validate the blocks (each block must end before the next block / the index):
+	for (unsigned int k=0; k<nrOfBlocks; k++)
+	{
+		quint64 limit = indexOffset;
+		if (k+1 < nrOfBlocks)
+			limit = _index.at(k+1).offset;
+		if (!validateBlock(_index.at(k).offset, limit, &_index.at(k)))
+		{
+			_index.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool MBSWlogFileReader::rebuildIndex(quint64 dataOffset)
+{
+	quint64 offset = dataOffset;
+	_index.clear();
+	while (offset + MBSWLOG_BLOCK_HEADER_SIZE <= static_cast<quint64>(_size))
+	{
+		MBSWlogIndexEntry_dt entry;
+		if (!validateBlock(offset, _size, &entry))
+			break;	// footer, truncated or corrupted block: ignore the rest of the file
+		_index.push_back(entry);
+		offset += MBSWLOG_BLOCK_HEADER_SIZE + qFromLittleEndian<quint32>(_data + offset + 4);
+	}
+	return true;
+}
+
+
+bool MBSWlogFileReader::validateBlock(quint64 offset, quint64 limit, MBSWlogIndexEntry_dt *entry) const
+{
+	/* NOTE: the readers access the mapped data without further checks,
+	 *       so the record sizes must match the payload size exactly      */
+	if ((limit > static_cast<quint64>(_size)) || (offset + MBSWLOG_BLOCK_HEADER_SIZE > limit))
+		return false;
+	const uchar *pos = _data + offset;
+	if (memcmp(pos, "BLCK", 4) != 0)
+		return false;
+	quint64 payloadSize = qFromLittleEndian<quint32>(pos + 4);
+	unsigned int nrOfRecords = qFromLittleEndian<quint32>(pos + 8);
+	if (offset + MBSWLOG_BLOCK_HEADER_SIZE + payloadSize > limit)
+		return false;
+	quint64 recordOffset = 0;
+	for (unsigned int r=0; r<nrOfRecords; r++)
+	{
+		if (recordOffset + 5 > payloadSize)
+			return false;
+		uchar type = pos[MBSWLOG_BLOCK_HEADER_SIZE + recordOffset];
+		if ((type != MBSWlogFrame_dt::record_data) && (type != MBSWlogFrame_dt::record_gap))
+			return false;
+		recordOffset += recordSize(type);
+	}
+	if (recordOffset != payloadSize)
+		return false;
+	entry->firstTime_ms = qFromLittleEndian<quint32>(pos + 12);
+	entry->lastTime_ms = qFromLittleEndian<quint32>(pos + 16);
+	entry->offset = offset;
+	entry->nrOfRecords = nrOfRecords;
+	return true;
+}
+
+
+unsigned int MBSWlogFileReader::firstBlockForTime(unsigned int time_ms) const
+{
+	// Binary search for the first block which ends at or after the specified time:
+	unsigned int low = 0;
+	unsigned int high = _index.size();
+	while (low < high)
+	{
+		unsigned int mid = low + (high - low) / 2;
+		if (_index.at(mid).lastTime_ms < time_ms)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+
+unsigned int MBSWlogFileReader::recordSize(uchar type) const
+{
+	if (type == MBSWlogFrame_dt::record_data)
+		return 5 + _queryAddresses.size();
+	return 5;
+}
@@ -0,0 +1,219 @@
+/*
+ * MBSWlogFile.h - Recording and random access of measuring block/switch logs
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWLOGFILE_H
+#define MBSWLOGFILE_H
+
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QtEndian>
+#include <vector>
+#include <algorithm>
+
+
+/* File layout (all values little endian):
+ *   header:  "FSSMMBSW", u16 version, u16 reserved, u64 start time (ms since epoch),
+ *            u32 number of query addresses, u32 addresses[],
+ *            u32 number of channels, channels[] (u8 blockType, u8 precision, u32 addrLow/byteAddr,
+ *            u32 addrHigh/bitAddr, u16-length-prefixed UTF-8 title, unit, scaling formula)
+ *   blocks:  "BLCK", u32 payload size, u32 record count, u32 first time, u32 last time, records[]
+ *            record: u8 type, u32 time (ms since start of recording), raw data bytes (data records only)
+ *   footer:  index entries[] (u32 first time, u32 last time, u64 block offset),
+ *            u64 index offset, u32 number of blocks, "FIDX"
+ * NOTE: the footer is written when the log is closed. Files without footer (e.g. after a crash)
+ *       are still readable, the index is rebuilt from the block headers in this case.
+ */
+
+#define		MBSWLOG_FORMAT_VERSION		1
+#define		MBSWLOG_RECORDS_PER_BLOCK	256
+
+
+class MBSWlogChannel_dt
+{
+public:
+	MBSWlogChannel_dt() { blockType=0; precision=0; addrLow=0; addrHigh=0; };
+	bool blockType;			// 0=MB, 1=SW
+	char precision;
+	unsigned int addrLow;		// SW: byte address
+	unsigned int addrHigh;		// SW: bit address (1-8); MB: MEMORY_ADDRESS_NONE if 8 bit value
+	QString title;
+	QString unit;
+	QString scaleformula;
+};
+
+
+class MBSWlogFrame_dt
+{
+public:
+	enum recordType_dt {record_data=0, record_gap=1};
+	MBSWlogFrame_dt() { type=record_data; time_ms=0; };
+	recordType_dt type;
+	unsigned int time_ms;
+	std::vector<char> rawdata;
+};
+
+
+class MBSWlogIndexEntry_dt
+{
+public:
+	unsigned int firstTime_ms;
+	unsigned int lastTime_ms;
+	quint64 offset;
+	unsigned int nrOfRecords;
+};
+
+
+
+class MBSWrawValueDecoder
+{
+
+public:
+	MBSWrawValueDecoder();
+	void setup(const std::vector<unsigned int> & queryAddresses, const std::vector<MBSWlogChannel_dt> & channels);
+	unsigned int nrOfChannels() const;
+	bool isValid(unsigned int channelIndex) const;
+	unsigned int rawValue(unsigned int channelIndex, const char *rawdata) const;
+	void rawValues(const char *rawdata, std::vector<unsigned int> *rawValues) const;
+
+private:
+	friend class MBSWlogFileReader;
+	std::vector<int> _lowSlots;	// position of the (low) data byte in the raw data, -1 if not available
+	std::vector<int> _highSlots;	// position of the high data byte in the raw data, -1 if 8 bit value
+	std::vector<unsigned char> _bitMasks;	// switches only
+};
+
+
+
+/* NOTE: all frames are allocated in advance, adding frames doesn't allocate memory */
+
+class MBSWframeRingBuffer
+{
+
+public:
+	MBSWframeRingBuffer();
+	void setup(unsigned int capacity, unsigned int frameSize);
+	void setFrameSize(unsigned int frameSize);
+	void clear();
+	unsigned int size() const;
+	unsigned int capacity() const;
+	void add(unsigned int time_ms, const std::vector<char> & rawdata);
+	void copyFrames(unsigned int from_ms, std::vector<MBSWlogFrame_dt> *frames, bool relativeTime=true) const;
+
+private:
+	std::vector<MBSWlogFrame_dt> _frames;
+	unsigned int _start;
+	unsigned int _count;
+
+	const MBSWlogFrame_dt & at(unsigned int index) const;
+};
+
+
+
+class MBSWlogFileWriter
+{
+
+public:
+	MBSWlogFileWriter();
+	~MBSWlogFileWriter();
+	bool open(QString filename, std::vector<unsigned int> queryAddresses, std::vector<MBSWlogChannel_dt> channels);
+	bool isOpen();
+	bool addFrame(unsigned int time_ms, const std::vector<char> & rawdata);
+	bool addGapMarker(unsigned int time_ms);
+	bool close();
+
+private:
+	QFile _file;
+	unsigned int _nrOfQueryAddresses;
+	QByteArray _block;
+	unsigned int _blockRecords;
+	unsigned int _blockFirstTime;
+	unsigned int _blockLastTime;
+	std::vector<MBSWlogIndexEntry_dt> _index;
+
+	bool addRecord(MBSWlogFrame_dt::recordType_dt type, unsigned int time_ms, const char *data, unsigned int datalen);
+	bool flushBlock();
+};
+
+
+
+class MBSWlogFileReader;
+
+
+class MBSWlogChannelIterator
+{
+
+public:
+	MBSWlogChannelIterator();
+	bool next(unsigned int *time_ms, unsigned int *rawValue);
+
+private:
+	friend class MBSWlogFileReader;
+	const MBSWlogFileReader *_reader;
+	int _lowSlot;
+	int _highSlot;
+	unsigned char _bitMask;
+	unsigned int _from_ms;
+	unsigned int _to_ms;
+	unsigned int _blockIndex;
+	unsigned int _recordsLeft;
+	const uchar *_pos;
+};
+
+
+
+class MBSWlogFileReader
+{
+
+public:
+	MBSWlogFileReader();
+	~MBSWlogFileReader();
+	bool open(QString filename);
+	bool isOpen();
+	void close();
+	std::vector<unsigned int> queryAddresses() const;
+	std::vector<MBSWlogChannel_dt> channels() const;
+	quint64 startTime() const;
+	unsigned int duration_ms() const;
+	bool readFrames(unsigned int from_ms, unsigned int to_ms, std::vector<MBSWlogFrame_dt> *frames) const;
+	bool channelIterator(unsigned int channelIndex, unsigned int from_ms, unsigned int to_ms, MBSWlogChannelIterator *iterator) const;
+	bool assignRawValues(const std::vector<char> & rawdata, std::vector<unsigned int> *rawValues) const;
+
+private:
+	friend class MBSWlogChannelIterator;
+	QFile _file;
+	const uchar *_data;
+	qint64 _size;
+	quint64 _startTime;
+	std::vector<unsigned int> _queryAddresses;
+	std::vector<MBSWlogChannel_dt> _channels;
+	MBSWrawValueDecoder _decoder;
+	std::vector<MBSWlogIndexEntry_dt> _index;
+
+	bool parseHeader(quint64 *dataOffset);
+	bool readIndexFooter();
+	bool rebuildIndex(quint64 dataOffset);
+	bool validateBlock(quint64 offset, quint64 limit, MBSWlogIndexEntry_dt *entry) const;
+	unsigned int firstBlockForTime(unsigned int time_ms) const;
+	unsigned int recordSize(uchar type) const;
+};
+
+
+#endif
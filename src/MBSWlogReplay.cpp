@@ -0,0 +1,257 @@
+/*
+ * MBSWlogReplay.cpp - Replay of recorded measuring block/switch logs
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWlogReplay.h"
+
+
+
+MBSWlogReplay::MBSWlogReplay()
+{
+	_abort = false;
+	_speed = 1;
+	_seekRequested = true;
+	_seekTime_ms = 0;
+}
+
+
+MBSWlogReplay::~MBSWlogReplay()
+{
+	stopReplay();
+	_reader.close();
+}
+
+
+bool MBSWlogReplay::open(QString filename)
+{
+	if (isRunning()) return false;
+	_reader.close();
+	_slotMap.clear();
+	return _reader.open(filename);
+}
+
+
+std::vector<unsigned int> MBSWlogReplay::queryAddresses()
+{
+	return _reader.queryAddresses();
+}
+
+
+std::vector<MBSWlogChannel_dt> MBSWlogReplay::channels()
+{
+	return _reader.channels();
+}
+
+
+unsigned int MBSWlogReplay::duration_ms()
+{
+	return _reader.duration_ms();
+}
+
+
+bool MBSWlogReplay::setTargetQueryAddresses(std::vector<unsigned int> addresses)
+{
+	// Setup map for reordering the recorded raw data:
+	std::vector<unsigned int> logAddresses = _reader.queryAddresses();
+	std::vector<unsigned int> slotMap;
+	if (isRunning()) return false;
+	for (unsigned int k=0; k<addresses.size(); k++)
+	{
+		std::vector<unsigned int>::iterator it = std::find(logAddresses.begin(), logAddresses.end(), addresses.at(k));
+		if (it == logAddresses.end())
+			return false;	// address not recorded
+		slotMap.push_back(it - logAddresses.begin());
+	}
+	_slotMap = slotMap;
+	return true;
+}
+
+
+void MBSWlogReplay::setSpeed(double factor)
+{
+	_mutex.lock();
+	if (factor < 0)
+		factor = 0;
+	_speed = factor;
+	_mutex.unlock();
+}
+
+
+void MBSWlogReplay::seek(unsigned int time_ms)
+{
+	_mutex.lock();
+	_seekRequested = true;
+	_seekTime_ms = time_ms;
+	_mutex.unlock();
+}
+
+
+bool MBSWlogReplay::startReplay()
+{
+	if (isRunning() || !_reader.isOpen()) return false;
+	_abort = false;
+	start();
+	return true;
+}
+
+
+bool MBSWlogReplay::stopReplay()
+{
+	if (!isRunning())
+		return true;
+	bool stopped = false;
+	QTimer timer;
+	connect( this, SIGNAL( finished() ), &_el, SLOT( quit() ) );
+	connect( &timer, SIGNAL( timeout() ), &_el, SLOT( quit() ) );
+	_mutex.lock();
+	_abort = true;
+	_mutex.unlock();
+	timer.start(5000);
+	_el.exec();	// NOTE: processes the data emitted with Qt::BlockingQueuedConnection
+	disconnect( &timer, SIGNAL( timeout() ), &_el, SLOT( quit() ) );
+	disconnect( this, SIGNAL( finished() ), &_el, SLOT( quit() ) );
+	stopped = !isRunning();
+	if (!stopped)
+	{
+		terminate();
+		stopped = wait(5000);
+	}
+	return stopped;
+}
+
+// PRIVATE:
+
+void MBSWlogReplay::run()
+{
+	std::vector<MBSWlogFrame_dt> frames;
+	std::vector<char> rawdata;
+	unsigned int frameIndex = 0;
+	unsigned int nextWindowStart_ms = 0;
+	unsigned int paceStartTime_ms = 0;
+	bool paceValid = false;
+	double lastSpeed = 0;
+	unsigned int lastFrameTime_ms = 0;
+	bool lastFrameTimeValid = false;
+	int duration_ms = 0;
+	QTime paceTimer;
+	QTime positionTimer;
+	bool abort = false;
+	bool seekRequested = false;
+	unsigned int seekTime_ms = 0;
+	double speed = 0;
+
+	positionTimer.start();
+	while (true)
+	{
+		_mutex.lock();
+		abort = _abort;
+		speed = _speed;
+		seekRequested = _seekRequested;
+		seekTime_ms = _seekTime_ms;
+		_seekRequested = false;
+		_mutex.unlock();
+		if (abort) break;
+		if (seekRequested)
+		{
+			frames.clear();
+			frameIndex = 0;
+			nextWindowStart_ms = seekTime_ms;
+			paceValid = false;
+			lastFrameTimeValid = false;
+		}
+		// Decode next time window:
+		if (frameIndex >= frames.size())
+		{
+			if (nextWindowStart_ms > _reader.duration_ms())
+			{
+				emit position(_reader.duration_ms());
+				emit endReached();
+				break;
+			}
+			_reader.readFrames(nextWindowStart_ms, nextWindowStart_ms + MBSWREPLAY_READ_WINDOW_MS - 1, &frames);
+			frameIndex = 0;
+			nextWindowStart_ms += MBSWREPLAY_READ_WINDOW_MS;
+			continue;
+		}
+		const MBSWlogFrame_dt & frame = frames.at(frameIndex);
+		frameIndex++;
+		if (frame.type == MBSWlogFrame_dt::record_gap)
+		{
+			// Skip communication gaps:
+			paceValid = false;
+			continue;
+		}
+		// Wait until the frame is due:
+		if (speed > 0)
+		{
+			if (!paceValid || (speed != lastSpeed))
+			{
+				paceTimer.start();
+				paceStartTime_ms = frame.time_ms;
+				paceValid = true;
+				lastSpeed = speed;
+			}
+			else if (!waitUntil(&paceTimer, static_cast<int>((frame.time_ms - paceStartTime_ms) / speed)))
+				continue;	// abort or seek request
+		}
+		// Reorder raw data according to the current query address list:
+		if (_slotMap.size())
+		{
+			rawdata.resize(_slotMap.size());
+			for (unsigned int k=0; k<_slotMap.size(); k++)
+				rawdata.at(k) = frame.rawdata.at(_slotMap.at(k));
+		}
+		else
+			rawdata = frame.rawdata;
+		/* NOTE: the durations are derived from the recorded time stamps (scaled by the replay speed),
+		 *       the replay timing is not exact (and is nearly 0 at maximum speed)                    */
+		duration_ms = 0;
+		if (lastFrameTimeValid)
+		{
+			duration_ms = frame.time_ms - lastFrameTime_ms;
+			if (speed > 0)
+				duration_ms = static_cast<int>(duration_ms / speed);
+		}
+		lastFrameTime_ms = frame.time_ms;
+		lastFrameTimeValid = true;
+		emit recievedData(rawdata, duration_ms);
+		if (positionTimer.elapsed() >= MBSWREPLAY_POSITION_INTERVAL_MS)
+		{
+			positionTimer.restart();
+			emit position(frame.time_ms);
+		}
+	}
+}
+
+
+bool MBSWlogReplay::waitUntil(QTime *paceTimer, int elapsed_ms)
+{
+	int remaining_ms = 0;
+	while (true)
+	{
+		_mutex.lock();
+		bool interrupt = (_abort || _seekRequested);
+		_mutex.unlock();
+		if (interrupt)
+			return false;
+		remaining_ms = elapsed_ms - paceTimer->elapsed();
+		if (remaining_ms <= 0)
+			return true;
+		msleep( (remaining_ms > 20) ? 20 : remaining_ms );
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * MBSWlogReplay.h - Replay of recorded measuring block/switch logs
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWLOGREPLAY_H
+#define MBSWLOGREPLAY_H
+
+
+#include <QtGui>
+#include <vector>
+#include "MBSWlogFile.h"
+
+
+#define MBSWREPLAY_READ_WINDOW_MS	10000	// time window of frames decoded at once
+#define MBSWREPLAY_POSITION_INTERVAL_MS	200	// min. interval between position signals
+
+
+
+/* NOTE: the replay thread emits the recorded raw data exactly like the
+ *       communication threads do during permanent read operations.     */
+
+class MBSWlogReplay : public QThread
+{
+	Q_OBJECT
+
+public:
+	MBSWlogReplay();
+	~MBSWlogReplay();
+	bool open(QString filename);
+	std::vector<unsigned int> queryAddresses();
+	std::vector<MBSWlogChannel_dt> channels();
+	unsigned int duration_ms();
+	bool setTargetQueryAddresses(std::vector<unsigned int> addresses);
+	void setSpeed(double factor);	// 0 = as fast as possible
+	void seek(unsigned int time_ms);
+	bool startReplay();
+	bool stopReplay();
+
+private:
+	MBSWlogFileReader _reader;
+	std::vector<unsigned int> _slotMap;
+	QMutex _mutex;
+	QEventLoop _el;
+	bool _abort;
+	double _speed;
+	bool _seekRequested;
+	unsigned int _seekTime_ms;
+
+	void run();
+	bool waitUntil(QTime *paceTimer, int elapsed_ms);
+
+signals:
+	void recievedData(std::vector<char> rawdata, int duration_ms);
+	void position(unsigned int time_ms);
+	void endReached();
+
+};
+
+
+#endif
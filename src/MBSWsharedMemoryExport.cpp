@@ -0,0 +1,200 @@
+/*
+ * MBSWsharedMemoryExport.cpp - Export of the latest MB/SW values to a shared memory segment
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWsharedMemoryExport.h"
+
+
+
+MBSWsharedMemoryExport *MBSWsharedMemoryExport::_instance = NULL;
+
+
+MBSWsharedMemoryExport::MBSWsharedMemoryExport()
+{
+	_segment = NULL;
+	_size = MBSW_SHM_HEADER_SIZE + MBSW_SHM_MAX_CHANNELS * (MBSW_SHM_DESCRIPTOR_SIZE + MBSW_SHM_VALUE_SIZE);
+	_nrOfChannels = 0;
+	_frameNr = 0;
+#ifdef __WIN32__
+	_mapping = NULL;
+#endif
+}
+
+
+MBSWsharedMemoryExport::~MBSWsharedMemoryExport()
+{
+	destroy();
+}
+
+
+bool MBSWsharedMemoryExport::create(QString name)
+{
+	if (_segment != NULL)
+		return false;
+	/* NOTE: the segment has a fixed size (max. nr. of channels), so readers never have to remap it */
+#ifdef __WIN32__
+	_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, _size, name.toLocal8Bit().constData());
+	if (_mapping == NULL)
+		return false;
+	_segment = static_cast<char*>( MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, _size) );
+	if (_segment == NULL)
+	{
+		CloseHandle(_mapping);
+		_mapping = NULL;
+		return false;
+	}
+#else
+	int fd = shm_open(name.toLocal8Bit().constData(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0)
+		return false;
+	if (ftruncate(fd, _size) < 0)
+	{
+		::close(fd);
+		shm_unlink(name.toLocal8Bit().constData());
+		return false;
+	}
+	void *segment = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);	// NOTE: the mapping stays valid
+	if (segment == MAP_FAILED)
+	{
+		shm_unlink(name.toLocal8Bit().constData());
+		return false;
+	}
+	_segment = static_cast<char*>(segment);
+#endif
+	_name = name;
+	// Setup header:
+	memset(_segment, 0, _size);
+	memcpy(_segment, "FSSMSHM", 8);
+	*field(8) = MBSW_SHM_FORMAT_VERSION;
+	*field(24) = MBSW_SHM_HEADER_SIZE;
+	*field(28) = MBSW_SHM_HEADER_SIZE + MBSW_SHM_MAX_CHANNELS * MBSW_SHM_DESCRIPTOR_SIZE;
+	_nrOfChannels = 0;
+	_frameNr = 0;
+	_instance = this;
+	return true;
+}
+
+
+void MBSWsharedMemoryExport::destroy()
+{
+	QMutexLocker locker(&_mutex);
+	if (_segment == NULL)
+		return;
+	if (_instance == this)
+		_instance = NULL;
+#ifdef __WIN32__
+	UnmapViewOfFile(_segment);
+	CloseHandle(_mapping);
+	_mapping = NULL;
+#else
+	munmap(_segment, _size);
+	// NOTE: readers which have the segment mapped keep their (last) values
+	shm_unlink(_name.toLocal8Bit().constData());
+#endif
+	_segment = NULL;
+}
+
+
+bool MBSWsharedMemoryExport::isCreated()
+{
+	return (_segment != NULL);
+}
+
+
+bool MBSWsharedMemoryExport::setChannels(const std::vector<MBSWlogChannel_dt> & channels)
+{
+	QMutexLocker locker(&_mutex);
+	if ((_segment == NULL) || (channels.size() > MBSW_SHM_MAX_CHANNELS))
+		return false;
+	const unsigned int valuesOffset = *field(28);
+	beginUpdate();
+	for (unsigned int k=0; k<MBSW_SHM_MAX_CHANNELS; k++)
+	{
+		char *descriptor = _segment + MBSW_SHM_HEADER_SIZE + k * MBSW_SHM_DESCRIPTOR_SIZE;
+		memset(descriptor, 0, MBSW_SHM_DESCRIPTOR_SIZE);
+		memset(_segment + valuesOffset + k * MBSW_SHM_VALUE_SIZE, 0, MBSW_SHM_VALUE_SIZE);
+		if (k >= channels.size())
+			continue;
+		QByteArray title = channels.at(k).title.toUtf8().left(MBSW_SHM_TITLE_SIZE - 1);
+		QByteArray unit = channels.at(k).unit.toUtf8().left(MBSW_SHM_UNIT_SIZE - 1);
+		memcpy(descriptor, title.constData(), title.size());
+		memcpy(descriptor + MBSW_SHM_TITLE_SIZE, unit.constData(), unit.size());
+		*field(descriptor - _segment + MBSW_SHM_TITLE_SIZE + MBSW_SHM_UNIT_SIZE) = valuesOffset + k * MBSW_SHM_VALUE_SIZE;
+		*field(descriptor - _segment + MBSW_SHM_TITLE_SIZE + MBSW_SHM_UNIT_SIZE + 4) = channels.at(k).blockType;
+	}
+	_nrOfChannels = channels.size();
+	_frameNr = 0;
+	*field(16) += 1;	// layout generation
+	*field(20) = _nrOfChannels;
+	*field(32) = 0;
+	*field(36) = 0;
+	endUpdate();
+	return true;
+}
+
+
+void MBSWsharedMemoryExport::publish(unsigned int time_ms, const std::vector<MBSWvalue_dt> & values, const std::vector<unsigned int> & outputChannels)
+{
+	/* NOTE: called by the decoder thread for each frame. Only memory is written (no system calls),
+	 *       the mutex is uncontended (the layout is changed only while decoding is stopped).       */
+	QMutexLocker locker(&_mutex);
+	if ((_segment == NULL) || (outputChannels.size() != _nrOfChannels))
+		return;
+	char *value = _segment + *field(28);
+	beginUpdate();
+	for (unsigned int k=0; k<_nrOfChannels; k++, value += MBSW_SHM_VALUE_SIZE)
+	{
+		const MBSWvalue_dt & v = values.at(outputChannels.at(k));
+		bool valid = (v.scaled && v.numeric);
+		double scaledValue = valid ? v.scaledValue : std::numeric_limits<double>::quiet_NaN();
+		memcpy(value, &scaledValue, 8);
+		*field(value - _segment + 8) = v.rawValue;
+		*field(value - _segment + 12) = valid;
+	}
+	*field(32) = ++_frameNr;
+	*field(36) = time_ms;
+	endUpdate();
+}
+
+
+MBSWsharedMemoryExport * MBSWsharedMemoryExport::instance()
+{
+	return _instance;
+}
+
+// PRIVATE
+
+quint32 * MBSWsharedMemoryExport::field(unsigned int offset)
+{
+	return reinterpret_cast<quint32*>(_segment + offset);
+}
+
+
+void MBSWsharedMemoryExport::beginUpdate()
+{
+	// Sequence becomes odd, ordered: the data is not written before
+	reinterpret_cast<QAtomicInt*>(field(12))->fetchAndAddOrdered(1);
+}
+
+
+void MBSWsharedMemoryExport::endUpdate()
+{
+	// Sequence becomes even, ordered: the data has been written completely
+	reinterpret_cast<QAtomicInt*>(field(12))->fetchAndAddOrdered(1);
+}
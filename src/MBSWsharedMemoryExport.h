@@ -0,0 +1,105 @@
+/*
+ * MBSWsharedMemoryExport.h - Export of the latest MB/SW values to a shared memory segment
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWSHAREDMEMORYEXPORT_H
+#define MBSWSHAREDMEMORYEXPORT_H
+
+
+#ifdef __WIN32__
+    #include <windows.h>
+#elif defined __linux__
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#else
+    #error "Operating system not supported !"
+#endif
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+#include <QAtomicInt>
+#include <vector>
+#include <limits>
+#include <cstring>
+#include "MBSWdecoder.h"
+#include "MBSWlogFile.h"
+
+
+#ifdef __WIN32__
+    #define	MBSW_SHM_NAME		"Local\\FreeSSM.values"
+#else
+    #define	MBSW_SHM_NAME		"/FreeSSM.values"
+#endif
+#define		MBSW_SHM_FORMAT_VERSION		1
+#define		MBSW_SHM_MAX_CHANNELS		256
+#define		MBSW_SHM_HEADER_SIZE		64
+#define		MBSW_SHM_DESCRIPTOR_SIZE	128
+#define		MBSW_SHM_VALUE_SIZE		16
+#define		MBSW_SHM_TITLE_SIZE		80
+#define		MBSW_SHM_UNIT_SIZE		32
+
+
+/* Segment layout (native byte order, offsets in bytes):
+ *   header:      0: char[8] "FSSMSHM", 8: u32 format version, 12: u32 sequence,
+ *                16: u32 layout generation, 20: u32 nr. of channels, 24: u32 descriptors offset,
+ *                28: u32 values offset, 32: u32 frame nr., 36: u32 time (ms since start of MB/SW reading)
+ *   descriptors: 128 bytes per channel: char[80] title, char[32] unit (UTF-8, NUL-terminated),
+ *                u32 value offset, u32 kind (0=MB, 1=SW)
+ *   values:      16 bytes per channel: f64 scaled value (NaN if not numeric), u32 raw value,
+ *                u32 flags (bit 0: scaled value is valid)
+ *
+ * The sequence is a seqlock, it is odd while the segment is updated. Readers never block the writer:
+ * read sequence s1 (retry if odd), copy the needed data, read sequence s2 and retry if s1 != s2.
+ * A change of the layout generation means that the descriptors have changed.
+ */
+
+class MBSWsharedMemoryExport
+{
+
+public:
+	MBSWsharedMemoryExport();
+	~MBSWsharedMemoryExport();
+	bool create(QString name = MBSW_SHM_NAME);
+	void destroy();
+	bool isCreated();
+	bool setChannels(const std::vector<MBSWlogChannel_dt> & channels);
+	void publish(unsigned int time_ms, const std::vector<MBSWvalue_dt> & values, const std::vector<unsigned int> & outputChannels);
+	static MBSWsharedMemoryExport * instance();
+
+private:
+	static MBSWsharedMemoryExport *_instance;
+	QString _name;
+	char *_segment;
+	unsigned int _size;
+	unsigned int _nrOfChannels;
+	unsigned int _frameNr;
+	QMutex _mutex;		// writers only
+#ifdef __WIN32__
+	HANDLE _mapping;
+#endif
+
+	quint32 * field(unsigned int offset);
+	void beginUpdate();
+	void endUpdate();
+
+};
+
+
+#endif
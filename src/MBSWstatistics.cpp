@@ -0,0 +1,373 @@
+/*
+ * MBSWstatistics.cpp - Streaming statistics of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWstatistics.h"
+
+
+
+MBSWdigest::MBSWdigest(unsigned int compression)
+{
+	_compression = compression;
+	if (_compression < 10)
+		_compression = 10;
+	clear();
+}
+
+
+void MBSWdigest::clear()
+{
+	_means.clear();
+	_weights.clear();
+	_weight = 0;
+	_bufferedValues.clear();
+	_bufferedWeights.clear();
+	_bufferedWeight = 0;
+	_min = 0;
+	_max = 0;
+}
+
+
+void MBSWdigest::add(double value, double weight)
+{
+	if (weight <= 0) return;
+	if ((_weight + _bufferedWeight) == 0)
+	{
+		_min = value;
+		_max = value;
+	}
+	else
+	{
+		if (value < _min)
+			_min = value;
+		if (value > _max)
+			_max = value;
+	}
+	_bufferedValues.push_back(value);
+	_bufferedWeights.push_back(weight);
+	_bufferedWeight += weight;
+	if (_bufferedValues.size() >= (5 * _compression))
+		compress();
+}
+
+
+void MBSWdigest::merge(const MBSWdigest & digest)
+{
+	if (digest.totalWeight() == 0) return;
+	// Add the centroids and buffered values of the other digest:
+	for (unsigned int k=0; k<digest._means.size(); k++)
+		add(digest._means.at(k), digest._weights.at(k));
+	for (unsigned int k=0; k<digest._bufferedValues.size(); k++)
+		add(digest._bufferedValues.at(k), digest._bufferedWeights.at(k));
+	// Min/max values of the other digest:
+	if (digest._min < _min)
+		_min = digest._min;
+	if (digest._max > _max)
+		_max = digest._max;
+	compress();
+}
+
+
+double MBSWdigest::quantile(double q) const
+{
+	if (_bufferedValues.size())
+	{
+		MBSWdigest compressed(*this);
+		compressed.compress();
+		return compressed.quantile(q);
+	}
+	if (_means.empty())
+		return 0;
+	if (q <= 0)
+		return _min;
+	if (q >= 1)
+		return _max;
+	if (_means.size() == 1)
+		return _means.at(0);
+	double index = q * _weight;
+	double weightSoFar = _weights.at(0) / 2;
+	double result = 0;
+	// Left tail (between min value and first centroid):
+	if (index < weightSoFar)
+		result = _min + (_means.at(0) - _min) * index / weightSoFar;
+	else
+	{
+		// Interpolate between the centroids:
+		unsigned int k = 0;
+		for (k=0; k<(_means.size()-1); k++)
+		{
+			double dw = (_weights.at(k) + _weights.at(k+1)) / 2;
+			if ((weightSoFar + dw) > index)
+			{
+				result = _means.at(k) + (_means.at(k+1) - _means.at(k)) * (index - weightSoFar) / dw;
+				break;
+			}
+			weightSoFar += dw;
+		}
+		// Right tail (between last centroid and max value):
+		if (k == (_means.size()-1))
+			result = _means.back() + (_max - _means.back()) * (index - weightSoFar) / (_weights.back() / 2);
+	}
+	if (result < _min)
+		result = _min;
+	if (result > _max)
+		result = _max;
+	return result;
+}
+
+
+double MBSWdigest::totalWeight() const
+{
+	return _weight + _bufferedWeight;
+}
+
+// PRIVATE:
+
+void MBSWdigest::compress()
+{
+	std::vector< std::pair<double, double> > items;
+	std::vector<double> means;
+	std::vector<double> weights;
+	double total = _weight + _bufferedWeight;
+	double weightSoFar = 0;
+	double currentMean = 0;
+	double currentWeight = 0;
+	if (_bufferedValues.empty()) return;
+	// Sort centroids and buffered values:
+	items.reserve(_means.size() + _bufferedValues.size());
+	for (unsigned int k=0; k<_means.size(); k++)
+		items.push_back( std::make_pair(_means.at(k), _weights.at(k)) );
+	for (unsigned int k=0; k<_bufferedValues.size(); k++)
+		items.push_back( std::make_pair(_bufferedValues.at(k), _bufferedWeights.at(k)) );
+	std::sort(items.begin(), items.end());
+	// Merge neighbouring items as long as the size limit of the centroid is not exceeded:
+	currentMean = items.at(0).first;
+	currentWeight = items.at(0).second;
+	for (unsigned int k=1; k<items.size(); k++)
+	{
+		double proposedWeight = currentWeight + items.at(k).second;
+		if ((scale((weightSoFar + proposedWeight) / total) - scale(weightSoFar / total)) <= 1)
+		{
+			currentMean += (items.at(k).first - currentMean) * items.at(k).second / proposedWeight;
+			currentWeight = proposedWeight;
+		}
+		else
+		{
+			means.push_back(currentMean);
+			weights.push_back(currentWeight);
+			weightSoFar += currentWeight;
+			currentMean = items.at(k).first;
+			currentWeight = items.at(k).second;
+		}
+	}
+	means.push_back(currentMean);
+	weights.push_back(currentWeight);
+	// Save new centroids:
+	_means.swap(means);
+	_weights.swap(weights);
+	_weight = total;
+	_bufferedValues.clear();
+	_bufferedWeights.clear();
+	_bufferedWeight = 0;
+}
+
+
+double MBSWdigest::scale(double q) const
+{
+	/* NOTE: scale function k1 of the t-digest: small centroids at the tails,
+	 *       large centroids around the median */
+	if (q < 0)
+		q = 0;
+	if (q > 1)
+		q = 1;
+	return _compression * asin(2*q - 1) / (2 * M_PI);
+}
+
+
+
+MBSWstatistics::MBSWstatistics(unsigned int digestCompression) : _digest(digestCompression)
+{
+	clear();
+}
+
+
+void MBSWstatistics::clear()
+{
+	_count = 0;
+	_mean = 0;
+	_M2 = 0;
+	_min = 0;
+	_max = 0;
+	_digest.clear();
+}
+
+
+void MBSWstatistics::add(double value)
+{
+	double delta = 0;
+	// Min/max:
+	if (!_count || (value < _min))
+		_min = value;
+	if (!_count || (value > _max))
+		_max = value;
+	// Mean and variance (Welford):
+	_count++;
+	delta = value - _mean;
+	_mean += delta / _count;
+	_M2 += delta * (value - _mean);
+	// Percentiles:
+	_digest.add(value);
+}
+
+
+void MBSWstatistics::merge(const MBSWstatistics & statistics)
+{
+	double delta = 0;
+	unsigned long count = 0;
+	if (!statistics._count) return;
+	if (!_count)
+	{
+		_count = statistics._count;
+		_mean = statistics._mean;
+		_M2 = statistics._M2;
+		_min = statistics._min;
+		_max = statistics._max;
+		_digest.merge(statistics._digest);
+		return;
+	}
+	// Combine mean and variance (parallel algorithm):
+	count = _count + statistics._count;
+	delta = statistics._mean - _mean;
+	_mean += delta * statistics._count / count;
+	_M2 += statistics._M2 + delta * delta * (static_cast<double>(_count) * statistics._count / count);
+	_count = count;
+	// Min/max:
+	if (statistics._min < _min)
+		_min = statistics._min;
+	if (statistics._max > _max)
+		_max = statistics._max;
+	// Percentiles:
+	_digest.merge(statistics._digest);
+}
+
+
+unsigned long MBSWstatistics::count() const
+{
+	return _count;
+}
+
+
+double MBSWstatistics::mean() const
+{
+	return _mean;
+}
+
+
+double MBSWstatistics::variance() const
+{
+	if (_count < 2)
+		return 0;
+	return _M2 / (_count - 1);
+}
+
+
+double MBSWstatistics::standardDeviation() const
+{
+	return sqrt(variance());
+}
+
+
+double MBSWstatistics::min() const
+{
+	return _min;
+}
+
+
+double MBSWstatistics::max() const
+{
+	return _max;
+}
+
+
+double MBSWstatistics::percentile(double p) const
+{
+	return _digest.quantile(p / 100);
+}
+
+
+
+MBSWrollingStatistics::MBSWrollingStatistics()
+{
+	_blockDuration_ms = MBSW_DEFAULT_ROLLING_WINDOW_MS / MBSW_ROLLING_BLOCKS;
+	_blocks.assign(MBSW_ROLLING_BLOCKS + 1, MBSWstatistics(MBSW_ROLLING_DIGEST_COMPRESSION));
+	_blockNrs.assign(MBSW_ROLLING_BLOCKS + 1, 0);
+	_blockUsed.assign(MBSW_ROLLING_BLOCKS + 1, false);
+	_lastBlockNr = 0;
+}
+
+
+void MBSWrollingStatistics::setup(unsigned int window_ms)
+{
+	_blockDuration_ms = window_ms / MBSW_ROLLING_BLOCKS;
+	if (_blockDuration_ms < 1)
+		_blockDuration_ms = 1;
+	clear();
+}
+
+
+void MBSWrollingStatistics::clear()
+{
+	for (unsigned int k=0; k<_blocks.size(); k++)
+	{
+		_blocks.at(k).clear();
+		_blockUsed.at(k) = false;
+	}
+	_lastBlockNr = 0;
+}
+
+
+void MBSWrollingStatistics::add(unsigned int time_ms, double value)
+{
+	unsigned int blockNr = time_ms / _blockDuration_ms;
+	unsigned int index = blockNr % _blocks.size();
+	// Time jumped backwards (e.g. replay seek or restart): the old blocks are not part of the new window
+	if (blockNr < _lastBlockNr)
+		clear();
+	// Start new block, if necessary:
+	if (!_blockUsed.at(index) || (_blockNrs.at(index) != blockNr))
+	{
+		_blocks.at(index).clear();
+		_blockNrs.at(index) = blockNr;
+		_blockUsed.at(index) = true;
+	}
+	_blocks.at(index).add(value);
+	_lastBlockNr = blockNr;
+}
+
+
+MBSWstatistics MBSWrollingStatistics::statistics() const
+{
+	MBSWstatistics statistics(MBSW_ROLLING_DIGEST_COMPRESSION);
+	for (unsigned int k=0; k<_blocks.size(); k++)
+	{
+		// Merge all blocks within the time window:
+		if (_blockUsed.at(k) && (_blockNrs.at(k) + _blocks.size() > _lastBlockNr) && (_blockNrs.at(k) <= _lastBlockNr))
+			statistics.merge(_blocks.at(k));
+	}
+	return statistics;
+}
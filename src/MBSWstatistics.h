@@ -0,0 +1,118 @@
+/*
+ * MBSWstatistics.h - Streaming statistics of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWSTATISTICS_H
+#define MBSWSTATISTICS_H
+
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+
+#define		MBSW_DIGEST_COMPRESSION			100	// session statistics
+#define		MBSW_ROLLING_DIGEST_COMPRESSION		20	// per block of the rolling statistics
+#define		MBSW_ROLLING_BLOCKS			10
+#define		MBSW_DEFAULT_ROLLING_WINDOW_MS		10000
+
+
+
+/* NOTE: percentile sketch (merging t-digest). The number of centroids is limited
+ *       by the compression factor, so the memory usage doesn't grow with the
+ *       number of values. Digests can be merged (e.g. of several log files).    */
+
+class MBSWdigest
+{
+
+public:
+	MBSWdigest(unsigned int compression = MBSW_DIGEST_COMPRESSION);
+	void clear();
+	void add(double value, double weight = 1);
+	void merge(const MBSWdigest & digest);
+	double quantile(double q) const;	// q = 0...1
+	double totalWeight() const;
+
+private:
+	unsigned int _compression;
+	std::vector<double> _means;	// centroids, sorted by mean
+	std::vector<double> _weights;
+	double _weight;			// total weight of the centroids
+	std::vector<double> _bufferedValues;
+	std::vector<double> _bufferedWeights;
+	double _bufferedWeight;
+	double _min;
+	double _max;
+
+	void compress();
+	double scale(double q) const;
+};
+
+
+
+class MBSWstatistics
+{
+
+public:
+	MBSWstatistics(unsigned int digestCompression = MBSW_DIGEST_COMPRESSION);
+	void clear();
+	void add(double value);
+	void merge(const MBSWstatistics & statistics);
+	unsigned long count() const;
+	double mean() const;
+	double variance() const;
+	double standardDeviation() const;
+	double min() const;
+	double max() const;
+	double percentile(double p) const;	// p = 0...100
+
+private:
+	unsigned long _count;
+	double _mean;
+	double _M2;	// sum of squared differences from the mean
+	double _min;
+	double _max;
+	MBSWdigest _digest;
+};
+
+
+
+/* NOTE: the time window is divided into blocks, the statistics of the blocks
+ *       are merged on request. The covered time span is between window and
+ *       window + 1 block.                                                   */
+
+class MBSWrollingStatistics
+{
+
+public:
+	MBSWrollingStatistics();
+	void setup(unsigned int window_ms);
+	void clear();
+	void add(unsigned int time_ms, double value);
+	MBSWstatistics statistics() const;
+
+private:
+	unsigned int _blockDuration_ms;
+	std::vector<MBSWstatistics> _blocks;
+	std::vector<unsigned int> _blockNrs;
+	std::vector<bool> _blockUsed;
+	unsigned int _lastBlockNr;
+};
+
+
+#endif
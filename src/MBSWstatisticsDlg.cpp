@@ -0,0 +1,224 @@
+/*
+ * MBSWstatisticsDlg.cpp - Dialog for displaying statistics of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWstatisticsDlg.h"
+
+
+
+MBSWstatisticsDlg::MBSWstatisticsDlg(QWidget *parent, MBSWdecoder *decoder, QStringList titles, std::vector<MBSWscaling_dt> scalings) : QDialog(parent)
+{
+	_decoder = decoder;
+	_liveData = (_decoder != NULL);
+	// Setup GUI:
+	setupUi(this);
+	setupUiFonts();
+	unsigned int window_ms = _decoder ? _decoder->rollingWindow() : MBSW_DEFAULT_ROLLING_WINDOW_MS;
+	rolling_checkBox->setText(tr("Last %1 s only").arg(window_ms / 1000));
+	rolling_checkBox->setEnabled(_liveData);
+	// Setup entries for the currently selected MBs/SWs:
+	for (int k=0; k<titles.size(); k++)
+	{
+		MBSWstatisticsEntry_dt entry;
+		entry.title = titles.at(k);
+		if (k < static_cast<int>(scalings.size()))
+			entry.scaling = scalings.at(k);
+		_entries.push_back(entry);
+	}
+	refreshStatistics();
+	// CONNECT BUTTONS AND TIMER WITH SLOTS:
+	connect(addlogs_pushButton, SIGNAL( released() ), this, SLOT( addLogFiles() ));
+	connect(close_pushButton, SIGNAL( released() ), this, SLOT( close() ));
+	connect(rolling_checkBox, SIGNAL( toggled(bool) ), this, SLOT( refreshStatistics() ));
+	connect(&_refreshTimer, SIGNAL( timeout() ), this, SLOT( refreshStatistics() ));
+	// Refresh live statistics periodically:
+	if (_liveData)
+		_refreshTimer.start(MBSW_STATISTICS_REFRESH_INTERVAL);
+}
+
+
+MBSWstatisticsDlg::~MBSWstatisticsDlg()
+{
+	_refreshTimer.stop();
+	disconnect(addlogs_pushButton, SIGNAL( released() ), this, SLOT( addLogFiles() ));
+	disconnect(close_pushButton, SIGNAL( released() ), this, SLOT( close() ));
+	disconnect(rolling_checkBox, SIGNAL( toggled(bool) ), this, SLOT( refreshStatistics() ));
+	disconnect(&_refreshTimer, SIGNAL( timeout() ), this, SLOT( refreshStatistics() ));
+}
+
+
+void MBSWstatisticsDlg::refreshStatistics()
+{
+	std::vector<MBSWstatistics> session;
+	std::vector<MBSWstatistics> rolling;
+	if (_liveData && _decoder->statistics(&session, &rolling))
+	{
+		// NOTE: the statistics of the decoder refer to the MB/SW selection of the last reading
+		if ((session.size() == _entries.size()) && (rolling.size() == _entries.size()))
+		{
+			for (unsigned int k=0; k<_entries.size(); k++)
+			{
+				_entries.at(k).session = session.at(k);
+				_entries.at(k).rolling = rolling.at(k);
+			}
+		}
+	}
+	displayStatistics();
+}
+
+
+void MBSWstatisticsDlg::addLogFiles()
+{
+	QStringList filenames = QFileDialog::getOpenFileNames(this, tr("Add Measuring Block Logs"), QDir::homePath(), tr("FreeSSM MB/SW logs (*.fmbsw)"));
+	QStringList failedFiles;
+	if (filenames.isEmpty()) return;
+	// Stop live update (statistics of the log files are merged into the current statistics):
+	_refreshTimer.stop();
+	_liveData = false;
+	rolling_checkBox->setChecked(false);
+	rolling_checkBox->setEnabled(false);
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	for (int f=0; f<filenames.size(); f++)
+	{
+		std::vector<MBSWlogChannel_dt> channels;
+		std::vector<MBSWstatistics> statistics;
+		if (!MBSWdecoder::logFileStatistics(filenames.at(f), &channels, &statistics))
+		{
+			failedFiles.push_back(QFileInfo(filenames.at(f)).fileName());
+			continue;
+		}
+		// Merge statistics of all channels with the same title and unit:
+		for (unsigned int c=0; c<channels.size(); c++)
+		{
+			MBSWstatisticsEntry_dt entry;
+			entry.title = channels.at(c).title;
+			if (channels.at(c).blockType == 0)	// MB
+			{
+				mb_dt mb;
+				mb.title = channels.at(c).title;
+				mb.unit = channels.at(c).unit;
+				mb.scaleformula = channels.at(c).scaleformula;
+				mb.precision = channels.at(c).precision;
+				entry.scaling.setup(mb);
+			}
+			else	// SW
+			{
+				sw_dt sw;
+				sw.title = channels.at(c).title;
+				sw.unit = channels.at(c).unit;
+				entry.scaling.setup(sw);
+			}
+			unsigned int e = 0;
+			for (e=0; e<_entries.size(); e++)
+			{
+				if ((_entries.at(e).title == entry.title) && (_entries.at(e).scaling.defaultUnitStr() == entry.scaling.defaultUnitStr()))
+					break;
+			}
+			if (e < _entries.size())
+				_entries.at(e).session.merge(statistics.at(c));
+			else
+			{
+				entry.session = statistics.at(c);
+				_entries.push_back(entry);
+			}
+		}
+	}
+	QApplication::restoreOverrideCursor();
+	displayStatistics();
+	if (failedFiles.size())
+	{
+		QMessageBox msg( QMessageBox::Warning, tr("Warning"), tr("The following log files couldn't be read:\n") + failedFiles.join("\n"), QMessageBox::Ok, this);
+		QFont msgfont = msg.font();
+		msgfont.setPixelSize(12); // 9pts
+		msg.setFont( msgfont );
+		msg.show();
+		msg.exec();
+		msg.close();
+	}
+}
+
+// PRIVATE:
+
+void MBSWstatisticsDlg::displayStatistics()
+{
+	bool rolling = rolling_checkBox->isChecked();
+	statistics_tableWidget->setRowCount(_entries.size());
+	for (unsigned int k=0; k<_entries.size(); k++)
+	{
+		const MBSWstatisticsEntry_dt & entry = _entries.at(k);
+		const MBSWstatistics & statistics = rolling ? entry.rolling : entry.session;
+		QStringList texts;
+		texts << entry.title << QString::number(statistics.count());
+		if (statistics.count())
+		{
+			texts << entry.scaling.numberStr(statistics.mean());
+			texts << entry.scaling.numberStr(statistics.standardDeviation());
+			texts << entry.scaling.numberStr(statistics.min());
+			texts << entry.scaling.numberStr(statistics.percentile(50));
+			texts << entry.scaling.numberStr(statistics.percentile(95));
+			texts << entry.scaling.numberStr(statistics.max());
+		}
+		else
+		{
+			for (int c=0; c<6; c++)
+				texts << "---";
+		}
+		texts << entry.scaling.defaultUnitStr();
+		for (int c=0; c<texts.size(); c++)
+		{
+			QTableWidgetItem *item = statistics_tableWidget->item(k, c);
+			if (!item)
+			{
+				item = new QTableWidgetItem();
+				if ((c > 0) && (c < (texts.size()-1)))
+					item->setTextAlignment(Qt::AlignCenter);
+				statistics_tableWidget->setItem(k, c, item);
+			}
+			if (item->text() != texts.at(c))
+				item->setText(texts.at(c));
+		}
+	}
+}
+
+
+void MBSWstatisticsDlg::setupUiFonts()
+{
+	// SET FONT FAMILY AND FONT SIZE
+	// OVERWRITES SETTINGS OF ui_MBSWstatisticsDlg.h (made with QDesigner)
+	QFont appfont = QApplication::font();
+	QFont font = this->font();
+	font.setFamily(appfont.family());
+	font.setPixelSize(12);	// 9pts
+	this->setFont(font);
+	font = title_label->font();
+	font.setBold(true);
+	font.setPixelSize(13);	// 10pts
+	title_label->setFont(font);
+	font = statistics_tableWidget->font();
+	font.setPixelSize(12);	// 9pts
+	statistics_tableWidget->setFont(font);
+	font = rolling_checkBox->font();
+	font.setPixelSize(12);	// 9pts
+	rolling_checkBox->setFont(font);
+	font = addlogs_pushButton->font();
+	font.setPixelSize(13);	// 10pts
+	addlogs_pushButton->setFont(font);
+	font = close_pushButton->font();
+	font.setPixelSize(13);	// 10pts
+	close_pushButton->setFont(font);
+}
@@ -0,0 +1,72 @@
+/*
+ * MBSWstatisticsDlg.h - Dialog for displaying statistics of measuring block/switch values
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWSTATISTICSDLG_H
+#define MBSWSTATISTICSDLG_H
+
+
+
+#include <QtGui>
+#include <vector>
+#include "ui_MBSWstatisticsDlg.h"
+#include "MBSWdecoder.h"
+#include "MBSWstatistics.h"
+
+
+#define		MBSW_STATISTICS_REFRESH_INTERVAL	1000	// [ms]
+
+
+
+class MBSWstatisticsEntry_dt
+{
+public:
+	QString title;
+	MBSWscaling_dt scaling;
+	MBSWstatistics session;
+	MBSWstatistics rolling;
+};
+
+
+
+class MBSWstatisticsDlg : public QDialog, private Ui::MBSWstatistics_Dialog
+{
+	Q_OBJECT
+
+private:
+	MBSWdecoder *_decoder;
+	std::vector<MBSWstatisticsEntry_dt> _entries;
+	bool _liveData;
+	QTimer _refreshTimer;
+
+	void displayStatistics();
+	void setupUiFonts();
+
+public:
+	MBSWstatisticsDlg(QWidget *parent, MBSWdecoder *decoder, QStringList titles, std::vector<MBSWscaling_dt> scalings);
+	~MBSWstatisticsDlg();
+
+private slots:
+	void refreshStatistics();
+	void addLogFiles();
+
+};
+
+
+
+#endif
@@ -0,0 +1,396 @@
+/*
+ * MBSWtelemetryServer.cpp - Publishing of the live MB/SW values on local sockets
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWtelemetryServer.h"
+
+
+static void appendLE(QByteArray *buf, quint64 value, unsigned char nrOfBytes)
+{
+	for (unsigned char k=0; k<nrOfBytes; k++)
+		buf->append( static_cast<char>((value >> (8*k)) & 0xFF) );
+}
+
+
+
+MBSWtelemetrySubscriber_dt::MBSWtelemetrySubscriber_dt()
+{
+	socket = NULL;
+	subscribed = false;
+	decimation = 1;
+	skippedSamples = 0;
+}
+
+
+
+MBSWtelemetryServer *MBSWtelemetryServer::_instance = NULL;
+
+
+MBSWtelemetryServer::MBSWtelemetryServer(QObject *parent) : QObject(parent)
+{
+	_nrOfChannels = 0;
+	_sampleNr = 0;
+	_sendScheduled = false;
+	_startTime = QDateTime::currentDateTime();
+	connect( &_localServer, SIGNAL( newConnection() ), this, SLOT( newLocalConnection() ) );
+	connect( &_tcpServer, SIGNAL( newConnection() ), this, SLOT( newTcpConnection() ) );
+}
+
+
+MBSWtelemetryServer::~MBSWtelemetryServer()
+{
+	close();
+	disconnect( &_localServer, SIGNAL( newConnection() ), this, SLOT( newLocalConnection() ) );
+	disconnect( &_tcpServer, SIGNAL( newConnection() ), this, SLOT( newTcpConnection() ) );
+}
+
+
+bool MBSWtelemetryServer::listen(QString localName, quint16 tcpPort)
+{
+	close();
+	// Remove the socket file of a crashed instance (NOTE: never of a running server):
+	QLocalSocket probe;
+	probe.connectToServer(localName);
+	if (probe.waitForConnected(TELEMETRY_PROBE_TIMEOUT))
+	{
+		probe.abort();
+		return false;	// another instance is running
+	}
+	if (probe.error() == QLocalSocket::ConnectionRefusedError)
+		QLocalServer::removeServer(localName);
+	if (!_localServer.listen(localName))
+		return false;
+	if (tcpPort && !_tcpServer.listen(QHostAddress::LocalHost, tcpPort))
+	{
+		_localServer.close();
+		return false;
+	}
+	_instance = this;
+	return true;
+}
+
+
+void MBSWtelemetryServer::close()
+{
+	while (_subscribers.size())
+		dropSubscriber(_subscribers.size() - 1);
+	_localServer.close();
+	_tcpServer.close();
+	if (_instance == this)
+		_instance = NULL;
+}
+
+
+void MBSWtelemetryServer::setChannels(const std::vector<MBSWlogChannel_dt> & channels)
+{
+	// NOTE: only title, unit and type are used (order of the decoder output channels)
+	_channels = channels;
+	_startTime = QDateTime::currentDateTime();
+	_sampleMutex.lock();
+	_nrOfChannels = channels.size();
+	_sampleNr = 0;
+	_pendingSamples.clear();
+	_sampleMutex.unlock();
+	// Subscriptions refer to the previous channels:
+	QByteArray metadataFrame = metadata();
+	for (unsigned int k=0; k<_subscribers.size(); k++)
+	{
+		_subscribers.at(k).subscribed = false;
+		_subscribers.at(k).channels.clear();
+		sendFrame(k, frame_metadata, metadataFrame);
+	}
+}
+
+
+unsigned int MBSWtelemetryServer::numberOfSubscribers()
+{
+	return _subscribers.size();
+}
+
+
+MBSWtelemetryServer * MBSWtelemetryServer::instance()
+{
+	return _instance;
+}
+
+
+void MBSWtelemetryServer::publish(unsigned int time_ms, const std::vector<MBSWvalue_dt> & values, const std::vector<unsigned int> & outputChannels)
+{
+	/* NOTE: called by the decoder thread for each frame. The values are only queued,
+	 *       they are sent to the subscribers in the thread of the server (sendSamples()). */
+	MBSWtelemetrySample_dt sample;
+	bool schedule = false;
+	sample.time_ms = time_ms;
+	sample.rawValues.resize(outputChannels.size());
+	sample.scaledValues.resize(outputChannels.size());
+	for (unsigned int k=0; k<outputChannels.size(); k++)
+	{
+		const MBSWvalue_dt & v = values.at(outputChannels.at(k));
+		sample.rawValues.at(k) = v.rawValue;
+		sample.scaledValues.at(k) = (v.scaled && v.numeric) ? v.scaledValue : std::numeric_limits<double>::quiet_NaN();
+	}
+	_sampleMutex.lock();
+	if (outputChannels.size() != _nrOfChannels)
+	{
+		_sampleMutex.unlock();
+		return;
+	}
+	sample.sampleNr = ++_sampleNr;
+	if (_pendingSamples.size() >= TELEMETRY_MAX_PENDING_SAMPLES)
+		_pendingSamples.erase(_pendingSamples.begin());
+	_pendingSamples.push_back(sample);
+	schedule = !_sendScheduled;
+	_sendScheduled = true;
+	_sampleMutex.unlock();
+	if (schedule)
+		QMetaObject::invokeMethod(this, "sendSamples", Qt::QueuedConnection);
+}
+
+
+// PRIVATE
+
+void MBSWtelemetryServer::addSubscriber(QIODevice *socket)
+{
+	MBSWtelemetrySubscriber_dt subscriber;
+	subscriber.socket = socket;
+	_subscribers.push_back(subscriber);
+	connect( socket, SIGNAL( readyRead() ), this, SLOT( readControlMessages() ) );
+	connect( socket, SIGNAL( disconnected() ), this, SLOT( subscriberDisconnected() ) );
+	sendFrame(_subscribers.size() - 1, frame_metadata, metadata());
+}
+
+
+void MBSWtelemetryServer::dropSubscriber(unsigned int index)
+{
+	QIODevice *socket = _subscribers.at(index).socket;
+	_subscribers.erase(_subscribers.begin() + index);
+	disconnect( socket, SIGNAL( readyRead() ), this, SLOT( readControlMessages() ) );
+	disconnect( socket, SIGNAL( disconnected() ), this, SLOT( subscriberDisconnected() ) );
+	// NOTE: abort() discards the pending data
+	QLocalSocket *localSocket = qobject_cast<QLocalSocket*>(socket);
+	QTcpSocket *tcpSocket = qobject_cast<QTcpSocket*>(socket);
+	if (localSocket != NULL)
+		localSocket->abort();
+	else if (tcpSocket != NULL)
+		tcpSocket->abort();
+	socket->deleteLater();
+}
+
+
+int MBSWtelemetryServer::subscriberIndex(QObject *socket)
+{
+	for (unsigned int k=0; k<_subscribers.size(); k++)
+	{
+		if (_subscribers.at(k).socket == socket)
+			return k;
+	}
+	return -1;
+}
+
+
+void MBSWtelemetryServer::processControlMessage(unsigned int index, QString message)
+{
+	MBSWtelemetrySubscriber_dt & subscriber = _subscribers.at(index);
+	QRegExp cmdRx("\"cmd\"\\s*:\\s*\"(\\w+)\"");
+	QRegExp channelsRx("\"channels\"\\s*:\\s*\\[([^\\]]*)\\]");
+	QRegExp decimationRx("\"decimation\"\\s*:\\s*(\\d+)");
+	QString cmd;
+	bool ok = false;
+	if (cmdRx.indexIn(message) >= 0)
+		cmd = cmdRx.cap(1);
+	if (cmd == "subscribe")
+	{
+		std::vector<unsigned int> channels;
+		unsigned int decimation = 1;
+		ok = true;
+		if (channelsRx.indexIn(message) >= 0)
+		{
+			QStringList indexes = channelsRx.cap(1).split(',', QString::SkipEmptyParts);
+			for (int k=0; (k<indexes.size()) && ok; k++)
+			{
+				unsigned int channel = indexes.at(k).trimmed().toUInt(&ok);
+				if (ok && (channel < _channels.size()))
+					channels.push_back(channel);
+				else
+					ok = false;
+			}
+		}
+		if (decimationRx.indexIn(message) >= 0)
+			decimation = decimationRx.cap(1).toUInt();
+		if (decimation < 1)
+			ok = false;
+		if (ok)
+		{
+			subscriber.subscribed = true;
+			subscriber.channels = channels;
+			subscriber.decimation = decimation;
+			subscriber.skippedSamples = 0;
+		}
+	}
+	else if (cmd == "unsubscribe")
+	{
+		subscriber.subscribed = false;
+		ok = true;
+	}
+	else if (cmd == "metadata")
+	{
+		sendFrame(index, frame_metadata, metadata());
+		ok = true;
+	}
+	QString reply = "{\"type\":\"reply\",\"cmd\":" + JSONstring(cmd) + ",\"ok\":" + (ok ? "true" : "false") + "}";
+	sendFrame(index, frame_reply, reply.toUtf8());
+}
+
+
+void MBSWtelemetryServer::sendFrame(unsigned int index, frameType_dt type, const QByteArray & payload)
+{
+	QByteArray frame;
+	frame.reserve(5 + payload.size());
+	frame.append( static_cast<char>(type) );
+	appendLE(&frame, payload.size(), 4);
+	frame.append(payload);
+	_subscribers.at(index).socket->write(frame);
+}
+
+
+QByteArray MBSWtelemetryServer::metadata()
+{
+	QString json = "{\"type\":\"metadata\",\"start\":" + JSONstring(_startTime.toString(Qt::ISODate)) + ",\"channels\":[";
+	for (unsigned int k=0; k<_channels.size(); k++)
+	{
+		if (k > 0)
+			json += ",";
+		json += "{\"index\":" + QString::number(k) + ",\"title\":" + JSONstring(_channels.at(k).title)
+		        + ",\"unit\":" + JSONstring(_channels.at(k).unit)
+		        + ",\"kind\":" + (_channels.at(k).blockType ? "\"SW\"" : "\"MB\"") + "}";
+	}
+	json += "]}";
+	return json.toUtf8();
+}
+
+
+QString MBSWtelemetryServer::JSONstring(QString str)
+{
+	QString escaped = "\"";
+	for (int k=0; k<str.size(); k++)
+	{
+		QChar c = str.at(k);
+		if ((c == '"') || (c == '\\'))
+			escaped += QString("\\") + c;
+		else if (c.unicode() < 0x20)
+			escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+		else
+			escaped += c;
+	}
+	return escaped + "\"";
+}
+
+
+void MBSWtelemetryServer::newLocalConnection()
+{
+	while (_localServer.hasPendingConnections())
+		addSubscriber( _localServer.nextPendingConnection() );
+}
+
+
+void MBSWtelemetryServer::newTcpConnection()
+{
+	while (_tcpServer.hasPendingConnections())
+		addSubscriber( _tcpServer.nextPendingConnection() );
+}
+
+
+void MBSWtelemetryServer::readControlMessages()
+{
+	int index = subscriberIndex(sender());
+	if (index < 0)
+		return;
+	_subscribers.at(index).rxBuffer.append( _subscribers.at(index).socket->readAll() );
+	int end = 0;
+	while ((end = _subscribers.at(index).rxBuffer.indexOf('\n')) >= 0)
+	{
+		QString message = QString::fromUtf8(_subscribers.at(index).rxBuffer.left(end));
+		_subscribers.at(index).rxBuffer.remove(0, end + 1);
+		processControlMessage(index, message.trimmed());
+	}
+	// Protect against subscribers sending garbage:
+	if (_subscribers.at(index).rxBuffer.size() > TELEMETRY_MAX_CONTROL_LINE)
+		dropSubscriber(index);
+}
+
+
+void MBSWtelemetryServer::subscriberDisconnected()
+{
+	int index = subscriberIndex(sender());
+	if (index >= 0)
+		dropSubscriber(index);
+}
+
+
+void MBSWtelemetryServer::sendSamples()
+{
+	/* NOTE: the sockets are buffered, so writing never blocks. Subscribers which do not keep
+	 *       up are decimated (samples are skipped) and finally dropped.                      */
+	std::vector<MBSWtelemetrySample_dt> samples;
+	_sampleMutex.lock();
+	samples.swap(_pendingSamples);
+	_sendScheduled = false;
+	_sampleMutex.unlock();
+	for (unsigned int n=0; n<samples.size(); n++)
+	{
+		const MBSWtelemetrySample_dt & sample = samples.at(n);
+		for (int s=_subscribers.size()-1; s>=0; s--)
+		{
+			MBSWtelemetrySubscriber_dt & subscriber = _subscribers.at(s);
+			if (!subscriber.subscribed || (sample.sampleNr % subscriber.decimation))
+				continue;
+			qint64 pending = subscriber.socket->bytesToWrite();
+			if (pending > TELEMETRY_HARD_LIMIT)
+			{
+#ifdef __FSSM_DEBUG__
+				std::cout << "MBSWtelemetryServer::sendSamples():   dropping subscriber (" << pending << " bytes pending)\n";
+#endif
+				dropSubscriber(s);
+				continue;
+			}
+			if (pending > TELEMETRY_SOFT_LIMIT)
+			{
+				subscriber.skippedSamples++;
+				continue;
+			}
+			unsigned int nrOfValues = subscriber.channels.size() ? subscriber.channels.size() : sample.rawValues.size();
+			QByteArray payload;
+			payload.reserve(14 + 14*nrOfValues);
+			appendLE(&payload, sample.time_ms, 4);
+			appendLE(&payload, sample.sampleNr, 4);
+			appendLE(&payload, subscriber.skippedSamples, 4);
+			appendLE(&payload, nrOfValues, 2);
+			for (unsigned int k=0; k<nrOfValues; k++)
+			{
+				unsigned int channel = subscriber.channels.size() ? subscriber.channels.at(k) : k;
+				quint64 scaledValue = 0;
+				memcpy(&scaledValue, &sample.scaledValues.at(channel), 8);
+				appendLE(&payload, channel, 2);
+				appendLE(&payload, sample.rawValues.at(channel), 4);
+				appendLE(&payload, scaledValue, 8);
+			}
+			sendFrame(s, frame_sample, payload);
+			subscriber.skippedSamples = 0;
+		}
+	}
+}
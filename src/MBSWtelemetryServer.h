@@ -0,0 +1,142 @@
+/*
+ * MBSWtelemetryServer.h - Publishing of the live MB/SW values on local sockets
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWTELEMETRYSERVER_H
+#define MBSWTELEMETRYSERVER_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QMutex>
+#include <QRegExp>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <vector>
+#include <limits>
+#include <cstring>
+#include "MBSWdecoder.h"
+#include "MBSWlogFile.h"
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
+
+
+#define		TELEMETRY_LOCAL_NAME		"FreeSSM.telemetry"
+#define		TELEMETRY_TCP_PORT		7533	// localhost only
+#define		TELEMETRY_SOFT_LIMIT		65536	// [bytes] pending: samples are skipped
+#define		TELEMETRY_HARD_LIMIT		1048576	// [bytes] pending: subscriber is dropped
+#define		TELEMETRY_MAX_CONTROL_LINE	4096	// [bytes]
+#define		TELEMETRY_MAX_PENDING_SAMPLES	256	// samples published by the decoder thread and not yet sent (oldest are dropped)
+#define		TELEMETRY_PROBE_TIMEOUT		500	// [ms] connection attempt to detect a running server
+
+
+/* Frame layout (all values little endian):
+ *   u8 frame type, u32 payload length, payload
+ *   metadata (1): UTF-8 JSON, {"type":"metadata","start":<ISO time>,"channels":[{"index","title","unit","kind"}, ...]}
+ *   sample (2):   u32 time (ms since start of MB/SW reading), u32 sample nr.,
+ *                 u32 nr. of samples skipped since the previous sample frame (subscriber too slow), u16 nr. of values,
+ *                 values: u16 channel index, u32 raw value, f64 scaled value (NaN if not numeric)
+ *   reply (3):    UTF-8 JSON, {"type":"reply","cmd":<command>,"ok":true|false}
+ *
+ * Control messages (subscriber -> server), one flat JSON object per line:
+ *   {"cmd":"subscribe","channels":[0,3,5],"decimation":2}   channels optional (default: all), decimation optional (default: 1)
+ *   {"cmd":"unsubscribe"}
+ *   {"cmd":"metadata"}
+ * New subscribers receive the metadata, but no samples until they have subscribed.
+ */
+
+class MBSWtelemetrySample_dt
+{
+public:
+	unsigned int time_ms;
+	unsigned int sampleNr;
+	std::vector<unsigned int> rawValues;
+	std::vector<double> scaledValues;	// NaN if not numeric
+};
+
+
+
+class MBSWtelemetrySubscriber_dt
+{
+public:
+	MBSWtelemetrySubscriber_dt();
+	QIODevice *socket;
+	QByteArray rxBuffer;
+	bool subscribed;
+	std::vector<unsigned int> channels;	// empty: all
+	unsigned int decimation;
+	unsigned int skippedSamples;	// due to pending data, since the last sent sample
+};
+
+
+
+class MBSWtelemetryServer : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum frameType_dt {frame_metadata=1, frame_sample=2, frame_reply=3};
+
+	MBSWtelemetryServer(QObject *parent = 0);
+	~MBSWtelemetryServer();
+	bool listen(QString localName = TELEMETRY_LOCAL_NAME, quint16 tcpPort = TELEMETRY_TCP_PORT);
+	void close();
+	void setChannels(const std::vector<MBSWlogChannel_dt> & channels);
+	void publish(unsigned int time_ms, const std::vector<MBSWvalue_dt> & values, const std::vector<unsigned int> & outputChannels);
+	unsigned int numberOfSubscribers();
+	static MBSWtelemetryServer * instance();
+
+private:
+	static MBSWtelemetryServer *_instance;
+	QLocalServer _localServer;
+	QTcpServer _tcpServer;
+	std::vector<MBSWtelemetrySubscriber_dt> _subscribers;
+	std::vector<MBSWlogChannel_dt> _channels;
+	QDateTime _startTime;
+	// Samples of the decoder thread (protected by _sampleMutex):
+	unsigned int _nrOfChannels;
+	unsigned int _sampleNr;
+	std::vector<MBSWtelemetrySample_dt> _pendingSamples;
+	bool _sendScheduled;
+	QMutex _sampleMutex;
+
+	void addSubscriber(QIODevice *socket);
+	void dropSubscriber(unsigned int index);
+	int subscriberIndex(QObject *socket);
+	void processControlMessage(unsigned int index, QString message);
+	void sendFrame(unsigned int index, frameType_dt type, const QByteArray & payload);
+	QByteArray metadata();
+	static QString JSONstring(QString str);
+
+private slots:
+	void newLocalConnection();
+	void newTcpConnection();
+	void readControlMessages();
+	void subscriberDisconnected();
+	void sendSamples();
+
+};
+
+
+#endif
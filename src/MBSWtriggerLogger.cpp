@@ -0,0 +1,316 @@
+/*
+ * MBSWtriggerLogger.cpp - Triggered recording of measuring blocks/switches with pre-trigger history
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MBSWtriggerLogger.h"
+#include "MBSWdecoder.h"
+#include <cstring>
+#include <limits.h>
+
+
+
+MBSWtriggerLogger::MBSWtriggerLogger()
+{
+	_active = false;
+	_preTrigger_ms = 0;
+	_postTrigger_ms = 0;
+	_time_ms = 0;
+	_triggered = false;
+	_triggerTime_ms = 0;
+}
+
+
+MBSWtriggerLogger::~MBSWtriggerLogger()
+{
+	deactivate();
+	clearScalings();
+}
+
+
+bool MBSWtriggerLogger::setup(QString filenamePrefix, QStringList triggerExpressions, unsigned int preTrigger_ms, unsigned int postTrigger_ms,
+			      std::vector<unsigned int> queryAddresses, std::vector<MBSWlogChannel_dt> channels, unsigned int frameInterval_ms)
+{
+	std::vector<MBSWtriggerCondition_dt> conditions;
+	if (isActive() || triggerExpressions.isEmpty() || queryAddresses.empty()) return false;
+	// Check if the ring buffer can hold the pre- and post-trigger window:
+	unsigned int ringSize = ringCapacity(preTrigger_ms + postTrigger_ms, frameInterval_ms);
+	if (ringSize > MBSWTRIGGER_MAX_RING_SIZE)
+		return false;
+	// Compile trigger expressions:
+	for (int k=0; k<triggerExpressions.size(); k++)
+	{
+		MBSWtriggerCondition_dt condition;
+		if (!parseTriggerExpression(triggerExpressions.at(k), channels, &condition))
+			return false;
+		conditions.push_back(condition);
+	}
+	_mutex.lock();
+	_filenamePrefix = filenamePrefix;
+	_preTrigger_ms = preTrigger_ms;
+	_postTrigger_ms = postTrigger_ms;
+	_queryAddresses = queryAddresses;
+	_channels = channels;
+	_decoder.setup(queryAddresses, channels);
+	// Precompile the scalings (the conditions are evaluated for each frame):
+	clearScalings();
+	for (unsigned int k=0; k<channels.size(); k++)
+	{
+		MBSWscaling_dt *scaling = NULL;
+		if (channels.at(k).blockType == 0)
+		{
+			mb_dt mb;
+			mb.title = channels.at(k).title;
+			mb.unit = channels.at(k).unit;
+			mb.scaleformula = channels.at(k).scaleformula;
+			mb.precision = channels.at(k).precision;
+			scaling = new MBSWscaling_dt;
+			scaling->setup(mb);
+		}
+		_scalings.push_back(scaling);
+	}
+	_conditions = conditions;
+	_lastConditionStates.assign(_conditions.size(), true);	// NOTE: no trigger on conditions which are already true at start
+	_lastRawValues.clear();
+	// NOTE: allocate all frames now to avoid allocations in the communication thread
+	_ring.setup(ringSize, queryAddresses.size());
+	_time_ms = 0;
+	_triggered = false;
+	_active = true;
+	_mutex.unlock();
+	return true;
+}
+
+
+void MBSWtriggerLogger::deactivate()
+{
+	_mutex.lock();
+	// Save the window of a pending trigger:
+	if (_active && _triggered)
+		captureWindow();
+	_triggered = false;
+	_active = false;
+	_mutex.unlock();
+	// Write captured windows (with the current channel setup):
+	writeCapturedWindows();
+}
+
+
+bool MBSWtriggerLogger::isActive()
+{
+	QMutexLocker locker(&_mutex);
+	return _active;
+}
+
+
+unsigned int MBSWtriggerLogger::maxWindowDuration_ms(unsigned int frameInterval_ms)
+{
+	if (frameInterval_ms < MBSWTRIGGER_MIN_FRAME_INTERVAL_MS)
+		frameInterval_ms = MBSWTRIGGER_MIN_FRAME_INTERVAL_MS;
+	return (static_cast<quint64>(MBSWTRIGGER_MAX_RING_SIZE - 2) * frameInterval_ms) / 2;
+}
+
+
+bool MBSWtriggerLogger::parseTriggerExpression(QString expression, std::vector<MBSWlogChannel_dt> channels, MBSWtriggerCondition_dt *condition)
+{
+	// Syntax: "<MB/SW title> <operator> <value>" or "<MB/SW title> toggles"
+	const char *opStr[6] = {"<=", ">=", "==", "!=", "<", ">"};
+	const MBSWtriggerCondition_dt::operator_dt ops[6] = {MBSWtriggerCondition_dt::op_lessEqual, MBSWtriggerCondition_dt::op_greaterEqual,
+							      MBSWtriggerCondition_dt::op_equal, MBSWtriggerCondition_dt::op_notEqual,
+							      MBSWtriggerCondition_dt::op_less, MBSWtriggerCondition_dt::op_greater};
+	QString title;
+	expression = expression.trimmed();
+	if (expression.endsWith(" toggles", Qt::CaseInsensitive))
+	{
+		title = expression.left(expression.size() - 8).trimmed();
+		condition->op = MBSWtriggerCondition_dt::op_toggles;
+		condition->value = 0;
+	}
+	else
+	{
+		int pos = -1;
+		unsigned char k = 0;
+		for (k=0; k<6; k++)
+		{
+			pos = expression.lastIndexOf(opStr[k]);
+			if (pos > 0)
+				break;
+		}
+		if (pos <= 0)
+			return false;
+		bool ok = false;
+		condition->value = expression.mid(pos + strlen(opStr[k])).trimmed().toDouble(&ok);
+		if (!ok)
+			return false;
+		condition->op = ops[k];
+		title = expression.left(pos).trimmed();
+	}
+	for (unsigned int k=0; k<channels.size(); k++)
+	{
+		if (channels.at(k).title.compare(title, Qt::CaseInsensitive) == 0)
+		{
+			condition->channelIndex = k;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void MBSWtriggerLogger::processRawData(std::vector<char> rawdata, int duration_ms)
+{
+	_mutex.lock();
+	if (!_active || (rawdata.size() != _queryAddresses.size()))
+	{
+		_mutex.unlock();
+		return;
+	}
+	_time_ms += duration_ms;
+	_ring.add(_time_ms, rawdata);
+	if (_triggered)
+	{
+		if (_time_ms - _triggerTime_ms >= _postTrigger_ms)
+		{
+			captureWindow();
+			_triggered = false;
+		}
+		evaluateConditions(&rawdata.at(0));	// keep condition states up to date
+	}
+	else if (evaluateConditions(&rawdata.at(0)))
+	{
+		_triggered = true;
+		_triggerTime_ms = _time_ms;
+	}
+	_mutex.unlock();
+}
+
+// PRIVATE
+
+void MBSWtriggerLogger::writeCapturedWindows()
+{
+	std::vector< std::vector<MBSWlogFrame_dt> > windows;
+	_capturedWindowsMutex.lock();
+	windows.swap(_capturedWindows);
+	_capturedWindowsMutex.unlock();
+	for (unsigned int w=0; w<windows.size(); w++)
+	{
+		const std::vector<MBSWlogFrame_dt> & frames = windows.at(w);
+		QString filename = _filenamePrefix + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz") + ".fmbsw";
+		MBSWlogFileWriter writer;
+		if (!writer.open(filename, _queryAddresses, _channels))
+			continue;
+		bool ok = true;
+		for (unsigned int k=0; k<frames.size(); k++)
+			ok &= writer.addFrame(frames.at(k).time_ms, frames.at(k).rawdata);
+		if (writer.close() && ok)
+			emit triggered(filename);
+	}
+}
+
+
+bool MBSWtriggerLogger::evaluateConditions(const char *rawdata)
+{
+	bool trigger = false;
+	_decoder.rawValues(rawdata, &_rawValues);
+	for (unsigned int k=0; k<_conditions.size(); k++)
+	{
+		const MBSWtriggerCondition_dt & condition = _conditions.at(k);
+		bool state = false;
+		if (condition.op == MBSWtriggerCondition_dt::op_toggles)
+		{
+			state = (_lastRawValues.size() && (_rawValues.at(condition.channelIndex) != _lastRawValues.at(condition.channelIndex)));
+			if (state)
+				trigger = true;	// NOTE: edges are triggers themselves
+		}
+		else
+		{
+			double value = channelValue(condition.channelIndex, _rawValues.at(condition.channelIndex));
+			if (condition.op == MBSWtriggerCondition_dt::op_less)
+				state = (value < condition.value);
+			else if (condition.op == MBSWtriggerCondition_dt::op_lessEqual)
+				state = (value <= condition.value);
+			else if (condition.op == MBSWtriggerCondition_dt::op_greater)
+				state = (value > condition.value);
+			else if (condition.op == MBSWtriggerCondition_dt::op_greaterEqual)
+				state = (value >= condition.value);
+			else if (condition.op == MBSWtriggerCondition_dt::op_equal)
+				state = (value == condition.value);
+			else if (condition.op == MBSWtriggerCondition_dt::op_notEqual)
+				state = (value != condition.value);
+			// Trigger on transitions from false to true only:
+			if (state && !_lastConditionStates.at(k))
+				trigger = true;
+		}
+		_lastConditionStates.at(k) = state;
+	}
+	_lastRawValues.swap(_rawValues);
+	return trigger;
+}
+
+
+double MBSWtriggerLogger::channelValue(unsigned int channelIndex, unsigned int rawValue)
+{
+	// Use the scaled value if it is numeric, the raw value otherwise:
+	const MBSWscaling_dt *scaling = _scalings.at(channelIndex);
+	if (scaling != NULL)
+	{
+		double value = 0;
+		bool numeric = false;
+		int textIndex = -1;
+		if (scaling->scale(rawValue, &value, &numeric, &textIndex) && numeric)
+			return value;
+	}
+	return rawValue;
+}
+
+
+void MBSWtriggerLogger::clearScalings()
+{
+	for (unsigned int k=0; k<_scalings.size(); k++)
+		delete _scalings.at(k);
+	_scalings.clear();
+}
+
+
+unsigned int MBSWtriggerLogger::ringCapacity(unsigned int window_ms, unsigned int frameInterval_ms)
+{
+	// NOTE: twice the measured frame rate, the frame rate varies with the communication load
+	if (frameInterval_ms < MBSWTRIGGER_MIN_FRAME_INTERVAL_MS)
+		frameInterval_ms = MBSWTRIGGER_MIN_FRAME_INTERVAL_MS;
+	quint64 capacity = (2 * static_cast<quint64>(window_ms)) / frameInterval_ms + 2;
+	if (capacity > UINT_MAX)
+		return UINT_MAX;
+	return capacity;
+}
+
+
+void MBSWtriggerLogger::captureWindow()
+{
+	// Copy pre- and post-trigger window (times relative to the first frame):
+	std::vector<MBSWlogFrame_dt> frames;
+	unsigned int firstTime_ms = 0;
+	if (_triggerTime_ms > _preTrigger_ms)
+		firstTime_ms = _triggerTime_ms - _preTrigger_ms;
+	_ring.copyFrames(firstTime_ms, &frames);
+	if (frames.empty())
+		return;
+	_capturedWindowsMutex.lock();
+	_capturedWindows.push_back(frames);
+	_capturedWindowsMutex.unlock();
+	// NOTE: don't block the communication thread with disk I/O
+	QMetaObject::invokeMethod(this, "writeCapturedWindows", Qt::QueuedConnection);
+}
@@ -0,0 +1,114 @@
+/*
+ * MBSWtriggerLogger.h - Triggered recording of measuring blocks/switches with pre-trigger history
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MBSWTRIGGERLOGGER_H
+#define MBSWTRIGGERLOGGER_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QMutex>
+#include <vector>
+#include "MBSWlogFile.h"
+
+
+#define MBSWTRIGGER_MAX_RING_SIZE		131072	// max. nr. of frames kept in memory
+#define MBSWTRIGGER_MIN_FRAME_INTERVAL_MS	10	// assumed if the frame rate is unknown
+
+
+class MBSWscaling_dt;
+
+
+class MBSWtriggerCondition_dt
+{
+public:
+	enum operator_dt {op_less, op_lessEqual, op_greater, op_greaterEqual, op_equal, op_notEqual, op_toggles};
+	MBSWtriggerCondition_dt() { channelIndex=0; op=op_equal; value=0; };
+	unsigned int channelIndex;
+	operator_dt op;
+	double value;
+};
+
+
+
+/* NOTE: processRawData() is called from the communication thread (direct connection).
+ *       The captured windows are written to disk in the thread the logger lives in.
+ *       The ring buffer is sized for the pre- AND post-trigger window at twice the
+ *       measured frame rate, setup() fails if the windows are too long.
+ *       The logger must not be deleted before the data source has been stopped,
+ *       use deactivate() to stop logging while the data source is running.          */
+
+class MBSWtriggerLogger : public QObject
+{
+	Q_OBJECT
+
+public:
+	MBSWtriggerLogger();
+	~MBSWtriggerLogger();
+	bool setup(QString filenamePrefix, QStringList triggerExpressions, unsigned int preTrigger_ms, unsigned int postTrigger_ms,
+		   std::vector<unsigned int> queryAddresses, std::vector<MBSWlogChannel_dt> channels, unsigned int frameInterval_ms = 0);
+	void deactivate();
+	bool isActive();
+	static unsigned int maxWindowDuration_ms(unsigned int frameInterval_ms);
+	static bool parseTriggerExpression(QString expression, std::vector<MBSWlogChannel_dt> channels, MBSWtriggerCondition_dt *condition);
+
+public slots:
+	void processRawData(std::vector<char> rawdata, int duration_ms);
+
+private slots:
+	void writeCapturedWindows();
+
+private:
+	bool _active;
+	QString _filenamePrefix;
+	unsigned int _preTrigger_ms;
+	unsigned int _postTrigger_ms;
+	std::vector<unsigned int> _queryAddresses;
+	std::vector<MBSWlogChannel_dt> _channels;
+	MBSWrawValueDecoder _decoder;
+	std::vector<MBSWscaling_dt*> _scalings;	// MBs only (NULL for SWs)
+	std::vector<MBSWtriggerCondition_dt> _conditions;
+	std::vector<bool> _lastConditionStates;
+	std::vector<unsigned int> _rawValues;
+	std::vector<unsigned int> _lastRawValues;
+	MBSWframeRingBuffer _ring;
+	unsigned int _time_ms;
+	// Trigger state:
+	bool _triggered;
+	unsigned int _triggerTime_ms;
+	// Captured windows waiting to be written:
+	std::vector< std::vector<MBSWlogFrame_dt> > _capturedWindows;
+	QMutex _mutex;
+	QMutex _capturedWindowsMutex;
+
+	bool evaluateConditions(const char *rawdata);
+	double channelValue(unsigned int channelIndex, unsigned int rawValue);
+	void clearScalings();
+	static unsigned int ringCapacity(unsigned int window_ms, unsigned int frameInterval_ms);
+	void captureWindow();
+
+signals:
+	void triggered(QString logfilename);
+
+};
+
+
+#endif
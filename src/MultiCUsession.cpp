@@ -0,0 +1,165 @@
+/*
+ * MultiCUsession.cpp - Concurrent sessions with several control units over one ISO-15765 interface
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiCUsession.h"
+
+
+
+MultiCUsession::MultiCUsession(AbstractDiagInterface *diagInterface, QString language) : _mux(diagInterface)
+{
+	_language = language;
+	_sample.time_ms = 0;
+}
+
+
+MultiCUsession::~MultiCUsession()
+{
+	stopMBSWreading();
+	// NOTE: the sessions must be deleted before the multiplexer (channels)
+	for (unsigned int k=0; k<_sessions.size(); k++)
+		delete _sessions.at(k);
+}
+
+
+SSMprotocol2 * MultiCUsession::addControlUnit(SSMprotocol::CUtype_dt CU, SSMprotocol::CUsetupResult_dt *result)
+{
+	SSMprotocol::CUsetupResult_dt setupResult = SSMprotocol::result_success;
+	AbstractDiagInterface *channel = NULL;
+	SSMprotocol2 *session = NULL;
+	// CAN-ID of the control unit:
+	if (_mux.diagInterface()->protocolType() != AbstractDiagInterface::protocol_SSM2_ISO15765)
+		setupResult = SSMprotocol::result_invalidInterfaceConfig;
+	else if (CU == SSMprotocol::CUtype_Engine)
+		channel = _mux.channel(0x7E0);
+	else if (CU == SSMprotocol::CUtype_Transmission)
+		channel = _mux.channel(0x7E1);
+	else
+		setupResult = SSMprotocol::result_invalidCUtype;
+	if (channel != NULL)
+	{
+		// Each control unit can be added only once:
+		for (unsigned int k=0; k<_sessions.size(); k++)
+		{
+			SSMprotocol::CUtype_dt sessionCU;
+			if (_sessions.at(k)->CUtype(&sessionCU) && (sessionCU == CU))
+			{
+				channel = NULL;
+				setupResult = SSMprotocol::result_invalidCUtype;
+				break;
+			}
+		}
+	}
+	if (channel != NULL)
+	{
+		if (channel->connect(AbstractDiagInterface::protocol_SSM2_ISO15765))
+		{
+			session = new SSMprotocol2(channel, _language);
+			setupResult = session->setupCUdata(CU);
+			if (setupResult == SSMprotocol::result_success)
+			{
+				_sessions.push_back(session);
+			}
+			else
+			{
+				delete session;
+				session = NULL;
+				channel->disconnect();
+			}
+		}
+		else
+			setupResult = SSMprotocol::result_commError;
+	}
+	if (result != NULL)
+		*result = setupResult;
+	return session;
+}
+
+
+unsigned int MultiCUsession::numberOfControlUnits()
+{
+	return _sessions.size();
+}
+
+
+SSMprotocol2 * MultiCUsession::controlUnit(unsigned int index)
+{
+	if (index >= _sessions.size())
+		return NULL;
+	return _sessions.at(index);
+}
+
+
+bool MultiCUsession::startMBSWreading(const std::vector< std::vector<MBSWmetadata_dt> > & mbswmetaLists)
+{
+	if (!_sessions.size() || (mbswmetaLists.size() != _sessions.size()))
+		return false;
+	stopMBSWreading();
+	// Setup the sample and the common timeline:
+	_sample.time_ms = 0;
+	_sample.rawValues = std::vector< std::vector<unsigned int> >(_sessions.size());
+	_sample.valueTimes_ms = std::vector<unsigned int>(_sessions.size(), 0);
+	_freshValues = std::vector<bool>(_sessions.size(), false);
+	_timeline.start();
+	for (unsigned int k=0; k<_sessions.size(); k++)
+	{
+		connect( _sessions.at(k), SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ),
+			 this, SLOT( processMBSWrawValues(std::vector<unsigned int>, int) ) );
+		if (!_sessions.at(k)->startMBSWreading(mbswmetaLists.at(k)))
+		{
+			stopMBSWreading();
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool MultiCUsession::stopMBSWreading()
+{
+	bool ok = true;
+	for (unsigned int k=0; k<_sessions.size(); k++)
+	{
+		disconnect( _sessions.at(k), SIGNAL( newMBSWrawValues(std::vector<unsigned int>, int) ),
+			    this, SLOT( processMBSWrawValues(std::vector<unsigned int>, int) ) );
+		SSMprotocol::state_dt state = _sessions.at(k)->state();
+		if (state == SSMprotocol::state_MBSWreading)
+			ok &= _sessions.at(k)->stopMBSWreading();
+	}
+	return ok;
+}
+
+// PRIVATE
+
+void MultiCUsession::processMBSWrawValues(std::vector<unsigned int> rawValues, int /* duration_ms */)
+{
+	unsigned int index = 0;
+	while ((index < _sessions.size()) && (_sessions.at(index) != sender()))
+		index++;
+	if (index >= _sessions.size())
+		return;
+	_sample.rawValues.at(index) = rawValues;
+	_sample.valueTimes_ms.at(index) = _timeline.elapsed();
+	_freshValues.at(index) = true;
+	// Emit the sample if new values of all control units are available:
+	if (std::find(_freshValues.begin(), _freshValues.end(), false) != _freshValues.end())
+		return;
+	_sample.time_ms = _timeline.elapsed();
+	emit newSample(_sample);
+	_freshValues.assign(_freshValues.size(), false);
+}
@@ -0,0 +1,81 @@
+/*
+ * MultiCUsession.h - Concurrent sessions with several control units over one ISO-15765 interface
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTICUSESSION_H
+#define MULTICUSESSION_H
+
+
+#include <QObject>
+#include <QString>
+#include <QTime>
+#include <vector>
+#include <algorithm>
+#include "AbstractDiagInterface.h"
+#include "DiagInterfaceMultiplexer.h"
+#include "SSMprotocol.h"
+#include "SSMprotocol2.h"
+
+
+
+class MultiCUsample_dt
+{
+public:
+	unsigned int time_ms;	// time of the sample on the timeline of the session
+	std::vector< std::vector<unsigned int> > rawValues;	// per control unit (in the order they have been added)
+	std::vector<unsigned int> valueTimes_ms;		// reception times of the values of each control unit
+};
+
+
+
+/* NOTE: each control unit has its own SSMprotocol2-object, which can be used as usual.
+ *       The requests of all control units are interleaved (see DiagInterfaceMultiplexer).
+ *       A sample is emitted as soon as each control unit has delivered new MB/SW values,
+ *       so each sample contains exactly one reading of each control unit.               */
+
+class MultiCUsession : public QObject
+{
+	Q_OBJECT
+
+public:
+	MultiCUsession(AbstractDiagInterface *diagInterface, QString language = "en");
+	~MultiCUsession();
+	SSMprotocol2 * addControlUnit(SSMprotocol::CUtype_dt CU, SSMprotocol::CUsetupResult_dt *result = NULL);
+	unsigned int numberOfControlUnits();
+	SSMprotocol2 * controlUnit(unsigned int index);
+	bool startMBSWreading(const std::vector< std::vector<MBSWmetadata_dt> > & mbswmetaLists);
+	bool stopMBSWreading();
+
+private:
+	DiagInterfaceMultiplexer _mux;
+	QString _language;
+	std::vector<SSMprotocol2*> _sessions;
+	QTime _timeline;
+	MultiCUsample_dt _sample;
+	std::vector<bool> _freshValues;
+
+signals:
+	void newSample(MultiCUsample_dt sample);
+
+private slots:
+	void processMBSWrawValues(std::vector<unsigned int> rawValues, int duration_ms);
+
+};
+
+
+#endif
@@ -114,6 +114,7 @@ Preferences::Preferences(QMainWindow *parent, AbstractDiagInterface::interface_t
 	connect( interfaceType_comboBox, SIGNAL( activated(int) ), this, SLOT( selectInterfaceType(int) ) );
 	connect( interfaceName_comboBox, SIGNAL( activated(int) ), this, SLOT( selectInterfaceName(int) ) );
 	connect( testinterface_pushButton, SIGNAL( released() ), this, SLOT( interfacetest() ) );
+	connect( autodetect_pushButton, SIGNAL( released() ), this, SLOT( autodetectInterfaces() ) );
 	connect( ok_pushButton, SIGNAL( released() ), this, SLOT( ok() ) );
 	connect( cancel_pushButton, SIGNAL( released() ), this, SLOT( cancel() ) );
 	// NOTE: using released() instead of pressed() as workaround for a Qt-Bug occuring under MS Windows
@@ -127,6 +128,7 @@ Preferences::~Preferences()
 	disconnect( interfaceType_comboBox, SIGNAL( activated(int) ), this, SLOT( selectInterfaceType(int) ) );
 	disconnect( interfaceName_comboBox, SIGNAL( activated(int) ), this, SLOT( selectInterfaceName(int) ) );
 	disconnect( testinterface_pushButton, SIGNAL( released() ), this, SLOT( interfacetest() ) );
+	disconnect( autodetect_pushButton, SIGNAL( released() ), this, SLOT( autodetectInterfaces() ) );
 	disconnect( ok_pushButton, SIGNAL( released() ), this, SLOT( ok() ) );
 	disconnect( cancel_pushButton, SIGNAL( released() ), this, SLOT( cancel() ) );
 }
@@ -391,8 +393,12 @@ void Preferences::interfacetest()
 						resultText += '\n' + tr("The selected interface does not support the SSM2-protocol.");
 				}
 			}
+			QPushButton *benchmarkButton = NULL;
 			if (icresult)
+			{
 				msgbox = new QMessageBox(QMessageBox::Information, tr("Interface test"), resultText, QMessageBox::Ok, this);
+				benchmarkButton = msgbox->addButton(tr("Benchmark"), QMessageBox::ActionRole);
+			}
 			else
 			{
 				msgbox = new QMessageBox(QMessageBox::Critical, tr("Interface test"), resultText, QMessageBox::NoButton, this);
@@ -405,6 +411,8 @@ void Preferences::interfacetest()
 			msgbox->show();
 			choice = msgbox->exec();
 			msgbox->close();
+			if (icresult && (msgbox->clickedButton() == benchmarkButton))
+				interfaceBenchmark(diagInterface);
 			delete msgbox;
 			if (!icresult && (choice != QMessageBox::AcceptRole))
 				retry = false;
@@ -417,6 +425,56 @@ void Preferences::interfacetest()
 }
 
 
+void Preferences::autodetectInterfaces()
+{
+	std::vector<detectedDiagInterface_dt> interfaces;
+	QStringList interfaceDescriptions;
+	bool ok = false;
+	// DETECT INTERFACES:
+	FSSM_WaitMsgBox *waitmsgbox = new FSSM_WaitMsgBox(this, tr("Searching for diagnostic interfaces... Please wait !     "));
+	waitmsgbox->show();
+	DiagInterfaceDetector detector;
+	interfaces = detector.detectInterfaces();
+	waitmsgbox->close();
+	delete waitmsgbox;
+	if (interfaces.empty())
+	{
+		displayErrorMsg(tr("No diagnostic interface found !") + "\n\n" + tr("NOTE: Serial Pass-Through interfaces can only be detected if they are connected to the vehicle."));
+		return;
+	}
+	// LET USER SELECT ONE OF THE INTERFACES (RANKED LIST):
+	for (unsigned int k=0; k<interfaces.size(); k++)
+	{
+		QString description = interfaces.at(k).name;
+		if (interfaces.at(k).version.size())
+			description += " " + interfaces.at(k).version;
+		description += " (" + interfaces.at(k).filename + ")";
+		interfaceDescriptions.push_back(description);
+	}
+	QString selection = QInputDialog::getItem(this, tr("Auto-Detect Interfaces"), tr("Detected interfaces:"), interfaceDescriptions, 0, false, &ok);
+	if (!ok) return;
+	const detectedDiagInterface_dt & selectedInterface = interfaces.at(interfaceDescriptions.indexOf(selection));
+	// SELECT INTERFACE TYPE AND NAME:
+	int if_type_index = 0;	// Serial Pass-Through
+	int if_name_index = -1;
+	if (selectedInterface.type == AbstractDiagInterface::interface_J2534)
+		if_type_index = 1;
+	else if (selectedInterface.type == AbstractDiagInterface::interface_ATcommandControlled)
+		if_type_index = 2;
+	interfaceType_comboBox->setCurrentIndex(if_type_index);
+	selectInterfaceType(if_type_index);
+	if (selectedInterface.type == AbstractDiagInterface::interface_J2534)
+		if_name_index = _J2534libraryPaths.indexOf(selectedInterface.filename);
+	else
+		if_name_index = interfaceName_comboBox->findText(selectedInterface.filename);
+	if (if_name_index >= 0)
+	{
+		interfaceName_comboBox->setCurrentIndex(if_name_index);
+		selectInterfaceName(if_name_index);
+	}
+}
+
+
 void Preferences::ok()
 {
 	// RETURN CURRENT INTERFACE-TYPE AND -NAME:
@@ -470,6 +528,148 @@ void Preferences::closeEvent(QCloseEvent *event)
 }
 
 
+void Preferences::interfaceBenchmark(AbstractDiagInterface *diagInterface)
+{
+	QMessageBox *msgbox;
+	QFont msgboxfont;
+	QString resultText;
+	std::vector<AbstractDiagInterface::protocol_type> protocols = diagInterface->supportedProtocols();
+	if (protocols.empty())
+	{
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO14230);
+		protocols.push_back(AbstractDiagInterface::protocol_SSM2_ISO15765);
+		protocols.push_back(AbstractDiagInterface::protocol_SSM1);
+	}
+	// OUTPUT WAIT MESSAGE:
+	FSSM_WaitMsgBox *waitmsgbox = new FSSM_WaitMsgBox(this, tr("Benchmarking interface... Please wait !     "));
+	waitmsgbox->show();
+	// BENCHMARK ALL PROTOCOLS:
+	for (unsigned int k=0; k<protocols.size(); k++)
+	{
+		QString protocolResultText;
+		if (benchmarkProtocol(diagInterface, protocols.at(k), &protocolResultText))
+		{
+			if (resultText.size())
+				resultText += "\n\n";
+			resultText += protocolResultText;
+		}
+	}
+	// CLOSE WAIT MESSAGE:
+	waitmsgbox->close();
+	delete waitmsgbox;
+	// DISPLAY RESULTS:
+	if (resultText.isEmpty())
+	{
+		displayErrorMsg(tr("Interface benchmark failed !") + "\n\n" + tr("Please make sure that the interface is connected properly and ignition is switched ON."));
+		return;
+	}
+	msgbox = new QMessageBox(QMessageBox::Information, tr("Interface benchmark"), resultText, QMessageBox::Ok, this);
+	msgboxfont = msgbox->font();
+	msgboxfont.setPixelSize(12); // 9pts
+	msgbox->setFont( msgboxfont );
+	msgbox->show();
+	msgbox->exec();
+	msgbox->close();
+	delete msgbox;
+}
+
+
+bool Preferences::benchmarkProtocol(AbstractDiagInterface *diagInterface, AbstractDiagInterface::protocol_type protocol, QString *resultText)
+{
+	SSMP1communication *SSMP1com = NULL;
+	SSMP2communication *SSMP2com = NULL;
+	std::vector<unsigned int> SSM2cuaddresses;
+	std::vector<SSM1_CUtype_dt> SSM1cus;
+	unsigned int addr = 0x61;
+	char data = 0;
+	unsigned int replysize = 0;
+	bool cufound = false;
+	unsigned int errors = 0;
+	MBSWstatistics latency;
+	QTime requestTime;
+	QTime totalTime;
+	unsigned int totalTime_ms = 0;
+	if (!diagInterface->connect(protocol))
+		return false;
+	// FIND A CONTROL UNIT WHICH REPLIES:
+	/* NOTE: no retries, because each failed request counts as error */
+	/* NOTE: reply sizes of the read requests (1 data byte):
+	 *       SSM1: address (2 bytes) + data byte
+	 *       SSM2 ISO14230: header (4 bytes) + reply ID + data byte + checksum
+	 *       SSM2 ISO15765: CAN-ID (4 bytes) + reply ID + data byte           */
+	if (protocol == AbstractDiagInterface::protocol_SSM1)
+	{
+		addr = 0x00;
+		replysize = 3;
+		SSM1cus.push_back(SSM1_CU_Engine);
+		SSM1cus.push_back(SSM1_CU_Transmission);
+		SSMP1com = new SSMP1communication(diagInterface, SSM1cus.at(0), 0);
+		for (unsigned int k=0; (k<SSM1cus.size()) && !cufound; k++)
+		{
+			SSMP1com->selectCU(SSM1cus.at(k));
+			cufound = SSMP1com->readAddress(addr, &data);
+		}
+	}
+	else
+	{
+		if (protocol == AbstractDiagInterface::protocol_SSM2_ISO15765)
+		{
+			SSM2cuaddresses.push_back(0x7E0);
+			replysize = 6;
+		}
+		else
+		{
+			replysize = 7;
+			SSM2cuaddresses.push_back(0x10);
+			SSM2cuaddresses.push_back(0x01);
+			SSM2cuaddresses.push_back(0x02);
+		}
+		SSMP2com = new SSMP2communication(diagInterface, SSM2cuaddresses.at(0), 0);
+		for (unsigned int k=0; (k<SSM2cuaddresses.size()) && !cufound; k++)
+		{
+			SSMP2com->setCUaddress(SSM2cuaddresses.at(k));
+			cufound = SSMP2com->readMultipleDatabytes('\x0', &addr, 1, &data);
+		}
+	}
+	// TIMED SERIES OF READ REQUESTS:
+	if (cufound)
+	{
+		totalTime.start();
+		for (unsigned int k=0; k<IFBENCHMARK_REQUESTS; k++)
+		{
+			bool ok = false;
+			requestTime.start();
+			if (SSMP1com)
+				ok = SSMP1com->readAddress(addr, &data);
+			else
+				ok = SSMP2com->readMultipleDatabytes('\x0', &addr, 1, &data);
+			if (ok)
+				latency.add(requestTime.elapsed());
+			else
+				errors++;
+		}
+		totalTime_ms = totalTime.elapsed();
+	}
+	delete SSMP1com;
+	delete SSMP2com;
+	// Get protocol description (only available while connected):
+	*resultText = QString::fromStdString(diagInterface->protocolDescription()) + ":";
+	diagInterface->disconnect();
+	if (!cufound)
+		return false;
+	if (totalTime_ms < 1)
+		totalTime_ms = 1;
+	// NOTE: requests are sent one after another, so the request rate is limited by the round-trip time
+	*resultText += "\n" + tr("Round-trip latency (50% / 90% / 99% / max.): %1 / %2 / %3 / %4 ms")
+			.arg(latency.percentile(50), 0, 'f', 0).arg(latency.percentile(90), 0, 'f', 0)
+			.arg(latency.percentile(99), 0, 'f', 0).arg(latency.max(), 0, 'f', 0);
+	*resultText += "\n" + tr("Max. request rate: %1 requests/s").arg(1000.0 * latency.count() / totalTime_ms, 0, 'f', 1);
+	*resultText += "\n" + tr("Effective data rate: %1 bytes/s").arg(1000.0 * latency.count() * replysize / totalTime_ms, 0, 'f', 0);
+	*resultText += "\n" + tr("Error rate: %1 %").arg(100.0 * errors / IFBENCHMARK_REQUESTS, 0, 'f', 1);
+	return true;
+}
+
+
 void Preferences::displayErrorMsg(QString errormsg)
 {
 	QMessageBox *msgbox;
@@ -510,6 +710,10 @@ void Preferences::setupUiFonts()
 	font.setFamily(appfont.family());
 	font.setPixelSize(12);	// 9pts
 	testinterface_pushButton->setFont(font);
+	font = autodetect_pushButton->font();
+	font.setFamily(appfont.family());
+	font.setPixelSize(12);	// 9pts
+	autodetect_pushButton->setFont(font);
 	font = language_label->font();
 	font.setFamily(appfont.family());
 	font.setPixelSize(12);	// 9pts
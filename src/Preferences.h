@@ -37,11 +37,16 @@
 #include "J2534DiagInterface.h"
 #include "SSMP1communication.h"
 #include "SSMP2communication.h"
+#include "MBSWstatistics.h"
+#include "DiagInterfaceDetector.h"
 #include "FSSMdialogs.h"
 #include "ui_Preferences.h"
 
 
 
+#define		IFBENCHMARK_REQUESTS	100	// nr. of timed read requests per protocol
+
+
 
 class Preferences : public QDialog, private Ui::Preferences_Dialog
 {
@@ -61,6 +66,8 @@ private:
 	QStringList _J2534libraryPaths;
 
 	void displayErrorMsg(QString errormsg);
+	void interfaceBenchmark(AbstractDiagInterface *diagInterface);
+	bool benchmarkProtocol(AbstractDiagInterface *diagInterface, AbstractDiagInterface::protocol_type protocol, QString *resultText);
 	void setupUiFonts();
 	void closeEvent(QCloseEvent *event);
 
@@ -74,6 +81,7 @@ public slots:
 	void selectInterfaceType(int index);
 	void selectInterfaceName(int index);
 	void interfacetest();
+	void autodetectInterfaces();
 	void ok();
 	void cancel();
 
@@ -0,0 +1,270 @@
+/*
+ * ReplayDiagInterface.cpp - Virtual diagnostic interface which replays captured interface traffic
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReplayDiagInterface.h"
+
+
+static unsigned int fromLE(const char *data, unsigned char nrOfBytes)
+{
+	unsigned int value = 0;
+	for (unsigned char k=0; k<nrOfBytes; k++)
+		value |= static_cast<unsigned int>(static_cast<unsigned char>(data[k])) << (8*k);
+	return value;
+}
+
+
+
+ReplayDiagInterface::ReplayDiagInterface(bool originalTiming)
+{
+	_originalTiming = originalTiming;
+	_interfaceType = interface_serialPassThrough;
+	_cursor = 0;
+	_open = false;
+	_connected = false;
+	_anchorTime_ms = 0;
+	setName("Capture Replay");
+	setVersion("1.0");
+	setProtocolBaudrate( 0 );
+}
+
+
+ReplayDiagInterface::~ReplayDiagInterface()
+{
+	close();
+}
+
+
+AbstractDiagInterface::interface_type ReplayDiagInterface::interfaceType()
+{
+	return _interfaceType;
+}
+
+
+bool ReplayDiagInterface::open( std::string name )
+{
+	unsigned int index = 0;
+	if (_open)
+		return false;
+	if (!loadCaptureFile(name))
+		return false;
+	_cursor = 0;
+	if (!findNext(DiagCaptureRecord_dt::ev_open, &index) || !_records.at(index).result)
+		return false;
+	_cursor = index + 1;
+	_open = true;
+	return true;
+}
+
+
+bool ReplayDiagInterface::isOpen()
+{
+	return _open;
+}
+
+
+bool ReplayDiagInterface::close()
+{
+	if (!_open)
+		return false;
+	disconnect();
+	_records.clear();
+	_cursor = 0;
+	_open = false;
+	return true;
+}
+
+
+bool ReplayDiagInterface::connect(AbstractDiagInterface::protocol_type protocol)
+{
+	if (!_open || _connected)
+		return false;
+	for (unsigned int k=_cursor; k<_records.size(); k++)
+	{
+		const DiagCaptureRecord_dt & record = _records.at(k);
+		if ((record.event == DiagCaptureRecord_dt::ev_connect) && (record.data.size() >= 5) && (record.data.at(0) == protocol))
+		{
+			_cursor = k + 1;
+			setAnchor(record.time_ms);
+			if (!record.result)
+				return false;
+			setProtocolType( protocol );
+			setProtocolBaudrate( fromLE(&record.data.at(1), 4) );
+			_connected = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+bool ReplayDiagInterface::isConnected()
+{
+	return (_open && _connected);
+}
+
+
+bool ReplayDiagInterface::disconnect()
+{
+	unsigned int index = 0;
+	if (!_open)
+		return false;
+	if (_connected && findNext(DiagCaptureRecord_dt::ev_disconnect, &index))
+		_cursor = index + 1;
+	_connected = false;
+	setProtocolType( protocol_NONE );
+	setProtocolBaudrate( 0 );
+	return true;
+}
+
+
+bool ReplayDiagInterface::read(std::vector<char> *buffer)
+{
+	buffer->clear();
+	if (!_connected)
+		return false;
+	if ((_cursor >= _records.size()) || (_records.at(_cursor).event != DiagCaptureRecord_dt::ev_read))
+		return true;	// no (more) data
+	const DiagCaptureRecord_dt & record = _records.at(_cursor);
+	if (_originalTiming && (_time.elapsed() < (record.time_ms - _anchorTime_ms)))
+		return true;	// data not yet available
+	_cursor++;
+	*buffer = record.data;
+	return record.result;
+}
+
+
+bool ReplayDiagInterface::write(std::vector<char> buffer)
+{
+	unsigned int index = 0;
+	if (!_connected)
+		return false;
+	if (!findNext(DiagCaptureRecord_dt::ev_write, &index))
+	{
+#ifdef __FSSM_DEBUG__
+		std::cout << "ReplayDiagInterface::write(...):   end of capture reached\n";
+#endif
+		return false;
+	}
+	if (_records.at(index).data != buffer)
+	{
+#ifdef __FSSM_DEBUG__
+		std::cout << "ReplayDiagInterface::write(...):   request differs from captured request (record " << index << ")\n";
+#endif
+		return false;
+	}
+	_cursor = index + 1;
+	setAnchor(_records.at(index).time_ms);
+	return _records.at(index).result;
+}
+
+
+bool ReplayDiagInterface::clearSendBuffer()
+{
+	if (!_open)
+		return false;
+	if ((_cursor < _records.size()) && (_records.at(_cursor).event == DiagCaptureRecord_dt::ev_clearSendBuffer))
+		_cursor++;
+	return true;
+}
+
+
+bool ReplayDiagInterface::clearReceiveBuffer()
+{
+	if (!_open)
+		return false;
+	// Discard pending replies:
+	while ((_cursor < _records.size()) && (_records.at(_cursor).event == DiagCaptureRecord_dt::ev_read))
+		_cursor++;
+	if ((_cursor < _records.size()) && (_records.at(_cursor).event == DiagCaptureRecord_dt::ev_clearReceiveBuffer))
+	{
+		setAnchor(_records.at(_cursor).time_ms);
+		_cursor++;
+	}
+	return true;
+}
+
+// PRIVATE
+
+bool ReplayDiagInterface::loadCaptureFile(std::string filename)
+{
+	std::vector<protocol_type> supportedProtocols;
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+	std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	// Header:
+	if ((content.size() < 12) || (std::string(&content.at(0), 7) != "FSSMCAP") || (content.at(7) != DIAGCAPTURE_FORMAT_VERSION))
+		return false;
+	_interfaceType = static_cast<interface_type>(content.at(8));
+	unsigned int namelen = fromLE(&content.at(9), 2);
+	unsigned int pos = 11;
+	if (pos + namelen > content.size())
+		return false;
+	setName("Capture Replay (" + std::string(content.begin() + pos, content.begin() + pos + namelen) + ")");
+	pos += namelen;
+	// Records:
+	_records.clear();
+	while (pos + 10 <= content.size())
+	{
+		DiagCaptureRecord_dt record;
+		record.time_ms = fromLE(&content.at(pos), 4);
+		record.event = static_cast<DiagCaptureRecord_dt::event_dt>(content.at(pos + 4));
+		record.result = content.at(pos + 5);
+		unsigned int datalen = fromLE(&content.at(pos + 6), 4);
+		pos += 10;
+		if (pos + datalen > content.size())
+			break;	// incomplete record (capture has been aborted)
+		record.data.assign(content.begin() + pos, content.begin() + pos + datalen);
+		pos += datalen;
+		if ((record.event == DiagCaptureRecord_dt::ev_connect) && record.result && record.data.size())
+		{
+			protocol_type protocol = static_cast<protocol_type>(record.data.at(0));
+			if (std::find(supportedProtocols.begin(), supportedProtocols.end(), protocol) == supportedProtocols.end())
+				supportedProtocols.push_back(protocol);
+		}
+		_records.push_back(record);
+	}
+	setSupportedProtocols(supportedProtocols);
+	return true;
+}
+
+
+bool ReplayDiagInterface::findNext(DiagCaptureRecord_dt::event_dt event, unsigned int *index)
+{
+	for (unsigned int k=_cursor; k<_records.size(); k++)
+	{
+		if (_records.at(k).event == event)
+		{
+			*index = k;
+			return true;
+		}
+		// NOTE: do not skip beyond the next (dis-)connection
+		if ((k > _cursor) && ((_records.at(k).event == DiagCaptureRecord_dt::ev_connect) || (_records.at(k).event == DiagCaptureRecord_dt::ev_disconnect)))
+			return false;
+	}
+	return false;
+}
+
+
+void ReplayDiagInterface::setAnchor(unsigned int time_ms)
+{
+	_anchorTime_ms = time_ms;
+	_time.start();
+}
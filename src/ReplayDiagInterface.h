@@ -0,0 +1,76 @@
+/*
+ * ReplayDiagInterface.h - Virtual diagnostic interface which replays captured interface traffic
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAYDIAGINTERFACE_H
+#define REPLAYDIAGINTERFACE_H
+
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include "AbstractDiagInterface.h"
+#include "CapturingDiagInterface.h"
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
+
+
+/* NOTE: replies are served in the captured order. A reply becomes available
+ *       after the captured delay to the preceding request (or immediately, if
+ *       the original timing is disabled). Requests which differ from the
+ *       captured ones are rejected.                                          */
+
+class ReplayDiagInterface : public AbstractDiagInterface
+{
+
+public:
+	ReplayDiagInterface(bool originalTiming = true);
+	~ReplayDiagInterface();
+	interface_type interfaceType();
+	bool open( std::string name );
+	bool isOpen();
+	bool close();
+	bool connect(AbstractDiagInterface::protocol_type protocol);
+	bool isConnected();
+	bool disconnect();
+	bool read(std::vector<char> *buffer);
+	bool write(std::vector<char> buffer);
+	bool clearSendBuffer();
+	bool clearReceiveBuffer();
+
+private:
+	bool _originalTiming;
+	interface_type _interfaceType;
+	std::vector<DiagCaptureRecord_dt> _records;
+	unsigned int _cursor;
+	bool _open;
+	bool _connected;
+	unsigned int _anchorTime_ms;
+	TimeM _time;
+
+	bool loadCaptureFile(std::string filename);
+	bool findNext(DiagCaptureRecord_dt::event_dt event, unsigned int *index);
+	void setAnchor(unsigned int time_ms);
+
+};
+
+
+#endif
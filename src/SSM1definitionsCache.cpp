@@ -0,0 +1,433 @@
+/*
+ * SSM1definitionsCache.cpp - Binary cache of the SSM1-definitions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SSM1definitionsCache.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <string.h>
+
+
+#define		SSM1DEFS_CACHE_DIRNAME		"FreeSSM.cache"
+#define		SSM1DEFS_CACHE_SLOT_SIZE	8
+#define		SSM1DEFS_CACHE_MIN_DC_SIZE	(8 + 16*2)	// addresses + 8 codes and titles (empty strings)
+#define		SSM1DEFS_CACHE_MIN_MB_SIZE	(9 + 3*2)	// addresses, precision + title, unit, formula
+#define		SSM1DEFS_CACHE_MIN_SW_SIZE	(5 + 2*2)	// addresses + title, unit
+
+
+static void appendU8(QByteArray *buf, unsigned char value)
+{
+	buf->append(static_cast<char>(value));
+}
+
+
+static void appendU16(QByteArray *buf, quint16 value)
+{
+	uchar tmp[2];
+	qToLittleEndian<quint16>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 2);
+}
+
+
+static void appendU32(QByteArray *buf, quint32 value)
+{
+	uchar tmp[4];
+	qToLittleEndian<quint32>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 4);
+}
+
+
+static void appendU64(QByteArray *buf, quint64 value)
+{
+	uchar tmp[8];
+	qToLittleEndian<quint64>(value, tmp);
+	buf->append(reinterpret_cast<char*>(tmp), 8);
+}
+
+
+static void appendString(QByteArray *buf, QString str)
+{
+	QByteArray utf8 = str.toUtf8();
+	appendU16(buf, utf8.size());
+	buf->append(utf8);
+}
+
+
+static void appendString(QByteArray *buf, std::string str)
+{
+	appendString(buf, QString::fromStdString(str));
+}
+
+
+
+SSM1definitionsCache::SSM1definitionsCache()
+{
+	_data = NULL;
+	_size = 0;
+	_nrOfRecords = 0;
+	_hashSlots = 0;
+	_hashOffset = 0;
+	_defaultRecordOffset = 0;
+}
+
+
+SSM1definitionsCache::~SSM1definitionsCache()
+{
+	close();
+}
+
+
+std::string SSM1definitionsCache::cacheFilename(std::string defsFile, std::string lang)
+{
+	QString filename = QFileInfo(QString::fromStdString(defsFile)).completeBaseName() + "_" + QString::fromStdString(lang) + ".bin";
+	return QDir(QDir::homePath() + "/" + SSM1DEFS_CACHE_DIRNAME).filePath(filename).toStdString();
+}
+
+
+bool SSM1definitionsCache::getKey(std::string defsFile, std::string lang, SSM1definitionsCacheKey_dt *key)
+{
+	QFileInfo fileinfo(QString::fromStdString(defsFile));
+	if (!fileinfo.exists() || !fileinfo.isFile())
+		return false;
+	key->defsFile = fileinfo.absoluteFilePath().toStdString();
+	key->defsFileSize = fileinfo.size();
+	key->defsFileMTime = fileinfo.lastModified().toTime_t();
+	key->language = lang;
+	return true;
+}
+
+
+bool SSM1definitionsCache::write(std::string cacheFile, const SSM1definitionsCacheKey_dt & key, std::string defs_version, std::string format_version,
+                                 const std::vector<SSM1definitionsCacheRecord_dt> & records, const std::vector< std::pair<unsigned int, unsigned int> > & IDs)
+{
+	QByteArray data;
+	std::vector<unsigned int> recordOffsets;
+	unsigned int hashSlots = 1;
+	if (!records.size())
+		return false;
+	// Header:
+	data.append("FSSMSSM1", 8);
+	appendU16(&data, SSM1DEFS_CACHE_FORMAT_VERSION);
+	appendU16(&data, 0);
+	appendU64(&data, 0);	// file size, set below
+	appendU64(&data, key.defsFileSize);
+	appendU64(&data, key.defsFileMTime);
+	appendString(&data, key.defsFile);
+	appendString(&data, key.language);
+	appendString(&data, defs_version);
+	appendString(&data, format_version);
+	appendU32(&data, records.size());
+	while (hashSlots < (2 * IDs.size()))
+		hashSlots <<= 1;
+	appendU32(&data, hashSlots);
+	int hashOffsetPos = data.size();
+	appendU32(&data, 0);	// hash table offset, set below
+	// Records:
+	for (unsigned int r=0; r<records.size(); r++)
+	{
+		const SSM1definitionsCacheRecord_dt & record = records.at(r);
+		recordOffsets.push_back(data.size());
+		appendU8(&data, record.hasSysDescription | (record.hasModel << 1) | (record.hasYear << 2) | (record.hasCMdata << 3));
+		appendString(&data, record.sysDescription);
+		appendString(&data, record.model);
+		appendString(&data, record.year);
+		appendU32(&data, record.CMaddr);
+		appendU8(&data, record.CMvalue);
+		appendU32(&data, record.dcs.size());
+		for (unsigned int k=0; k<record.dcs.size(); k++)
+		{
+			appendU32(&data, record.dcs.at(k).byteAddr_currentOrTempOrLatest);
+			appendU32(&data, record.dcs.at(k).byteAddr_historicOrMemorized);
+			for (unsigned char b=0; b<8; b++)
+			{
+				appendString(&data, record.dcs.at(k).code[b]);
+				appendString(&data, record.dcs.at(k).title[b]);
+			}
+		}
+		appendU32(&data, record.mbs.size());
+		for (unsigned int k=0; k<record.mbs.size(); k++)
+		{
+			appendU32(&data, record.mbs.at(k).addr_low);
+			appendU32(&data, record.mbs.at(k).addr_high);
+			appendU8(&data, record.mbs.at(k).precision);
+			appendString(&data, record.mbs.at(k).title);
+			appendString(&data, record.mbs.at(k).unit);
+			appendString(&data, record.mbs.at(k).scaleformula);
+		}
+		appendU32(&data, record.sws.size());
+		for (unsigned int k=0; k<record.sws.size(); k++)
+		{
+			appendU32(&data, record.sws.at(k).byteAddr);
+			appendU8(&data, record.sws.at(k).bitAddr);
+			appendString(&data, record.sws.at(k).title);
+			appendString(&data, record.sws.at(k).unit);
+		}
+	}
+	// Hash table (open addressing, linear probing):
+	std::vector<quint32> slotIDs(hashSlots, 0);
+	std::vector<quint32> slotOffsets(hashSlots, 0);
+	for (unsigned int k=0; k<IDs.size(); k++)
+	{
+		if (IDs.at(k).second >= records.size())
+			return false;
+		unsigned int slot = hashSlot(IDs.at(k).first, hashSlots);
+		while (slotIDs.at(slot))
+			slot = (slot + 1) & (hashSlots - 1);
+		slotIDs.at(slot) = IDs.at(k).first + 1;
+		slotOffsets.at(slot) = recordOffsets.at(IDs.at(k).second);
+	}
+	qToLittleEndian<quint32>(data.size(), reinterpret_cast<uchar*>(data.data() + hashOffsetPos));
+	for (unsigned int s=0; s<hashSlots; s++)
+	{
+		appendU32(&data, slotIDs.at(s));
+		appendU32(&data, slotOffsets.at(s));
+	}
+	qToLittleEndian<quint64>(data.size(), reinterpret_cast<uchar*>(data.data() + 12));
+	// Write to a temporary file first, an incomplete cache file must never be used:
+	QString filename = QString::fromStdString(cacheFile);
+	if (!QDir().mkpath(QFileInfo(filename).absolutePath()))
+		return false;
+	QFile file(filename + ".tmp");
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	bool ok = (file.write(data) == data.size());
+	file.close();
+	if (ok)
+	{
+		QFile::remove(filename);
+		ok = QFile::rename(filename + ".tmp", filename);
+	}
+	if (!ok)
+		QFile::remove(filename + ".tmp");
+	return ok;
+}
+
+
+bool SSM1definitionsCache::open(std::string cacheFile, const SSM1definitionsCacheKey_dt & key)
+{
+	quint64 offset = 0;
+	std::string str;
+	close();
+	_file.setFileName(QString::fromStdString(cacheFile));
+	if (!_file.open(QIODevice::ReadOnly))
+		return false;
+	_size = _file.size();
+	if (_size < 48)
+		goto error;
+	_data = _file.map(0, _size);
+	if (!_data)
+		goto error;
+	// Check header and key:
+	if (memcmp(_data, "FSSMSSM1", 8) || (qFromLittleEndian<quint16>(_data + 8) != SSM1DEFS_CACHE_FORMAT_VERSION))
+		goto error;
+	if ((qFromLittleEndian<quint64>(_data + 12) != _size) || (qFromLittleEndian<quint64>(_data + 20) != key.defsFileSize)
+	    || (qFromLittleEndian<quint64>(_data + 28) != key.defsFileMTime))
+		goto error;
+	offset = 36;
+	if (!readString(&offset, &str) || (str != key.defsFile))
+		goto error;
+	if (!readString(&offset, &str) || (str != key.language))
+		goto error;
+	if (!readString(&offset, &_defs_version) || !readString(&offset, &_defs_format_version))
+		goto error;
+	if ((offset + 12) > _size)
+		goto error;
+	_nrOfRecords = qFromLittleEndian<quint32>(_data + offset);
+	_hashSlots = qFromLittleEndian<quint32>(_data + offset + 4);
+	_hashOffset = qFromLittleEndian<quint32>(_data + offset + 8);
+	_defaultRecordOffset = offset + 12;
+	if (!_nrOfRecords || !_hashSlots || (_hashSlots & (_hashSlots - 1)) || (_hashOffset < _defaultRecordOffset)
+	    || ((_hashOffset + static_cast<quint64>(_hashSlots) * SSM1DEFS_CACHE_SLOT_SIZE) != _size))
+		goto error;
+	return true;
+
+error:
+	close();
+	return false;
+}
+
+
+bool SSM1definitionsCache::isOpen() const
+{
+	return (_data != NULL);
+}
+
+
+void SSM1definitionsCache::close()
+{
+	if (_data)
+		_file.unmap(const_cast<uchar*>(_data));
+	_data = NULL;
+	_size = 0;
+	_file.close();
+	_defs_version.clear();
+	_defs_format_version.clear();
+	_nrOfRecords = 0;
+	_hashSlots = 0;
+	_hashOffset = 0;
+	_defaultRecordOffset = 0;
+}
+
+
+void SSM1definitionsCache::getVersionInfos(std::string *defs_version, std::string *format_version) const
+{
+	*defs_version = _defs_version;
+	*format_version = _defs_format_version;
+}
+
+
+bool SSM1definitionsCache::getRecord(char id[3], SSM1definitionsCacheRecord_dt *record) const
+{
+	unsigned int IDval = 0;
+	unsigned int slot = 0;
+	if (!_data)
+		return false;
+	IDval = (static_cast<unsigned char>(id[0]) << 16) | (static_cast<unsigned char>(id[1]) << 8) | static_cast<unsigned char>(id[2]);
+	slot = hashSlot(IDval, _hashSlots);
+	for (unsigned int k=0; k<_hashSlots; k++)
+	{
+		const uchar *slotData = _data + _hashOffset + slot * SSM1DEFS_CACHE_SLOT_SIZE;
+		quint32 slotID = qFromLittleEndian<quint32>(slotData);
+		if (!slotID)
+			return false;	// empty slot: ID not defined
+		if (slotID == (IDval + 1))
+			return readRecord(qFromLittleEndian<quint32>(slotData + 4), record);
+		slot = (slot + 1) & (_hashSlots - 1);
+	}
+	return false;
+}
+
+
+bool SSM1definitionsCache::getDefaultRecord(SSM1definitionsCacheRecord_dt *record) const
+{
+	if (!_data)
+		return false;
+	return readRecord(_defaultRecordOffset, record);
+}
+
+// PRIVATE
+
+unsigned int SSM1definitionsCache::hashSlot(unsigned int id, unsigned int slots)
+{
+	return (static_cast<quint32>(id * 2654435761U) >> 8) & (slots - 1);
+}
+
+
+bool SSM1definitionsCache::readString(quint64 *offset, std::string *str) const
+{
+	QString qstr;
+	if (!readString(offset, &qstr))
+		return false;
+	*str = qstr.toStdString();
+	return true;
+}
+
+
+bool SSM1definitionsCache::readString(quint64 *offset, QString *str) const
+{
+	if ((*offset + 2) > _size)
+		return false;
+	quint16 len = qFromLittleEndian<quint16>(_data + *offset);
+	if ((*offset + 2 + len) > _size)
+		return false;
+	*str = QString::fromUtf8(reinterpret_cast<const char*>(_data + *offset + 2), len);
+	*offset += 2 + len;
+	return true;
+}
+
+
+bool SSM1definitionsCache::readRecord(quint64 offset, SSM1definitionsCacheRecord_dt *record) const
+{
+	unsigned char flags = 0;
+	unsigned int count = 0;
+	*record = SSM1definitionsCacheRecord_dt();
+	if ((offset < _defaultRecordOffset) || (offset >= _hashOffset))
+		return false;
+	flags = _data[offset];
+	offset++;
+	record->hasSysDescription = flags & 0x01;
+	record->hasModel = flags & 0x02;
+	record->hasYear = flags & 0x04;
+	record->hasCMdata = flags & 0x08;
+	if (!readString(&offset, &record->sysDescription) || !readString(&offset, &record->model) || !readString(&offset, &record->year))
+		return false;
+	if ((offset + 9) > _hashOffset)
+		return false;
+	record->CMaddr = qFromLittleEndian<quint32>(_data + offset);
+	record->CMvalue = _data[offset + 4];
+	count = qFromLittleEndian<quint32>(_data + offset + 5);
+	offset += 9;
+	// DCs:
+	// NOTE: the counts are checked against the remaining data (corrupt cache)
+	if ((static_cast<quint64>(count) * SSM1DEFS_CACHE_MIN_DC_SIZE) > (_hashOffset - offset))
+		return false;
+	record->dcs.resize(count);
+	for (unsigned int k=0; k<count; k++)
+	{
+		if ((offset + 8) > _hashOffset)
+			return false;
+		record->dcs.at(k).byteAddr_currentOrTempOrLatest = qFromLittleEndian<quint32>(_data + offset);
+		record->dcs.at(k).byteAddr_historicOrMemorized = qFromLittleEndian<quint32>(_data + offset + 4);
+		offset += 8;
+		for (unsigned char b=0; b<8; b++)
+		{
+			if (!readString(&offset, &record->dcs.at(k).code[b]) || !readString(&offset, &record->dcs.at(k).title[b]))
+				return false;
+		}
+	}
+	// MBs:
+	if ((offset + 4) > _hashOffset)
+		return false;
+	count = qFromLittleEndian<quint32>(_data + offset);
+	offset += 4;
+	if ((static_cast<quint64>(count) * SSM1DEFS_CACHE_MIN_MB_SIZE) > (_hashOffset - offset))
+		return false;
+	record->mbs.resize(count);
+	for (unsigned int k=0; k<count; k++)
+	{
+		if ((offset + 9) > _hashOffset)
+			return false;
+		record->mbs.at(k).addr_low = qFromLittleEndian<quint32>(_data + offset);
+		record->mbs.at(k).addr_high = qFromLittleEndian<quint32>(_data + offset + 4);
+		record->mbs.at(k).precision = _data[offset + 8];
+		offset += 9;
+		if (!readString(&offset, &record->mbs.at(k).title) || !readString(&offset, &record->mbs.at(k).unit)
+		    || !readString(&offset, &record->mbs.at(k).scaleformula))
+			return false;
+	}
+	// SWs:
+	if ((offset + 4) > _hashOffset)
+		return false;
+	count = qFromLittleEndian<quint32>(_data + offset);
+	offset += 4;
+	if ((static_cast<quint64>(count) * SSM1DEFS_CACHE_MIN_SW_SIZE) > (_hashOffset - offset))
+		return false;
+	record->sws.resize(count);
+	for (unsigned int k=0; k<count; k++)
+	{
+		if ((offset + 5) > _hashOffset)
+			return false;
+		record->sws.at(k).byteAddr = qFromLittleEndian<quint32>(_data + offset);
+		record->sws.at(k).bitAddr = _data[offset + 4];
+		offset += 5;
+		if (!readString(&offset, &record->sws.at(k).title) || !readString(&offset, &record->sws.at(k).unit))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * SSM1definitionsCache.h - Binary cache of the SSM1-definitions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SSM1DEFINITIONSCACHE_H
+#define SSM1DEFINITIONSCACHE_H
+
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QtEndian>
+#include <string>
+#include <vector>
+#include <utility>
+#include "SSMprotocol.h"
+
+
+/* File layout (all values little endian):
+ *   header:   "FSSMSSM1", u16 version, u16 reserved, u64 file size,
+ *             u64 definitions file size, u64 definitions file modification time (s since epoch),
+ *             u16-length-prefixed UTF-8 definitions file path, language, definitions version, format version,
+ *             u32 number of records, u32 number of hash slots (power of 2), u32 hash table offset
+ *   records:  u8 flags (bit 0: system description, 1: model, 2: year, 3: clear memory data),
+ *             strings system description, model, year, u32 CM address, u8 CM value,
+ *             u32 number of DC blocks, blocks[] (u32 address current, u32 address historic, 8x strings code, title),
+ *             u32 number of MBs, MBs[] (u32 address low, u32 address high, s8 precision, strings title, unit, formula),
+ *             u32 number of SWs, SWs[] (u32 byte address, u8 bit address, strings title, unit)
+ *   hash:     slots[] (u32 ID + 1 (0 = empty slot), u32 record offset)
+ * NOTE: record 0 contains the definitions which are used if no ID is selected.
+ *       The definitions are resolved per ID, so all data of an ID is stored in one record.
+ */
+
+#define		SSM1DEFS_CACHE_FORMAT_VERSION	1
+
+
+class SSM1definitionsCacheKey_dt
+{
+public:
+	SSM1definitionsCacheKey_dt() { defsFileSize=0; defsFileMTime=0; };
+	std::string defsFile;
+	quint64 defsFileSize;
+	quint64 defsFileMTime;
+	std::string language;
+};
+
+
+class SSM1definitionsCacheRecord_dt
+{
+public:
+	SSM1definitionsCacheRecord_dt() { hasSysDescription=false; hasModel=false; hasYear=false; hasCMdata=false; CMaddr=0; CMvalue=0; };
+	bool hasSysDescription;
+	std::string sysDescription;
+	bool hasModel;
+	std::string model;
+	bool hasYear;
+	std::string year;
+	bool hasCMdata;
+	unsigned int CMaddr;
+	char CMvalue;
+	std::vector<dc_defs_dt> dcs;
+	std::vector<mb_intl_dt> mbs;
+	std::vector<sw_intl_dt> sws;
+};
+
+
+
+class SSM1definitionsCache
+{
+
+public:
+	SSM1definitionsCache();
+	~SSM1definitionsCache();
+	static std::string cacheFilename(std::string defsFile, std::string lang);
+	static bool getKey(std::string defsFile, std::string lang, SSM1definitionsCacheKey_dt *key);
+	static bool write(std::string cacheFile, const SSM1definitionsCacheKey_dt & key, std::string defs_version, std::string format_version,
+	                  const std::vector<SSM1definitionsCacheRecord_dt> & records, const std::vector< std::pair<unsigned int, unsigned int> > & IDs);
+	bool open(std::string cacheFile, const SSM1definitionsCacheKey_dt & key);
+	bool isOpen() const;
+	void close();
+	void getVersionInfos(std::string *defs_version, std::string *format_version) const;
+	bool getRecord(char id[3], SSM1definitionsCacheRecord_dt *record) const;
+	bool getDefaultRecord(SSM1definitionsCacheRecord_dt *record) const;
+
+private:
+	QFile _file;
+	const uchar *_data;
+	quint64 _size;
+	std::string _defs_version;
+	std::string _defs_format_version;
+	unsigned int _nrOfRecords;
+	unsigned int _hashSlots;
+	unsigned int _hashOffset;
+	unsigned int _defaultRecordOffset;
+
+	static unsigned int hashSlot(unsigned int id, unsigned int slots);
+	bool readString(quint64 *offset, std::string *str) const;
+	bool readString(quint64 *offset, QString *str) const;
+	bool readRecord(quint64 offset, SSM1definitionsCacheRecord_dt *record) const;
+};
+
+
+#endif
@@ -18,6 +18,12 @@
  */
 
 #include <SSM1definitionsInterface.h>
+#include <map>
+#include <set>
+#include <string.h>
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
 
 
 SSM1definitionsInterface::SSM1definitionsInterface(std::string lang)
@@ -33,6 +39,12 @@ SSM1definitionsInterface::SSM1definitionsInterface(std::string lang)
 }
 
 
+SSM1definitionsInterface::~SSM1definitionsInterface()
+{
+	delete _xmldoc;
+}
+
+
 bool SSM1definitionsInterface::selectDefinitionsFile(std::string filename)
 {
 	std::string fn_bak;
@@ -41,8 +53,30 @@ bool SSM1definitionsInterface::selectDefinitionsFile(std::string filename)
 	TiXmlNode *root_node;
 	if (!filename.size())
 		goto error;
+	// Use the cache of the definitions file, if it is up to date:
+	if (openCache(filename))
+	{
+		delete _xmldoc;
+		_xmldoc = NULL;
+		_defs_root_node = NULL;
+		_datacommon_root_node = NULL;
+		_defs_for_id_b1_node = NULL;
+		_defs_for_id_b2_node = NULL;
+		_defs_for_id_b3_node = NULL;
+		_defsFile = filename;
+		_cache.getVersionInfos(&_defs_version, &_defs_format_version);
+		_cache.getDefaultRecord(&_cacheRecord);
+		// Select definitions for the current ID:
+		if (_id_set)
+			selectID(_ID);
+		return true;
+	}
+	_cache.close();
 	if (!_xmldoc)
+	{
 		_xmldoc = new TiXmlDocument();
+		fn_bak = _defsFile;	// last document may be cached
+	}
 	else
 		fn_bak = _xmldoc->ValueStr();
 	if (!_xmldoc->LoadFile(filename)) // always closes the current document automatically !
@@ -91,6 +125,17 @@ bool SSM1definitionsInterface::selectDefinitionsFile(std::string filename)
 	if (elements.size() != 1)
 		goto error;
 	_datacommon_root_node = elements.at(0);
+	_defsFile = _xmldoc->ValueStr();
+	// Create the cache and use it for all further requests:
+	if (buildCache() && openCache(_defsFile))
+	{
+		delete _xmldoc;
+		_xmldoc = NULL;
+		_defs_root_node = NULL;
+		_datacommon_root_node = NULL;
+		_cache.getDefaultRecord(&_cacheRecord);
+	}
+	/* NOTE: continue with the XML-document if the cache can't be written */
 	// Find and save definition nodes for the current ID:
 	if (_id_set)
 		selectID(_ID);
@@ -99,6 +144,9 @@ bool SSM1definitionsInterface::selectDefinitionsFile(std::string filename)
 error:
 	delete _xmldoc;
 	_xmldoc = NULL;
+	_defsFile.clear();
+	_cache.close();
+	_cacheRecord = SSM1definitionsCacheRecord_dt();
 	_defs_version.clear();
 	_defs_format_version.clear();
 	_defs_root_node = NULL;
@@ -119,7 +167,11 @@ void SSM1definitionsInterface::getVersionInfos(std::string *defs_version, std::s
 
 void SSM1definitionsInterface::setLanguage(std::string lang)
 {
+	bool changed = (lang != _lang);
 	_lang = lang;
+	// The cache contains the definitions for one language only:
+	if (changed && _cache.isOpen())
+		selectDefinitionsFile(_defsFile);
 }
 
 
@@ -133,6 +185,20 @@ bool SSM1definitionsInterface::selectID(char id[3])
 	_defs_for_id_b1_node = NULL;
 	_defs_for_id_b2_node = NULL;
 	_defs_for_id_b3_node = NULL;
+	if (_cache.isOpen())
+	{
+		// Hash lookup of the resolved definitions:
+		if (!_cache.getRecord(id, &_cacheRecord))
+		{
+			_cache.getDefaultRecord(&_cacheRecord);
+			return false;
+		}
+		_ID[0] = id[0];
+		_ID[1] = id[1];
+		_ID[2] = id[2];
+		_id_set = true;
+		return true;
+	}
 	if (!_defs_root_node)
 		return false;
 	attribCondition.name = "value";
@@ -173,6 +239,13 @@ bool SSM1definitionsInterface::selectID(char id[3])
 bool SSM1definitionsInterface::systemDescription(std::string *description)
 {
 	std::vector<TiXmlElement*> elements;
+	if (_cache.isOpen())
+	{
+		if (!_cacheRecord.hasSysDescription)
+			return false;
+		*description = _cacheRecord.sysDescription;
+		return true;
+	}
 	if (_defs_for_id_b3_node)
 	{
 		elements = getAllMatchingChildElements(_defs_for_id_b3_node, "SYSTEMDESCRIPTION");
@@ -206,6 +279,13 @@ bool SSM1definitionsInterface::systemDescription(std::string *description)
 bool SSM1definitionsInterface::model(std::string *name)
 {
 	std::vector<TiXmlElement*> elements;
+	if (_cache.isOpen())
+	{
+		if (!_cacheRecord.hasModel)
+			return false;
+		*name = _cacheRecord.model;
+		return true;
+	}
 	if (_defs_for_id_b3_node)
 	{
 		elements = getAllMatchingChildElements(_defs_for_id_b3_node, "MODEL");
@@ -239,6 +319,13 @@ bool SSM1definitionsInterface::model(std::string *name)
 bool SSM1definitionsInterface::year(std::string *yearstr)
 {
 	std::vector<TiXmlElement*> elements;
+	if (_cache.isOpen())
+	{
+		if (!_cacheRecord.hasYear)
+			return false;
+		*yearstr = _cacheRecord.year;
+		return true;
+	}
 	if (_defs_for_id_b3_node)
 	{
 		elements = getAllMatchingChildElements(_defs_for_id_b3_node, "YEAR");
@@ -275,6 +362,14 @@ bool SSM1definitionsInterface::clearMemoryData(unsigned int *address, char *valu
 	TiXmlElement *CM_element;
 	TiXmlElement *addr_element;
 	const char *str = NULL;
+	if (_cache.isOpen())
+	{
+		if (!_cacheRecord.hasCMdata)
+			return false;
+		*address = _cacheRecord.CMaddr;
+		*value = _cacheRecord.CMvalue;
+		return true;
+	}
 	if (_defs_for_id_b3_node)
 	{
 		elements = getAllMatchingChildElements(_defs_for_id_b3_node, "CLEARMEMORY");
@@ -327,6 +422,11 @@ bool SSM1definitionsInterface::diagnosticCodes(std::vector<dc_defs_dt> *dcs)
 	std::vector<TiXmlElement*> DTCblock_elements;
 	std::vector<TiXmlElement*> DTCblock_elements2;
 	const char *str = NULL;
+	if (_cache.isOpen())
+	{
+		*dcs = _cacheRecord.dcs;
+		return true;
+	}
 	dcs->clear();
 	if (_defs_root_node)
 		DTCblock_elements = getAllMatchingChildElements(_defs_root_node, "DTCBLOCK");
@@ -518,6 +618,11 @@ bool SSM1definitionsInterface::measuringBlocks(std::vector<mb_intl_dt> *mbs)
 	std::vector<TiXmlElement*> MB_elements;
 	std::vector<TiXmlElement*> MB_elements2;
 	const char *str = NULL;
+	if (_cache.isOpen())
+	{
+		*mbs = _cacheRecord.mbs;
+		return true;
+	}
 	mbs->clear();
 	if (_defs_root_node)
 		MB_elements = getAllMatchingChildElements(_defs_root_node, "MB");
@@ -651,6 +756,11 @@ bool SSM1definitionsInterface::switches(std::vector<sw_intl_dt> *sws)
 	std::vector<TiXmlElement*> SWblock_elements;
 	std::vector<TiXmlElement*> SWblock_elements2;
 	const char *str = NULL;
+	if (_cache.isOpen())
+	{
+		*sws = _cacheRecord.sws;
+		return true;
+	}
 	sws->clear();
 	if (_defs_root_node)
 		SWblock_elements = getAllMatchingChildElements(_defs_root_node, "SWBLOCK");
@@ -776,6 +886,131 @@ bool SSM1definitionsInterface::switches(std::vector<sw_intl_dt> *sws)
 
 // PRIVATE:
 
+bool SSM1definitionsInterface::openCache(std::string filename)
+{
+	SSM1definitionsCacheKey_dt key;
+	std::string defs_version;
+	std::string format_version;
+	if (!SSM1definitionsCache::getKey(filename, _lang, &key))
+		return false;
+	if (!_cache.open(SSM1definitionsCache::cacheFilename(filename, _lang), key))
+		return false;
+	// The supported definitions format versions may have changed:
+	_cache.getVersionInfos(&defs_version, &format_version);
+	if (!checkDefsFormatVersion(format_version))
+	{
+		_cache.close();
+		return false;
+	}
+	return true;
+}
+
+
+bool SSM1definitionsInterface::buildCache()
+{
+	SSM1definitionsCacheKey_dt key;
+	std::vector<SSM1definitionsCacheRecord_dt> records;
+	std::vector< std::pair<unsigned int, unsigned int> > IDs;
+	std::map<TiXmlNode*, unsigned int> recordIndexes;
+	std::set<unsigned int> checkedIDs;
+	std::vector<TiXmlElement*> b1_elements;
+	std::vector<TiXmlElement*> b2_elements;
+	std::vector<TiXmlElement*> b3_elements;
+	unsigned int b1 = 0, b2 = 0, b3_start = 0, b3_end = 0;
+	char id[3];
+	char current_ID[3] = {_ID[0], _ID[1], _ID[2]};
+	bool current_id_set = _id_set;
+	bool ok = false;
+
+	if (!_defs_root_node || !SSM1definitionsCache::getKey(_defsFile, _lang, &key))
+		return false;
+	_cache.close();
+	// Definitions without ID:
+	_defs_for_id_b1_node = NULL;
+	_defs_for_id_b2_node = NULL;
+	_defs_for_id_b3_node = NULL;
+	records.push_back(SSM1definitionsCacheRecord_dt());
+	resolveDefinitions(&records.back());
+	// Definitions of all IDs:
+	b1_elements = getAllMatchingChildElements(_defs_root_node, "ID_BYTE1");
+	for (unsigned int k=0; k<b1_elements.size(); k++)
+	{
+		if (!IDbyteValue(b1_elements.at(k), "value", &b1))
+			continue;
+		b2_elements = getAllMatchingChildElements(b1_elements.at(k), "ID_BYTE2");
+		for (unsigned int m=0; m<b2_elements.size(); m++)
+		{
+			if (!IDbyteValue(b2_elements.at(m), "value", &b2))
+				continue;
+			b3_elements = getAllMatchingChildElements(b2_elements.at(m), "ID_BYTE3");
+			for (unsigned int n=0; n<b3_elements.size(); n++)
+			{
+				if (!IDbyteValue(b3_elements.at(n), "value_start", &b3_start) || !IDbyteValue(b3_elements.at(n), "value_end", &b3_end))
+					continue;
+				for (unsigned int b3=b3_start; b3<=b3_end; b3++)
+				{
+					unsigned int IDval = (b1 << 16) | (b2 << 8) | b3;
+					if (!checkedIDs.insert(IDval).second)
+						continue;
+					// Use the same ID selection as without cache (detects ambiguous definitions):
+					id[0] = b1;
+					id[1] = b2;
+					id[2] = b3;
+					if (!selectID(id))
+						continue;
+					// Resolve the definitions only once per ID_BYTE3 node:
+					std::map<TiXmlNode*, unsigned int>::iterator it = recordIndexes.find(_defs_for_id_b3_node);
+					if (it == recordIndexes.end())
+					{
+						records.push_back(SSM1definitionsCacheRecord_dt());
+						resolveDefinitions(&records.back());
+						it = recordIndexes.insert(std::make_pair(_defs_for_id_b3_node, records.size()-1)).first;
+					}
+					IDs.push_back(std::make_pair(IDval, it->second));
+				}
+			}
+		}
+	}
+	// Restore ID selection:
+	_defs_for_id_b1_node = NULL;
+	_defs_for_id_b2_node = NULL;
+	_defs_for_id_b3_node = NULL;
+	memcpy(_ID, current_ID, 3);
+	_id_set = current_id_set;
+	ok = SSM1definitionsCache::write(SSM1definitionsCache::cacheFilename(_defsFile, _lang), key, _defs_version, _defs_format_version, records, IDs);
+#ifdef __FSSM_DEBUG__
+	if (!ok)
+		std::cout << "SSM1definitionsInterface::buildCache():   failed to write the definitions cache\n";
+#endif
+	return ok;
+}
+
+
+void SSM1definitionsInterface::resolveDefinitions(SSM1definitionsCacheRecord_dt *record)
+{
+	record->hasSysDescription = systemDescription(&record->sysDescription);
+	record->hasModel = model(&record->model);
+	record->hasYear = year(&record->year);
+	record->hasCMdata = clearMemoryData(&record->CMaddr, &record->CMvalue);
+	diagnosticCodes(&record->dcs);
+	measuringBlocks(&record->mbs);
+	switches(&record->sws);
+}
+
+
+bool SSM1definitionsInterface::IDbyteValue(TiXmlElement *element, std::string attribName, unsigned int *value)
+{
+	double dval = 0;
+	const char *str = element->Attribute(attribName.c_str());
+	if ((str == NULL) || !StrToDouble(str, &dval))
+		return false;
+	if ((dval < 0) || (dval > 255) || (dval != static_cast<unsigned int>(dval)))
+		return false;
+	*value = dval;
+	return true;
+}
+
+
 std::vector<TiXmlElement*> SSM1definitionsInterface::getAllMatchingChildElements(TiXmlNode *pParent, std::string elementName, std::vector<attributeCondition> attribConditions)
 {
 	std::vector<TiXmlElement*> retElements;
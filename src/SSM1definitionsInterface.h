@@ -27,6 +27,7 @@
 #include "SSMprotocol.h"
 #include "tinyxml/tinyxml.h"
 #include "libFSSM.h"
+#include "SSM1definitionsCache.h"
 
 
 #define		SSM1_DEFS_FORMAT_VERSION_CURRENT	"0.2.0"
@@ -52,6 +53,7 @@ class SSM1definitionsInterface
 {
 public:
 	SSM1definitionsInterface(std::string lang = "en");
+	~SSM1definitionsInterface();
 	bool selectDefinitionsFile(std::string filename);
 	void getVersionInfos(std::string *defs_version, std::string *format_version);
 	void setLanguage(std::string lang);
@@ -68,6 +70,9 @@ public:
 
 private:
 	TiXmlDocument *_xmldoc;
+	std::string _defsFile;
+	SSM1definitionsCache _cache;
+	SSM1definitionsCacheRecord_dt _cacheRecord;	// definitions of the selected ID
 	std::string _defs_version;
 	std::string _defs_format_version;
 	std::string _lang;
@@ -80,6 +85,10 @@ private:
 	TiXmlNode *_defs_for_id_b2_node;
 	TiXmlNode *_defs_for_id_b3_node;
 
+	bool openCache(std::string filename);
+	bool buildCache();
+	void resolveDefinitions(SSM1definitionsCacheRecord_dt *record);
+	bool IDbyteValue(TiXmlElement *element, std::string attribName, unsigned int *value);
 	std::vector<TiXmlElement*> getAllMatchingChildElements(TiXmlNode *pParent, std::string elementName, std::vector<attributeCondition> attribCond=std::vector<attributeCondition>());
 	bool StrToDouble(std::string mystring, double *d);
 	bool checkDefsFormatVersion(std::string version_str);
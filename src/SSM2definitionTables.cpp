@@ -0,0 +1,413 @@
+/*
+ * SSM2definitionTables.cpp - Compiled SSM2-protocol-definitions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SSM2definitionTables.h"
+
+
+QMutex SSM2definitionTables::_mutex;
+SSM2definitionTables *SSM2definitionTables::_tables = NULL;
+SSM2definitionTexts *SSM2definitionTables::_texts_en = NULL;
+SSM2definitionTexts *SSM2definitionTables::_texts_de = NULL;
+
+
+
+const SSM2definitionTables *SSM2definitionTables::tables()
+{
+	QMutexLocker locker(&_mutex);
+	if (!_tables)
+		_tables = new SSM2definitionTables();
+	return _tables;
+	/* NOTE: the tables are never deleted (needed until the end of the program) */
+}
+
+
+const SSM2definitionTexts *SSM2definitionTables::texts(QString language)
+{
+	const SSM2definitionTables *numTables = tables();
+	QMutexLocker locker(&_mutex);
+	// The english texts are always needed (fallback for other languages):
+	if (!_texts_en)
+		_texts_en = compileTexts(numTables, "en", NULL);
+	if (language == "de")
+	{
+		if (!_texts_de)
+			_texts_de = compileTexts(numTables, "de", _texts_en);
+		return _texts_de;
+	}
+	return _texts_en;
+}
+
+
+QString SSM2definitionTables::definitionsKey(QString language)
+{
+	/* NOTE: identifies the compiled definitions independent of the application version,
+	 *       e.g. for caching data derived from the definitions                          */
+	return texts(language)->definitionsKey;
+}
+
+
+quint64 SSM2definitionTables::DCindexKey(unsigned int addr_currOrTempOrLatest, unsigned int addr_histOrMem)
+{
+	return (static_cast<quint64>(addr_currOrTempOrLatest) << 32) | addr_histOrMem;
+}
+
+// PRIVATE:
+
+SSM2definitionTables::SSM2definitionTables()
+{
+	/* NOTE: the numeric data is taken from the english definitions */
+	SSMprotocol2_def_en rawdefs_en;
+	compileMBs(rawdefs_en.MBrawDefs(), &MBs);
+	compileSWs(rawdefs_en.SWrawDefs(), &SWs);
+	compileAdjustments(rawdefs_en.AdjustmentRawDefs(), &adjustments);
+	compileActuators(rawdefs_en.ActuatorRawDefs(), &actuators);
+	compileDCs(rawdefs_en.SUBDTCrawDefs(), &SUBDTCs);
+	compileDCs(rawdefs_en.OBDDTCrawDefs(), &OBDDTCs);
+	compileDCs(rawdefs_en.CCCCrawDefs(), &CCCCs);
+}
+
+
+void SSM2definitionTables::compileMBs(const QStringList & rawDefs, std::vector<SSM2MBdef_dt> *defs)
+{
+	SSM2MBdef_dt def;
+	QString tmpstr;
+	int tmpbytenr = 0;
+	int tmpbitnr = 0;
+	int tmpprecision = 0;
+	bool ok = false;
+	defs->clear();
+	defs->reserve(rawDefs.size());
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		def.valid = false;
+		// Get flagbyte and flagbit definition:
+		tmpbytenr = rawDefs.at(k).section(';', 0, 0).toInt(&ok, 10);
+		tmpbitnr = rawDefs.at(k).section(';', 1, 1).toInt();
+		if (ok && (tmpbytenr > 0) && (tmpbytenr <= 96) && (tmpbitnr >= 1) && (tmpbitnr <= 8))
+		{
+			def.flagbyte = tmpbytenr;
+			def.flagmask = 1 << (tmpbitnr - 1);
+			// Get CU types:
+			def.CUs = rawDefs.at(k).section(';', 2, 2).toUInt();
+			// Get memory addresses:
+			def.addrLow = rawDefs.at(k).section(';', 3, 3).toUInt(&ok, 16);
+			if (ok && (def.addrLow != 0))
+			{
+				tmpstr = rawDefs.at(k).section(';', 4, 4);
+				if (tmpstr.isEmpty())
+					def.addrHigh = MEMORY_ADDRESS_NONE;
+				else
+					def.addrHigh = tmpstr.toUInt(&ok, 16);
+				def.valid = ok;
+			}
+			// Get precision and correct if necessary:
+			tmpprecision = rawDefs.at(k).section(';', 8, 8).toInt(&ok, 10);
+			if ((ok) && (tmpprecision < 4) && (tmpprecision > -4))
+				def.precision = tmpprecision;
+			else
+				def.precision = 1;
+		}
+		defs->push_back(def);
+	}
+}
+
+
+void SSM2definitionTables::compileSWs(const QStringList & rawDefs, std::vector<SSM2SWdef_dt> *defs)
+{
+	SSM2SWdef_dt def;
+	int tmpbytenr = 0;
+	int tmpbitnr = 0;
+	bool ok = false;
+	defs->clear();
+	defs->reserve(rawDefs.size());
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		def.valid = false;
+		tmpbytenr = rawDefs.at(k).section(';', 0, 0).toInt(&ok, 10);
+		tmpbitnr = rawDefs.at(k).section(';', 1, 1).toInt();
+		if (ok && (tmpbytenr > 0) && (tmpbytenr <= 96) && (tmpbitnr >= 1) && (tmpbitnr <= 8))
+		{
+			def.flagbyte = tmpbytenr;
+			def.flagbit = tmpbitnr;
+			def.CUs = rawDefs.at(k).section(';', 2, 2).toUInt();
+			def.byteAddr = rawDefs.at(k).section(';', 3, 3).toInt(&ok, 16);
+			def.valid = (ok && (def.byteAddr != 0));
+		}
+		defs->push_back(def);
+	}
+}
+
+
+void SSM2definitionTables::compileAdjustments(const QStringList & rawDefs, std::vector<SSM2adjustmentDef_dt> *defs)
+{
+	SSM2adjustmentDef_dt def;
+	QString defline;
+	QString tmphelpstr;
+	unsigned int tmpflagbyte = 0;
+	unsigned int tmpflagbit = 0;
+	unsigned int tmpCU = 0;
+	int tmpprecision = 0;
+	bool ok = false;
+	defs->clear();
+	defs->reserve(rawDefs.size());
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		defline = rawDefs.at(k);
+		def.valid = false;
+		def.flagbyte = 0;
+		def.flagmask = 0;
+		memset(def.sysID, 0, 3);
+		defs->push_back(def);
+		// Flagbyte/-bit or SYS-ID:
+		tmphelpstr = defline.section(';', 0, 0);
+		if (tmphelpstr.count('-') == 1)
+		{
+			tmpflagbyte = tmphelpstr.section('-', 0, 0).toUInt(&ok, 10);
+			if (!ok || (tmpflagbyte == 0) || (tmpflagbyte > 96))
+				continue;
+			tmpflagbit = tmphelpstr.section('-', 1, 1).toUInt(&ok, 10);
+			if (!ok || (tmpflagbit < 1) || (tmpflagbit > 8))
+				continue;
+			def.flagbyte = tmpflagbyte;
+			def.flagmask = 1 << (tmpflagbit - 1);
+		}
+		else if (tmphelpstr.size() == 6)
+		{
+			for (unsigned char b=0; b<3; b++)
+			{
+				def.sysID[b] = tmphelpstr.mid(2*b, 2).toUInt(&ok, 16);
+				if (!ok)
+					break;
+			}
+			if (!ok)
+				continue;
+		}
+		else
+			continue;
+		// CU type:
+		tmpCU = defline.section(';', 1, 1).toUInt(&ok, 10);
+		if (!ok || (tmpCU > 1))
+			continue;
+		def.CU = tmpCU;
+		// Memory addresses:
+		def.addrLow = defline.section(';', 2, 2).toUInt(&ok, 16);
+		if (!ok || (def.addrLow == 0))
+			continue;
+		def.addrHigh = defline.section(';', 3, 3).toUInt(&ok, 16);
+		if (!ok || (def.addrHigh < 1))
+			def.addrHigh = 0;
+		// Raw value range:
+		def.rawMin = defline.section(';', 6, 6).toUInt(&ok, 10);
+		if (!ok)
+			continue;
+		def.rawMax = defline.section(';', 7, 7).toUInt(&ok, 10);
+		if (!ok)
+			continue;
+		def.rawDefault = defline.section(';', 8, 8).toUInt(&ok, 10);
+		if (!ok)
+			continue;
+		// Precision:
+		tmphelpstr = defline.section(';', 10, 10);
+		if (tmphelpstr.length() == 0)
+			tmphelpstr = "0";
+		tmpprecision = tmphelpstr.toInt(&ok, 10);
+		if (!ok || (tmpprecision > 10) || (tmpprecision < -10))
+			continue;
+		def.precision = tmpprecision;
+		def.valid = true;
+		defs->back() = def;
+	}
+}
+
+
+void SSM2definitionTables::compileActuators(const QStringList & rawDefs, std::vector<SSM2actuatorDef_dt> *defs)
+{
+	SSM2actuatorDef_dt def;
+	unsigned int tmpflagbyte = 0;
+	unsigned int tmpflagbit = 0;
+	unsigned int tmpbitaddr = 0;
+	bool ok = false;
+	defs->clear();
+	defs->reserve(rawDefs.size());
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		def.valid = false;
+		tmpflagbyte = rawDefs.at(k).section(';', 0, 0).toUInt();
+		tmpflagbit = rawDefs.at(k).section(';', 1, 1).toUInt();
+		def.byteAddr = rawDefs.at(k).section(';', 2, 2).toUInt(&ok, 16);
+		tmpbitaddr = rawDefs.at(k).section(';', 3, 3).toUInt();
+		if ((tmpflagbyte >= 1) && (tmpflagbyte <= 96) && (tmpflagbit >= 1) && (tmpflagbit <= 8)
+		    && ok && (def.byteAddr != 0) && (tmpbitaddr >= 1) && (tmpbitaddr <= 8))
+		{
+			def.flagbyte = tmpflagbyte;
+			def.flagmask = 1 << (tmpflagbit - 1);
+			def.bitAddr = tmpbitaddr;
+			def.valid = true;
+		}
+		defs->push_back(def);
+	}
+}
+
+
+void SSM2definitionTables::compileDCs(const QStringList & rawDefs, SSM2DCtable_dt *table)
+{
+	SSM2DCdef_dt def;
+	QStringList tmpdefparts;
+	unsigned int tmpbitaddr = 0;
+	bool ok1 = false;
+	bool ok2 = false;
+	table->defs.clear();
+	table->index.clear();
+	table->defs.reserve(rawDefs.size());
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		def.addr_currOrTempOrLatest = 0;
+		def.addr_histOrMem = 0;
+		def.bit = 0;
+		tmpdefparts = rawDefs.at(k).split(';');
+		if (tmpdefparts.size() == 5)
+		{
+			def.addr_currOrTempOrLatest = tmpdefparts.at(0).toUInt(&ok1, 16);	// current/temporary/latest/D-Check DCs memory address
+			def.addr_histOrMem = tmpdefparts.at(1).toUInt(&ok2, 16);		// historic/memorized DCs memory address
+			tmpbitaddr = tmpdefparts.at(2).toUInt();				// flagbit
+			if (ok1 && ok2 && (tmpbitaddr >= 1) && (tmpbitaddr <= 8))
+			{
+				def.bit = tmpbitaddr;
+				table->index[ DCindexKey(def.addr_currOrTempOrLatest, def.addr_histOrMem) ].push_back(k);
+			}
+		}
+		table->defs.push_back(def);
+	}
+}
+
+
+SSM2definitionTexts *SSM2definitionTables::compileTexts(const SSM2definitionTables *numTables, QString language, const SSM2definitionTexts *fallback)
+{
+	SSM2definitionTexts *texts = new SSM2definitionTexts;
+	QHash<QString, QString> pool;
+	std::vector<int> fields;
+	QStringList MBrawDefs, SWrawDefs, adjustmentRawDefs, actuatorRawDefs, SUBDTCrawDefs, OBDDTCrawDefs, CCCCrawDefs;
+	if (language == "de")
+	{
+		SSMprotocol2_def_de rawdefs_de;
+		MBrawDefs = rawdefs_de.MBrawDefs();
+		SWrawDefs = rawdefs_de.SWrawDefs();
+		adjustmentRawDefs = rawdefs_de.AdjustmentRawDefs();
+		actuatorRawDefs = rawdefs_de.ActuatorRawDefs();
+		SUBDTCrawDefs = rawdefs_de.SUBDTCrawDefs();
+		OBDDTCrawDefs = rawdefs_de.OBDDTCrawDefs();
+		CCCCrawDefs = rawdefs_de.CCCCrawDefs();
+	}
+	else
+	{
+		SSMprotocol2_def_en rawdefs_en;
+		MBrawDefs = rawdefs_en.MBrawDefs();
+		SWrawDefs = rawdefs_en.SWrawDefs();
+		adjustmentRawDefs = rawdefs_en.AdjustmentRawDefs();
+		actuatorRawDefs = rawdefs_en.ActuatorRawDefs();
+		SUBDTCrawDefs = rawdefs_en.SUBDTCrawDefs();
+		OBDDTCrawDefs = rawdefs_en.OBDDTCrawDefs();
+		CCCCrawDefs = rawdefs_en.CCCCrawDefs();
+	}
+	// Hash of the raw definitions (the numeric data is taken from the english definitions, see fallback):
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (fallback)
+		hash.addData(fallback->definitionsKey.toAscii());
+	addToHash(MBrawDefs, &hash);
+	addToHash(SWrawDefs, &hash);
+	addToHash(adjustmentRawDefs, &hash);
+	addToHash(actuatorRawDefs, &hash);
+	addToHash(SUBDTCrawDefs, &hash);
+	addToHash(OBDDTCrawDefs, &hash);
+	addToHash(CCCCrawDefs, &hash);
+	texts->definitionsKey = language + ":" + QString(hash.result().toHex());
+	// MBs: title, unit, formula
+	fields.push_back(5);
+	fields.push_back(6);
+	fields.push_back(7);
+	addTexts(MBrawDefs, numTables->MBs.size(), fields, fallback ? &fallback->MBs : NULL, &pool, &texts->MBs);
+	// Switches: title, unit
+	fields.clear();
+	fields.push_back(4);
+	fields.push_back(5);
+	addTexts(SWrawDefs, numTables->SWs.size(), fields, fallback ? &fallback->SWs : NULL, &pool, &texts->SWs);
+	// Adjustments: title, unit, formula
+	fields.clear();
+	fields.push_back(4);
+	fields.push_back(5);
+	fields.push_back(9);
+	addTexts(adjustmentRawDefs, numTables->adjustments.size(), fields, fallback ? &fallback->adjustments : NULL, &pool, &texts->adjustments);
+	// Actuators: title
+	fields.clear();
+	fields.push_back(4);
+	addTexts(actuatorRawDefs, numTables->actuators.size(), fields, fallback ? &fallback->actuators : NULL, &pool, &texts->actuators);
+	// DCs: code, title
+	fields.clear();
+	fields.push_back(3);
+	fields.push_back(4);
+	addTexts(SUBDTCrawDefs, numTables->SUBDTCs.defs.size(), fields, fallback ? &fallback->SUBDTCs : NULL, &pool, &texts->SUBDTCs);
+	addTexts(OBDDTCrawDefs, numTables->OBDDTCs.defs.size(), fields, fallback ? &fallback->OBDDTCs : NULL, &pool, &texts->OBDDTCs);
+	addTexts(CCCCrawDefs, numTables->CCCCs.defs.size(), fields, fallback ? &fallback->CCCCs : NULL, &pool, &texts->CCCCs);
+	return texts;
+}
+
+
+void SSM2definitionTables::addToHash(const QStringList & rawDefs, QCryptographicHash *hash)
+{
+	for (int k=0; k<rawDefs.size(); k++)
+	{
+		hash->addData(rawDefs.at(k).toUtf8());
+		hash->addData("\n", 1);
+	}
+	hash->addData("\0", 1);	// end of list
+}
+
+
+void SSM2definitionTables::addTexts(const QStringList & rawDefs, unsigned int nrOfDefs, const std::vector<int> & fields,
+				    const std::vector<QString> *fallback, QHash<QString, QString> *pool, std::vector<QString> *texts)
+{
+	QString tmpstr;
+	texts->clear();
+	if ((static_cast<unsigned int>(rawDefs.size()) != nrOfDefs) && fallback)
+	{
+		// Definitions don't match the numeric tables: use fallback texts
+		*texts = *fallback;
+		return;
+	}
+	texts->reserve(nrOfDefs * fields.size());
+	for (unsigned int k=0; k<nrOfDefs; k++)
+	{
+		for (unsigned int f=0; f<fields.size(); f++)
+		{
+			if (static_cast<int>(k) < rawDefs.size())
+				tmpstr = rawDefs.at(k).section(';', fields.at(f), fields.at(f));
+			else
+				tmpstr.clear();
+			// Share identical strings:
+			QHash<QString, QString>::const_iterator it = pool->find(tmpstr);
+			if (it != pool->end())
+				texts->push_back(it.value());
+			else
+			{
+				pool->insert(tmpstr, tmpstr);
+				texts->push_back(tmpstr);
+			}
+		}
+	}
+}
@@ -0,0 +1,164 @@
+/*
+ * SSM2definitionTables.h - Compiled SSM2-protocol-definitions
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SSM2DEFINITIONTABLES_H
+#define SSM2DEFINITIONTABLES_H
+
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <vector>
+#include "SSMprotocol.h"
+#include "SSMprotocol2_def_en.h"
+#include "SSMprotocol2_def_de.h"
+
+
+
+/* NOTE: the raw definitions are parsed only once per program run.
+ *       The numeric data is language independent and exists only once,
+ *       the strings of each language are stored in separate tables
+ *       (same index as the numeric data, identical strings are shared).
+ *       => the definitions of all languages must have the same order !
+ */
+
+class SSM2MBdef_dt
+{
+public:
+	bool valid;
+	unsigned char flagbyte;		// 1-96
+	unsigned char flagmask;
+	unsigned char CUs;		// bit 0: engine, bit 1: transmission
+	unsigned int addrLow;
+	unsigned int addrHigh;		// MEMORY_ADDRESS_NONE if 8 bit value
+	char precision;
+};
+
+
+class SSM2SWdef_dt
+{
+public:
+	bool valid;
+	unsigned char flagbyte;
+	unsigned char flagbit;		// 1-8
+	unsigned char CUs;
+	unsigned int byteAddr;
+};
+
+
+class SSM2adjustmentDef_dt
+{
+public:
+	bool valid;
+	unsigned char flagbyte;		// 0 if selected by SYS-ID
+	unsigned char flagmask;
+	unsigned char sysID[3];
+	unsigned char CU;		// 0: engine, 1: transmission
+	unsigned int addrLow;
+	unsigned int addrHigh;
+	unsigned int rawMin;
+	unsigned int rawMax;
+	unsigned int rawDefault;
+	char precision;
+};
+
+
+class SSM2actuatorDef_dt
+{
+public:
+	bool valid;
+	unsigned char flagbyte;
+	unsigned char flagmask;
+	unsigned int byteAddr;
+	unsigned char bitAddr;
+};
+
+
+class SSM2DCdef_dt
+{
+public:
+	unsigned int addr_currOrTempOrLatest;
+	unsigned int addr_histOrMem;
+	unsigned char bit;		// 1-8
+};
+
+
+class SSM2DCtable_dt
+{
+public:
+	std::vector<SSM2DCdef_dt> defs;
+	QHash<quint64, std::vector<unsigned int> > index;	// address pair => definitions
+};
+
+
+class SSM2definitionTexts
+{
+public:
+	std::vector<QString> MBs;		// title, unit, formula
+	std::vector<QString> SWs;		// title, unit
+	std::vector<QString> adjustments;	// title, unit, formula
+	std::vector<QString> actuators;		// title
+	std::vector<QString> SUBDTCs;		// code, title
+	std::vector<QString> OBDDTCs;		// code, title
+	std::vector<QString> CCCCs;		// code, title
+	QString definitionsKey;			// hash of the raw definitions (including the fallback language)
+};
+
+
+
+class SSM2definitionTables
+{
+
+public:
+	static const SSM2definitionTables *tables();
+	static const SSM2definitionTexts *texts(QString language);
+	static QString definitionsKey(QString language);
+
+	std::vector<SSM2MBdef_dt> MBs;
+	std::vector<SSM2SWdef_dt> SWs;
+	std::vector<SSM2adjustmentDef_dt> adjustments;
+	std::vector<SSM2actuatorDef_dt> actuators;
+	SSM2DCtable_dt SUBDTCs;
+	SSM2DCtable_dt OBDDTCs;
+	SSM2DCtable_dt CCCCs;
+
+	static quint64 DCindexKey(unsigned int addr_currOrTempOrLatest, unsigned int addr_histOrMem);
+
+private:
+	static QMutex _mutex;
+	static SSM2definitionTables *_tables;
+	static SSM2definitionTexts *_texts_en;
+	static SSM2definitionTexts *_texts_de;
+
+	SSM2definitionTables();
+	static void compileMBs(const QStringList & rawDefs, std::vector<SSM2MBdef_dt> *defs);
+	static void compileSWs(const QStringList & rawDefs, std::vector<SSM2SWdef_dt> *defs);
+	static void compileAdjustments(const QStringList & rawDefs, std::vector<SSM2adjustmentDef_dt> *defs);
+	static void compileActuators(const QStringList & rawDefs, std::vector<SSM2actuatorDef_dt> *defs);
+	static void compileDCs(const QStringList & rawDefs, SSM2DCtable_dt *table);
+	static SSM2definitionTexts *compileTexts(const SSM2definitionTables *numTables, QString language, const SSM2definitionTexts *fallback);
+	static void addToHash(const QStringList & rawDefs, QCryptographicHash *hash);
+	static void addTexts(const QStringList & rawDefs, unsigned int nrOfDefs, const std::vector<int> & fields,
+			     const std::vector<QString> *fallback, QHash<QString, QString> *pool, std::vector<QString> *texts);
+};
+
+
+#endif
@@ -77,7 +77,8 @@ bool SSM2definitionsInterface::systemDescription(QString *description)
 bool SSM2definitionsInterface::diagnosticCodes(std::vector<dc_defs_dt> *diagnosticCodes, bool *fmt_OBD2)
 {
 	unsigned int addr = 0;
-	QStringList rawDefs;
+	const SSM2DCtable_dt *table = NULL;
+	const std::vector<QString> *texts = NULL;
 	bool obdDTCs = false;
 
 	if (!_id_set)
@@ -85,75 +86,70 @@ bool SSM2definitionsInterface::diagnosticCodes(std::vector<dc_defs_dt> *diagnost
 	if ((_CU != SSMprotocol::CUtype_Engine) && (_CU != SSMprotocol::CUtype_Transmission))
 		return false;
 	*fmt_OBD2 = !(_flagbytes[29] & 0x80);
-	if (_language == "de")
+	// Select definitions:
+	if (*fmt_OBD2)
 	{
-		SSMprotocol2_def_de rawdefs_de;
-		if (*fmt_OBD2)
-			rawDefs = rawdefs_de.OBDDTCrawDefs();
-		else
-			rawDefs = rawdefs_de.SUBDTCrawDefs();
+		table = &SSM2definitionTables::tables()->OBDDTCs;
+		texts = &SSM2definitionTables::texts(_language)->OBDDTCs;
 	}
 	else
 	{
-		SSMprotocol2_def_en rawdefs_en;
-		if (*fmt_OBD2)
-			rawDefs = rawdefs_en.OBDDTCrawDefs();
-		else
-			rawDefs = rawdefs_en.SUBDTCrawDefs();
+		table = &SSM2definitionTables::tables()->SUBDTCs;
+		texts = &SSM2definitionTables::texts(_language)->SUBDTCs;
 	}
 	// Setup data of the supported DTCs:
 	diagnosticCodes->clear();
 	if (!obdDTCs)
 	{
 		for (addr=0x8E; addr<=0x98; addr++)
-			addDCdefs(addr, addr+22, rawDefs, diagnosticCodes);
+			addDCdefs(addr, addr+22, *table, *texts, diagnosticCodes);
 		return true;
 	}
 	else if ((_flagbytes[29] & 0x10) || (_flagbytes[29] & 0x40))
 	{
 		for (addr=0x8E; addr<=0xAD; addr++)
-			addDCdefs(addr, addr+32, rawDefs, diagnosticCodes);
+			addDCdefs(addr, addr+32, *table, *texts, diagnosticCodes);
 	}
 	if (_flagbytes[28] & 0x01)
 	{
 		for (addr=0xF0; addr<=0xF3; addr++)
-			addDCdefs(addr, addr+4, rawDefs, diagnosticCodes);
+			addDCdefs(addr, addr+4, *table, *texts, diagnosticCodes);
 	}
 	if (_nrofflagbytes > 32)
 	{
 		if (_flagbytes[39] & 0x80)
 		{
 			for (addr=0x123; addr<=0x12A; addr++)
-				addDCdefs(addr, addr+8, rawDefs, diagnosticCodes);
+				addDCdefs(addr, addr+8, *table, *texts, diagnosticCodes);
 		}
 		if (_flagbytes[39] & 0x40)
 		{
 			for (addr=0x150; addr<=0x154; addr++)
-				addDCdefs(addr, addr+5, rawDefs, diagnosticCodes);
+				addDCdefs(addr, addr+5, *table, *texts, diagnosticCodes);
 		}
 		if (_flagbytes[39] & 0x20)
 		{
 			for (addr=0x160; addr<=0x164; addr++)
-				addDCdefs(addr, addr+5, rawDefs, diagnosticCodes);
+				addDCdefs(addr, addr+5, *table, *texts, diagnosticCodes);
 		}
 		if (_flagbytes[39] & 0x10)
 		{
 			for (addr=0x174; addr<=0x17A; addr++)
-				addDCdefs(addr, addr+7, rawDefs, diagnosticCodes);
+				addDCdefs(addr, addr+7, *table, *texts, diagnosticCodes);
 		}
 		if (_nrofflagbytes > 48)
 		{
 			if (_flagbytes[50] & 0x40)
 			{
 				for (addr=0x1C1; addr<=0x1C6; addr++)
-					addDCdefs(addr, addr+6, rawDefs, diagnosticCodes);
+					addDCdefs(addr, addr+6, *table, *texts, diagnosticCodes);
 				for (addr=0x20A; addr<=0x20D; addr++)
-					addDCdefs(addr, addr+4, rawDefs, diagnosticCodes);
+					addDCdefs(addr, addr+4, *table, *texts, diagnosticCodes);
 			}
 			if (_flagbytes[50] & 0x20)
 			{
 				for (addr=0x263; addr<=0x267; addr++)
-					addDCdefs(addr, addr+5, rawDefs, diagnosticCodes);
+					addDCdefs(addr, addr+5, *table, *texts, diagnosticCodes);
 			}
 		}
 	}
@@ -171,21 +167,12 @@ bool SSM2definitionsInterface::cruiseControlCancelCodes(std::vector<dc_defs_dt>
 	cancelCodes->clear();
 	if (!CCsup)
 		return true;
-	// Get raw CCCC-definitions:
-	QStringList CCrawDefs;
-	if (_language == "de")
-	{
-		SSMprotocol2_def_de rawdefs_de;
-		CCrawDefs = rawdefs_de.CCCCrawDefs();
-	}
-	else
-	{
-		SSMprotocol2_def_en rawdefs_en;
-		CCrawDefs = rawdefs_en.CCCCrawDefs();
-	}
+	// Get CCCC-definitions:
+	const SSM2DCtable_dt & table = SSM2definitionTables::tables()->CCCCs;
+	const std::vector<QString> & texts = SSM2definitionTables::texts(_language)->CCCCs;
 	// Setup data of the supported CCCCs:
 	for (addr=0x133; addr<=0x136; addr++)
-		addDCdefs(addr, addr+4, CCrawDefs, cancelCodes);
+		addDCdefs(addr, addr+4, table, texts, cancelCodes);
 	*memCC_supported = (_flagbytes[41] & 0x04);
 	return true;
 }
@@ -193,90 +180,41 @@ bool SSM2definitionsInterface::cruiseControlCancelCodes(std::vector<dc_defs_dt>
 
 bool SSM2definitionsInterface::measuringBlocks(std::vector<mb_intl_dt> *measuringblocks)
 {
-	QString mbdefline;
-	QString tmpstr;
-	int tmpbytenr = 0;
-	int tmpbitnr = 0;
-	int tmpprecision = 0;
+	unsigned char CUmask = 0;
 	mb_intl_dt tmpMB;
-	bool ok = false;
-	int k = 0;
 
 	if (!_id_set)
 		return false;
-	if ((_CU != SSMprotocol::CUtype_Engine) && (_CU != SSMprotocol::CUtype_Transmission))
+	if (_CU == SSMprotocol::CUtype_Engine)
+		CUmask = 0x01;
+	else if (_CU == SSMprotocol::CUtype_Transmission)
+		CUmask = 0x02;
+	else
 		return false;
 	measuringblocks->clear();
-	// Select definitions depending on language:
-	QStringList mbrawdata;
-	if (_language == "de")
-	{
-		SSMprotocol2_def_de rawdefs_de;
-		mbrawdata = rawdefs_de.MBrawDefs();
-	}
-	else
-	{
-		SSMprotocol2_def_en rawdefs_en;
-		mbrawdata = rawdefs_en.MBrawDefs();
-	}
+	const std::vector<SSM2MBdef_dt> & defs = SSM2definitionTables::tables()->MBs;
+	const std::vector<QString> & texts = SSM2definitionTables::texts(_language)->MBs;
 	// Assort list of supported MBs:
-	for (k=0; k<mbrawdata.size(); k++)
+	for (unsigned int k=0; k<defs.size(); k++)
 	{
-		// Get flagbyte address definition:
-		mbdefline = mbrawdata.at(k);
-		tmpstr = mbdefline.section(';', 0, 0);
-		tmpbytenr = tmpstr.toInt(&ok, 10);
-		// Check if flagbyte is supported by our CU:
-		if (!ok || (tmpbytenr > _nrofflagbytes))
-			continue;
-		// Get flagbit definition:
-		tmpstr = mbdefline.section(';', 1, 1);
-		tmpbitnr = tmpstr.toInt();
-		// Check if CU supports this MB (if flagbit is set):
-		if ((tmpbitnr < 1) || (tmpbitnr > 8))
-			continue;;
-		if (!(_flagbytes[tmpbytenr-1] & static_cast<unsigned char>(pow(2, (tmpbitnr-1)))))
-			continue;
-		// Check if MB is intended for this CU type:
-		tmpstr = mbdefline.section(';', 2, 2);
-		if (!((_CU == SSMprotocol::CUtype_Engine) && (tmpstr.toUInt() & 0x01)) &&
-		    !((_CU == SSMprotocol::CUtype_Transmission) && (tmpstr.toUInt() & 0x02)))
+		const SSM2MBdef_dt & def = defs.at(k);
+		// Check if definition is valid and flagbyte is supported by our CU:
+		if (!def.valid || (def.flagbyte > _nrofflagbytes))
 			continue;
-		// Get memory address (low) definition:
-		tmpstr = mbdefline.section(';', 3, 3);
-		tmpMB.addr_low = tmpstr.toUInt(&ok, 16);
-		// Check if memory address (low) is valid:
-		if (!ok || (tmpMB.addr_low == 0))
+		// Check if CU supports this MB (if flagbit is set) and if MB is intended for this CU type:
+		if (!(_flagbytes[def.flagbyte-1] & def.flagmask) || !(def.CUs & CUmask))
 			continue;
-		// Get memory address (high) definition:
-		tmpstr = mbdefline.section(';', 4, 4);
-		if (tmpstr.isEmpty())
-			tmpMB.addr_high = MEMORY_ADDRESS_NONE;
-		else
-			tmpMB.addr_high = tmpstr.toUInt(&ok, 16);
-		if (!ok)
-			continue;
-		// Get title definition:
-		tmpMB.title = mbdefline.section(';', 5, 5);
-		// Check if title is available:
-		if (tmpMB.title.isEmpty())
-			continue;
-		// Get scaling formula definition:
-		tmpMB.scaleformula = mbdefline.section(';', 7, 7);
-		// Check if scaling formula is available:
-		if (tmpMB.scaleformula.isEmpty())
+		// Check if title and scaling formula are available:
+		if (texts.at(3*k).isEmpty() || texts.at(3*k+2).isEmpty())
 			continue;
-		// Get precision and correct if necessary:
-		tmpstr = mbdefline.section(';', 8, 8);
-		tmpprecision = tmpstr.toInt(&ok, 10);
-		if ((ok) && (tmpprecision < 4) && (tmpprecision > -4))
-			tmpMB.precision = tmpprecision;
-		else
-			tmpMB.precision = 1;
-		// Get unit:
-		tmpMB.unit = mbdefline.section(';', 6, 6);
 		// ***** MB IS SUPPORTED BY CU AND DEFINITION IS VALID *****
 		// Put MB data on the list:
+		tmpMB.addr_low = def.addrLow;
+		tmpMB.addr_high = def.addrHigh;
+		tmpMB.title = texts.at(3*k);
+		tmpMB.unit = texts.at(3*k+1);
+		tmpMB.scaleformula = texts.at(3*k+2);
+		tmpMB.precision = def.precision;
 		measuringblocks->push_back(tmpMB);
 	}
 	return true;
@@ -285,72 +223,39 @@ bool SSM2definitionsInterface::measuringBlocks(std::vector<mb_intl_dt> *measurin
 
 bool SSM2definitionsInterface::switches(std::vector<sw_intl_dt> *switches)
 {
-	QString swdefline;
-	QString tmpstr;
-	int tmpbytenr = 0;
-	int tmpbitnr = 0;
+	unsigned char CUmask = 0;
 	sw_intl_dt tmpSW;
-	bool ok = false;
-	int k = 0;
 
 	if (!_id_set)
 		return false;
-	if ((_CU != SSMprotocol::CUtype_Engine) && (_CU != SSMprotocol::CUtype_Transmission))
+	if (_CU == SSMprotocol::CUtype_Engine)
+		CUmask = 0x01;
+	else if (_CU == SSMprotocol::CUtype_Transmission)
+		CUmask = 0x02;
+	else
 		return false;
 	switches->clear();
-	// Select definitions depending on language:
-	QStringList swrawdata;
-	if (_language == "de")
-	{
-		SSMprotocol2_def_de rawdefs_de;
-		swrawdata = rawdefs_de.SWrawDefs();
-	}
-	else
-	{
-		SSMprotocol2_def_en rawdefs_en;
-		swrawdata = rawdefs_en.SWrawDefs();
-	}
+	const std::vector<SSM2SWdef_dt> & defs = SSM2definitionTables::tables()->SWs;
+	const std::vector<QString> & texts = SSM2definitionTables::texts(_language)->SWs;
 	// Assort list of supported switches:
-	for (k=0; k<swrawdata.size(); k++)
+	for (unsigned int k=0; k<defs.size(); k++)
 	{
-		// Get flagbyte address definition:
-		swdefline = swrawdata.at(k);
-		tmpstr = swdefline.section(';', 0, 0);
-		tmpbytenr = tmpstr.toInt(&ok, 10);
-		// Check if flagbyte is supported by our CU:
-		if (!ok || (tmpbytenr > _nrofflagbytes))
-			continue;
-		// Get flagbit definition:
-		tmpstr = swdefline.section(';', 1, 1);
-		tmpbitnr = tmpstr.toInt();
-		// Check if CU supports this switch (if flagbit is set):
-		if ((tmpbitnr < 1) || (tmpbitnr > 8))
+		const SSM2SWdef_dt & def = defs.at(k);
+		// Check if definition is valid and flagbyte is supported by our CU:
+		if (!def.valid || (def.flagbyte > _nrofflagbytes))
 			continue;
-		if (!(_flagbytes[tmpbytenr-1] & static_cast<unsigned char>(pow(2, (tmpbitnr-1)) )))
+		// Check if CU supports this switch (if flagbit is set) and if switch is intended for this CU type:
+		if (!(_flagbytes[def.flagbyte-1] & (1 << (def.flagbit-1))) || !(def.CUs & CUmask))
 			continue;
-		// Check if switch is intended for this CU type:
-		tmpstr = swdefline.section(';', 2, 2);
-		if (!((_CU == SSMprotocol::CUtype_Engine) && (tmpstr.toUInt() & 0x01)) &&
-		    !((_CU == SSMprotocol::CUtype_Transmission) && (tmpstr.toUInt() & 0x02)))
-			continue;
-		// Get memory address definition:
-		tmpstr = swdefline.section(';', 3, 3);
-		tmpSW.byteAddr = tmpstr.toInt(&ok, 16);
-		// Check if memory address is valid:
-		if (!ok || (tmpSW.byteAddr == 0))
-			continue;
-		// Get title definition:
-		tmpSW.title = swdefline.section(';', 4, 4);
-		// Check if title is available:
-		if (tmpSW.title.isEmpty())
-			continue;
-		// Get unit definition:
-		tmpSW.unit = swdefline.section(';', 5, 5);
-		if (tmpSW.unit.isEmpty())
+		// Check if title and unit are available:
+		if (texts.at(2*k).isEmpty() || texts.at(2*k+1).isEmpty())
 			continue;
 		// ***** SWITCH IS SUPPORTED BY CU AND DEFINITION IS VALID *****
 		// Put switch data on the list:
-		tmpSW.bitAddr = static_cast<unsigned char>(tmpbitnr);
+		tmpSW.byteAddr = def.byteAddr;
+		tmpSW.bitAddr = def.flagbit;
+		tmpSW.title = texts.at(2*k);
+		tmpSW.unit = texts.at(2*k+1);
 		switches->push_back(tmpSW);
 	}
 	return true;
@@ -359,97 +264,45 @@ bool SSM2definitionsInterface::switches(std::vector<sw_intl_dt> *switches)
 
 bool SSM2definitionsInterface::adjustments(std::vector<adjustment_intl_dt> *adjustments)
 {
-	QString defline = "";
-	QString tmphelpstr = "";
-	unsigned int tmpflagbyte = 0;
-	unsigned int tmpflagbit = 0;
-	unsigned int tmpsidbval = 0;
-	unsigned int tmpCU = 0;
+	unsigned char CU = 0;
 	adjustment_intl_dt tmpadjustment;
-	int k = 0;
-	bool ok = false;
-	QStringList adjustmentsrawdata;
 
 	if (!_id_set)
 		return false;
-	if ((_CU != SSMprotocol::CUtype_Engine) && (_CU != SSMprotocol::CUtype_Transmission))
+	if (_CU == SSMprotocol::CUtype_Engine)
+		CU = 0;
+	else if (_CU == SSMprotocol::CUtype_Transmission)
+		CU = 1;
+	else
 		return false;
 	adjustments->clear();
-	if (_language == "de")
+	const std::vector<SSM2adjustmentDef_dt> & defs = SSM2definitionTables::tables()->adjustments;
+	const std::vector<QString> & texts = SSM2definitionTables::texts(_language)->adjustments;
+	for (unsigned int k=0; k<defs.size(); k++)
 	{
-		SSMprotocol2_def_de rawdefs_de;
-		adjustmentsrawdata = rawdefs_de.AdjustmentRawDefs();
-	}
-	else
-	{
-		SSMprotocol2_def_en rawdefs_en;
-		adjustmentsrawdata = rawdefs_en.AdjustmentRawDefs();
-	}
-	for (k=0; k<adjustmentsrawdata.size(); k++)
-	{
-		defline = adjustmentsrawdata.at(k);
-		tmphelpstr = defline.section(';', 0, 0);
-		if (tmphelpstr.count('-') == 1)
-		{
-			tmpflagbyte = tmphelpstr.section('-', 0, 0).toUInt(&ok, 10);
-			if (!ok || (tmpflagbyte == 0) || (tmpflagbyte > _nrofflagbytes))
-				continue;
-			tmpflagbit = tmphelpstr.section('-', 1, 1).toUInt(&ok, 10);
-			if (!ok || (tmpflagbit < 1) || (tmpflagbit > 8))
-				continue;
-			if (!(_flagbytes[tmpflagbyte-1] & static_cast<unsigned char>(pow(2,(tmpflagbit-1)))))
-				continue;
-		}
-		else if (tmphelpstr.size() == 6)
+		const SSM2adjustmentDef_dt & def = defs.at(k);
+		if (!def.valid || (def.CU != CU))
+			continue;
+		if (def.flagbyte)
 		{
-			tmpsidbval = tmphelpstr.mid(0, 2).toUInt(&ok, 16);
-			if (!ok || (tmpsidbval != static_cast<unsigned char>(_ID1[0])))
-				continue;
-			tmpsidbval = tmphelpstr.mid(2, 2).toUInt(&ok, 16);
-			if (!ok || (tmpsidbval != static_cast<unsigned char>(_ID1[1])))
-				continue;
-			tmpsidbval = tmphelpstr.mid(4, 2).toUInt(&ok, 16);
-			if (!ok || (tmpsidbval != static_cast<unsigned char>(_ID1[2])))
+			if ((def.flagbyte > _nrofflagbytes) || !(_flagbytes[def.flagbyte-1] & def.flagmask))
 				continue;
 		}
-		else
-			continue;
-		tmpCU = defline.section(';', 1, 1).toUInt(&ok, 10);
-		if (!ok)
+		else if ((def.sysID[0] != static_cast<unsigned char>(_ID1[0])) || (def.sysID[1] != static_cast<unsigned char>(_ID1[1]))
+			 || (def.sysID[2] != static_cast<unsigned char>(_ID1[2])))
 			continue;
-		if ( !((_CU == SSMprotocol::CUtype_Engine) && (tmpCU == 0)) && !((_CU == SSMprotocol::CUtype_Transmission) && (tmpCU == 1)) )
+		if (texts.at(3*k).isEmpty() || texts.at(3*k+2).isEmpty())
 			continue;
-		tmpadjustment.AddrLow = defline.section(';', 2, 2).toUInt(&ok, 16);
-		if (!ok || (tmpadjustment.AddrLow == 0))
-			continue;
-		tmpadjustment.AddrHigh = defline.section(';', 3, 3).toUInt(&ok, 16);
-		if (!ok || (tmpadjustment.AddrHigh < 1))
-			tmpadjustment.AddrHigh = 0;
-		tmpadjustment.title = defline.section(';', 4, 4);
-		if (!tmpadjustment.title.length())
-			continue;
-		tmpadjustment.unit = defline.section(';', 5, 5);	// may be empty
-		tmphelpstr = defline.section(';', 6, 6);
-		tmpadjustment.rawMin = tmphelpstr.toUInt(&ok, 10);
-		if (!ok)
-			continue;
-		tmphelpstr = defline.section(';', 7, 7);
-		tmpadjustment.rawMax = tmphelpstr.toUInt(&ok, 10);
-		if (!ok)
-			continue;
-		tmphelpstr = defline.section(';', 8, 8);
-		tmpadjustment.rawDefault = tmphelpstr.toUInt(&ok, 10);
-		if (!ok)
-			continue;
-		tmpadjustment.formula = defline.section(';', 9, 9);
-		if (!tmpadjustment.formula.length())
-			continue;
-		tmphelpstr = defline.section(';', 10, 10);
-		if (tmphelpstr.length() == 0)
-			tmphelpstr = "0";
-		tmpadjustment.precision = tmphelpstr.toInt(&ok, 10);
-		if (ok && (tmpadjustment.precision<=10) && (tmpadjustment.precision>=-10))
-			adjustments->push_back(tmpadjustment);
+		tmpadjustment.AddrLow = def.addrLow;
+		tmpadjustment.AddrHigh = def.addrHigh;
+		tmpadjustment.title = texts.at(3*k);
+		tmpadjustment.unit = texts.at(3*k+1);	// may be empty
+		tmpadjustment.rawMin = def.rawMin;
+		tmpadjustment.rawMax = def.rawMax;
+		tmpadjustment.rawDefault = def.rawDefault;
+		tmpadjustment.formula = texts.at(3*k+2);
+		tmpadjustment.precision = def.precision;
+		adjustments->push_back(tmpadjustment);
 	}
 	return true;
 }
@@ -458,56 +311,27 @@ bool SSM2definitionsInterface::adjustments(std::vector<adjustment_intl_dt> *adju
 bool SSM2definitionsInterface::actuatorTests(std::vector<actuator_dt> *actuators)
 {
 	bool ATsup = false;
-	QString tmpstr = "";
-	unsigned int tmpflagbyte = 0;
-	unsigned int tmpflagbit = 0;
 	actuator_dt tmpactuator;
-	unsigned char tmpbitadr = 0;
-	bool ok = false;
-	int k = 0;
-	QStringList actuatorsrawdata;
 
 	if (!hasActuatorTests( &ATsup ))
 		return false;
 	actuators->clear();
 	if (!ATsup)
 		return true;
-	if (_language == "de")
-	{
-		SSMprotocol2_def_de rawdefs_de;
-		actuatorsrawdata = rawdefs_de.ActuatorRawDefs();
-	}
-	else
+	const std::vector<SSM2actuatorDef_dt> & defs = SSM2definitionTables::tables()->actuators;
+	const std::vector<QString> & texts = SSM2definitionTables::texts(_language)->actuators;
+	for (unsigned int k=0; k<defs.size(); k++)
 	{
-		SSMprotocol2_def_en rawdefs_en;
-		actuatorsrawdata = rawdefs_en.ActuatorRawDefs();
-	}
-	for (k=0; k<actuatorsrawdata.size(); k++)
-	{
-		tmpstr = actuatorsrawdata.at(k).section(';', 0, 0);
-		if (!tmpstr.size())
-			continue;
-		tmpflagbyte = tmpstr.toUInt();
-		if ((tmpflagbyte < 1) || (tmpflagbyte > _nrofflagbytes))
-			continue;
-		tmpstr = actuatorsrawdata.at(k).section(';', 1, 1);
-		if (!tmpstr.size())
-			continue;
-		tmpflagbit = tmpstr.toUInt();
-		if ((tmpflagbit < 1) || (tmpflagbit > 8))
+		const SSM2actuatorDef_dt & def = defs.at(k);
+		if (!def.valid || (def.flagbyte > _nrofflagbytes))
 			continue;
-		if (!(_flagbytes[tmpflagbyte-1] & static_cast<unsigned char>(pow(2, tmpflagbit-1))))
+		if (!(_flagbytes[def.flagbyte-1] & def.flagmask))
 			continue;
-		tmpactuator.byteadr = actuatorsrawdata.at(k).section(';', 2, 2).toUInt(&ok, 16);
-		if (!ok || (tmpactuator.byteadr == 0))
+		if (texts.at(k).isEmpty())
 			continue;
-		tmpbitadr = actuatorsrawdata.at(k).section(';', 3, 3).toUInt();
-		if ((tmpbitadr < 1) || (tmpbitadr > 8))
-			continue;
-		tmpactuator.title = actuatorsrawdata.at(k).section(';', 4, 4);
-		if (!tmpactuator.title.length())
-			continue;
-		tmpactuator.bitadr = tmpbitadr;
+		tmpactuator.byteadr = def.byteAddr;
+		tmpactuator.bitadr = def.bitAddr;
+		tmpactuator.title = texts.at(k);
 		actuators->push_back( tmpactuator );
 	}
 	return true;
@@ -675,14 +499,9 @@ bool SSM2definitionsInterface::hasSWignition(bool *IgnSWsup)
 
 // PRIVATE:
 
-void SSM2definitionsInterface::addDCdefs(unsigned int currOrTempOrLatestDCsAddr, unsigned int histOrMemDCsAddr, QStringList rawDefs, std::vector<dc_defs_dt> * defs)
+void SSM2definitionsInterface::addDCdefs(unsigned int currOrTempOrLatestDCsAddr, unsigned int histOrMemDCsAddr, const SSM2DCtable_dt & table, const std::vector<QString> & texts, std::vector<dc_defs_dt> * defs)
 {
 	dc_defs_dt tmpdef;
-	QStringList tmpdefparts;
-	unsigned int tmpdtcaddr_1 = 0;
-	unsigned int tmpdtcaddr_2 = 0;
-	unsigned int tmpbitaddr = 0;
-	bool ok = false;
 
 	tmpdef.byteAddr_currentOrTempOrLatest = currOrTempOrLatestDCsAddr;
 	tmpdef.byteAddr_historicOrMemorized = histOrMemDCsAddr;
@@ -691,19 +510,15 @@ void SSM2definitionsInterface::addDCdefs(unsigned int currOrTempOrLatestDCsAddr,
 		tmpdef.code[k] = "???";
 		tmpdef.title[k] = "     ???     (0x" + QString::number(currOrTempOrLatestDCsAddr,16).toUpper() + "/0x" + QString::number(histOrMemDCsAddr,16).toUpper() + " Bit " + QString::number(k+1) + ")";
 	}
-	for (int m=0; m<rawDefs.size(); m++)
+	// Get the definitions for this address pair:
+	QHash<quint64, std::vector<unsigned int> >::const_iterator it = table.index.find( SSM2definitionTables::DCindexKey(currOrTempOrLatestDCsAddr, histOrMemDCsAddr) );
+	if (it != table.index.end())
 	{
-		tmpdefparts = rawDefs.at(m).split(';');
-		if (tmpdefparts.size() == 5)
+		for (unsigned int m=0; m<it.value().size(); m++)
 		{
-			tmpdtcaddr_1 = tmpdefparts.at(0).toUInt(&ok, 16);  // current/temporary/latest/D-Check DCs memory address
-			tmpdtcaddr_2 = tmpdefparts.at(1).toUInt(&ok, 16);  // historic/memorized DCs memory address
-			if ((ok) && (tmpdtcaddr_1 == currOrTempOrLatestDCsAddr) && (tmpdtcaddr_2 == histOrMemDCsAddr))
-			{
-				tmpbitaddr = tmpdefparts.at(2).toUInt(); // flagbit
-				tmpdef.code[ tmpbitaddr-1 ] = tmpdefparts.at(3);
-				tmpdef.title[ tmpbitaddr-1 ] = tmpdefparts.at(4);
-			}
+			unsigned int d = it.value().at(m);
+			tmpdef.code[ table.defs.at(d).bit-1 ] = texts.at(2*d);
+			tmpdef.title[ table.defs.at(d).bit-1 ] = texts.at(2*d+1);
 		}
 	}
 	defs->push_back(tmpdef);
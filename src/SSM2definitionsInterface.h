@@ -28,6 +28,7 @@
 #include "SSMprotocol2_ID.h"
 #include "SSMprotocol2_def_en.h"
 #include "SSMprotocol2_def_de.h"
+#include "SSM2definitionTables.h"
 
 
 
@@ -70,7 +71,7 @@ private:
 	char _flagbytes[96];
 	unsigned char _nrofflagbytes;
 
-	void addDCdefs(unsigned int currOrTempOrLatestDCsAddr, unsigned int histOrMemDCsAddr, QStringList rawDefs, std::vector<dc_defs_dt> * defs);
+	void addDCdefs(unsigned int currOrTempOrLatestDCsAddr, unsigned int histOrMemDCsAddr, const SSM2DCtable_dt & table, const std::vector<QString> & texts, std::vector<dc_defs_dt> * defs);
 
 };
 
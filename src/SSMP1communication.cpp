@@ -24,6 +24,7 @@ SSMP1communication::SSMP1communication(AbstractDiagInterface *diagInterface, SSM
 {
 	_cu = cu;
 	_errRetries = errRetries;
+	_readTimeout = SSMP1_T_RW_REC_MAX;
 	_CommOperation = comOp_noCom;
 	_delay = 0;
 	_result = false;
@@ -49,6 +50,14 @@ void SSMP1communication::setRetriesOnError(unsigned char retries)
 }
 
 
+bool SSMP1communication::setReadTimeout(unsigned int timeout_ms)
+{
+	if (_CommOperation != comOp_noCom) return false;
+	_readTimeout = timeout_ms;
+	return true;
+}
+
+
 SSMP1communication::comOp_dt SSMP1communication::getCurrentCommOperation()
 {
 	return _CommOperation;
@@ -244,6 +253,7 @@ void SSMP1communication::run()
 	unsigned char errmax = 3;
 	char errcount = 0;
 	int delay = 0;
+	unsigned int readTimeout = SSMP1_T_RW_REC_MAX;
 
 	// Synchronise with main-thread:
 	_mutex.lock();
@@ -254,6 +264,7 @@ void SSMP1communication::run()
 	data = _data;
 	errmax = _errRetries + 1;
 	delay = _delay;
+	readTimeout = _readTimeout;
 	_result = false;
 	_abort = false;
 	_mutex.unlock();
@@ -320,7 +331,7 @@ void SSMP1communication::run()
 			{
 				// Read next data:
 				if (k==0) data.clear();
-				op_success = getNextData(&data);
+				op_success = getNextData(&data, readTimeout);
 #ifdef __FSSM_DEBUG__
 				if (!op_success)
 					std::cout << "SSMP1communication::run():   getNextData(...) failed !\n";
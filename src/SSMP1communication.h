@@ -38,6 +38,7 @@ public:
 	~SSMP1communication();
 	void selectCU(SSM1_CUtype_dt cu);
 	void setRetriesOnError(unsigned char retries);
+	bool setReadTimeout(unsigned int timeout_ms = SSMP1_T_RW_REC_MAX);
 	comOp_dt getCurrentCommOperation();
 	bool getCUdata(unsigned char extradatareqlen, char *ID, char *extradata, unsigned char *extradatalen);
 	bool readAddress(unsigned int addr, char * databyte);
@@ -53,6 +54,7 @@ public:
 private:
 	SSM1_CUtype_dt _cu;
 	unsigned char _errRetries;
+	unsigned int _readTimeout;	// [ms]
 	comOp_dt _CommOperation;
 	QMutex _mutex;
 	QEventLoop _el;
@@ -28,11 +28,15 @@ SSMP2communication::SSMP2communication(AbstractDiagInterface *diagInterface, uns
 	unsigned int k = 0;
 	_CommOperation = comOp_noCom;
 	_result = false;
+	_rejected = false;
 	_abort = false;
+	_newWriteData = false;
 	_errRetries = errRetries;
 	_padaddr = 0;
 	for (k=0; k<SSMP2COM_BUFFER_SIZE; k++) _dataaddr[k] = 0;
 	_datalen = 0;
+	_secDatalen = 0;
+	_secDivisor = 1;
 	for (k=0; k<SSMP2COM_BUFFER_SIZE; k++) _rec_buf[k] = 0;
 	for (k=0; k<SSMP2COM_BUFFER_SIZE; k++) _snd_buf[k] = 0;
 	_delay = 0;
@@ -62,6 +66,19 @@ void SSMP2communication::setRetriesOnError(unsigned char retries)
 
 
 
+bool SSMP2communication::setReadTimeout(unsigned int timeout_ms)
+{
+	/* NOTE: the timeout must also cover the transfer time of the reply message,
+	 *       so it should be only reduced for requests with short replies !  */
+	if (_CommOperation != comOp_noCom) return false;
+	if (timeout_ms < SSM2_MIN_READ_TIMEOUT)
+		timeout_ms = SSM2_MIN_READ_TIMEOUT;
+	_readTimeout = timeout_ms;
+	return true;
+}
+
+
+
 bool SSMP2communication::getCUdata(char *SYS_ID, char *ROM_ID, char *flagbytes, unsigned char *nrofflagbytes)
 {
 	bool ok = false;
@@ -103,7 +120,7 @@ bool SSMP2communication::readDataBlock(char padaddr, unsigned int dataaddr, unsi
 	{
 		return false;
 	}
-	else
+	else if (nrofbytes > SSMP2COM_BUFFER_SIZE) // limited by buffer sizes
 	{
 		return false;
 	}
@@ -244,7 +261,7 @@ bool SSMP2communication::readDataBlock_permanent(char padaddr, unsigned int data
 	{
 		return false;
 	}
-	else
+	else if (nrofbytes > SSMP2COM_BUFFER_SIZE) // limited by buffer sizes
 	{
 		return false;
 	}
@@ -265,14 +282,26 @@ bool SSMP2communication::readDataBlock_permanent(char padaddr, unsigned int data
 
 bool SSMP2communication::readMultipleDatabytes_permanent(char padaddr, unsigned int dataaddr[SSMP2COM_BUFFER_SIZE], unsigned int datalen, int delay)
 {
+	return readMultipleDatabytes_permanent(padaddr, dataaddr, datalen, NULL, 0, 1, delay);
+}
+
+
+bool SSMP2communication::readMultipleDatabytes_permanent(char padaddr, unsigned int dataaddr[SSMP2COM_BUFFER_SIZE], unsigned int datalen,
+							 unsigned int secdataaddr[SSMP2COM_BUFFER_SIZE], unsigned int secdatalen, unsigned int secdivisor, int delay)
+{
+	/* NOTE: the secondary addresses are appended to the primary addresses in every secdivisor-th
+	 *       read cycle. Their data is emitted separately with recievedSecondaryData().          */
 	unsigned int k = 0;
-	if (datalen > SSMP2COM_BUFFER_SIZE) return false; // limited by buffer sizes
+	if ((datalen < 1) || (datalen + secdatalen > SSMP2COM_BUFFER_SIZE)) return false; // limited by buffer sizes
 	if ((_CommOperation != comOp_noCom) || (_cuaddress == 0) || isRunning()) return false;
 	_CommOperation = comOp_readMulti_p;
 	// Prepare buffers:
 	_padaddr = padaddr;
 	for (k=0; k<datalen; k++) _dataaddr[k] = dataaddr[k];
+	for (k=0; k<secdatalen; k++) _dataaddr[datalen+k] = secdataaddr[k];
 	_datalen = datalen;
+	_secDatalen = secdatalen;
+	_secDivisor = (secdivisor > 0) ? secdivisor : 1;
 	_delay = delay;
 	// Start permanent reading:
 	start();
@@ -323,12 +352,43 @@ bool SSMP2communication::writeDatabyte_permanent(unsigned int dataaddr, char dat
 
 
 
+bool SSMP2communication::setPermanentWriteData(char *data, unsigned int datalen)
+{
+	// NOTE: replaces the data of the running permanent write operation, takes effect with the next write cycle
+	unsigned int k = 0;
+	if (((_CommOperation != comOp_writeBlock_p) && (_CommOperation != comOp_writeSingle_p)) || !isRunning())
+		return false;
+	_mutex.lock();
+	if (datalen != _datalen)
+	{
+		_mutex.unlock();
+		return false;
+	}
+	for (k=0; k<datalen; k++) _snd_buf[k] = data[k];
+	_newWriteData = true;
+	_mutex.unlock();
+	return true;
+}
+
+
+
 SSMP2communication::comOp_dt SSMP2communication::getCurrentCommOperation()
 {
 	return _CommOperation;
 }
 
 
+bool SSMP2communication::lastRequestRejected()
+{
+	// NOTE: true if the last (failed) single operation has been answered with a negative/invalid reply
+	bool rejected = false;
+	_mutex.lock();
+	rejected = _rejected;
+	_mutex.unlock();
+	return rejected;
+}
+
+
 
 bool SSMP2communication::stopCommunication()
 {
@@ -375,6 +435,7 @@ void SSMP2communication::run()
 {
 	std::vector<char> rawdata;
 	QTime timer;
+	QTime sectimer;
 	int duration_ms = 0;
 	unsigned int k = 1;
 	unsigned int rindex = 1;
@@ -387,6 +448,10 @@ void SSMP2communication::run()
 	unsigned int cuaddress;
 	char padaddr = '\x0';
 	unsigned char datalen = 0;
+	unsigned int secdatalen = 0;
+	unsigned int secdivisor = 1;
+	unsigned int readlen = 0;
+	unsigned int cycle = 0;
 	unsigned int dataaddr[SSMP2COM_BUFFER_SIZE] = {0};
 	char snd_buf[SSMP2COM_BUFFER_SIZE] = {'\x0'};
 	char rec_buf[SSMP2COM_BUFFER_SIZE] = {'\x0'};
@@ -400,12 +465,16 @@ void SSMP2communication::run()
 	cuaddress = _cuaddress;
 	padaddr = _padaddr;
 	datalen = _datalen;
-	for (k=0; k<datalen; k++) dataaddr[k] = _dataaddr[k];
+	secdatalen = (_CommOperation == comOp_readMulti_p) ? _secDatalen : 0;
+	secdivisor = _secDivisor;
+	for (k=0; k<(datalen+secdatalen); k++) dataaddr[k] = _dataaddr[k];
 	for (k=0; k<datalen; k++) snd_buf[k] = _snd_buf[k];
 	delay = _delay;
 	errmax = _errRetries + 1;
 	_result = false;
+	_rejected = false;
 	_abort = false;
+	_newWriteData = false;
 	_mutex.unlock();
 #ifdef __FSSM_DEBUG__
 	// Debug-output:
@@ -452,10 +521,18 @@ void SSMP2communication::run()
 	{
 		permanent = true;
 		timer.start();
+		sectimer.start();
 	}
 	// COMMUNICATION:
 	do
 	{
+		// Include secondary addresses in every secdivisor-th read cycle:
+		if (rindex == 1)
+		{
+			readlen = datalen;
+			if (secdatalen && ((cycle % secdivisor) == 0))
+				readlen += secdatalen;
+		}
 		// Call SSMP-core-function:
 		switch (operation)
 		{
@@ -470,10 +547,10 @@ void SSMP2communication::run()
 			case comOp_readMulti:
 			case comOp_readMulti_p:// ReadMultipleDatabytes_permanent(...)
 				// CALCULATE NR OF ADDRESSES FOR NEXT READ:
-				if (max_bytes_per_multiread*(rindex) <= datalen)
+				if (max_bytes_per_multiread*(rindex) <= readlen)
 					nrofReadAddr = max_bytes_per_multiread;
 				else
-					nrofReadAddr = datalen % max_bytes_per_multiread;
+					nrofReadAddr = readlen % max_bytes_per_multiread;
 				// READ NEXT ADDRESSES:
 				op_success = ReadMultipleDatabytes(cuaddress, padaddr, dataaddr+((rindex-1)*max_bytes_per_multiread), nrofReadAddr, rec_buf+((rindex-1)*max_bytes_per_multiread));
 				break;
@@ -495,7 +572,7 @@ void SSMP2communication::run()
 			if (errcount > 0)
 				errcount--;
 			// Set query-index:
-			if ( ((operation == comOp_readMulti) || (operation == comOp_readMulti_p)) && (rindex < static_cast<unsigned int>(((datalen-1)/max_bytes_per_multiread)+1)) )
+			if ( ((operation == comOp_readMulti) || (operation == comOp_readMulti_p)) && (rindex < static_cast<unsigned int>(((readlen-1)/max_bytes_per_multiread)+1)) )
 				rindex++;
 			else
 				rindex=1;
@@ -508,6 +585,12 @@ void SSMP2communication::run()
 				duration_ms = timer.restart();
 				// SEND DATA TO MAIN THREAD:
 				emit recievedData(rawdata, duration_ms);
+				if (readlen > datalen)
+				{
+					rawdata = std::vector<char>(rec_buf+datalen, rec_buf+readlen);
+					emit recievedSecondaryData(rawdata, sectimer.restart());
+				}
+				cycle++;
 				// Wait for the desired delay time:
 				if (delay > 0) msleep(delay);
 			}
@@ -519,9 +602,14 @@ void SSMP2communication::run()
 			std::cout << "SSMP2communication::run():   communication operation error counter=" << (int)(errcount) << '\n';
 #endif
 		}
-		// GET ABORT STATUS::
+		// GET ABORT STATUS AND NEW WRITE DATA:
 		_mutex.lock();
 		abort = _abort;
+		if (_newWriteData)
+		{
+			for (k=0; k<datalen; k++) snd_buf[k] = _snd_buf[k];
+			_newWriteData = false;
+		}
 		_mutex.unlock();
 	} while (!abort && (errcount < errmax) && (permanent || (rindex > 1) || !op_success));
 	// Send error signal:
@@ -535,6 +623,7 @@ void SSMP2communication::run()
 		for (k=0; k<datalen; k++) _rec_buf[k] = rec_buf[k];
 		_result = op_success;
 	}
+	_rejected = (!op_success && _invalidReply);
 	_abort = false;
 	_mutex.unlock();
 	if (!permanent)
@@ -42,6 +42,7 @@ public:
 	~SSMP2communication();
 	void setCUaddress(unsigned int cuaddress);
 	void setRetriesOnError(unsigned char retries);
+	bool setReadTimeout(unsigned int timeout_ms = SSM2_READ_TIMEOUT);
 
 	bool getCUdata(char *SYS_ID, char *ROM_ID, char *flagbytes, unsigned char *nrofflagbytes);
 	bool readDataBlock(char padaddr, unsigned int dataaddr, unsigned int nrofbytes, char *data);
@@ -51,10 +52,14 @@ public:
 
 	bool readDataBlock_permanent(char padaddr, unsigned int dataaddr, unsigned int nrofbytes, int delay=0);
 	bool readMultipleDatabytes_permanent(char padaddr, unsigned int dataaddr[SSMP2COM_BUFFER_SIZE], unsigned int datalen, int delay=0);
+	bool readMultipleDatabytes_permanent(char padaddr, unsigned int dataaddr[SSMP2COM_BUFFER_SIZE], unsigned int datalen,
+					     unsigned int secdataaddr[SSMP2COM_BUFFER_SIZE], unsigned int secdatalen, unsigned int secdivisor, int delay=0);
 	bool writeDataBlock_permanent(unsigned int dataaddr, char *data, unsigned int datalen, int delay=0);
 	bool writeDatabyte_permanent(unsigned int dataaddr, char databyte, int delay=0);
+	bool setPermanentWriteData(char *data, unsigned int datalen);
 
 	comOp_dt getCurrentCommOperation();
+	bool lastRequestRejected();
 
 	bool stopCommunication();
 
@@ -64,12 +69,16 @@ private:
 	QMutex _mutex;
 	QEventLoop _el;
 	bool _result;
+	bool _rejected;
 	bool _abort;
+	bool _newWriteData;
 	unsigned char _errRetries;
 	// Buffers for sending/recieving data:
 	char _padaddr;
 	unsigned int _dataaddr[SSMP2COM_BUFFER_SIZE];
 	unsigned int _datalen;
+	unsigned int _secDatalen;
+	unsigned int _secDivisor;
 	char _snd_buf[SSMP2COM_BUFFER_SIZE];
 	char _rec_buf[SSMP2COM_BUFFER_SIZE];
 	int _delay;
@@ -79,6 +88,7 @@ private:
 
 signals:
 	void recievedData(std::vector<char> rawdata, int duration_ms);
+	void recievedSecondaryData(std::vector<char> rawdata, int duration_ms);
 
 	void commError();
 
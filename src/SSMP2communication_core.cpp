@@ -24,6 +24,8 @@
 SSMP2communication_core::SSMP2communication_core(AbstractDiagInterface *diagInterface)
 {
 	_diagInterface = diagInterface;
+	_readTimeout = SSM2_READ_TIMEOUT;
+	_invalidReply = false;
 }
 
 
@@ -40,10 +42,6 @@ bool SSMP2communication_core::ReadDataBlock(unsigned int ecuaddr, char padaddr,
 	{
 		return false;
 	}
-	else
-	{
-		return false;
-	}
 
 	char indata[255] = {0,};
 	unsigned char indatalen = 0;
@@ -70,6 +68,8 @@ bool SSMP2communication_core::ReadDataBlock(unsigned int ecuaddr, char padaddr,
 				return true;
 			}
 		}
+		// Negative or invalid reply:
+		_invalidReply = true;
 	}
 	return false;
 }
@@ -261,6 +261,7 @@ bool SSMP2communication_core::GetCUdata(unsigned int ecuaddr, char *SYS_ID, char
 
 bool SSMP2communication_core::SndRcvMessage(unsigned int ecuaddr, char *outdata, unsigned char outdatalen, char *indata, unsigned char *indatalen)
 {
+	_invalidReply = false;
 	if (_diagInterface == NULL) return false;
 	if (outdatalen < 1) return false;
 	std::vector<char> msg_buffer;
@@ -358,7 +359,7 @@ bool SSMP2communication_core::receiveReplyISO14230(unsigned int ecuaddr, unsigne
 	msg_buffer->clear();
 	timer.start();
 	// WAIT FOR HEADER OF ANSWER OR ECHO:
-	if (!readFromInterface(4, SSM2_READ_TIMEOUT, msg_buffer))
+	if (!readFromInterface(4, _readTimeout, msg_buffer))
 		return false;
 	// CHECK HEADER OF THE MESSAGE AND DETECT ECHO
 	if ((msg_buffer->at(0) == '\x80') && (static_cast<unsigned char>(msg_buffer->at(1)) == ecuaddr) && (msg_buffer->at(2) == '\xF0') && (static_cast<unsigned char>(msg_buffer->at(3)) == (outmsg_len - 4 - 1)))
@@ -383,7 +384,7 @@ bool SSMP2communication_core::receiveReplyISO14230(unsigned int ecuaddr, unsigne
 	min_bytes_to_read = msglen - msg_buffer->size() + echo*4; // NOTE: can be < 0 !
 	if (min_bytes_to_read > 0)
 	{
-		if (!readFromInterface(min_bytes_to_read, SSM2_READ_TIMEOUT - timer.elapsed(), &read_buffer))
+		if (!readFromInterface(min_bytes_to_read, _readTimeout - timer.elapsed(), &read_buffer))
 			return false;
 		msg_buffer->insert(msg_buffer->end(), read_buffer.begin(), read_buffer.end());
 	}
@@ -422,7 +423,7 @@ bool SSMP2communication_core::receiveReplyISO14230(unsigned int ecuaddr, unsigne
 	{
 		// WAIT FOR REST OF THE INCOMING MESSAGE:
 		min_bytes_to_read = msglen - msg_buffer->size();
-		if (!readFromInterface(min_bytes_to_read, SSM2_READ_TIMEOUT - timer.elapsed(), &read_buffer)) // Timeout: 260-4=256Bytes=533.3ms => 540ms
+		if (!readFromInterface(min_bytes_to_read, _readTimeout - timer.elapsed(), &read_buffer)) // Timeout: 260-4=256Bytes=533.3ms => 540ms
 			return false;
 		msg_buffer->insert(msg_buffer->end(), read_buffer.begin(), read_buffer.end());
 	}
@@ -449,7 +450,7 @@ bool SSMP2communication_core::receiveReplyISO15765(unsigned int ecuaddr, std::ve
 {
 	msg_buffer->clear();
 	// READ MESSAGE
-	if (!readFromInterface(5, SSM2_READ_TIMEOUT, msg_buffer)) // NOTE: we always get complete messages from the interfaces (as long as minbytes is > 0) !
+	if (!readFromInterface(5, _readTimeout, msg_buffer)) // NOTE: we always get complete messages from the interfaces (as long as minbytes is > 0) !
 		return false;
 	// CHECK CAN-IDENTIFIER (IF POSSIBLE)
 	if (ecuaddr == (ecuaddr & 0x7EF)) // ISO15765-4 11 bit CAN IDs for physical addressing
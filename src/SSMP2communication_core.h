@@ -40,6 +40,7 @@
 
 
 #define SSM2_READ_TIMEOUT	2000 // [ms]
+#define SSM2_MIN_READ_TIMEOUT	100  // [ms]
 
 
 
@@ -57,6 +58,9 @@ public:
 
 protected:
 	AbstractDiagInterface *_diagInterface;
+	unsigned int _readTimeout;	// [ms]
+	bool _invalidReply;		// reply to the last request received, but negative/invalid
+	bool _invalidReply;		// reply to the last request received, but negative/invalid
 
 private:
 	bool SndRcvMessage(unsigned int ecuaddr, char *outdata, unsigned char outdatalen, char *indata, unsigned char *indatalen);
@@ -18,6 +18,128 @@
  */
 
 #include "SSMprotocol.h"
+#include "CUsetupCache.h"
+
+
+
+DCevaluator::DCevaluator()
+{
+	_hasPreviousData = false;
+}
+
+
+void DCevaluator::setup(const std::vector<dc_defs_dt> & DCdefs, bool historicOrMemorized, bool skipMissingAddresses)
+{
+	_slots.clear();
+	for (unsigned int k=0; k<DCdefs.size(); k++)
+	{
+		const dc_defs_dt & def = DCdefs.at(k);
+		unsigned int address = historicOrMemorized ? def.byteAddr_historicOrMemorized : def.byteAddr_currentOrTempOrLatest;
+		if (skipMissingAddresses && (address == MEMORY_ADDRESS_NONE))
+			continue;
+		slot_dt slot;
+		slot.usedBitsMask = 0;
+		for (unsigned char flagbit=0; flagbit<8; flagbit++)
+		{
+			// NOTE: DCs with existing definition and empty code- and title-fields must be ignored !
+			if (!(def.code[flagbit].isEmpty() && def.title[flagbit].isEmpty()))
+				slot.usedBitsMask |= static_cast<char>(1 << flagbit);
+			slot.code[flagbit] = def.code[flagbit];
+			slot.title[flagbit] = def.title[flagbit];
+		}
+		_slots.push_back(slot);
+	}
+	reset();
+}
+
+
+void DCevaluator::reset()
+{
+	_lastRawBytes.assign(_slots.size(), 0);
+	_hasPreviousData = false;
+	_DCs.clear();
+	_DCdescriptions.clear();
+}
+
+
+unsigned int DCevaluator::nrOfBytes() const
+{
+	return _slots.size();
+}
+
+
+bool DCevaluator::hasPreviousData() const
+{
+	return _hasPreviousData;
+}
+
+
+bool DCevaluator::evaluate(const char *rawdata, QStringList *setDCs, QStringList *setDCdescriptions, QStringList *clearedDCs, QStringList *clearedDCdescriptions)
+{
+	bool changed = !_hasPreviousData;
+	setDCs->clear();
+	setDCdescriptions->clear();
+	clearedDCs->clear();
+	clearedDCdescriptions->clear();
+	for (unsigned int k=0; k<_slots.size(); k++)
+	{
+		const slot_dt & slot = _slots.at(k);
+		char changedBits = (rawdata[k] ^ _lastRawBytes.at(k)) & slot.usedBitsMask;
+		if (!changedBits)
+			continue;
+		for (unsigned char flagbit=0; flagbit<8; flagbit++)
+		{
+			char bitmask = static_cast<char>(1 << flagbit);
+			if (!(changedBits & bitmask))
+				continue;
+			if (rawdata[k] & bitmask)
+			{
+				setDCs->push_back( slot.code[flagbit] );
+				setDCdescriptions->push_back( slot.title[flagbit] );
+			}
+			else
+			{
+				clearedDCs->push_back( slot.code[flagbit] );
+				clearedDCdescriptions->push_back( slot.title[flagbit] );
+			}
+		}
+		_lastRawBytes.at(k) = rawdata[k];
+		changed = true;
+	}
+	_hasPreviousData = true;
+	if (!changed)
+		return false;
+	// Rebuild the lists of all active DCs (ordered by byte and bit):
+	_DCs.clear();
+	_DCdescriptions.clear();
+	for (unsigned int k=0; k<_slots.size(); k++)
+	{
+		char activeBits = _lastRawBytes.at(k) & _slots.at(k).usedBitsMask;
+		if (!activeBits)
+			continue;
+		for (unsigned char flagbit=0; flagbit<8; flagbit++)
+		{
+			if (activeBits & static_cast<char>(1 << flagbit))
+			{
+				_DCs.push_back( _slots.at(k).code[flagbit] );
+				_DCdescriptions.push_back( _slots.at(k).title[flagbit] );
+			}
+		}
+	}
+	return true;
+}
+
+
+QStringList DCevaluator::DCs() const
+{
+	return _DCs;
+}
+
+
+QStringList DCevaluator::DCdescriptions() const
+{
+	return _DCdescriptions;
+}
 
 
 
@@ -27,6 +149,18 @@ SSMprotocol::SSMprotocol(AbstractDiagInterface *diagInterface, QString language)
 	_language = language;
 	_CU = CUtype_Engine;
 	_state = state_needSetup;
+	_interruptedState = state_normal;
+	_MBSWlogWriter = NULL;
+	_MBSWlogTime_ms = 0;
+	_MBSWreplay = NULL;
+	_MBSWdataSource = NULL;
+	_MBSWtriggerLogger = NULL;
+	_MBSWhistoryTime_ms = 0;
+	// NOTE: the history is allocated once, setupMBSWQueryAddrList() only adjusts the frame size
+	_MBSWhistory.setup(MBSW_HISTORY_SIZE, 0);
+	_DTCsnapshotHistory_ms = 10000;
+	_lastTestMode = false;
+	_lastDCheckActive = false;
 	resetCommonCUdata();
 	qRegisterMetaType< std::vector<char> >("std::vector<char>");
 }
@@ -34,6 +168,9 @@ SSMprotocol::SSMprotocol(AbstractDiagInterface *diagInterface, QString language)
 
 SSMprotocol::~SSMprotocol()
 {
+	deleteMBSWreplay();
+	stopMBSWrecording();
+	setMBSWdataSource(NULL);
 }
 
 
@@ -234,6 +371,22 @@ bool SSMprotocol::restartMBSWreading()
 }
 
 
+bool SSMprotocol::setCombinedDCreading(int DCgroups, unsigned int divisor)
+{
+	// NOTE: not supported by default
+	(void)divisor; // to avoid compiler error
+	if (DCgroups != noDCs_DCgroup) return false;
+	_combinedDCgroups = noDCs_DCgroup;
+	return true;
+}
+
+
+int SSMprotocol::combinedDCgroups()
+{
+	return _combinedDCgroups;
+}
+
+
 bool SSMprotocol::restartActuatorTest()
 {
 	return startActuatorTest(_selectedActuatorTestIndex);
@@ -243,34 +396,423 @@ bool SSMprotocol::restartActuatorTest()
 bool SSMprotocol::stopAllPermanentOperations()
 {
 	bool result = false;
-	if ((_state == state_needSetup) || (_state == state_normal))
+	state_dt state = (_state == state_resuming) ? _interruptedState : _state;
+	if ((state == state_needSetup) || (state == state_normal))
 	{
 		result = true;
 	}
-	else if (_state == state_DCreading)
+	else if (state == state_DCreading)
 	{
 		result = stopDCreading();
 	}
-	else if (_state == state_MBSWreading)
+	else if (state == state_MBSWreading)
 	{
 		result = stopMBSWreading();
 	}
-	else if (_state == state_ActTesting)
+	else if (state == state_ActTesting)
 	{
 		result = stopActuatorTesting();
 	}
 	return result;
 }
 
+
+bool SSMprotocol::waitForIgnitionOff(unsigned int window_ms)
+{
+	QEventLoop el;
+	connect( this, SIGNAL( ignitionOff() ), &el, SLOT( quit() ) );
+	if (!startIgnitionOffDetection(window_ms))
+	{
+		disconnect( this, SIGNAL( ignitionOff() ), &el, SLOT( quit() ) );
+		return false;
+	}
+	// NOTE: ignitionOff() is emitted from a slot, so it can not be missed before the event loop is running
+	el.exec();
+	disconnect( this, SIGNAL( ignitionOff() ), &el, SLOT( quit() ) );
+	return true;
+}
+
+
+bool SSMprotocol::startMBSWrecording(QString filename, std::vector<MBSWlogChannel_dt> derivedChannels)
+{
+	if ((_state != state_MBSWreading) || _MBSWlogWriter) return false;
+	// Setup channel descriptions for the log:
+	std::vector<MBSWlogChannel_dt> channels = MBSWlogChannels();
+	/* NOTE: derived channels are not read from the control unit (no data in the log),
+	 *       their expressions are saved to recalculate them from the recorded MBs */
+	channels.insert(channels.end(), derivedChannels.begin(), derivedChannels.end());
+	// Create log file:
+	_MBSWlogWriter = new MBSWlogFileWriter;
+	if (!_MBSWlogWriter->open(filename, _selMBsSWsAddr, channels))
+	{
+		delete _MBSWlogWriter;
+		_MBSWlogWriter = NULL;
+		return false;
+	}
+	_MBSWlogTime_ms = 0;
+	return true;
+}
+
+
+bool SSMprotocol::isRecordingMBSWs()
+{
+	return _MBSWlogWriter;
+}
+
+
+bool SSMprotocol::stopMBSWrecording()
+{
+	if (!_MBSWlogWriter) return true;
+	bool ok = _MBSWlogWriter->close();
+	delete _MBSWlogWriter;
+	_MBSWlogWriter = NULL;
+	return ok;
+}
+
+
+bool SSMprotocol::startMBSWreplay(QString filename, double speed)
+{
+	std::vector<MBSWmetadata_dt> MBSWmetaList;
+	if ((_state != state_normal) || _MBSWreplay) return false;
+	MBSWlogReplay *replay = new MBSWlogReplay;
+	if (!replay->open(filename))
+	{
+		delete replay;
+		return false;
+	}
+	// Assign the recorded channels to the MBs/SWs of the current control unit:
+	std::vector<MBSWlogChannel_dt> channels = replay->channels();
+	for (unsigned int k=0; k<channels.size(); k++)
+	{
+		MBSWmetadata_dt MBSWmetadata;
+		bool found = false;
+		if ((channels.at(k).blockType == 0) && (channels.at(k).addrLow == MEMORY_ADDRESS_NONE))
+			continue;	// derived MB (calculated from the recorded MBs)
+		MBSWmetadata.blockType = channels.at(k).blockType;
+		if (MBSWmetadata.blockType == 0)
+		{
+			for (unsigned int m=0; m<_supportedMBs.size(); m++)
+			{
+				if ((_supportedMBs.at(m).addr_low == channels.at(k).addrLow) && (_supportedMBs.at(m).addr_high == channels.at(k).addrHigh))
+				{
+					MBSWmetadata.nativeIndex = m;
+					found = true;
+					break;
+				}
+			}
+		}
+		else
+		{
+			for (unsigned int m=0; m<_supportedSWs.size(); m++)
+			{
+				if ((_supportedSWs.at(m).byteAddr == channels.at(k).addrLow) && (_supportedSWs.at(m).bitAddr == channels.at(k).addrHigh))
+				{
+					MBSWmetadata.nativeIndex = m;
+					found = true;
+					break;
+				}
+			}
+		}
+		if (!found)	// log has been recorded with a different control unit
+		{
+			delete replay;
+			return false;
+		}
+		MBSWmetaList.push_back(MBSWmetadata);
+	}
+	if (!setupMBSWQueryAddrList(MBSWmetaList) || !replay->setTargetQueryAddresses(_selMBsSWsAddr))
+	{
+		delete replay;
+		return false;
+	}
+	replay->setSpeed(speed);
+	// Save MB/SW-selection (necessary for evaluation of raw data):
+	_MBSWmetaList = MBSWmetaList;
+	// Connect signals/slots:
+	connect( replay, SIGNAL( recievedData(std::vector<char>, int) ),
+		 this, SLOT( processMBSWrawData(std::vector<char>, int) ), Qt::BlockingQueuedConnection );
+	connect( replay, SIGNAL( position(unsigned int) ), this, SIGNAL( MBSWreplayPosition(unsigned int) ) );
+	connect( replay, SIGNAL( endReached() ), this, SLOT( finishMBSWreplay() ) );
+	_MBSWreplay = replay;
+	if (!_MBSWreplay->startReplay())
+	{
+		deleteMBSWreplay();
+		return false;
+	}
+	setMBSWdataSource(_MBSWreplay);
+	_state = state_MBSWreading;
+	emit startedMBSWreading();
+	return true;
+}
+
+
+bool SSMprotocol::isReplayingMBSWs()
+{
+	return _MBSWreplay;
+}
+
+
+bool SSMprotocol::setMBSWreplaySpeed(double speed)
+{
+	if (!_MBSWreplay) return false;
+	_MBSWreplay->setSpeed(speed);
+	return true;
+}
+
+
+bool SSMprotocol::seekMBSWreplay(unsigned int time_ms)
+{
+	if (!_MBSWreplay) return false;
+	_MBSWreplay->seek(time_ms);
+	return true;
+}
+
+
+unsigned int SSMprotocol::MBSWreplayDuration()
+{
+	if (!_MBSWreplay) return 0;
+	return _MBSWreplay->duration_ms();
+}
+
+
+bool SSMprotocol::startMBSWtriggerLogging(QString filenamePrefix, QStringList triggerExpressions, unsigned int preTrigger_ms, unsigned int postTrigger_ms, unsigned int frameInterval_ms)
+{
+	if ((_state != state_MBSWreading) || !_MBSWdataSource) return false;
+	if (!_MBSWtriggerLogger)
+	{
+		// NOTE: trigger conditions are evaluated in the thread of the data source
+		_MBSWtriggerLogger = new MBSWtriggerLogger;
+		connect( _MBSWdataSource, SIGNAL( recievedData(std::vector<char>, int) ),
+			 _MBSWtriggerLogger, SLOT( processRawData(std::vector<char>, int) ), Qt::DirectConnection );
+		connect( _MBSWtriggerLogger, SIGNAL( triggered(QString) ), this, SIGNAL( MBSWtriggerLogWritten(QString) ) );
+	}
+	else if (_MBSWtriggerLogger->isActive())
+		return false;
+	return _MBSWtriggerLogger->setup(filenamePrefix, triggerExpressions, preTrigger_ms, postTrigger_ms, _selMBsSWsAddr, MBSWlogChannels(), frameInterval_ms);
+}
+
+
+bool SSMprotocol::isTriggerLoggingMBSWs()
+{
+	return (_MBSWtriggerLogger && _MBSWtriggerLogger->isActive());
+}
+
+
+void SSMprotocol::stopMBSWtriggerLogging()
+{
+	// NOTE: the logger is deleted when the data source stops (see setMBSWdataSource())
+	if (_MBSWtriggerLogger)
+		_MBSWtriggerLogger->deactivate();
+}
+
+
+void SSMprotocol::setDTCsnapshotHistory(unsigned int history_ms)
+{
+	_DTCsnapshotHistory_ms = history_ms;
+}
+
+
+void SSMprotocol::getDTCsnapshots(std::vector<DTCsnapshot_dt> *snapshots)
+{
+	*snapshots = _DTCsnapshots;
+}
+
+
+void SSMprotocol::clearDTCsnapshots()
+{
+	_DTCsnapshots.clear();
+}
+
+
+bool SSMprotocol::saveDTCsnapshot(unsigned int index, QString filename)
+{
+	if (index >= _DTCsnapshots.size()) return false;
+	const DTCsnapshot_dt & snapshot = _DTCsnapshots.at(index);
+	if (snapshot.frames.empty()) return false;
+	MBSWlogFileWriter writer;
+	if (!writer.open(filename, snapshot.queryAddresses, snapshot.channels))
+		return false;
+	bool ok = true;
+	for (unsigned int k=0; k<snapshot.frames.size(); k++)
+		ok &= writer.addFrame(snapshot.frames.at(k).time_ms, snapshot.frames.at(k).rawdata);
+	return (writer.close() && ok);
+}
+
 // PROTECTED / PRIVATE:
 
+bool SSMprotocol::stopMBSWreplay()
+{
+	if (!_MBSWreplay) return true;
+	if (!_MBSWreplay->stopReplay())
+		return false;
+	deleteMBSWreplay();
+	_state = state_normal;
+	emit stoppedMBSWreading();
+	return true;
+}
+
+
+void SSMprotocol::deleteMBSWreplay()
+{
+	if (!_MBSWreplay) return;
+	_MBSWreplay->stopReplay();
+	setMBSWdataSource(NULL);
+	disconnect( _MBSWreplay, SIGNAL( recievedData(std::vector<char>, int) ),
+		    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+	disconnect( _MBSWreplay, SIGNAL( position(unsigned int) ), this, SIGNAL( MBSWreplayPosition(unsigned int) ) );
+	disconnect( _MBSWreplay, SIGNAL( endReached() ), this, SLOT( finishMBSWreplay() ) );
+	delete _MBSWreplay;
+	_MBSWreplay = NULL;
+}
+
+
+std::vector<MBSWlogChannel_dt> SSMprotocol::MBSWlogChannels()
+{
+	std::vector<MBSWlogChannel_dt> channels;
+	for (unsigned int k=0; k<_MBSWmetaList.size(); k++)
+	{
+		MBSWlogChannel_dt channel;
+		channel.blockType = _MBSWmetaList.at(k).blockType;
+		if (channel.blockType == 0)
+		{
+			const mb_intl_dt & mb = _supportedMBs.at( _MBSWmetaList.at(k).nativeIndex );
+			channel.title = mb.title;
+			channel.unit = mb.unit;
+			channel.scaleformula = mb.scaleformula;
+			channel.precision = mb.precision;
+			channel.addrLow = mb.addr_low;
+			channel.addrHigh = mb.addr_high;
+		}
+		else
+		{
+			const sw_intl_dt & sw = _supportedSWs.at( _MBSWmetaList.at(k).nativeIndex );
+			channel.title = sw.title;
+			channel.unit = sw.unit;
+			channel.addrLow = sw.byteAddr;
+			channel.addrHigh = sw.bitAddr;
+		}
+		channels.push_back(channel);
+	}
+	return channels;
+}
+
+
+void SSMprotocol::setMBSWdataSource(QObject *source)
+{
+	// NOTE: must be called with NULL after the data source has been stopped
+	if (_MBSWtriggerLogger && !_MBSWdataSource && source)
+	{
+		// Resume after suspendMBSWdataSource(): keep the trigger logger
+		connect( source, SIGNAL( recievedData(std::vector<char>, int) ),
+			 _MBSWtriggerLogger, SLOT( processRawData(std::vector<char>, int) ), Qt::DirectConnection );
+	}
+	else if (_MBSWtriggerLogger && ((source != _MBSWdataSource) || !source))
+	{
+		if (_MBSWdataSource)
+			disconnect( _MBSWdataSource, SIGNAL( recievedData(std::vector<char>, int) ),
+				    _MBSWtriggerLogger, SLOT( processRawData(std::vector<char>, int) ) );
+		disconnect( _MBSWtriggerLogger, SIGNAL( triggered(QString) ), this, SIGNAL( MBSWtriggerLogWritten(QString) ) );
+		delete _MBSWtriggerLogger;	// writes pending captures
+		_MBSWtriggerLogger = NULL;
+	}
+	_MBSWdataSource = source;
+}
+
+
+void SSMprotocol::suspendMBSWdataSource()
+{
+	// NOTE: must be called before the data source is deleted; the trigger logger is kept until the next call of setMBSWdataSource()
+	if (_MBSWtriggerLogger && _MBSWdataSource)
+		disconnect( _MBSWdataSource, SIGNAL( recievedData(std::vector<char>, int) ),
+			    _MBSWtriggerLogger, SLOT( processRawData(std::vector<char>, int) ) );
+	_MBSWdataSource = NULL;
+}
+
+
+void SSMprotocol::markMBSWgap(unsigned int duration_ms)
+{
+	_MBSWhistoryTime_ms += duration_ms;
+	if (_MBSWlogWriter)
+	{
+		if (!_MBSWlogWriter->addGapMarker(_MBSWlogTime_ms))
+			stopMBSWrecording();	// write error
+		_MBSWlogTime_ms += duration_ms;
+	}
+}
+
+
+void SSMprotocol::setupDCevaluation()
+{
+	// NOTE: SSM1 control units may not provide all DC bytes
+	_currentOrTempDTCsEvaluator.setup(_DTCdefs, false, true);
+	_historicOrMemDTCsEvaluator.setup(_DTCdefs, true, true);
+	_lastTestMode = false;
+	_lastDCheckActive = false;
+}
+
+
+void SSMprotocol::captureDTCsnapshots(const QStringList & newDTCs, const QStringList & newDTCsDescriptions)
+{
+	for (int k=0; k<newDTCs.size(); k++)
+	{
+		DTCsnapshot_dt snapshot;
+		snapshot.DTC = newDTCs.at(k);
+		snapshot.description = newDTCsDescriptions.at(k);
+		snapshot.firstSeen = QDateTime::currentDateTime();
+		// Add MB/SW history (if it is up to date):
+		if (_MBSWhistory.size() && _MBSWhistoryLastFrame.isValid() && (_MBSWhistoryLastFrame.elapsed() < static_cast<qint64>(_DTCsnapshotHistory_ms)))
+		{
+			unsigned int from_ms = 0;
+			if (_MBSWhistoryTime_ms > _DTCsnapshotHistory_ms)
+				from_ms = _MBSWhistoryTime_ms - _DTCsnapshotHistory_ms;
+			snapshot.queryAddresses = _selMBsSWsAddr;
+			snapshot.channels = MBSWlogChannels();
+			_MBSWhistory.copyFrames(from_ms, &snapshot.frames);
+		}
+		if (_DTCsnapshots.size() >= MAX_DTC_SNAPSHOTS)
+			_DTCsnapshots.erase(_DTCsnapshots.begin());
+		_DTCsnapshots.push_back(snapshot);
+#ifdef __FSSM_DEBUG__
+		std::cout << "SSMprotocol::captureDTCsnapshots():   new DTC " << snapshot.DTC.toStdString() << ", " << snapshot.frames.size() << " MB/SW frames\n";
+#endif
+		emit capturedDTCsnapshot(snapshot.DTC);
+	}
+}
+
+
+void SSMprotocol::finishMBSWreplay()
+{
+	// NOTE: signal is queued, the replay may have been stopped in the meantime
+	if (_MBSWreplay && (sender() == _MBSWreplay))
+		stopMBSWreading();
+}
+
+
+void SSMprotocol::processIgnitionSwitchData(std::vector<char> rawdata, int duration_ms)
+{
+	(void)duration_ms; // to avoid compiler error
+	// Ignition switch: bit 3 of address 0x62
+	if (rawdata.size() && !(rawdata.at(0) & 0x08))
+		finishIgnitionOffDetection();
+}
+
+
+void SSMprotocol::finishIgnitionOffDetection()
+{
+	// NOTE: signals are queued, the detection may have been finished in the meantime
+	if (_state != state_waitingForIgnOff) return;
+	resetCUdata();
+	emit ignitionOff();
+}
+
+
 unsigned int SSMprotocol::processDTCsRawdata(std::vector<char> DCrawdata, int duration_ms)
 {
 	(void)duration_ms; // to avoid compiler error
-	QStringList DCs;
-	QStringList DCdescriptions;
-	QStringList tmpDTCs;
-	QStringList tmpDTCsDescriptions;
+	QStringList setDCs;
+	QStringList setDCdescriptions;
+	QStringList clearedDCs;
+	QStringList clearedDCdescriptions;
 	bool TestMode = false;
 	bool DCheckActive = false;
 	unsigned int rawDataIndex = 0;
@@ -284,83 +826,49 @@ unsigned int SSMprotocol::processDTCsRawdata(std::vector<char> DCrawdata, int du
 			DCheckActive = DCrawdata.at(0) & 0x80;
 		}
 		// FIXME: support test mode and D-Check status for other SSM1 control units, too
-		DCs.clear();
-		DCdescriptions.clear();
 		// Evaluate current/latest data trouble codes:
-		for (unsigned int DTCdefs_index=0; DTCdefs_index<_DTCdefs.size(); DTCdefs_index++)
+		if (DCrawdata.size() < rawDataIndex + _currentOrTempDTCsEvaluator.nrOfBytes())
+			return rawDataIndex;
+		bool first = !_currentOrTempDTCsEvaluator.hasPreviousData();
+		bool changed = _currentOrTempDTCsEvaluator.evaluate(&DCrawdata.at(rawDataIndex), &setDCs, &setDCdescriptions, &clearedDCs, &clearedDCdescriptions);
+		rawDataIndex += _currentOrTempDTCsEvaluator.nrOfBytes();
+		if (changed)
 		{
-			unsigned int address = _DTCdefs.at(DTCdefs_index).byteAddr_currentOrTempOrLatest;
-			if (address == MEMORY_ADDRESS_NONE)
-				continue;
-			evaluateDCdataByte(address, DCrawdata.at(rawDataIndex), _DTCdefs, &tmpDTCs, &tmpDTCsDescriptions);
-			DCs += tmpDTCs;
-			DCdescriptions += tmpDTCsDescriptions;
-			rawDataIndex++;
+			// NOTE: DTCs which are already present when DC reading is started don't produce snapshots
+			if (!first)
+				captureDTCsnapshots(setDCs, setDCdescriptions);
+			emit changedDCs(_selectedDCgroups & (currentDTCs_DCgroup | temporaryDTCs_DCgroup), setDCs, setDCdescriptions, clearedDCs, clearedDCdescriptions);
 		}
-		emit currentOrTemporaryDTCs(DCs, DCdescriptions, TestMode, DCheckActive);
+		if (changed || (TestMode != _lastTestMode) || (DCheckActive != _lastDCheckActive))
+			emit currentOrTemporaryDTCs(_currentOrTempDTCsEvaluator.DCs(), _currentOrTempDTCsEvaluator.DCdescriptions(), TestMode, DCheckActive);
+		_lastTestMode = TestMode;
+		_lastDCheckActive = DCheckActive;
 	}
 	if ((_selectedDCgroups & historicDTCs_DCgroup) || (_selectedDCgroups & memorizedDTCs_DCgroup))
 	{
-		DCs.clear();
-		DCdescriptions.clear();
 		// Evaluate historic/memorized data trouble codes:
-		for (unsigned int DTCdefs_index=0; DTCdefs_index<_DTCdefs.size(); DTCdefs_index++)
+		if (DCrawdata.size() < rawDataIndex + _historicOrMemDTCsEvaluator.nrOfBytes())
+			return rawDataIndex;
+		if (_historicOrMemDTCsEvaluator.evaluate(&DCrawdata.at(rawDataIndex), &setDCs, &setDCdescriptions, &clearedDCs, &clearedDCdescriptions))
 		{
-			unsigned int address = _DTCdefs.at(DTCdefs_index).byteAddr_historicOrMemorized;
-			if (address == MEMORY_ADDRESS_NONE)
-				continue;
-			evaluateDCdataByte(address, DCrawdata.at(rawDataIndex), _DTCdefs, &tmpDTCs, &tmpDTCsDescriptions);
-			DCs += tmpDTCs;
-			DCdescriptions += tmpDTCsDescriptions;
-			rawDataIndex++;
+			emit changedDCs(_selectedDCgroups & (historicDTCs_DCgroup | memorizedDTCs_DCgroup), setDCs, setDCdescriptions, clearedDCs, clearedDCdescriptions);
+			emit historicOrMemorizedDTCs(_historicOrMemDTCsEvaluator.DCs(), _historicOrMemDTCsEvaluator.DCdescriptions());
 		}
-		emit historicOrMemorizedDTCs(DCs, DCdescriptions);
+		rawDataIndex += _historicOrMemDTCsEvaluator.nrOfBytes();
 	}
 	return rawDataIndex;
 }
 
 
-void SSMprotocol::evaluateDCdataByte(unsigned int DCbyteadr, char DCrawdata, std::vector<dc_defs_dt> DCdefs, QStringList *DC, QStringList *DCdescription)
-{
-	unsigned int k = 0;
-	QString ukdctitle;
-
-	DC->clear();
-	DCdescription->clear();
-	if (DCrawdata == 0) return;
-	// Search definitions:
-	dc_defs_dt def;
-	for (k=0; k<DCdefs.size(); k++)
-	{
-		if ((DCdefs.at(k).byteAddr_currentOrTempOrLatest == DCbyteadr) || (DCdefs.at(k).byteAddr_historicOrMemorized == DCbyteadr))
-		{
-			def = DCdefs.at(k);
-			break;
-		}
-	}
-	// Assign codes and descriptions:
-	for (unsigned char flagbit=0; flagbit<8; flagbit++)
-	{
-		if (DCrawdata & static_cast<char>(pow(2, flagbit)))
-		{
-			// Check if DC is to be ignored:
-			// NOTE: DCs with existing definition and empty code- and title-fields must be ignored !
-			if (!(def.code[flagbit].isEmpty() && def.title[flagbit].isEmpty()))
-			{
-				DC->push_back( def.code[flagbit] );		// DC
-				DCdescription->push_back( def.title[flagbit] );	// DC description
-			}
-		}
-	}
-}
-
-
 bool SSMprotocol::setupMBSWQueryAddrList(std::vector<MBSWmetadata_dt> MBSWmetaList)
 {
 	// ***** SETUP (BYTE-) ADDRESS LIST FOR QUERYS *****
 	unsigned int k = 0, m = 0;
 	bool newadr = true;
+	// NOTE: a running recording doesn't match the new query address list
+	stopMBSWrecording();
 	_selMBsSWsAddr.clear();
+	_MBSWhistory.clear();
 	if (MBSWmetaList.size() == 0) return false;
 	for (k=0; k<MBSWmetaList.size(); k++)
 	{
@@ -410,6 +918,9 @@ bool SSMprotocol::setupMBSWQueryAddrList(std::vector<MBSWmetadata_dt> MBSWmetaLi
 				_selMBsSWsAddr.push_back( _supportedSWs.at( MBSWmetaList.at(k).nativeIndex ).byteAddr );
 		}
 	}
+	// Setup MB/SW history for DTC snapshots:
+	_MBSWhistory.setFrameSize(_selMBsSWsAddr.size());
+	_MBSWhistoryTime_ms = 0;
 	return true;
 }
 
@@ -417,9 +928,16 @@ bool SSMprotocol::setupMBSWQueryAddrList(std::vector<MBSWmetadata_dt> MBSWmetaLi
 void SSMprotocol::processMBSWrawData(std::vector<char> MBSWrawdata, int duration_ms)
 {
 	std::vector<unsigned int> rawValues;
-	QStringList valueStrList;
-	QStringList unitStrList;
 	assignMBSWRawData( MBSWrawdata, &rawValues );
+	_MBSWhistoryTime_ms += duration_ms;
+	_MBSWhistory.add(_MBSWhistoryTime_ms, MBSWrawdata);
+	_MBSWhistoryLastFrame.start();
+	if (_MBSWlogWriter)
+	{
+		_MBSWlogTime_ms += duration_ms;
+		if (!_MBSWlogWriter->addFrame(_MBSWlogTime_ms, MBSWrawdata))
+			stopMBSWrecording();	// MB/SW selection has changed or write error
+	}
 	emit newMBSWrawValues(rawValues, duration_ms);
 }
 
@@ -488,8 +1006,35 @@ void SSMprotocol::setupActuatorTestAddrList()
 }
 
 
+bool SSMprotocol::adjustmentRawData(unsigned char index, unsigned int rawValue, std::vector<unsigned int> *addresses, std::vector<char> *data)
+{
+	// Validate adjustment value selection:
+	if (index >= _adjustments.size()) return false;
+	if ((_adjustments.at(index).rawMin <= _adjustments.at(index).rawMax) && ((rawValue < _adjustments.at(index).rawMin) || ((rawValue > _adjustments.at(index).rawMax))))
+		return false;
+	if ((_adjustments.at(index).rawMin > _adjustments.at(index).rawMax) && (rawValue < _adjustments.at(index).rawMin) && (rawValue > _adjustments.at(index).rawMax))
+		return false;
+	if ((_adjustments.at(index).AddrHigh > 0) && (rawValue > 65535))
+		return false;
+	else if ((_adjustments.at(index).AddrHigh == 0) && (rawValue > 255))
+		return false;
+	// Setup addresses and convert raw value to 2 byte values:
+	addresses->push_back( _adjustments.at(index).AddrLow );
+	data->push_back( static_cast<char>(rawValue & 0xff) );
+	if (_adjustments.at(index).AddrHigh > 0)
+	{
+		addresses->push_back( _adjustments.at(index).AddrHigh );
+		data->push_back( static_cast<char>((rawValue & 0xffff) >> 8) );
+	}
+	return true;
+}
+
+
 void SSMprotocol::resetCommonCUdata()
 {
+	deleteMBSWreplay();
+	stopMBSWrecording();
+	setMBSWdataSource(NULL);
 	// RESET ECU DATA:
 	memset(_SYS_ID, 0, 3);
 	memset(_ROM_ID, 0, 5);
@@ -516,6 +1061,49 @@ void SSMprotocol::resetCommonCUdata()
 	_selectedDCgroups = noDCs_DCgroup;
 	_MBSWmetaList.clear();
 	_selMBsSWsAddr.clear();
+	_combinedDCgroups = noDCs_DCgroup;
+	_combinedDCdivisor = 10;
 	_selectedActuatorTestIndex = 255; // index ! => 0=first actuator !
+	// Clear DTC snapshot data:
+	_MBSWhistory.clear();
+	_currentOrTempDTCsEvaluator = DCevaluator();
+	_historicOrMemDTCsEvaluator = DCevaluator();
+	_DTCsnapshots.clear();
+}
+
+
+void SSMprotocol::getCUsetup(CUsetupCacheEntry_dt *setup)
+{
+	setup->sysDescription = _sysDescription;
+	setup->has_OBD2 = _has_OBD2;
+	setup->has_Immo = _has_Immo;
+	setup->has_TestMode = _has_TestMode;
+	setup->has_ActTest = _has_ActTest;
+	setup->has_MB_engineSpeed = _has_MB_engineSpeed;
+	setup->has_SW_ignition = _has_SW_ignition;
+	setup->DTCdefs = _DTCdefs;
+	setup->DTC_fmt_OBD2 = _DTC_fmt_OBD2;
+	setup->MBs = _supportedMBs;
+	setup->SWs = _supportedSWs;
+	setup->adjustments = _adjustments;
+	setup->actuators = _actuators;
+}
+
+
+void SSMprotocol::applyCUsetup(const CUsetupCacheEntry_dt & setup)
+{
+	_sysDescription = setup.sysDescription;
+	_has_OBD2 = setup.has_OBD2;
+	_has_Immo = setup.has_Immo;
+	_has_TestMode = setup.has_TestMode;
+	_has_ActTest = setup.has_ActTest;
+	_has_MB_engineSpeed = setup.has_MB_engineSpeed;
+	_has_SW_ignition = setup.has_SW_ignition;
+	_DTCdefs = setup.DTCdefs;
+	_DTC_fmt_OBD2 = setup.DTC_fmt_OBD2;
+	_supportedMBs = setup.MBs;
+	_supportedSWs = setup.SWs;
+	_adjustments = setup.adjustments;
+	_actuators = setup.actuators;
 }
 
@@ -27,15 +27,31 @@
 #include <QStringList>
 #include <QObject>
 #include <QEventLoop>
+#include <QDateTime>
+#include <QTime>
+#include <QElapsedTimer>
 #include <string>
 #include <vector>
 #include <cmath>
 #include <limits.h>
 #include "AbstractDiagInterface.h"
 #include "libFSSM.h"
+#include "MBSWlogFile.h"
+#include "MBSWlogReplay.h"
+#include "MBSWtriggerLogger.h"
+#ifdef __FSSM_DEBUG__
+    #include <iostream>
+#endif
 
 
 #define		MEMORY_ADDRESS_NONE	UINT_MAX
+#define		MBSW_HISTORY_SIZE	4096	// max. nr. of MB/SW frames kept for DTC snapshots
+#define		MAX_DTC_SNAPSHOTS	32
+#define		SSM_RESUME_TIMEOUT_MS		5000	// max. duration of a resume attempt after a communication error
+#define		SSM_RESUME_RETRY_INTERVAL_MS	500
+#define		SSM_IGNOFF_DETECTION_WINDOW_MS	1000	// max. duration of silence until the ignition is considered as switched off
+#define		SSM_IGNOFF_POLL_INTERVAL_MS	250
+#define		SSM_IGNOFF_RETRIES		1
 
 
 class dc_defs_dt
@@ -46,6 +62,37 @@ public:
 	QString code[8];
 	QString title[8];
 };
+
+
+/* NOTE: evaluates the raw bytes of one DC group (current/temporary/latest or historic/memorized codes).
+ *       The definitions are compiled into one slot per raw data byte, only changed bytes are evaluated. */
+
+class DCevaluator
+{
+public:
+	DCevaluator();
+	void setup(const std::vector<dc_defs_dt> & DCdefs, bool historicOrMemorized, bool skipMissingAddresses=false);
+	void reset();
+	unsigned int nrOfBytes() const;
+	bool hasPreviousData() const;
+	bool evaluate(const char *rawdata, QStringList *setDCs, QStringList *setDCdescriptions, QStringList *clearedDCs, QStringList *clearedDCdescriptions);
+	QStringList DCs() const;
+	QStringList DCdescriptions() const;
+
+private:
+	class slot_dt
+	{
+	public:
+		char usedBitsMask;	// bits with code or title
+		QString code[8];
+		QString title[8];
+	};
+	std::vector<slot_dt> _slots;
+	std::vector<char> _lastRawBytes;
+	bool _hasPreviousData;
+	QStringList _DCs;
+	QStringList _DCdescriptions;
+};
   
   
 class  mb_dt
@@ -121,6 +168,21 @@ public:
 
 
 
+class DTCsnapshot_dt
+{
+public:
+	QString DTC;
+	QString description;
+	QDateTime firstSeen;
+	std::vector<unsigned int> queryAddresses;
+	std::vector<MBSWlogChannel_dt> channels;
+	std::vector<MBSWlogFrame_dt> frames;	// MB/SW history before the DTC has been detected
+};
+
+
+class CUsetupCacheEntry_dt;
+
+
 class SSMprotocol : public QObject
 {
 	Q_OBJECT
@@ -129,7 +191,7 @@ public:
 	enum protocol_dt {SSM1, SSM2};
 	enum CUtype_dt {CUtype_Engine, CUtype_Transmission, CUtype_CruiseControl, CUtype_AirCon, CUtype_FourWheelSteering, CUtype_ABS, CUtype_AirSuspension, CUtype_PowerSteering};
 	enum CUsetupResult_dt {result_success, result_invalidCUtype, result_invalidInterfaceConfig, result_commError, result_noOrInvalidDefsFile, result_noDefs};
-	enum state_dt {state_needSetup, state_normal, state_DCreading, state_MBSWreading, state_ActTesting, state_waitingForIgnOff};
+	enum state_dt {state_needSetup, state_normal, state_DCreading, state_MBSWreading, state_ActTesting, state_waitingForIgnOff, state_resuming};
 	enum DCgroups_dt {noDCs_DCgroup=0, currentDTCs_DCgroup=1, temporaryDTCs_DCgroup=2, historicDTCs_DCgroup=4, memorizedDTCs_DCgroup=8,
 			  CClatestCCs_DCgroup=16, CCmemorizedCCs_DCgroup=32};
 	enum CMlevel_dt {CMlevel_1=1, CMlevel_2=2};
@@ -169,9 +231,12 @@ public:
 	virtual bool startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList) = 0;
 	bool restartMBSWreading();
 	virtual bool stopMBSWreading() = 0;
+	virtual bool setCombinedDCreading(int DCgroups, unsigned int divisor=10);
+	int combinedDCgroups();
 	virtual bool getAdjustmentValue(unsigned char index, unsigned int *rawValue) = 0;
 	virtual bool getAllAdjustmentValues(std::vector<unsigned int> *rawValues) = 0;
 	virtual bool setAdjustmentValue(unsigned char index, unsigned int rawValue) = 0;
+	virtual bool setAllAdjustmentValues(std::vector<unsigned int> rawValues) = 0;
 	virtual bool startActuatorTest(unsigned char actuatorTestIndex) = 0;
 	bool restartActuatorTest();
 	virtual bool stopActuatorTesting() = 0;
@@ -181,12 +246,33 @@ public:
 	virtual bool isEngineRunning(bool *isrunning) = 0;
 	virtual bool isInTestMode(bool *testmode) = 0;
 	bool stopAllPermanentOperations();
-	virtual bool waitForIgnitionOff() = 0;
+	virtual bool startIgnitionOffDetection(unsigned int window_ms = SSM_IGNOFF_DETECTION_WINDOW_MS) = 0;
+	bool waitForIgnitionOff(unsigned int window_ms = SSM_IGNOFF_DETECTION_WINDOW_MS);
+	// MB/SW RECORDING:
+	bool startMBSWrecording(QString filename, std::vector<MBSWlogChannel_dt> derivedChannels = std::vector<MBSWlogChannel_dt>());
+	bool isRecordingMBSWs();
+	bool stopMBSWrecording();
+	// MB/SW REPLAY:
+	bool startMBSWreplay(QString filename, double speed=1);
+	bool isReplayingMBSWs();
+	bool setMBSWreplaySpeed(double speed);
+	bool seekMBSWreplay(unsigned int time_ms);
+	unsigned int MBSWreplayDuration();
+	// MB/SW TRIGGERED RECORDING:
+	bool startMBSWtriggerLogging(QString filenamePrefix, QStringList triggerExpressions, unsigned int preTrigger_ms, unsigned int postTrigger_ms, unsigned int frameInterval_ms = 0);
+	bool isTriggerLoggingMBSWs();
+	void stopMBSWtriggerLogging();
+	// DTC SNAPSHOTS:
+	void setDTCsnapshotHistory(unsigned int history_ms);
+	void getDTCsnapshots(std::vector<DTCsnapshot_dt> *snapshots);
+	void clearDTCsnapshots();
+	bool saveDTCsnapshot(unsigned int index, QString filename);
 
 protected:
 	AbstractDiagInterface *_diagInterface;
 	CUtype_dt _CU;
 	state_dt _state;
+	state_dt _interruptedState;	// operation to be restarted after resuming (state_resuming)
 	QString _language;
 	// *** CONTROL UNIT RAW DATA ***:
 	char _SYS_ID[3];
@@ -214,14 +300,41 @@ protected:
 	int _selectedDCgroups;
 	std::vector<MBSWmetadata_dt> _MBSWmetaList;
 	std::vector<unsigned int> _selMBsSWsAddr;
+	int _combinedDCgroups;
+	unsigned int _combinedDCdivisor;
 	unsigned char _selectedActuatorTestIndex;
+	// *** MB/SW recording ***:
+	MBSWlogFileWriter *_MBSWlogWriter;
+	unsigned int _MBSWlogTime_ms;
+	MBSWlogReplay *_MBSWreplay;
+	QObject *_MBSWdataSource;
+	MBSWtriggerLogger *_MBSWtriggerLogger;
+	// *** DTC snapshots ***:
+	MBSWframeRingBuffer _MBSWhistory;
+	unsigned int _MBSWhistoryTime_ms;
+	QElapsedTimer _MBSWhistoryLastFrame;	// NOTE: monotonic
+	unsigned int _DTCsnapshotHistory_ms;
+	DCevaluator _currentOrTempDTCsEvaluator;
+	DCevaluator _historicOrMemDTCsEvaluator;
+	bool _lastTestMode;
+	bool _lastDCheckActive;
+	std::vector<DTCsnapshot_dt> _DTCsnapshots;
 
-	void evaluateDCdataByte(unsigned int DCbyteadr, char DCrawdata, std::vector<dc_defs_dt> DCdefs,
-				QStringList *DC, QStringList *DCdescription);
 	bool setupMBSWQueryAddrList(std::vector<MBSWmetadata_dt> MBSWmetaList);
 	void assignMBSWRawData(std::vector<char> rawdata, std::vector<unsigned int> * mbswrawvalues);
 	void setupActuatorTestAddrList();
+	bool adjustmentRawData(unsigned char index, unsigned int rawValue, std::vector<unsigned int> *addresses, std::vector<char> *data);
 	void resetCommonCUdata();
+	void getCUsetup(CUsetupCacheEntry_dt *setup);
+	void applyCUsetup(const CUsetupCacheEntry_dt & setup);
+	bool stopMBSWreplay();
+	void deleteMBSWreplay();
+	std::vector<MBSWlogChannel_dt> MBSWlogChannels();
+	void setMBSWdataSource(QObject *source);
+	void suspendMBSWdataSource();
+	void markMBSWgap(unsigned int duration_ms);
+	virtual void setupDCevaluation();
+	void captureDTCsnapshots(const QStringList & newDTCs, const QStringList & newDTCsDescriptions);
 
 signals:
 	void currentOrTemporaryDTCs(QStringList currentDTCs, QStringList currentDTCsDescriptions, bool testMode, bool DCheckActive);
@@ -236,10 +349,22 @@ signals:
 	void stoppedMBSWreading();
 	void stoppedActuatorTest();
 	void commError();
+	void commInterrupted();
+	void commResumed();
+	void ignitionOff();
+	void MBSWreplayPosition(unsigned int time_ms);
+	void MBSWtriggerLogWritten(QString filename);
+	void capturedDTCsnapshot(QString DTC);
+	void changedDCs(int DCgroup, QStringList setDCs, QStringList setDCdescriptions, QStringList clearedDCs, QStringList clearedDCdescriptions);
 
 protected slots:
 	void processMBSWrawData(std::vector<char> MBSWrawdata, int duration_ms);
 	unsigned int processDTCsRawdata(std::vector<char> dcrawdata, int duration_ms);
+	void processIgnitionSwitchData(std::vector<char> rawdata, int duration_ms);
+	void finishIgnitionOffDetection();
+
+private slots:
+	void finishMBSWreplay();
 
 public slots:
 	virtual void resetCUdata() = 0;
@@ -18,6 +18,8 @@
  */
 
 #include "SSMprotocol1.h"
+#include <QFileInfo>
+#include "CUsetupCache.h"
 
 
 SSMprotocol1::SSMprotocol1(AbstractDiagInterface *diagInterface, QString language) : SSMprotocol(diagInterface, language)
@@ -41,10 +43,13 @@ void SSMprotocol1::resetCUdata()
 		// Disconnect communication error and data signals:
 		disconnect( _SSMP1com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
 		disconnect( _SSMP1com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
+		disconnect( _SSMP1com, SIGNAL( commError() ), this, SLOT( finishIgnitionOffDetection() ) );
 		disconnect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
 			    this, SLOT( processDTCsRawdata(std::vector<char>, int) ) );
 		disconnect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
 			    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+		disconnect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
+			    this, SLOT( processIgnitionSwitchData(std::vector<char>, int) ) );
 		// Try to stop active communication processes:
 		// NOTE: DO NOT CALL any communicating member functions here because of possible recursions !
 		if (_SSMP1com->stopCommunication() && (_state == state_ActTesting) && _uses_SSM2defs) // TODO: other definition systems
@@ -97,6 +102,7 @@ SSMprotocol::CUsetupResult_dt SSMprotocol1::setupCUdata(CUtype_dt CU)
 	SSM1_CUtype_dt SSM1_CU;
 	char flagbytes[96];
 	unsigned char nrofflagbytes;
+	CUsetupCacheEntry_dt setup;
 	// Reset:
 	resetCUdata();
 	// Create SSMP1communication-object:
@@ -165,16 +171,31 @@ SSMprotocol::CUsetupResult_dt SSMprotocol1::setupCUdata(CUtype_dt CU)
 	connect( _SSMP1com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
 	connect( _SSMP1com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
 	/* Load control unit definitions */
+	setup.protocol = SSM1;
+	setup.CU = _CU;
+	setup.language = _language;
 	if (_uses_SSM2defs)
 	{
-		// Request flag bytes:
-		if (!_SSMP1com->getCUdata(32, _SYS_ID, flagbytes, &nrofflagbytes))
+		// Read extended ID (5-byte ROM-ID):
+		if (!readExtendedID(_ROM_ID))
 		{
 			resetCUdata();
 			return result_commError;
 		}
-		// Read extended ID (5-byte ROM-ID):
-		if (!readExtendedID(_ROM_ID))
+		// Check if the setup of this control unit is known (skips the flag bytes request):
+		setup.ID = QByteArray(_SYS_ID, 3) + QByteArray(_ROM_ID, 5);
+		// NOTE: the SSM2-definitions are compiled into the application, the key changes with any change of the definitions
+		setup.defsKey = SSM2definitionTables::definitionsKey(_language);
+		if (CUsetupCache::lookup(setup, &setup))
+		{
+			applyCUsetup(setup);
+			_CMaddr = setup.CMaddr;
+			_CMvalue = setup.CMvalue;
+			setupActuatorTestAddrList();
+			return result_success;
+		}
+		// Request flag bytes:
+		if (!_SSMP1com->getCUdata(32, _SYS_ID, flagbytes, &nrofflagbytes))
 		{
 			resetCUdata();
 			return result_commError;
@@ -212,14 +233,25 @@ SSMprotocol::CUsetupResult_dt SSMprotocol1::setupCUdata(CUtype_dt CU)
 	}
 	else
 	{
+		// Check if the setup of this control unit is known:
+		QFileInfo defsFileInfo(QString::fromStdString(SSM1defsFile));
+		setup.ID = QByteArray(_SYS_ID, 3);
+		setup.defsKey = defsFileInfo.absoluteFilePath() + "|" + QString::number(defsFileInfo.size())
+				+ "|" + QString::number(defsFileInfo.lastModified().toTime_t());
+		if (CUsetupCache::lookup(setup, &setup))
+		{
+			applyCUsetup(setup);
+			_CMaddr = setup.CMaddr;
+			_CMvalue = setup.CMvalue;
+			return result_success;
+		}
 		// Setup definitions interface:
-		SSM1definitionsInterface SSM1defsIface;
+		SSM1definitionsInterface SSM1defsIface(_language.toStdString());	// language must be known before loading (cache)
 		if (!SSM1defsIface.selectDefinitionsFile(SSM1defsFile))
 		{
 			resetCUdata();
 			return result_noOrInvalidDefsFile;
 		}
-		SSM1defsIface.setLanguage(_language.toStdString());
 		if (!SSM1defsIface.selectID(_SYS_ID)) // TODO: Ax 01 xx IDs
 		{
 			resetCUdata();
@@ -237,6 +269,11 @@ SSMprotocol::CUsetupResult_dt SSMprotocol1::setupCUdata(CUtype_dt CU)
 		// Get Clear Memory data:
 		SSM1defsIface.clearMemoryData(&_CMaddr, &_CMvalue);
 	}
+	// Save setup:
+	getCUsetup(&setup);
+	setup.CMaddr = _CMaddr;
+	setup.CMvalue = _CMvalue;
+	CUsetupCache::store(setup);
 	return result_success;
 }
 
@@ -317,6 +354,7 @@ bool SSMprotocol1::startDCreading(int DCgroups)
 		_state = state_DCreading;
 		// Save diagnostic codes group selection (for data evaluation and restartDCreading()):
 		_selectedDCgroups = DCgroups;
+		setupDCevaluation();
 		// Connect signals and slots:
 		connect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
 			this, SLOT( processDTCsRawdata(std::vector<char>, int) ), Qt::BlockingQueuedConnection );
@@ -366,6 +404,7 @@ bool SSMprotocol1::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 		// Connect signals/slots:
 		connect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
 			this, SLOT( processMBSWrawData(std::vector<char>, int) ) ); 
+		setMBSWdataSource(_SSMP1com);
 		// Emit signal:
 		emit startedMBSWreading();
 	}
@@ -378,12 +417,15 @@ bool SSMprotocol1::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 bool SSMprotocol1::stopMBSWreading()
 {
 	if ((_state == state_needSetup) || (_state == state_normal)) return true;
+	if (_MBSWreplay)
+		return stopMBSWreplay();
 	if (_state == state_MBSWreading)
 	{
 		if (_SSMP1com->stopCommunication())
 		{
 			disconnect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
 				    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+			setMBSWdataSource(NULL);
 			_state = state_normal;
 			emit stoppedMBSWreading();
 			return true;
@@ -462,29 +504,32 @@ bool SSMprotocol1::setAdjustmentValue(unsigned char index, unsigned int rawValue
 	std::vector<unsigned int> addresses;
 	std::vector<char> data;
 	if (_state != state_normal) return false;
-	// Validate adjustment value selection:
-	if (index >= _adjustments.size()) return false;
-	if ((_adjustments.at(index).rawMin <= _adjustments.at(index).rawMax) && ((rawValue < _adjustments.at(index).rawMin) || ((rawValue > _adjustments.at(index).rawMax))))
-		return false;
-	if ((_adjustments.at(index).rawMin > _adjustments.at(index).rawMax) && (rawValue < _adjustments.at(index).rawMin) && (rawValue > _adjustments.at(index).rawMax))
+	// Validate value, setup addresses and convert raw value to byte values:
+	if (!adjustmentRawData(index, rawValue, &addresses, &data))
 		return false;
-	if ((_adjustments.at(index).AddrHigh > 0) && (rawValue > 65535))
-	{
-		return false;
-	}
-	else if (rawValue > 255)
+	// Write value to control unit:
+	if (!_SSMP1com->writeAddresses(addresses, data))
 	{
+		resetCUdata();
 		return false;
 	}
-	// Setup addresses and convert raw value to 2 byte values:
-	addresses.push_back( _adjustments.at(index).AddrLow );
-	data.push_back( static_cast<char>(rawValue & 0xff) );
-	if (_adjustments.at(index).AddrHigh > 0)
+	return true;
+}
+
+
+bool SSMprotocol1::setAllAdjustmentValues(std::vector<unsigned int> rawValues)
+{
+	std::vector<unsigned int> addresses;
+	std::vector<char> data;
+	if ((_state != state_normal) || _adjustments.empty() || (rawValues.size() != _adjustments.size())) return false;
+	// Validate values, setup addresses and convert raw values to byte values:
+	for (unsigned char k=0; k<_adjustments.size(); k++)
 	{
-		addresses.push_back( _adjustments.at(index).AddrHigh );
-		data.push_back( static_cast<char>((rawValue & 0xffff) >> 8) );
+		if (!adjustmentRawData(k, rawValues.at(k), &addresses, &data))
+			return false;
 	}
-	// Write value to control unit:
+	// Write all values with a single communication operation:
+	// NOTE: SSM1 has no block write service, but the write sequence is not interrupted
 	if (!_SSMP1com->writeAddresses(addresses, data))
 	{
 		resetCUdata();
@@ -705,45 +750,33 @@ bool SSMprotocol1::isInTestMode(bool *testmode)
 }
 
 
-bool SSMprotocol1::waitForIgnitionOff()
+bool SSMprotocol1::startIgnitionOffDetection(unsigned int window_ms)
 {
+	unsigned int dataaddr = 0x0000;
+	bool ignSwitch = (_has_SW_ignition && _uses_SSM2defs);	// FIXME: other defintion types
 	if (_state != state_normal)
 		return false;
-	unsigned int dataaddr;
-	_state = state_waitingForIgnOff;
-	_SSMP1com->setRetriesOnError(1);
-	if (_has_SW_ignition && _uses_SSM2defs)	// FIXME: other defintion types
+	// NOTE: the window is covered by the first request and the retries
+	_SSMP1com->setRetriesOnError(SSM_IGNOFF_RETRIES);
+	_SSMP1com->setReadTimeout(window_ms / (SSM_IGNOFF_RETRIES + 1));
+	// Silence: control unit is switched off
+	disconnect( _SSMP1com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
+	disconnect( _SSMP1com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
+	connect( _SSMP1com, SIGNAL( commError() ), this, SLOT( finishIgnitionOffDetection() ) );
+	// Ignition switch (if available) reports the ignition state before the control unit is switched off:
+	if (ignSwitch)
 	{
-		bool ignstate = true;
-		char data = 0x00;
 		dataaddr = 0x62;
-		do
-		{
-			if (!_SSMP1com->readAddress(dataaddr, &data))
-				ignstate = false;
-			else
-				ignstate = (data & 0x08);
-		} while (ignstate);
+		connect( _SSMP1com, SIGNAL( recievedData(std::vector<char>, int) ),
+			 this, SLOT( processIgnitionSwitchData(std::vector<char>, int) ) );
 	}
-	else
+	if (!_SSMP1com->readAddress_permanent(dataaddr, SSM_IGNOFF_POLL_INTERVAL_MS))
 	{
-		dataaddr = 0x0000;
-		QEventLoop el;
-		disconnect( _SSMP1com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
-		disconnect( _SSMP1com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
-		if(!_SSMP1com->readAddress_permanent(dataaddr))
-		{
-			resetCUdata();
-			return false;
-		}
-		connect(_SSMP1com, SIGNAL( commError() ), &el, SLOT( quit() ));
-		el.exec();
-		disconnect(_SSMP1com, SIGNAL( commError() ), &el, SLOT( quit() ));
+		resetCUdata();
+		return false;
 	}
-	_SSMP1com->setRetriesOnError(2);
-	resetCUdata();
+	_state = state_waitingForIgnOff;
 	return true;
-/* NOTE: temporary solution, will become obsolete with extended SSMP1communication */
 }
 
 // PRIVATE
@@ -53,6 +53,7 @@ public:
 	bool getAdjustmentValue(unsigned char index, unsigned int *rawValue);
 	bool getAllAdjustmentValues(std::vector<unsigned int> *rawValues);
 	bool setAdjustmentValue(unsigned char index, unsigned int rawValue);
+	bool setAllAdjustmentValues(std::vector<unsigned int> rawValues);
 	bool startActuatorTest(unsigned char actuatorTestIndex);
 	bool stopActuatorTesting();
 	bool stopAllActuators();
@@ -60,7 +61,7 @@ public:
 	bool testImmobilizerCommLine(immoTestResult_dt *result);
 	bool isEngineRunning(bool *isrunning);
 	bool isInTestMode(bool *testmode);
-	bool waitForIgnitionOff();
+	bool startIgnitionOffDetection(unsigned int window_ms = SSM_IGNOFF_DETECTION_WINDOW_MS);
 
 private:
 	SSMP1communication *_SSMP1com;
@@ -18,12 +18,15 @@
  */
 
 #include "SSMprotocol2.h"
+#include "CUsetupCache.h"
 
 
 
 SSMprotocol2::SSMprotocol2(AbstractDiagInterface *diagInterface, QString language) : SSMprotocol(diagInterface, language)
 {
 	_SSMP2com = NULL;
+	_resumeTimer.setSingleShot(true);
+	connect( &_resumeTimer, SIGNAL( timeout() ), this, SLOT( retryResume() ) );
 	resetCUdata();
 }
 
@@ -31,21 +34,30 @@ SSMprotocol2::SSMprotocol2(AbstractDiagInterface *diagInterface, QString languag
 SSMprotocol2::~SSMprotocol2()
 {
 	resetCUdata();
+	disconnect( &_resumeTimer, SIGNAL( timeout() ), this, SLOT( retryResume() ) );
 }
 
 
 void SSMprotocol2::resetCUdata()
 {
+	// Cancel a pending resume attempt:
+	_resumeTimer.stop();
+	_interruptedState = state_normal;
+	_stopActuatorsOnResume = false;
 	// RESET COMMUNICATION:
 	if (_SSMP2com != NULL)
 	{
 		// Disconnect communication error and data signals:
-		disconnect( _SSMP2com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
-		disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
+		disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resumeCommunication() ) );
+		disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( finishIgnitionOffDetection() ) );
 		disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
 			    this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
 		disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
 			    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+		disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
+			    this, SLOT( processIgnitionSwitchData(std::vector<char>, int) ) );
+		disconnect( _SSMP2com, SIGNAL( recievedSecondaryData(std::vector<char>, int) ),
+			    this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
 		// Try to stop active communication processes:
 		// NOTE: DO NOT CALL any communicating member functions here because of possible recursions !
 		if (_SSMP2com->stopCommunication() && (_state == state_ActTesting))
@@ -57,13 +69,8 @@ void SSMprotocol2::resetCUdata()
 				// Check if test mode is active:
 				if (currentdatabyte & 0x20)
 				{
-					bool ok = false;
 					// Stop all actuator tests:
-					for (unsigned int k=0; k<_allActByteAddr.size(); k++)
-					{
-						ok =_SSMP2com->writeDatabyte(_allActByteAddr.at(k), 0x00);
-						if (!ok) break;
-					}
+					bool ok = writeAddresses(_allActByteAddr, std::vector<char>(_allActByteAddr.size(), 0x00));
 					_state = state_needSetup;	// MUST BE DONE AFTER ALL CALLS OF MEMBER-FUNCTIONS AND BEFORE EMITTING SIGNALS
 					if (ok)
 						emit stoppedActuatorTest();
@@ -93,6 +100,10 @@ void SSMprotocol2::resetCUdata()
 	_has_integratedCC = false;
 	_CCCCdefs.clear();
 	_memCCs_supported = false;
+	_CUaddress = 0x0;
+	_blockReadSupported = true;
+	_actuatorWriteAddr.clear();
+	_actuatorWriteData.clear();
 }
 
 
@@ -104,22 +115,28 @@ SSMprotocol::CUsetupResult_dt SSMprotocol2::setupCUdata(CUtype_dt CU)
 
 SSMprotocol::CUsetupResult_dt SSMprotocol2::setupCUdata(CUtype_dt CU, bool ignoreIgnitionOFF)
 {
-	unsigned int CUaddress = 0x0;
+	std::vector<unsigned int> CUaddresses;
+	unsigned int lastCUaddress = 0;
+	QString CUaddressKey;
+	bool CUdataOk = false;
 	char flagbytes[96];
 	unsigned char nrofflagbytes;
+	CUsetupCacheEntry_dt setup;
 	SSM2definitionsInterface *SSM2defsIface;
 	// Reset:
 	resetCUdata();
-	// Create SSMP2communication-object:
+	// Possible control unit addresses:
 	if (CU == CUtype_Engine)
 	{
 		if (_diagInterface->protocolType() == AbstractDiagInterface::protocol_SSM2_ISO14230)
 		{
-			CUaddress = 0x10;
+			CUaddresses.push_back(0x10);
+			CUaddresses.push_back(0x01);
+			CUaddresses.push_back(0x02);
 		}
 		else if (_diagInterface->protocolType() == AbstractDiagInterface::protocol_SSM2_ISO15765)
 		{
-			CUaddress = 0x7E0;
+			CUaddresses.push_back(0x7E0);
 		}
 		else
 			return result_invalidInterfaceConfig;
@@ -128,39 +145,49 @@ SSMprotocol::CUsetupResult_dt SSMprotocol2::setupCUdata(CUtype_dt CU, bool ignor
 	{
 		if (_diagInterface->protocolType() == AbstractDiagInterface::protocol_SSM2_ISO14230)
 		{
-			CUaddress = 0x18;
+			CUaddresses.push_back(0x18);
+			CUaddresses.push_back(0x01);
 		}
 		else if (_diagInterface->protocolType() == AbstractDiagInterface::protocol_SSM2_ISO15765)
 		{
-			CUaddress = 0x7E1;
+			CUaddresses.push_back(0x7E1);
 		}
 		else
 			return result_invalidInterfaceConfig;
 	}
 	else
 		return result_invalidCUtype;
-	_SSMP2com = new SSMP2communication(_diagInterface, CUaddress, 1);
-	// Get control unit data:
-	if (!_SSMP2com->getCUdata(_SYS_ID, _ROM_ID, flagbytes, &nrofflagbytes))
+	// Try the address which worked last time first:
+	CUaddressKey = "SSM2_" + QString::number(_diagInterface->protocolType()) + "_" + QString::number(CU);
+	if (CUsetupCache::lastCUaddress(CUaddressKey, &lastCUaddress))
 	{
-		if (_diagInterface->protocolType() == AbstractDiagInterface::protocol_SSM2_ISO14230)
+		for (unsigned int k=1; k<CUaddresses.size(); k++)
 		{
-			_SSMP2com->setCUaddress(0x01);
-			if (!_SSMP2com->getCUdata(_SYS_ID, _ROM_ID, flagbytes, &nrofflagbytes))
+			if (CUaddresses.at(k) == lastCUaddress)
 			{
-				if (CU == CUtype_Engine)
-				{
-					_SSMP2com->setCUaddress(0x02);
-					if (!_SSMP2com->getCUdata(_SYS_ID, _ROM_ID, flagbytes, &nrofflagbytes))
-						goto commError;
-				}
-				else
-					goto commError;
+				CUaddresses.erase(CUaddresses.begin() + k);
+				CUaddresses.insert(CUaddresses.begin(), lastCUaddress);
+				break;
 			}
 		}
-		else
-			goto commError;
 	}
+	// Create SSMP2communication-object:
+	_SSMP2com = new SSMP2communication(_diagInterface, CUaddresses.at(0), 1);
+	// Get control unit data:
+	for (unsigned int k=0; k<CUaddresses.size(); k++)
+	{
+		if (k > 0)
+			_SSMP2com->setCUaddress(CUaddresses.at(k));
+		if (_SSMP2com->getCUdata(_SYS_ID, _ROM_ID, flagbytes, &nrofflagbytes))
+		{
+			CUdataOk = true;
+			_CUaddress = CUaddresses.at(k);
+			CUsetupCache::setLastCUaddress(CUaddressKey, _CUaddress);
+			break;
+		}
+	}
+	if (!CUdataOk)
+		goto commError;
 	_SSMP2com->setRetriesOnError(2);
 	// Ensure that ignition switch is ON:
 	if ((_has_SW_ignition) && !ignoreIgnitionOFF)
@@ -172,31 +199,59 @@ SSMprotocol::CUsetupResult_dt SSMprotocol2::setupCUdata(CUtype_dt CU, bool ignor
 	}
 	_CU = CU;
 	_state = state_normal;
-	// Connect communication error signals from SSM2Pcommunication:
-	connect( _SSMP2com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
-	connect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
+	// Connect communication error signal from SSM2Pcommunication:
+	connect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resumeCommunication() ) );
 	/* Get definitions for this control unit */
-	SSM2defsIface = new SSM2definitionsInterface(_language);
-	SSM2defsIface->selectControlUnitID(_CU, _SYS_ID, _ROM_ID, flagbytes, nrofflagbytes);
-	SSM2defsIface->systemDescription(&_sysDescription);
-	SSM2defsIface->hasOBD2system(&_has_OBD2);
-	SSM2defsIface->hasImmobilizer(&_has_Immo);
-	SSM2defsIface->hasTestMode(&_has_TestMode);
-	SSM2defsIface->hasActuatorTests(&_has_ActTest);
-	SSM2defsIface->hasClearMemory(&_has_CM);
-	SSM2defsIface->hasClearMemory2(&_has_CM2);
-	SSM2defsIface->hasVINsupport(&_has_VINsupport);
-	SSM2defsIface->hasIntegratedCC(&_has_integratedCC);
-	SSM2defsIface->hasMBengineSpeed(&_has_MB_engineSpeed);
-	SSM2defsIface->hasSWignition(&_has_SW_ignition);
-	SSM2defsIface->diagnosticCodes(&_DTCdefs, &_DTC_fmt_OBD2);
-	SSM2defsIface->cruiseControlCancelCodes(&_CCCCdefs, &_memCCs_supported);
-	SSM2defsIface->measuringBlocks(&_supportedMBs);
-	SSM2defsIface->switches(&_supportedSWs);
-	SSM2defsIface->adjustments(&_adjustments);
-	SSM2defsIface->actuatorTests(&_actuators);
-	delete SSM2defsIface;
+	setup.protocol = SSM2;
+	setup.CU = _CU;
+	setup.ID = QByteArray(_SYS_ID, 3) + QByteArray(_ROM_ID, 5) + QByteArray(flagbytes, nrofflagbytes);
+	setup.language = _language;
+	// NOTE: the SSM2-definitions are compiled into the application, the key changes with any change of the definitions
+	setup.defsKey = SSM2definitionTables::definitionsKey(_language);
+	if (CUsetupCache::lookup(setup, &setup))
+	{
+		applyCUsetup(setup);
+		_has_CM = setup.has_CM;
+		_has_CM2 = setup.has_CM2;
+		_has_VINsupport = setup.has_VINsupport;
+		_has_integratedCC = setup.has_integratedCC;
+		_CCCCdefs = setup.CCCCdefs;
+		_memCCs_supported = setup.memCCs_supported;
+	}
+	else
+	{
+		SSM2defsIface = new SSM2definitionsInterface(_language);
+		SSM2defsIface->selectControlUnitID(_CU, _SYS_ID, _ROM_ID, flagbytes, nrofflagbytes);
+		SSM2defsIface->systemDescription(&_sysDescription);
+		SSM2defsIface->hasOBD2system(&_has_OBD2);
+		SSM2defsIface->hasImmobilizer(&_has_Immo);
+		SSM2defsIface->hasTestMode(&_has_TestMode);
+		SSM2defsIface->hasActuatorTests(&_has_ActTest);
+		SSM2defsIface->hasClearMemory(&_has_CM);
+		SSM2defsIface->hasClearMemory2(&_has_CM2);
+		SSM2defsIface->hasVINsupport(&_has_VINsupport);
+		SSM2defsIface->hasIntegratedCC(&_has_integratedCC);
+		SSM2defsIface->hasMBengineSpeed(&_has_MB_engineSpeed);
+		SSM2defsIface->hasSWignition(&_has_SW_ignition);
+		SSM2defsIface->diagnosticCodes(&_DTCdefs, &_DTC_fmt_OBD2);
+		SSM2defsIface->cruiseControlCancelCodes(&_CCCCdefs, &_memCCs_supported);
+		SSM2defsIface->measuringBlocks(&_supportedMBs);
+		SSM2defsIface->switches(&_supportedSWs);
+		SSM2defsIface->adjustments(&_adjustments);
+		SSM2defsIface->actuatorTests(&_actuators);
+		delete SSM2defsIface;
+		// Save setup:
+		getCUsetup(&setup);
+		setup.has_CM = _has_CM;
+		setup.has_CM2 = _has_CM2;
+		setup.has_VINsupport = _has_VINsupport;
+		setup.has_integratedCC = _has_integratedCC;
+		setup.CCCCdefs = _CCCCdefs;
+		setup.memCCs_supported = _memCCs_supported;
+		CUsetupCache::store(setup);
+	}
 	setupActuatorTestAddrList();
+	setupActuatorTestWriteData();
 	return result_success;
 
 commError:
@@ -300,49 +355,11 @@ bool SSMprotocol2::getVIN(QString *VIN)
 bool SSMprotocol2::startDCreading(int DCgroups)
 {
 	std::vector <unsigned int> DCqueryAddrList;
-	unsigned char k = 0;
 	bool started;
 	// Check if another communication operation is in progress:
 	if (_state != state_normal) return false;
-	// Check argument:
-	if (DCgroups < 1 || DCgroups > 63) return false;
-	if (((DCgroups & currentDTCs_DCgroup) || (DCgroups & historicDTCs_DCgroup)) && ((DCgroups & temporaryDTCs_DCgroup) || (DCgroups & memorizedDTCs_DCgroup)))
-		return false;
-	if (DCgroups > 15)
-	{
-		if (!_has_integratedCC)
-			return false;
-		if ( (DCgroups > 31) && (!_memCCs_supported) )
-			return false;
-	}
 	// Setup diagnostic codes addresses list:
-	if ((DCgroups & currentDTCs_DCgroup) || (DCgroups & temporaryDTCs_DCgroup))	// current/temporary DTCs
-	{
-		if (_CU == CUtype_Engine)
-			DCqueryAddrList.push_back( 0x000061 );
-		for (k=0; k<_DTCdefs.size(); k++)
-			DCqueryAddrList.push_back( _DTCdefs.at(k).byteAddr_currentOrTempOrLatest );
-	}	
-	if ((DCgroups & historicDTCs_DCgroup) || (DCgroups & memorizedDTCs_DCgroup))	// historic/memorized DTCs
-	{
-		for (k=0; k<_DTCdefs.size(); k++)
-			DCqueryAddrList.push_back( _DTCdefs.at(k).byteAddr_historicOrMemorized );
-	}
-	if (_has_integratedCC)
-	{
-		if (DCgroups & CClatestCCs_DCgroup)	// CC latest cancel codes
-		{
-			for (k=0; k<_CCCCdefs.size(); k++)
-				DCqueryAddrList.push_back( _CCCCdefs.at(k).byteAddr_currentOrTempOrLatest );
-		}
-		if ((DCgroups & CCmemorizedCCs_DCgroup) && _memCCs_supported)	// CC memorized cancel codes
-		{
-			for (k=0; k<_CCCCdefs.size(); k++)
-				DCqueryAddrList.push_back( _CCCCdefs.at(k).byteAddr_historicOrMemorized );
-		}
-	}
-	// Check if min. 1 address to read:
-	if ((DCqueryAddrList.size() < 1) || ((DCqueryAddrList.at(0) == 0x000061) && (DCqueryAddrList.size() < 2)))
+	if (!setupDCqueryAddrList(DCgroups, &DCqueryAddrList))
 		return false;
 	// Start diagostic codes reading:
 	started = _SSMP2com->readMultipleDatabytes_permanent('\x0', &DCqueryAddrList.at(0), DCqueryAddrList.size());
@@ -351,6 +368,7 @@ bool SSMprotocol2::startDCreading(int DCgroups)
 		_state = state_DCreading;
 		// Save diagnostic codes group selection (for data evaluation and restartDCreading()):
 		_selectedDCgroups = DCgroups;
+		setupDCevaluation();
 		// Connect signals and slots:
 		connect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
 			this, SLOT( processDCsRawdata(std::vector<char>, int) ), Qt::BlockingQueuedConnection );
@@ -366,6 +384,12 @@ bool SSMprotocol2::startDCreading(int DCgroups)
 bool SSMprotocol2::stopDCreading()
 {
 	if ((_state == state_needSetup) || (_state == state_normal)) return true;
+	if ((_state == state_resuming) && (_interruptedState == state_DCreading))
+	{
+		_interruptedState = state_normal;	// do not restart after the connection has been re-established
+		emit stoppedDCreading();
+		return true;
+	}
 	if (_state == state_DCreading)
 	{
 		if (_SSMP2com->stopCommunication())
@@ -383,6 +407,22 @@ bool SSMprotocol2::stopDCreading()
 }
 
 
+bool SSMprotocol2::setCombinedDCreading(int DCgroups, unsigned int divisor)
+{
+	// NOTE: takes effect with the next start of MB/SW-reading
+	std::vector<unsigned int> DCqueryAddrList;
+	if (_state == state_needSetup) return false;
+	// Only current/temporary DTCs and latest CC cancel codes are useful while reading MBs/SWs:
+	if (DCgroups & (historicDTCs_DCgroup | memorizedDTCs_DCgroup | CCmemorizedCCs_DCgroup))
+		return false;
+	if ((DCgroups != noDCs_DCgroup) && !setupDCqueryAddrList(DCgroups, &DCqueryAddrList))
+		return false;
+	_combinedDCgroups = DCgroups;
+	_combinedDCdivisor = (divisor > 0) ? divisor : 1;
+	return true;
+}
+
+
 bool SSMprotocol2::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 {
 	bool started = false;
@@ -390,8 +430,16 @@ bool SSMprotocol2::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 	// Setup list of MB/SW-addresses for SSM2Pcommunication:
 	if (!setupMBSWQueryAddrList(mbswmetaList))
 		return false;
+	// Setup list of DC-addresses for combined reading:
+	std::vector<unsigned int> DCqueryAddrList;
+	if ((_combinedDCgroups != noDCs_DCgroup) && !setupDCqueryAddrList(_combinedDCgroups, &DCqueryAddrList))
+		return false;
  	// Start MB/SW-reading:
-	started = _SSMP2com->readMultipleDatabytes_permanent('\x0', &_selMBsSWsAddr.at(0), _selMBsSWsAddr.size());
+	if (DCqueryAddrList.size())
+		started = _SSMP2com->readMultipleDatabytes_permanent('\x0', &_selMBsSWsAddr.at(0), _selMBsSWsAddr.size(),
+								     &DCqueryAddrList.at(0), DCqueryAddrList.size(), _combinedDCdivisor);
+	else
+		started = _SSMP2com->readMultipleDatabytes_permanent('\x0', &_selMBsSWsAddr.at(0), _selMBsSWsAddr.size());
 	if (started)
 	{
 		_state = state_MBSWreading;
@@ -400,6 +448,15 @@ bool SSMprotocol2::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 		// Connect signals/slots:
 		connect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
 			this, SLOT( processMBSWrawData(std::vector<char>, int) ) ); 
+		if (DCqueryAddrList.size())
+		{
+			// Save diagnostic codes group selection (for data evaluation):
+			_selectedDCgroups = _combinedDCgroups;
+			setupDCevaluation();
+			connect( _SSMP2com, SIGNAL( recievedSecondaryData(std::vector<char>, int) ),
+				 this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
+		}
+		setMBSWdataSource(_SSMP2com);
 		// Emit signal:
 		emit startedMBSWreading();
 	}
@@ -412,12 +469,24 @@ bool SSMprotocol2::startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList)
 bool SSMprotocol2::stopMBSWreading()
 {
 	if ((_state == state_needSetup) || (_state == state_normal)) return true;
+	if (_MBSWreplay)
+		return stopMBSWreplay();
+	if ((_state == state_resuming) && (_interruptedState == state_MBSWreading))
+	{
+		_interruptedState = state_normal;	// do not restart after the connection has been re-established
+		setMBSWdataSource(NULL);
+		emit stoppedMBSWreading();
+		return true;
+	}
 	if (_state == state_MBSWreading)
 	{
 		if (_SSMP2com->stopCommunication())
 		{
 			disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
 				    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+			disconnect( _SSMP2com, SIGNAL( recievedSecondaryData(std::vector<char>, int) ),
+				    this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
+			setMBSWdataSource(NULL);
 			_state = state_normal;
 			emit stoppedMBSWreading();
 			return true;
@@ -431,30 +500,25 @@ bool SSMprotocol2::stopMBSWreading()
 
 bool SSMprotocol2::getAdjustmentValue(unsigned char index, unsigned int *rawValue)
 {
-	unsigned int dataaddr[2] = {0,0};
-	unsigned int datalen = 0;
-	char data[2] = {0,0};
+	std::vector<unsigned int> dataaddr;
+	std::vector<char> data;
 	if (_state != state_normal) return false;
 	// Validate adjustment value selection:
 	if (_adjustments.empty() || (index >= _adjustments.size())) return false;
 	// Convert memory address into two byte addresses:
-	dataaddr[0] = _adjustments.at(index).AddrLow;
-	datalen = 1;
+	dataaddr.push_back( _adjustments.at(index).AddrLow );
 	if (_adjustments.at(index).AddrHigh > 0)
-	{
-		dataaddr[1] = _adjustments.at(index).AddrLow;
-		datalen++;
-	}
+		dataaddr.push_back( _adjustments.at(index).AddrHigh );
 	// Read data from control unit:
-	if (!_SSMP2com->readMultipleDatabytes('\x0', dataaddr, datalen, data))
+	if (!readAddresses(dataaddr, &data))
 	{
 		resetCUdata();
 		return false;
 	}
 	// Calculate raw value:
-	*rawValue = static_cast<unsigned char>(data[0]);
+	*rawValue = static_cast<unsigned char>(data.at(0));
 	if (_adjustments.at(index).AddrHigh > 0)
-		*rawValue += 256*static_cast<unsigned char>(data[1]);
+		*rawValue += 256*static_cast<unsigned char>(data.at(1));
 	return true;
 }
 
@@ -474,8 +538,7 @@ bool SSMprotocol2::getAllAdjustmentValues(std::vector<unsigned int> * rawValues)
 			dataaddr.push_back( _adjustments.at(k).AddrHigh );
 	}
 	// Read data from control unit:
-	data.resize( dataaddr.size() );
-	if (!_SSMP2com->readMultipleDatabytes('\x0', &dataaddr.at(0), dataaddr.size(), &data.at(0)))
+	if (!readAddresses(dataaddr, &data))
 	{
 		resetCUdata();
 		return false;
@@ -498,37 +561,35 @@ bool SSMprotocol2::getAllAdjustmentValues(std::vector<unsigned int> * rawValues)
 
 bool SSMprotocol2::setAdjustmentValue(unsigned char index, unsigned int rawValue)
 {
-	char lowdatabyte = 0;
-	char highdatabyte = 0;
+	std::vector<unsigned int> addresses;
+	std::vector<char> data;
 	if (_state != state_normal) return false;
-	// Validate adjustment value selection:
-	if (index >= _adjustments.size()) return false;
-	if ((_adjustments.at(index).rawMin <= _adjustments.at(index).rawMax) && ((rawValue < _adjustments.at(index).rawMin) || ((rawValue > _adjustments.at(index).rawMax))))
-		return false;
-	if ((_adjustments.at(index).rawMin > _adjustments.at(index).rawMax) && (rawValue < _adjustments.at(index).rawMin) && (rawValue > _adjustments.at(index).rawMax))
+	// Validate value, setup addresses and convert raw value to byte values:
+	if (!adjustmentRawData(index, rawValue, &addresses, &data))
 		return false;
-	if ((_adjustments.at(index).AddrHigh > 0) && (rawValue > 65535))
-	{
-		return false;
-	}
-	else if (rawValue > 255)
+	// Write value to control unit:
+	if (!writeAddresses(addresses, data))
 	{
+		resetCUdata();
 		return false;
 	}
-	// Convert raw value to 2 byte values:
-	lowdatabyte = static_cast<char>(rawValue & 0xff);
-	if (_adjustments.at(index).AddrHigh > 0)
-		highdatabyte = static_cast<char>((rawValue & 0xffff) >> 8);
-	// Write value to control unit:
-	if (_adjustments.at(index).AddrHigh > 0)
+	return true;
+}
+
+
+bool SSMprotocol2::setAllAdjustmentValues(std::vector<unsigned int> rawValues)
+{
+	std::vector<unsigned int> addresses;
+	std::vector<char> data;
+	if ((_state != state_normal) || _adjustments.empty() || (rawValues.size() != _adjustments.size())) return false;
+	// Validate values, setup addresses and convert raw values to byte values:
+	for (unsigned char k=0; k<_adjustments.size(); k++)
 	{
-		if (!_SSMP2com->writeDatabyte(_adjustments.at(index).AddrHigh, highdatabyte))
-		{
-			resetCUdata();
+		if (!adjustmentRawData(k, rawValues.at(k), &addresses, &data))
 			return false;
-		}
 	}
-	if (!_SSMP2com->writeDatabyte(_adjustments.at(index).AddrLow, lowdatabyte))
+	// Write values to control unit:
+	if (!writeAddresses(addresses, data))
 	{
 		resetCUdata();
 		return false;
@@ -540,40 +601,50 @@ bool SSMprotocol2::setAdjustmentValue(unsigned char index, unsigned int rawValue
 bool SSMprotocol2::startActuatorTest(unsigned char actuatorTestIndex)
 {
 	bool ATstarted = false;
-	bool ok = false;
 	bool testmode = false;
 	bool running = false;
-	unsigned char k = 0;
-	// Check if another communication operation is in progress:
-	if (_state != state_normal) return false;
 	// Validate selected test:
 	if (!_has_ActTest || (actuatorTestIndex >= _actuators.size()))
 		return false;
-	// Check if control unit is in test mode:
-	ok = isInTestMode(&testmode);
-	if (!ok || !testmode)
-		return false;
-	// Check that engine is not running:
-	ok = isEngineRunning(&running);
-	if (!ok || running)
+	// Switch from the running test:
+	if (_state == state_ActTesting)
+	{
+		if (_actuatorWriteAddr.at(actuatorTestIndex) == _actuatorWriteAddr.at(_selectedActuatorTestIndex))
+		{
+			// Same actuator bytes: replace the data of the running write operation
+			std::vector<char> & data = _actuatorWriteData.at(actuatorTestIndex);
+			if (!_SSMP2com->setPermanentWriteData(&data.at(0), data.size()))
+			{
+				resetCUdata();
+				return false;
+			}
+			_selectedActuatorTestIndex = actuatorTestIndex;
+			emit startedActuatorTest();
+			return true;
+		}
+		if (!stopActuatorTesting())
+			return false;
+	}
+	// Check if another communication operation is in progress:
+	if (_state != state_normal) return false;
+	// Check that control unit is in test mode and engine is not running:
+	if (!readActuatorTestConditions(&testmode, &running) || !testmode || running)
 		return false;
 	// Change state:
 	_state = state_ActTesting;
-	// Prepare test addresses:
-	unsigned int dataaddr = _actuators.at(actuatorTestIndex).byteadr;
-	char databyte = static_cast<char>(pow(2, _actuators.at(actuatorTestIndex).bitadr - 1));
 	// Stop all actuator tests:
-	for (k=0; k<_allActByteAddr.size(); k++)
+	if (!writeAddresses(_allActByteAddr, std::vector<char>(_allActByteAddr.size(), 0x00)))
 	{
-		if (!_SSMP2com->writeDatabyte(_allActByteAddr.at(k), 0x00))
-		{
-			_state = state_normal; // this avoids that resetCUdata() will try to stop all actuators again
-			resetCUdata();
-			return false;
-		}
+		_state = state_normal; // this avoids that resetCUdata() will try to stop all actuators again
+		resetCUdata();
+		return false;
 	}
 	// Start Actuator Test:
-	ATstarted = _SSMP2com->writeDatabyte_permanent(dataaddr, databyte, 100);
+	std::vector<char> & data = _actuatorWriteData.at(actuatorTestIndex);
+	if (data.size() > 1)
+		ATstarted = _SSMP2com->writeDataBlock_permanent(_actuatorWriteAddr.at(actuatorTestIndex), &data.at(0), data.size(), 100);
+	else
+		ATstarted = _SSMP2com->writeDatabyte_permanent(_actuatorWriteAddr.at(actuatorTestIndex), data.at(0), 100);
 	if (ATstarted)
 	{
 		_selectedActuatorTestIndex = actuatorTestIndex;
@@ -590,20 +661,25 @@ bool SSMprotocol2::startActuatorTest(unsigned char actuatorTestIndex)
 
 bool SSMprotocol2::stopActuatorTesting()
 {
-	unsigned char k = 0;
 	if ((_state == state_needSetup) || (_state == state_normal)) return true;
+	if ((_state == state_resuming) && (_interruptedState == state_ActTesting))
+	{
+		/* NOTE: the actuators are switched off after the connection has been re-established,
+		 *       the test is not restarted                                                     */
+		_interruptedState = state_normal;
+		_stopActuatorsOnResume = true;
+		emit stoppedActuatorTest();
+		return true;
+	}
 	if (_state == state_ActTesting)
 	{
 		if (_SSMP2com->stopCommunication())
 		{
 			// Stop all actuator tests:
-			for (k=0; k<_allActByteAddr.size(); k++)
+			if (!writeAddresses(_allActByteAddr, std::vector<char>(_allActByteAddr.size(), 0x00)))
 			{
-				if (!_SSMP2com->writeDatabyte(_allActByteAddr.at(k), 0x00))
-				{
-					resetCUdata();
-					return false;
-				}
+				resetCUdata();
+				return false;
 			}
 			_state = state_normal;
 			emit stoppedActuatorTest();
@@ -621,30 +697,20 @@ bool SSMprotocol2::stopAllActuators()
 	// NOTE: This function can be called even if no actuator test has been started with SSMprotocol
 	// => When switching the cars ignition on (with engine off) while test mode connector is connected,
 	//    some actuator tests are started automatically
-	unsigned char k = 0;
-	bool ok = false;
 	bool testmode = false;
 	bool enginerunning = false;
 	if (_state != state_normal) return false;
 	// Check if actuator tests are supported:
 	if (!_has_ActTest)
 		return false;
-	// Check if control unit is in test mode:
-	ok = isInTestMode(&testmode);
-	if (!ok || !testmode)
-		return false;
-	// Check that engine is not running:
-	ok = isEngineRunning(&enginerunning);
-	if (!ok || enginerunning)
+	// Check that control unit is in test mode and engine is not running:
+	if (!readActuatorTestConditions(&testmode, &enginerunning) || !testmode || enginerunning)
 		return false;
 	// Stop all actuator tests:
-	for (k=0; k<_allActByteAddr.size(); k++)
+	if (!writeAddresses(_allActByteAddr, std::vector<char>(_allActByteAddr.size(), 0x00)))
 	{
-		if (!_SSMP2com->writeDatabyte(_allActByteAddr.at(k), 0x00))
-		{
-			resetCUdata();
-			return false;
-		}
+		resetCUdata();
+		return false;
 	}
 	return true;
 }
@@ -751,43 +817,29 @@ bool SSMprotocol2::isInTestMode(bool *testmode)
 }
 
 
-bool SSMprotocol2::waitForIgnitionOff()
+bool SSMprotocol2::startIgnitionOffDetection(unsigned int window_ms)
 {
+	unsigned int dataaddr = 0x62;
 	if (_state != state_normal)
 		return false;
-	unsigned int dataaddr = 0x62;
-	_state = state_waitingForIgnOff;
-	_SSMP2com->setRetriesOnError(1);
+	/* NOTE: the window is covered by the first request and the retries.
+	 *       Short timeouts are ok, because the reply has only 1 data byte. */
+	_SSMP2com->setRetriesOnError(SSM_IGNOFF_RETRIES);
+	_SSMP2com->setReadTimeout(window_ms / (SSM_IGNOFF_RETRIES + 1));
+	// Silence: control unit is switched off
+	disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resumeCommunication() ) );
+	connect( _SSMP2com, SIGNAL( commError() ), this, SLOT( finishIgnitionOffDetection() ) );
+	// Ignition switch (if available) reports the ignition state before the control unit is switched off:
 	if (_has_SW_ignition)
+		connect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
+			 this, SLOT( processIgnitionSwitchData(std::vector<char>, int) ) );
+	if (!_SSMP2com->readMultipleDatabytes_permanent('\x0', &dataaddr, 1, SSM_IGNOFF_POLL_INTERVAL_MS))
 	{
-		bool ignstate = true;
-		char data = 0x00;
-		do
-		{
-			if (!_SSMP2com->readMultipleDatabytes('\x0', &dataaddr, 1, &data))
-				ignstate = false;
-			else
-				ignstate = (data & 0x08);
-		} while (ignstate);
-	}
-	else
-	{
-		QEventLoop el;
-		disconnect( _SSMP2com, SIGNAL( commError() ), this, SIGNAL( commError() ) );
-		disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resetCUdata() ) );
-		if(!_SSMP2com->readMultipleDatabytes_permanent('\x0', &dataaddr, 1))
-		{
-			resetCUdata();
-			return false;
-		}
-		connect(_SSMP2com, SIGNAL( commError() ), &el, SLOT( quit() ));
-		el.exec();
-		disconnect(_SSMP2com, SIGNAL( commError() ), &el, SLOT( quit() ));
+		resetCUdata();
+		return false;
 	}
-	_SSMP2com->setRetriesOnError(2);
-	resetCUdata();
+	_state = state_waitingForIgnOff;
 	return true;
-/* NOTE: temporary solution, will become obsolete with new SSMP2communication */
 }
 
 // PRIVATE
@@ -807,12 +859,323 @@ bool SSMprotocol2::validateVIN(char VIN[17])
 }
 
 
+bool SSMprotocol2::setupDCqueryAddrList(int DCgroups, std::vector<unsigned int> *DCqueryAddrList)
+{
+	unsigned char k = 0;
+	DCqueryAddrList->clear();
+	// Check argument:
+	if (DCgroups < 1 || DCgroups > 63) return false;
+	if (((DCgroups & currentDTCs_DCgroup) || (DCgroups & historicDTCs_DCgroup)) && ((DCgroups & temporaryDTCs_DCgroup) || (DCgroups & memorizedDTCs_DCgroup)))
+		return false;
+	if (DCgroups > 15)
+	{
+		if (!_has_integratedCC)
+			return false;
+		if ( (DCgroups > 31) && (!_memCCs_supported) )
+			return false;
+	}
+	// Setup diagnostic codes addresses list:
+	if ((DCgroups & currentDTCs_DCgroup) || (DCgroups & temporaryDTCs_DCgroup))	// current/temporary DTCs
+	{
+		if (_CU == CUtype_Engine)
+			DCqueryAddrList->push_back( 0x000061 );
+		for (k=0; k<_DTCdefs.size(); k++)
+			DCqueryAddrList->push_back( _DTCdefs.at(k).byteAddr_currentOrTempOrLatest );
+	}	
+	if ((DCgroups & historicDTCs_DCgroup) || (DCgroups & memorizedDTCs_DCgroup))	// historic/memorized DTCs
+	{
+		for (k=0; k<_DTCdefs.size(); k++)
+			DCqueryAddrList->push_back( _DTCdefs.at(k).byteAddr_historicOrMemorized );
+	}
+	if (_has_integratedCC)
+	{
+		if (DCgroups & CClatestCCs_DCgroup)	// CC latest cancel codes
+		{
+			for (k=0; k<_CCCCdefs.size(); k++)
+				DCqueryAddrList->push_back( _CCCCdefs.at(k).byteAddr_currentOrTempOrLatest );
+		}
+		if ((DCgroups & CCmemorizedCCs_DCgroup) && _memCCs_supported)	// CC memorized cancel codes
+		{
+			for (k=0; k<_CCCCdefs.size(); k++)
+				DCqueryAddrList->push_back( _CCCCdefs.at(k).byteAddr_historicOrMemorized );
+		}
+	}
+	// Check if min. 1 address to read:
+	if ((DCqueryAddrList->size() < 1) || ((DCqueryAddrList->at(0) == 0x000061) && (DCqueryAddrList->size() < 2)))
+		return false;
+	return true;
+}
+
+
+void SSMprotocol2::setupDCevaluation()
+{
+	SSMprotocol::setupDCevaluation();
+	_latestCCCCsEvaluator.setup(_CCCCdefs, false);
+	_memorizedCCCCsEvaluator.setup(_CCCCdefs, true);
+}
+
+
+bool SSMprotocol2::readAddresses(std::vector<unsigned int> addresses, std::vector<char> *data)
+{
+	/* NOTE: the requested addresses are read with as few requests as possible:
+	 *       - runs of consecutive addresses with at least SSM2_MIN_BLOCK_READ_LEN bytes: block read (A0)
+	 *       - all other addresses: multiple address read (A8) with max. SSM2_MAX_ADDRESSES_PER_READ addresses
+	 *       Duplicate addresses are read only once.                                                        */
+	std::vector<unsigned int> sortedAddr = addresses;
+	std::vector<unsigned int> multiAddr;
+	std::map<unsigned int, char> values;
+	unsigned int runStart = 0;
+	unsigned int runEnd = 0;
+	unsigned int k = 0;
+	if (addresses.empty()) return false;
+	std::sort(sortedAddr.begin(), sortedAddr.end());
+	sortedAddr.erase(std::unique(sortedAddr.begin(), sortedAddr.end()), sortedAddr.end());
+	while (runStart < sortedAddr.size())
+	{
+		// Find end of the run of consecutive addresses:
+		runEnd = runStart + 1;
+		while ((runEnd < sortedAddr.size()) && (sortedAddr.at(runEnd) == (sortedAddr.at(runEnd-1) + 1)) && ((runEnd - runStart) < SSM2_MAX_BLOCK_READ_LEN))
+			runEnd++;
+		if (_blockReadSupported && ((runEnd - runStart) >= SSM2_MIN_BLOCK_READ_LEN))
+		{
+			std::vector<char> blockdata(runEnd - runStart, 0);
+			if (_SSMP2com->readDataBlock('\x0', sortedAddr.at(runStart), blockdata.size(), &blockdata.at(0)))
+			{
+				for (k=0; k<blockdata.size(); k++)
+					values[sortedAddr.at(runStart + k)] = blockdata.at(k);
+				runStart = runEnd;
+				continue;
+			}
+			// Block read rejected by this control unit: use multiple address reads from now on
+			if (_SSMP2com->lastRequestRejected())
+				_blockReadSupported = false;
+			// NOTE: communication errors: multiple address reads for this run only
+		}
+		for (k=runStart; k<runEnd; k++)
+			multiAddr.push_back( sortedAddr.at(k) );
+		runStart = runEnd;
+	}
+	// Multiple address reads:
+	for (runStart=0; runStart<multiAddr.size(); runStart+=SSM2_MAX_ADDRESSES_PER_READ)
+	{
+		unsigned int len = std::min(static_cast<unsigned int>(multiAddr.size() - runStart), static_cast<unsigned int>(SSM2_MAX_ADDRESSES_PER_READ));
+		std::vector<char> multidata(len, 0);
+		if (!_SSMP2com->readMultipleDatabytes('\x0', &multiAddr.at(runStart), len, &multidata.at(0)))
+			return false;
+		for (k=0; k<len; k++)
+			values[multiAddr.at(runStart + k)] = multidata.at(k);
+	}
+	// Return data in the order of the requested addresses:
+	data->clear();
+	for (k=0; k<addresses.size(); k++)
+		data->push_back( values[addresses.at(k)] );
+	return true;
+}
+
+
+bool SSMprotocol2::writeAddresses(std::vector<unsigned int> addresses, std::vector<char> data)
+{
+	/* NOTE: runs of consecutive addresses are written with a single block write (B0).
+	 *       The control unit echoes the written data, which is verified for each address. */
+	std::map<unsigned int, char> values;
+	std::map<unsigned int, char>::iterator it;
+	std::vector<unsigned int> blockAddr;
+	std::vector<char> blockData;
+	unsigned int k = 0;
+	if (addresses.empty() || (addresses.size() != data.size())) return false;
+	// Sort by address, reject conflicting values for the same address:
+	for (k=0; k<addresses.size(); k++)
+	{
+		it = values.find(addresses.at(k));
+		if ((it != values.end()) && (it->second != data.at(k)))
+			return false;
+		values[addresses.at(k)] = data.at(k);
+	}
+	it = values.begin();
+	while (it != values.end())
+	{
+		// Collect run of consecutive addresses:
+		blockAddr.clear();
+		blockData.clear();
+		do
+		{
+			blockAddr.push_back(it->first);
+			blockData.push_back(it->second);
+			it++;
+		} while ((it != values.end()) && (it->first == (blockAddr.back() + 1)) && (blockData.size() < SSM2_MAX_BLOCK_WRITE_LEN));
+		// Write data:
+		if (blockData.size() > 1)
+		{
+			if (!_SSMP2com->writeDataBlock(blockAddr.at(0), &blockData.at(0), blockData.size()))
+				return false;
+		}
+		else if (!_SSMP2com->writeDatabyte(blockAddr.at(0), blockData.at(0)))
+			return false;
+	}
+	return true;
+}
+
+
+void SSMprotocol2::setupActuatorTestWriteData()
+{
+	/* NOTE: the actuator bytes are grouped into runs of consecutive addresses.
+	 *       Each test writes the whole run (with only its own bit set), so switching
+	 *       between tests of the same run only changes the written data.         */
+	std::vector<unsigned int> sortedAddr = _allActByteAddr;
+	unsigned int runStart = 0;
+	unsigned int runEnd = 0;
+	std::sort(sortedAddr.begin(), sortedAddr.end());
+	_actuatorWriteAddr.clear();
+	_actuatorWriteData.clear();
+	for (unsigned int k=0; k<_actuators.size(); k++)
+	{
+		// Find the run of consecutive actuator byte addresses which contains the byte of this test:
+		runStart = 0;
+		while (runStart < sortedAddr.size())
+		{
+			runEnd = runStart + 1;
+			while ((runEnd < sortedAddr.size()) && (sortedAddr.at(runEnd) == (sortedAddr.at(runEnd-1) + 1)) && ((runEnd - runStart) < SSM2_MAX_BLOCK_WRITE_LEN))
+				runEnd++;
+			if (sortedAddr.at(runEnd-1) >= _actuators.at(k).byteadr)
+				break;
+			runStart = runEnd;
+		}
+		// Setup bit pattern:
+		std::vector<char> data(runEnd - runStart, 0x00);
+		data.at(_actuators.at(k).byteadr - sortedAddr.at(runStart)) = static_cast<char>(1 << (_actuators.at(k).bitadr - 1));
+		_actuatorWriteAddr.push_back( sortedAddr.at(runStart) );
+		_actuatorWriteData.push_back( data );
+	}
+}
+
+
+bool SSMprotocol2::readActuatorTestConditions(bool *testmode, bool *enginerunning)
+{
+	std::vector<unsigned int> dataaddr;
+	std::vector<char> data;
+	if ((_state != state_normal) || !_has_TestMode || !_has_MB_engineSpeed) return false;
+	// Read test mode flag and engine speed (high byte) with a single request:
+	dataaddr.push_back(0x61);
+	dataaddr.push_back(0x0e);
+	if (!readAddresses(dataaddr, &data))
+	{
+		resetCUdata();
+		return false;
+	}
+	*testmode = (data.at(0) & 0x20);
+	*enginerunning = (static_cast<unsigned char>(data.at(1)) > 3);
+	return true;
+}
+
+
+void SSMprotocol2::resumeCommunication()
+{
+	/* NOTE: only permanent operations emit commError(), so there is always an operation to restart.
+	 *       Actuator tests are restarted, too: startActuatorTest() checks test mode and engine state again. */
+	if ((_state != state_DCreading) && (_state != state_MBSWreading) && (_state != state_ActTesting))
+	{
+		emit commError();
+		resetCUdata();
+		return;
+	}
+	_interruptedState = _state;
+	_resumeProtocol = _diagInterface->protocolType();
+	_resumeTime.start();
+	// Discard the failed communication object (keeps control unit data and selections):
+	disconnect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resumeCommunication() ) );
+	disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
+		    this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
+	disconnect( _SSMP2com, SIGNAL( recievedData(std::vector<char>, int) ),
+		    this, SLOT( processMBSWrawData(std::vector<char>, int) ) );
+	disconnect( _SSMP2com, SIGNAL( recievedSecondaryData(std::vector<char>, int) ),
+		    this, SLOT( processDCsRawdata(std::vector<char>, int) ) );
+	suspendMBSWdataSource();
+	_SSMP2com->stopCommunication();
+	delete _SSMP2com;
+	_SSMP2com = NULL;
+	// NOTE: no other operations are accepted while resuming, stopping the interrupted operation cancels its restart
+	_state = state_resuming;
+	emit commInterrupted();
+	// Re-establish the connection from the event loop (see retryResume()):
+	if (_state == state_resuming)
+		_resumeTimer.start(0);
+}
+
+
+void SSMprotocol2::retryResume()
+{
+	char SYS_ID[3] = {0,};
+	char ROM_ID[5] = {0,};
+	char flagbytes[96];
+	unsigned char nrofflagbytes = 0;
+	state_dt interruptedState = state_normal;
+	bool stopActuators = false;
+	bool ok = false;
+	bool otherCU = false;
+	if (_state != state_resuming) return;
+	// Re-establish the connection and verify the identity of the control unit:
+	_diagInterface->disconnect();
+	if (_diagInterface->connect(_resumeProtocol))
+	{
+		if (_SSMP2com == NULL)
+			_SSMP2com = new SSMP2communication(_diagInterface, _CUaddress, 1);
+		if (_SSMP2com->getCUdata(SYS_ID, ROM_ID, flagbytes, &nrofflagbytes))
+		{
+			otherCU = (memcmp(SYS_ID, _SYS_ID, 3) || memcmp(ROM_ID, _ROM_ID, 5));
+			ok = !otherCU;
+		}
+	}
+	// NOTE: the operation may have been stopped or the control unit data may have been reset meanwhile
+	if (_state != state_resuming) return;
+	if (otherCU)
+		goto error;
+	interruptedState = _interruptedState;
+	stopActuators = _stopActuatorsOnResume;
+	if (!ok)
+	{
+		if (_resumeTime.elapsed() >= SSM_RESUME_TIMEOUT_MS)
+			goto error;
+		_resumeTimer.start(SSM_RESUME_RETRY_INTERVAL_MS);
+		return;
+	}
+	_SSMP2com->setRetriesOnError(2);
+	connect( _SSMP2com, SIGNAL( commError() ), this, SLOT( resumeCommunication() ) );
+	_blockReadSupported = true;	// new connection
+	_state = state_normal;
+	_interruptedState = state_normal;
+	_stopActuatorsOnResume = false;
+	// Mark the interruption in the MB/SW log:
+	markMBSWgap(_resumeTime.elapsed());
+	// Restart the interrupted operation with the same selection:
+	if (interruptedState == state_DCreading)
+		ok = restartDCreading();
+	else if (interruptedState == state_MBSWreading)
+		ok = restartMBSWreading();
+	else if (interruptedState == state_ActTesting)
+		ok = restartActuatorTest();
+	else if (stopActuators)
+	{
+		// Actuator test has been stopped while resuming:
+		stopAllActuators();
+		ok = (_state == state_normal);	// NOTE: false return value without communication error if test mode is not active
+	}
+	if (!ok)
+		goto error;
+	emit commResumed();
+	return;
+
+error:
+	emit commError();
+	resetCUdata();
+}
+
+
 void SSMprotocol2::processDCsRawdata(std::vector<char> DCrawdata, int duration_ms)
 {
-	QStringList DCs;
-	QStringList DCdescriptions;
-	QStringList tmpDTCs;
-	QStringList tmpDTCsDescriptions;
+	QStringList setDCs;
+	QStringList setDCdescriptions;
+	QStringList clearedDCs;
+	QStringList clearedDCdescriptions;
 	unsigned int rawDataIndex = 0;
 
 	// Process DTCs raw data:
@@ -820,31 +1183,27 @@ void SSMprotocol2::processDCsRawdata(std::vector<char> DCrawdata, int duration_m
 	// Process CCCCs raw data:
 	if (_selectedDCgroups == (_selectedDCgroups | CClatestCCs_DCgroup))
 	{
-		DCs.clear();
-		DCdescriptions.clear();
 		// Evaluate latest CC cancel codes:
-		for (unsigned int CCCCdefs_index=0; CCCCdefs_index<_CCCCdefs.size(); CCCCdefs_index++)
+		if (DCrawdata.size() < rawDataIndex + _latestCCCCsEvaluator.nrOfBytes())
+			return;
+		if (_latestCCCCsEvaluator.evaluate(&DCrawdata.at(rawDataIndex), &setDCs, &setDCdescriptions, &clearedDCs, &clearedDCdescriptions))
 		{
-			evaluateDCdataByte(_CCCCdefs.at(CCCCdefs_index).byteAddr_currentOrTempOrLatest, DCrawdata.at(rawDataIndex), _CCCCdefs, &tmpDTCs, &tmpDTCsDescriptions);
-			DCs += tmpDTCs;
-			DCdescriptions += tmpDTCsDescriptions;
-			rawDataIndex++;
+			emit changedDCs(CClatestCCs_DCgroup, setDCs, setDCdescriptions, clearedDCs, clearedDCdescriptions);
+			emit latestCCCCs(_latestCCCCsEvaluator.DCs(), _latestCCCCsEvaluator.DCdescriptions());
 		}
-		emit latestCCCCs(DCs, DCdescriptions);
+		rawDataIndex += _latestCCCCsEvaluator.nrOfBytes();
 	}
 	if (_selectedDCgroups == (_selectedDCgroups | CCmemorizedCCs_DCgroup))
 	{
-		DCs.clear();
-		DCdescriptions.clear();
 		// Evaluate memorized CC cancel codes:
-		for (unsigned int CCCCdefs_index=0; CCCCdefs_index<_CCCCdefs.size(); CCCCdefs_index++)
+		if (DCrawdata.size() < rawDataIndex + _memorizedCCCCsEvaluator.nrOfBytes())
+			return;
+		if (_memorizedCCCCsEvaluator.evaluate(&DCrawdata.at(rawDataIndex), &setDCs, &setDCdescriptions, &clearedDCs, &clearedDCdescriptions))
 		{
-			evaluateDCdataByte(_CCCCdefs.at(CCCCdefs_index).byteAddr_historicOrMemorized, DCrawdata.at(rawDataIndex), _CCCCdefs, &tmpDTCs, &tmpDTCsDescriptions);
-			DCs += tmpDTCs;
-			DCdescriptions += tmpDTCsDescriptions;
-			rawDataIndex++;
+			emit changedDCs(CCmemorizedCCs_DCgroup, setDCs, setDCdescriptions, clearedDCs, clearedDCdescriptions);
+			emit memorizedCCCCs(_memorizedCCCCsEvaluator.DCs(), _memorizedCCCCsEvaluator.DCdescriptions());
 		}
-		emit memorizedCCCCs(DCs, DCdescriptions);
+		rawDataIndex += _memorizedCCCCsEvaluator.nrOfBytes();
 	}
 }
 
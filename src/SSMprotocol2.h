@@ -23,13 +23,22 @@
 
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <math.h>
+#include <QTimer>
 #include "AbstractDiagInterface.h"
 #include "SSMprotocol.h"
 #include "SSMP2communication.h"
 #include "SSM2definitionsInterface.h"
 
 
+#define		SSM2_MAX_ADDRESSES_PER_READ	84	// ISO14230 limit for multiple address reads (A8)
+#define		SSM2_MIN_BLOCK_READ_LEN		8	// min. nr. of consecutive addresses for block reads (A0)
+#define		SSM2_MAX_BLOCK_READ_LEN		254	// ISO14230 limit for block reads (A0)
+#define		SSM2_MAX_BLOCK_WRITE_LEN	251	// ISO14230 limit for block writes (B0)
+
+
 
 class SSMprotocol2 : public SSMprotocol, private SSMprotocol2_ID
 {
@@ -53,9 +62,11 @@ public:
 	bool stopDCreading();
 	bool startMBSWreading(std::vector<MBSWmetadata_dt> mbswmetaList);
 	bool stopMBSWreading();
+	bool setCombinedDCreading(int DCgroups, unsigned int divisor=10);
 	bool getAdjustmentValue(unsigned char index, unsigned int *rawValue);
 	bool getAllAdjustmentValues(std::vector<unsigned int> * rawValues);
 	bool setAdjustmentValue(unsigned char index, unsigned int rawValue);
+	bool setAllAdjustmentValues(std::vector<unsigned int> rawValues);
 	bool startActuatorTest(unsigned char actuatorTestIndex);
 	bool stopActuatorTesting();
 	bool stopAllActuators();
@@ -63,10 +74,12 @@ public:
 	bool testImmobilizerCommLine(immoTestResult_dt *result);
 	bool isEngineRunning(bool *isrunning);
 	bool isInTestMode(bool *testmode);
-	bool waitForIgnitionOff();
+	bool startIgnitionOffDetection(unsigned int window_ms = SSM_IGNOFF_DETECTION_WINDOW_MS);
 
 private:
 	SSMP2communication *_SSMP2com;
+	unsigned int _CUaddress;
+	bool _blockReadSupported;
 	// *** CONTROL UNIT BASIC DATA (SUPPORTED FEATURES) ***:
 	bool _has_CM;
 	bool _has_CM2;
@@ -75,11 +88,29 @@ private:
 	// Cruise Control Cancel Codes:
 	std::vector<dc_defs_dt> _CCCCdefs;
 	bool _memCCs_supported;
+	DCevaluator _latestCCCCsEvaluator;
+	DCevaluator _memorizedCCCCsEvaluator;
+	// Actuator tests (start address and data of the write operation for each test):
+	std::vector<unsigned int> _actuatorWriteAddr;
+	std::vector< std::vector<char> > _actuatorWriteData;
+	// Automatic resume after communication errors:
+	QTimer _resumeTimer;
+	QElapsedTimer _resumeTime;
+	AbstractDiagInterface::protocol_type _resumeProtocol;
+	bool _stopActuatorsOnResume;
 
 	bool validateVIN(char VIN[17]);
+	bool readAddresses(std::vector<unsigned int> addresses, std::vector<char> *data);
+	bool writeAddresses(std::vector<unsigned int> addresses, std::vector<char> data);
+	void setupActuatorTestWriteData();
+	bool readActuatorTestConditions(bool *testmode, bool *enginerunning);
+	bool setupDCqueryAddrList(int DCgroups, std::vector<unsigned int> *DCqueryAddrList);
+	void setupDCevaluation();
 
 private slots:
 	void processDCsRawdata(std::vector<char> dcrawdata, int duration_ms);
+	void resumeCommunication();
+	void retryResume();
 
 public slots:
 	void resetCUdata();
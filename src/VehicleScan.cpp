@@ -0,0 +1,458 @@
+/*
+ * VehicleScan.cpp - Scan of all control units of a vehicle
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VehicleScan.h"
+#include <QDataStream>
+#include <QFile>
+#include <QDir>
+
+
+QMutex VehicleTopologyCache::_mutex;
+bool VehicleTopologyCache::_loaded = false;
+std::vector<vehicleTopology_dt> VehicleTopologyCache::_topologies;
+
+
+
+vehicleCU_dt::vehicleCU_dt()
+{
+	CUtype = SSMprotocol::CUtype_Engine;
+	protocol = AbstractDiagInterface::protocol_NONE;
+	nrOfCurrentOrTempDTCs = -1;
+	nrOfHistoricOrMemDTCs = -1;
+}
+
+
+
+static QDataStream & operator<<(QDataStream & out, const vehicleCU_dt & cu)
+{
+	return out << static_cast<qint32>(cu.CUtype) << static_cast<qint32>(cu.protocol) << cu.SYS_ID << cu.ROM_ID
+		   << cu.description << static_cast<qint32>(cu.nrOfCurrentOrTempDTCs) << static_cast<qint32>(cu.nrOfHistoricOrMemDTCs);
+}
+
+
+static QDataStream & operator>>(QDataStream & in, vehicleCU_dt & cu)
+{
+	qint32 CUtype = 0, protocol = 0, nrOfCurrentOrTempDTCs = -1, nrOfHistoricOrMemDTCs = -1;
+	in >> CUtype >> protocol >> cu.SYS_ID >> cu.ROM_ID >> cu.description >> nrOfCurrentOrTempDTCs >> nrOfHistoricOrMemDTCs;
+	cu.CUtype = static_cast<SSMprotocol::CUtype_dt>(CUtype);
+	cu.protocol = static_cast<AbstractDiagInterface::protocol_type>(protocol);
+	cu.nrOfCurrentOrTempDTCs = nrOfCurrentOrTempDTCs;
+	cu.nrOfHistoricOrMemDTCs = nrOfHistoricOrMemDTCs;
+	return in;
+}
+
+
+static QDataStream & operator<<(QDataStream & out, const vehicleTopology_dt & topology)
+{
+	out << topology.key << topology.VIN << topology.scanTime << static_cast<quint32>(topology.CUs.size());
+	for (unsigned int k=0; k<topology.CUs.size(); k++)
+		out << topology.CUs.at(k);
+	return out;
+}
+
+
+static QDataStream & operator>>(QDataStream & in, vehicleTopology_dt & topology)
+{
+	quint32 nrOfCUs = 0;
+	in >> topology.key >> topology.VIN >> topology.scanTime >> nrOfCUs;
+	topology.CUs.clear();
+	for (unsigned int k=0; (k<nrOfCUs) && (in.status() == QDataStream::Ok); k++)
+	{
+		vehicleCU_dt cu;
+		in >> cu;
+		topology.CUs.push_back(cu);
+	}
+	return in;
+}
+
+
+
+bool VehicleTopologyCache::lookup(QString key, vehicleTopology_dt *topology)
+{
+	QMutexLocker locker(&_mutex);
+	load();
+	for (unsigned int k=0; k<_topologies.size(); k++)
+	{
+		if (_topologies.at(k).key == key)
+		{
+			*topology = _topologies.at(k);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void VehicleTopologyCache::preferLastProtocol(SSMprotocol::CUtype_dt CU, std::vector<AbstractDiagInterface::protocol_type> *protocols)
+{
+	/* NOTE: only the SSM2-protocols are reordered, SSM1 must always be probed last:
+	 *       with serial pass through (K)KL-interfaces, the interface echo could be detected as a SSM1-ROM-ID */
+	AbstractDiagInterface::protocol_type protocol = AbstractDiagInterface::protocol_NONE;
+	QMutexLocker locker(&_mutex);
+	load();
+	if (_topologies.empty())
+		return;
+	for (unsigned int k=0; k<_topologies.at(0).CUs.size(); k++)
+	{
+		if (_topologies.at(0).CUs.at(k).CUtype == CU)
+		{
+			protocol = _topologies.at(0).CUs.at(k).protocol;
+			break;
+		}
+	}
+	if ((protocol == AbstractDiagInterface::protocol_NONE) || (protocol == AbstractDiagInterface::protocol_SSM1))
+		return;
+	std::vector<AbstractDiagInterface::protocol_type>::iterator it = std::find(protocols->begin(), protocols->end(), protocol);
+	if (it != protocols->end())
+	{
+		protocols->erase(it);
+		protocols->insert(protocols->begin(), protocol);
+	}
+}
+
+
+void VehicleTopologyCache::store(const vehicleTopology_dt & topology)
+{
+	vehicleTopology_dt merged = topology;
+	QMutexLocker locker(&_mutex);
+	load();
+	for (unsigned int k=0; k<_topologies.size(); k++)
+	{
+		if (_topologies.at(k).key == topology.key)
+		{
+			// Merge: keep the control units which have not been found by the new scan
+			for (unsigned int c=0; c<_topologies.at(k).CUs.size(); c++)
+			{
+				bool found = false;
+				for (unsigned int n=0; n<merged.CUs.size(); n++)
+				{
+					if (merged.CUs.at(n).CUtype == _topologies.at(k).CUs.at(c).CUtype)
+					{
+						found = true;
+						break;
+					}
+				}
+				if (!found)
+					merged.CUs.push_back(_topologies.at(k).CUs.at(c));
+			}
+			if (merged.VIN.isEmpty())
+				merged.VIN = _topologies.at(k).VIN;
+			_topologies.erase(_topologies.begin() + k);
+			break;
+		}
+	}
+	_topologies.insert(_topologies.begin(), merged);
+	if (_topologies.size() > VEHICLE_TOPOLOGY_MAX_VEHICLES)
+		_topologies.resize(VEHICLE_TOPOLOGY_MAX_VEHICLES);
+	save();
+}
+
+// PRIVATE
+
+QString VehicleTopologyCache::filename()
+{
+	return QDir::homePath() + "/" + CU_SETUP_CACHE_DIRNAME + "/" + VEHICLE_TOPOLOGY_FILENAME;
+}
+
+
+void VehicleTopologyCache::load()
+{
+	QByteArray magic;
+	quint16 version = 0;
+	quint32 nrOfTopologies = 0;
+	if (_loaded) return;
+	_loaded = true;
+	QFile file(filename());
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_5);
+	in >> magic >> version;
+	if ((magic != "FSSMVTOP") || (version != VEHICLE_TOPOLOGY_FORMAT_VERSION))
+		return;
+	in >> nrOfTopologies;
+	for (unsigned int k=0; (k<nrOfTopologies) && (k<VEHICLE_TOPOLOGY_MAX_VEHICLES); k++)
+	{
+		vehicleTopology_dt topology;
+		in >> topology;
+		if (in.status() != QDataStream::Ok)
+			break;
+		_topologies.push_back(topology);
+	}
+	if (in.status() != QDataStream::Ok)
+		_topologies.clear();	// Corrupted file: discard all data
+}
+
+
+bool VehicleTopologyCache::save()
+{
+	QByteArray data;
+	QDataStream out(&data, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_4_5);
+	out << QByteArray("FSSMVTOP") << static_cast<quint16>(VEHICLE_TOPOLOGY_FORMAT_VERSION);
+	out << static_cast<quint32>(_topologies.size());
+	for (unsigned int k=0; k<_topologies.size(); k++)
+		out << _topologies.at(k);
+	// Write to a temporary file first, an incomplete file must never be used:
+	if (!QDir().mkpath(QDir::homePath() + "/" + CU_SETUP_CACHE_DIRNAME))
+		return false;
+	QFile file(filename() + ".tmp");
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	bool ok = (file.write(data) == data.size());
+	file.close();
+	if (ok)
+	{
+		QFile::remove(filename());
+		ok = QFile::rename(filename() + ".tmp", filename());
+	}
+	if (!ok)
+		QFile::remove(filename() + ".tmp");
+	return ok;
+}
+
+
+
+VehicleScanner::VehicleScanner(AbstractDiagInterface *diagInterface, QString language)
+{
+	_diagInterface = diagInterface;
+	_language = language;
+	_pendingDTCsignals = 0;
+	_nrOfCurrentOrTempDTCs = -1;
+	_nrOfHistoricOrMemDTCs = -1;
+	_DTCtimer.setSingleShot(true);
+	connect( &_DTCtimer, SIGNAL( timeout() ), &_el, SLOT( quit() ) );
+}
+
+
+bool VehicleScanner::scan(vehicleTopology_dt *topology, bool useKnownTopology)
+{
+	const SSMprotocol::CUtype_dt CUtypes[8] = {SSMprotocol::CUtype_Engine, SSMprotocol::CUtype_Transmission,
+						   SSMprotocol::CUtype_CruiseControl, SSMprotocol::CUtype_AirCon,
+						   SSMprotocol::CUtype_FourWheelSteering, SSMprotocol::CUtype_ABS,
+						   SSMprotocol::CUtype_AirSuspension, SSMprotocol::CUtype_PowerSteering};
+	vehicleTopology_dt knownTopology;
+	vehicleCU_dt vehicleCU;
+	std::vector<AbstractDiagInterface::protocol_type> protocols;
+	bool known = false;
+	unsigned int k = 0;
+	topology->key.clear();
+	topology->VIN.clear();
+	topology->CUs.clear();
+	_VIN.clear();
+	// Probe engine control unit (identifies the vehicle):
+	protocols = candidateProtocols(SSMprotocol::CUtype_Engine);
+	for (k=0; k<protocols.size(); k++)
+	{
+		if (probeControlUnit(SSMprotocol::CUtype_Engine, protocols.at(k), &vehicleCU))
+		{
+			topology->CUs.push_back(vehicleCU);
+			break;
+		}
+	}
+	if (topology->CUs.size())
+	{
+		if (_VIN.size())
+			topology->key = "VIN_" + _VIN;
+		else
+			topology->key = "ROM_" + topology->CUs.at(0).ROM_ID;
+		known = (useKnownTopology && VehicleTopologyCache::lookup(topology->key, &knownTopology));
+	}
+	if (known)
+	{
+		// Known vehicle: probe only the known control units with their protocol
+		for (k=0; k<knownTopology.CUs.size(); k++)
+		{
+			if (knownTopology.CUs.at(k).CUtype == SSMprotocol::CUtype_Engine)
+				continue;
+			if (probeControlUnit(knownTopology.CUs.at(k).CUtype, knownTopology.CUs.at(k).protocol, &vehicleCU))
+				topology->CUs.push_back(vehicleCU);
+		}
+	}
+	else
+	{
+		// Unknown vehicle: probe all other control units
+		for (unsigned char c=1; c<8; c++)
+		{
+			protocols = candidateProtocols(CUtypes[c]);
+			for (k=0; k<protocols.size(); k++)
+			{
+				if (probeControlUnit(CUtypes[c], protocols.at(k), &vehicleCU))
+				{
+					topology->CUs.push_back(vehicleCU);
+					break;
+				}
+			}
+		}
+		if (topology->CUs.empty())
+			return false;
+		if (topology->key.isEmpty())
+			topology->key = "ROM_" + topology->CUs.at(0).ROM_ID;
+	}
+	// Save topology:
+	topology->VIN = _VIN;
+	topology->scanTime = QDateTime::currentDateTime();
+	VehicleTopologyCache::store(*topology);
+	return true;
+}
+
+// PRIVATE
+
+std::vector<AbstractDiagInterface::protocol_type> VehicleScanner::candidateProtocols(SSMprotocol::CUtype_dt CU)
+{
+	/* NOTE: probe SSM2-protocols first (see ControlUnitDialog::probeProtocol()) */
+	std::vector<AbstractDiagInterface::protocol_type> candidates;
+	std::vector<AbstractDiagInterface::protocol_type> protocols;
+	std::vector<AbstractDiagInterface::protocol_type> supportedProtocols = _diagInterface->supportedProtocols();
+	if ((CU == SSMprotocol::CUtype_Engine) || (CU == SSMprotocol::CUtype_Transmission))
+	{
+		candidates.push_back(AbstractDiagInterface::protocol_SSM2_ISO15765);
+		candidates.push_back(AbstractDiagInterface::protocol_SSM2_ISO14230);
+	}
+	candidates.push_back(AbstractDiagInterface::protocol_SSM1);
+	// Skip protocols which are not supported by the interface:
+	for (unsigned int k=0; k<candidates.size(); k++)
+	{
+		if (supportedProtocols.empty() || (std::find(supportedProtocols.begin(), supportedProtocols.end(), candidates.at(k)) != supportedProtocols.end()))
+			protocols.push_back(candidates.at(k));
+	}
+	// Probe the SSM2-protocol of the last scanned vehicle first:
+	VehicleTopologyCache::preferLastProtocol(CU, &protocols);
+	return protocols;
+}
+
+
+bool VehicleScanner::probeControlUnit(SSMprotocol::CUtype_dt CU, AbstractDiagInterface::protocol_type protocol, vehicleCU_dt *vehicleCU)
+{
+	SSMprotocol *SSMPdev = NULL;
+	SSMprotocol::CUsetupResult_dt result = SSMprotocol::result_commError;
+	bool VINsup = false;
+	if (!_diagInterface->connect(protocol))
+		return false;
+	if (protocol == AbstractDiagInterface::protocol_SSM1)
+		SSMPdev = new SSMprotocol1(_diagInterface, _language);
+	else
+		SSMPdev = new SSMprotocol2(_diagInterface, _language);
+	result = SSMPdev->setupCUdata(CU);
+	bool ok = ((result == SSMprotocol::result_success) || (result == SSMprotocol::result_noOrInvalidDefsFile) || (result == SSMprotocol::result_noDefs));
+	if (ok)
+	{
+		*vehicleCU = vehicleCU_dt();
+		vehicleCU->CUtype = CU;
+		vehicleCU->protocol = protocol;
+		vehicleCU->SYS_ID = QString::fromStdString(SSMPdev->getSysID());
+		vehicleCU->ROM_ID = QString::fromStdString(SSMPdev->getROMID());
+		SSMPdev->getSystemDescription(&vehicleCU->description);
+		if (result == SSMprotocol::result_success)
+		{
+			readDTCcounts(SSMPdev, vehicleCU);
+			if (_VIN.isEmpty() && SSMPdev->hasVINsupport(&VINsup) && VINsup)
+				SSMPdev->getVIN(&_VIN);
+		}
+	}
+	delete SSMPdev;
+	_diagInterface->disconnect();
+#ifdef __FSSM_DEBUG__
+	std::cout << "VehicleScanner::probeControlUnit():   CU type " << std::dec << CU << ", protocol " << protocol << ": ";
+	if (ok)
+		std::cout << "found, SYS-ID " << vehicleCU->SYS_ID.toStdString() << ", ROM-ID " << vehicleCU->ROM_ID.toStdString() << '\n';
+	else
+		std::cout << "no reply\n";
+#endif
+	return ok;
+}
+
+
+bool VehicleScanner::readDTCcounts(SSMprotocol *SSMPdev, vehicleCU_dt *vehicleCU)
+{
+	int DCgroups = 0;
+	const int currentOrTempDCgroups = SSMprotocol::currentDTCs_DCgroup | SSMprotocol::temporaryDTCs_DCgroup;
+	const int historicOrMemDCgroups = SSMprotocol::historicDTCs_DCgroup | SSMprotocol::memorizedDTCs_DCgroup;
+	if (!SSMPdev->getSupportedDCgroups(&DCgroups))
+		return false;
+	// NOTE: Cruise Control Cancel Codes are not counted
+	DCgroups &= (currentOrTempDCgroups | historicOrMemDCgroups);
+	_nrOfCurrentOrTempDTCs = -1;
+	_nrOfHistoricOrMemDTCs = -1;
+	_pendingDTCsignals = 0;
+	if (DCgroups & currentOrTempDCgroups)
+		_pendingDTCsignals++;
+	if (DCgroups & historicOrMemDCgroups)
+		_pendingDTCsignals++;
+	if (_pendingDTCsignals)
+	{
+		/* NOTE: the DTC signals are always emitted for the first data received,
+		 *       so we only have to wait for the first data of each group */
+		connect( SSMPdev, SIGNAL( currentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ),
+			 this, SLOT( processCurrentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ) );
+		connect( SSMPdev, SIGNAL( historicOrMemorizedDTCs(QStringList, QStringList) ),
+			 this, SLOT( processHistoricOrMemorizedDTCs(QStringList, QStringList) ) );
+		connect( SSMPdev, SIGNAL( commError() ), &_el, SLOT( quit() ) );
+		if (SSMPdev->startDCreading(DCgroups))
+		{
+			_DTCtimer.start(VEHICLESCAN_DTC_TIMEOUT_MS);
+			_el.exec();
+			_DTCtimer.stop();
+			SSMPdev->stopDCreading();
+		}
+		disconnect( SSMPdev, SIGNAL( currentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ),
+			    this, SLOT( processCurrentOrTemporaryDTCs(QStringList, QStringList, bool, bool) ) );
+		disconnect( SSMPdev, SIGNAL( historicOrMemorizedDTCs(QStringList, QStringList) ),
+			    this, SLOT( processHistoricOrMemorizedDTCs(QStringList, QStringList) ) );
+		disconnect( SSMPdev, SIGNAL( commError() ), &_el, SLOT( quit() ) );
+	}
+	else	// no DTCs supported
+	{
+		_nrOfCurrentOrTempDTCs = 0;
+		_nrOfHistoricOrMemDTCs = 0;
+	}
+	if (DCgroups & currentOrTempDCgroups)
+		vehicleCU->nrOfCurrentOrTempDTCs = _nrOfCurrentOrTempDTCs;
+	else
+		vehicleCU->nrOfCurrentOrTempDTCs = 0;
+	if (DCgroups & historicOrMemDCgroups)
+		vehicleCU->nrOfHistoricOrMemDTCs = _nrOfHistoricOrMemDTCs;
+	else
+		vehicleCU->nrOfHistoricOrMemDTCs = 0;
+	return (_pendingDTCsignals == 0);
+}
+
+
+void VehicleScanner::processCurrentOrTemporaryDTCs(QStringList DTCs, QStringList descriptions, bool testMode, bool DCheckActive)
+{
+	(void)descriptions; // to avoid compiler error
+	(void)testMode;
+	(void)DCheckActive;
+	if (_nrOfCurrentOrTempDTCs >= 0) return;	// only the first data is needed
+	_nrOfCurrentOrTempDTCs = DTCs.size();
+	_pendingDTCsignals--;
+	if (!_pendingDTCsignals)
+		_el.quit();
+}
+
+
+void VehicleScanner::processHistoricOrMemorizedDTCs(QStringList DTCs, QStringList descriptions)
+{
+	(void)descriptions; // to avoid compiler error
+	if (_nrOfHistoricOrMemDTCs >= 0) return;	// only the first data is needed
+	_nrOfHistoricOrMemDTCs = DTCs.size();
+	_pendingDTCsignals--;
+	if (!_pendingDTCsignals)
+		_el.quit();
+}
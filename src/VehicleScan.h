@@ -0,0 +1,129 @@
+/*
+ * VehicleScan.h - Scan of all control units of a vehicle
+ *
+ * Copyright (C) 2012 Comer352L
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VEHICLESCAN_H
+#define VEHICLESCAN_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QTimer>
+#include <QMutex>
+#include <vector>
+#include <algorithm>
+#include "AbstractDiagInterface.h"
+#include "SSMprotocol.h"
+#include "SSMprotocol1.h"
+#include "SSMprotocol2.h"
+#include "CUsetupCache.h"
+
+
+#define		VEHICLE_TOPOLOGY_FORMAT_VERSION		1
+#define		VEHICLE_TOPOLOGY_MAX_VEHICLES		16
+#define		VEHICLE_TOPOLOGY_FILENAME		"vehicles.bin"	// in CU_SETUP_CACHE_DIRNAME
+#define		VEHICLESCAN_DTC_TIMEOUT_MS		5000
+
+
+
+class vehicleCU_dt
+{
+public:
+	vehicleCU_dt();
+
+	SSMprotocol::CUtype_dt CUtype;
+	AbstractDiagInterface::protocol_type protocol;
+	QString SYS_ID;		// hex string
+	QString ROM_ID;		// hex string
+	QString description;
+	int nrOfCurrentOrTempDTCs;	// -1: unknown
+	int nrOfHistoricOrMemDTCs;	// -1: unknown
+};
+
+
+
+class vehicleTopology_dt
+{
+public:
+	QString key;		// "VIN_<VIN>" or "ROM_<ROM-ID of the first control unit>"
+	QString VIN;
+	QDateTime scanTime;
+	std::vector<vehicleCU_dt> CUs;
+};
+
+
+
+class VehicleTopologyCache
+{
+
+public:
+	static bool lookup(QString key, vehicleTopology_dt *topology);
+	static void preferLastProtocol(SSMprotocol::CUtype_dt CU, std::vector<AbstractDiagInterface::protocol_type> *protocols);
+	static void store(const vehicleTopology_dt & topology);
+
+private:
+	static QMutex _mutex;
+	static bool _loaded;
+	static std::vector<vehicleTopology_dt> _topologies;	// most recently scanned first
+
+	static QString filename();
+	static void load();
+	static bool save();
+};
+
+
+
+/* NOTE: the engine control unit is probed first, it identifies the vehicle (VIN or ROM-ID).
+ *       If the vehicle is known, only the control units of the saved topology are probed
+ *       (with their known protocol). Otherwise, all control units are probed.
+ *       The saved topology is merged with the result, control units which are not
+ *       found (e.g. not responding temporarily) are kept.                                  */
+
+class VehicleScanner : public QObject
+{
+	Q_OBJECT
+
+public:
+	VehicleScanner(AbstractDiagInterface *diagInterface, QString language = "en");
+	bool scan(vehicleTopology_dt *topology, bool useKnownTopology = true);
+
+private:
+	AbstractDiagInterface *_diagInterface;
+	QString _language;
+	QString _VIN;
+	QEventLoop _el;
+	QTimer _DTCtimer;
+	unsigned char _pendingDTCsignals;
+	int _nrOfCurrentOrTempDTCs;
+	int _nrOfHistoricOrMemDTCs;
+
+	std::vector<AbstractDiagInterface::protocol_type> candidateProtocols(SSMprotocol::CUtype_dt CU);
+	bool probeControlUnit(SSMprotocol::CUtype_dt CU, AbstractDiagInterface::protocol_type protocol, vehicleCU_dt *vehicleCU);
+	bool readDTCcounts(SSMprotocol *SSMPdev, vehicleCU_dt *vehicleCU);
+
+private slots:
+	void processCurrentOrTemporaryDTCs(QStringList DTCs, QStringList descriptions, bool testMode, bool DCheckActive);
+	void processHistoricOrMemorizedDTCs(QStringList DTCs, QStringList descriptions);
+
+};
+
+
+#endif
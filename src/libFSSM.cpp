@@ -100,6 +100,51 @@ bool libFSSM::raw2scaledByCalculation(unsigned int rawValue, QString scaleformul
 }
 
 
+bool libFSSM::compileScaleformula(QString scaleformula, int *signedBits, std::vector<char> *operators, std::vector<double> *operands)
+{
+	double testValue = 0;
+	int opindex = 0;
+	operators->clear();
+	operands->clear();
+	*signedBits = 0;
+	if (scaleformula.size() < 1) return false;
+	// CHECK IF FORMULA BEGINS WITH A VALID DATA TYPE MODIFIER:
+	if (scaleformula.startsWith("s", Qt::CaseInsensitive))
+	{
+		if (scaleformula.mid(1,1) == "8")
+		{
+			*signedBits = 8;
+			scaleformula.remove(0,2);
+		}
+		else if (scaleformula.mid(1,2) == "16")
+		{
+			*signedBits = 16;
+			scaleformula.remove(0,3);
+		}
+		else
+			return false;
+	}
+	// VALIDATE FORMULA:
+	if (!scale(testValue, scaleformula, false, &testValue))
+		return false;
+	// SPLIT FORMULA INTO CALCULATION STEPS:
+	for (int charindex=1; charindex<=scaleformula.size(); charindex++)
+	{
+		if ((charindex == scaleformula.size()) ||
+		    (((scaleformula.at(charindex) == '+') || (scaleformula.at(charindex) == '-') || (scaleformula.at(charindex) == '*') || (scaleformula.at(charindex) == '/'))
+		     && ((charindex - opindex) > 1)))
+		{
+			operators->push_back( scaleformula.at(opindex).toAscii() );
+			operands->push_back( scaleformula.mid(opindex+1, charindex-opindex-1).toDouble() );
+			opindex = charindex;
+		}
+	}
+	return true;
+	/* NOTE: the calculation steps are applied in the same order as with raw2scaled(),
+	 *       so the results are identical */
+}
+
+
 bool libFSSM::scaled2raw(QString scaledValueStr, QString scaleformula, unsigned int *rawValue)
 {
 	bool success = false;
@@ -23,6 +23,7 @@
 
 #include <QString>
 #include <string>
+#include <vector>
 #include <math.h>
 
 
@@ -32,6 +33,7 @@ class libFSSM
 public:
 	static bool raw2scaled(unsigned int rawValue, QString scaleformula, char precision, QString *scaledValueStr);
 	static bool scaled2raw(QString scaledValueStr, QString scaleformula, unsigned int *rawValue);
+	static bool compileScaleformula(QString scaleformula, int *signedBits, std::vector<char> *operators, std::vector<double> *operands);
 	static std::string StrToHexstr(char *inputstr, unsigned int nrbytes);
 
 private:
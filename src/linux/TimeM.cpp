@@ -30,7 +30,7 @@ TimeM::TimeM()
 unsigned long int TimeM::start()
 {
 	unsigned int t_el = elapsed();
-	clock_gettime(CLOCK_REALTIME, &t_start);
+	clock_gettime(CLOCK_MONOTONIC, &t_start);
 	return t_el;
 }
 
@@ -40,7 +40,7 @@ unsigned long int TimeM::elapsed()
 	struct timespec t;
 	if (!t_start.tv_sec && !t_start.tv_nsec) return 0;
 	unsigned long int delta_s=0, delta_ns=0, t_el=0;
-	clock_gettime(CLOCK_REALTIME, &t);	// returns -1 on error, 0 on success
+	clock_gettime(CLOCK_MONOTONIC, &t);	// returns -1 on error, 0 on success
 	delta_s = t.tv_sec - t_start.tv_sec;	// field t.tv_sec is of type long (linux) => overflow every 68 years :-) )
 	if (t.tv_nsec >= t_start.tv_nsec)
 		delta_ns = t.tv_nsec - t_start.tv_nsec;
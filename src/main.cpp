@@ -22,12 +22,61 @@
 
 
 #include <QtGui>
+#include <csignal>
+#include <cstring>
 #include "FreeSSM.h"
+#include "DiagSessionManager.h"
+
+
+static void stopSessions(int sig)
+{
+	DiagSessionManager::requestStop();
+	signal(sig, stopSessions);
+}
+
+
+static int runSessions(int argc, char *argv[], QString configfile)
+{
+	// Run the sessions of the configuration file without GUI until SIGINT/SIGTERM:
+	QCoreApplication app(argc, argv);
+	app.setApplicationVersion(FSSM_VERSION);
+	QTextCodec::setCodecForCStrings( QTextCodec::codecForName("UTF-8") );
+	std::vector<diagSessionConfig_dt> configs;
+	if (!DiagSessionManager::loadConfiguration(configfile, &configs))
+	{
+		std::cout << "Couldn't load the session configuration file " << configfile.toLocal8Bit().constData() << '\n';
+		return -1;
+	}
+	DiagSessionManager manager;
+	for (unsigned int k=0; k<configs.size(); k++)
+	{
+		if (!manager.addSession(configs.at(k)))
+		{
+			std::cout << "Too many sessions (max. " << DIAGSESSION_MAX_SESSIONS << ")\n";
+			return -1;
+		}
+	}
+	signal(SIGINT, stopSessions);
+	signal(SIGTERM, stopSessions);
+	return manager.exec();
+}
 
 
 int main(int argc, char *argv[])
 {
+	// --sessions <file>: run several sessions without GUI
+	/* NOTE: checked before the application object is created: the sessions run with a QCoreApplication,
+	 *       so they neither need a display nor the single instance lock (can run parallel to the GUI)  */
+	for (int k=1; k<(argc - 1); k++)
+	{
+		if (!strcmp(argv[k], "--sessions"))
+			return runSessions(argc, argv, QString::fromLocal8Bit(argv[k+1]));
+	}
 	QApplication app(argc, argv);
+	// Set application version:
+	app.setApplicationVersion(FSSM_VERSION);
+	// Use Unicode UTF-8:
+	QTextCodec::setCodecForCStrings( QTextCodec::codecForName("UTF-8") );
 	// Ensure that only one instance of FreeSSM is started:
 	QSharedMemory fssm_lock("FreeSSM_smo-key_1234567890ABCDEFGHIJKLMNOPQRSTUVW");
 	if ( fssm_lock.attach() )
@@ -39,12 +88,8 @@ int main(int argc, char *argv[])
 			return -1;
 	}
 	fssm_lock.create(1, QSharedMemory::ReadOnly);
-	// Set application version:
-	app.setApplicationVersion(FSSM_VERSION);
 	// Set window icon:
 	app.setWindowIcon( QIcon(":/icons/freessm/32x32/FreeSSM.png") );
-	// Use Unicode UTF-8:
-	QTextCodec::setCodecForCStrings( QTextCodec::codecForName("UTF-8") );
 	// Get installed (system) fonts:
 	QFontDatabase fdb;
 	QStringList fontfamilies = fdb.families ( QFontDatabase::Any );